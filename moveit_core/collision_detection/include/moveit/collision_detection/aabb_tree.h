@@ -0,0 +1,155 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_COLLISION_DETECTION_AABB_TREE_
+#define MOVEIT_COLLISION_DETECTION_AABB_TREE_
+
+#include <Eigen/Geometry>
+#include <string>
+#include <vector>
+
+namespace collision_detection
+{
+/** \brief A dynamic bounding volume hierarchy over named axis-aligned boxes.
+ *
+ * Leaves can be inserted, removed and updated incrementally. Inner nodes are kept balanced by tree rotations,
+ * so queries visit O(log n) nodes for small query regions. Leaf handles stay valid until the leaf is removed. */
+class AABBTree
+{
+public:
+  typedef Eigen::AlignedBox3d Box;
+
+  /** \brief The handle returned for invalid or missing nodes */
+  static const int NULL_NODE = -1;
+
+  AABBTree();
+
+  /** \brief Insert a leaf named \e id with bounding box \e box. Returns the handle of the leaf */
+  int insert(const std::string& id, const Box& box);
+
+  /** \brief Remove a leaf, invalidating its handle */
+  void remove(int leaf);
+
+  /** \brief Change the bounding box of a leaf */
+  void update(int leaf, const Box& box);
+
+  /** \brief Remove all leaves */
+  void clear();
+
+  /** \brief Get the bounding box of a leaf */
+  const Box& getBox(int leaf) const
+  {
+    return nodes_[leaf].box_;
+  }
+
+  /** \brief Get the name of a leaf */
+  const std::string& getId(int leaf) const
+  {
+    return nodes_[leaf].id_;
+  }
+
+  /** \brief Number of leaves */
+  std::size_t size() const
+  {
+    return leaf_count_;
+  }
+
+  /** \brief Height of the tree: 0 for a single leaf, -1 for an empty tree */
+  int getHeight() const
+  {
+    return root_ == NULL_NODE ? -1 : nodes_[root_].height_;
+  }
+
+  /** \brief Visit all leaves whose box satisfies \e overlaps.
+   *
+   * \e overlaps is called as bool(const Box&) for inner nodes and leaves and must return true for every box that
+   * contains a box it returns true for. \e visit is called as void(const std::string& id, const Box&) for the
+   * matching leaves. */
+  template <typename Overlaps, typename Visit>
+  void query(const Overlaps& overlaps, const Visit& visit) const
+  {
+    if (root_ == NULL_NODE)
+      return;
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(root_);
+    while (!stack.empty())
+    {
+      const Node& node = nodes_[stack.back()];
+      stack.pop_back();
+      if (!overlaps(node.box_))
+        continue;
+      if (node.left_ == NULL_NODE)
+        visit(node.id_, node.box_);
+      else
+      {
+        stack.push_back(node.left_);
+        stack.push_back(node.right_);
+      }
+    }
+  }
+
+private:
+  struct Node
+  {
+    Box box_;
+    /* next node in the free list for unused nodes */
+    int parent_;
+    /* NULL_NODE for leaves */
+    int left_;
+    int right_;
+    /* 0 for leaves, -1 for unused nodes */
+    int height_;
+    /* only set for leaves */
+    std::string id_;
+  };
+
+  int allocateNode();
+  void freeNode(int node);
+  void insertLeaf(int leaf);
+  void removeLeaf(int leaf);
+  /* recompute the boxes and heights of \e node and its ancestors, rebalancing on the way */
+  void refit(int node);
+  int balance(int node);
+  /* replace \e node by its child \e up, returns the new root of the subtree */
+  int rotate(int node, int up);
+
+  std::vector<Node> nodes_;
+  int root_;
+  int free_list_;
+  std::size_t leaf_count_;
+};
+}  // namespace collision_detection
+
+#endif
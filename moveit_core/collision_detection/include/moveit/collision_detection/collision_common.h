@@ -39,9 +39,11 @@
 
 #include <boost/array.hpp>
 #include <boost/function.hpp>
+#include <functional>
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 #include <set>
 #include <Eigen/Core>
 #include <moveit/robot_model/robot_model.h>
@@ -136,7 +138,12 @@ struct CostSource
 /** \brief Representation of a collision checking result */
 struct CollisionResult
 {
-  CollisionResult() : collision(false), distance(std::numeric_limits<double>::max()), contact_count(0)
+  CollisionResult()
+    : collision(false)
+    , distance(std::numeric_limits<double>::max())
+    , contact_count(0)
+    , checked_pairs(0)
+    , bound_rejected_pairs(0)
   {
   }
   typedef std::map<std::pair<std::string, std::string>, std::vector<Contact> > ContactMap;
@@ -151,6 +158,8 @@ struct CollisionResult
     contact_count = 0;
     contacts.clear();
     cost_sources.clear();
+    checked_pairs = 0;
+    bound_rejected_pairs = 0;
   }
 
   /** \brief True if collision was found, false otherwise */
@@ -168,6 +177,13 @@ struct CollisionResult
 
   /** \brief When costs are computed, the individual cost sources are  */
   std::set<CostSource> cost_sources;
+
+  /** \brief Number of pairs of bodies that needed a detailed check after the broadphase and the collision matrix
+      (only counted by checkers that report it) */
+  std::size_t checked_pairs;
+
+  /** \brief Number of \e checked_pairs rejected by their bounding volumes, without running the narrowphase */
+  std::size_t bound_rejected_pairs;
 };
 
 /** \brief Representation of a collision checking request */
@@ -220,6 +236,43 @@ struct CollisionRequest
   bool verbose;
 };
 
+/** \brief Representation of a request to check a batch of robot states for collision. Each state is checked with the
+    settings of the underlying CollisionRequest and gets its own CollisionResult. */
+struct CollisionBatchRequest : public CollisionRequest
+{
+  CollisionBatchRequest() : stop_at_first_collision(false), num_threads(1)
+  {
+  }
+
+  explicit CollisionBatchRequest(const CollisionRequest& req)
+    : CollisionRequest(req), stop_at_first_collision(false), num_threads(1)
+  {
+  }
+
+  /** \brief If true, stop checking once a colliding state is found. All states before the first colliding one are
+      still checked, and the results end with the first colliding state. */
+  bool stop_at_first_collision;
+
+  /** \brief The number of threads to distribute the states across. With 1, all states are checked in the calling
+      thread. Otherwise, the calling thread is helped by worker threads that are kept across batches. */
+  unsigned int num_threads;
+};
+
+/** \brief Call \e check for the indices of a batch of \e count states, honoring the early exit and threading settings
+    of \e req. \e results is resized to \e count and cleared before \e check fills in the result of each state.
+    When more than one thread is used, \e check is called concurrently.
+    If the batch stops at a colliding state, \e results is truncated after it, so it only holds checked states.
+    @return The index of the first colliding state, or \e count if no checked state is in collision */
+std::size_t processCollisionBatch(const CollisionBatchRequest& req, std::size_t count,
+                                  std::vector<CollisionResult>& results,
+                                  const std::function<void(std::size_t, CollisionResult&)>& check);
+
+/** \brief Same as above, but \e check also gets the index of the worker calling it. The index is below
+    \e req.num_threads and each worker calls \e check sequentially, so it can select buffers owned by the worker. */
+std::size_t processCollisionBatch(const CollisionBatchRequest& req, std::size_t count,
+                                  std::vector<CollisionResult>& results,
+                                  const std::function<void(std::size_t, CollisionResult&, std::size_t)>& check);
+
 namespace DistanceRequestTypes
 {
 enum DistanceRequestType
@@ -232,6 +285,50 @@ enum DistanceRequestType
 }
 typedef DistanceRequestTypes::DistanceRequestType DistanceRequestType;
 
+/** \brief Data kept between distance queries of nearby states, so a query can start from the results of the previous
+    one (the closest pairs found and bounds on the distances of all examined pairs). The results of a query are the
+    same with or without a cache. A cache must not be used by several queries at the same time.
+
+    Callers opt in either by setting DistanceRequest::cache or, for all queries of a thread, with enableThreadCache(). */
+class DistanceCache
+{
+public:
+  /** \brief Base class for the data a collision detector stores in the cache */
+  struct Data
+  {
+    virtual ~Data() = default;
+  };
+
+  /** \brief Get the data of type \e T, replacing data of any other type by a default constructed \e T */
+  template <typename T>
+  T& getData()
+  {
+    T* data = dynamic_cast<T*>(data_.get());
+    if (!data)
+    {
+      data = new T();
+      data_.reset(data);
+    }
+    return *data;
+  }
+
+  /** \brief Forget everything learned from previous queries */
+  void clear()
+  {
+    data_.reset();
+  }
+
+  /** \brief Enable or disable the cache of the calling thread, which is used by distance queries
+      issued from this thread that do not specify a cache in their request. Disabling it frees its data. */
+  static void enableThreadCache(bool enable);
+
+  /** \brief Get the cache of the calling thread, or nullptr if it is not enabled */
+  static DistanceCache* getThreadCache();
+
+private:
+  std::unique_ptr<Data> data_;
+};
+
 struct DistanceRequest
 {
   DistanceRequest()
@@ -244,6 +341,7 @@ struct DistanceRequest
     , distance_threshold(std::numeric_limits<double>::max())
     , verbose(false)
     , compute_gradient(false)
+    , cache(nullptr)
   {
   }
 
@@ -289,6 +387,16 @@ struct DistanceRequest
   /// Indicate if gradient should be calculated between each object.
   /// This is the normalized vector connecting the closest points on the two objects.
   bool compute_gradient;
+
+  /// Results of previous queries used to speed up this one. If not set, the cache of the
+  /// calling thread is used if enabled (see DistanceCache::enableThreadCache()).
+  DistanceCache* cache;
+
+  /// Get the cache to use for this request: \e cache or the cache of the calling thread (may be nullptr)
+  DistanceCache* getCache() const
+  {
+    return cache ? cache : DistanceCache::getThreadCache();
+  }
 };
 
 struct DistanceResultsData
@@ -41,6 +41,7 @@
 #include <moveit/macros/class_forward.h>
 #include <moveit_msgs/msg/allowed_collision_matrix.hpp>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <string>
 #include <map>
@@ -72,6 +73,7 @@ enum Type
 typedef std::function<bool(collision_detection::Contact&)> DecideContactFn;
 
 MOVEIT_CLASS_FORWARD(AllowedCollisionMatrix)
+MOVEIT_CLASS_FORWARD(CompiledAllowedCollisionMatrix)
 
 /** @class AllowedCollisionMatrix
  *  @brief Definition of a structure for the allowed collision matrix. All elements in the collision world are referred
@@ -266,15 +268,101 @@ public:
   bool getAllowedCollision(const std::string& name1, const std::string& name2,
                            AllowedCollision::Type& allowed_collision) const;
 
+  /** @brief Get the compiled form of this matrix for lookups by name ID. It is built on first use after the matrix
+   *  was changed, and can be shared between threads. */
+  CompiledAllowedCollisionMatrixConstPtr getCompiled() const;
+
   /** @brief Print the allowed collision matrix */
   void print(std::ostream& out) const;
 
 private:
+  friend class CompiledAllowedCollisionMatrix;
+
   std::map<std::string, std::map<std::string, AllowedCollision::Type> > entries_;
   std::map<std::string, std::map<std::string, DecideContactFn> > allowed_contacts_;
 
   std::map<std::string, AllowedCollision::Type> default_entries_;
   std::map<std::string, DecideContactFn> default_allowed_contacts_;
+
+  /** @brief The compiled form of the entries above; reset by every change */
+  mutable CompiledAllowedCollisionMatrixConstPtr compiled_;
+};
+
+/** @class CompiledAllowedCollisionMatrix
+ *  @brief Index-based form of an AllowedCollisionMatrix for the collision checking hot path. Names are referred to by
+ *  NameID references, and the allowed collision types of all pairs are stored in bit matrices, so lookups are O(1)
+ *  without any string operations. Conditionally allowed pairs are only marked as
+ *  AllowedCollision::CONDITIONAL here; their DecideContactFn has to be retrieved from the AllowedCollisionMatrix. */
+class CompiledAllowedCollisionMatrix
+{
+public:
+  /** @brief A reference to the ID of a name. IDs are dense and do not change while a reference to them exists; once
+   *  the last reference to a name is gone, its ID is reused for other names. Copies are cheap and thread-safe. */
+  class NameID
+  {
+  public:
+    NameID() : entry_(nullptr), id_(-1)
+    {
+    }
+
+    explicit NameID(const std::string& name);
+    NameID(const NameID& other);
+    NameID& operator=(const NameID& other);
+    ~NameID();
+
+    /** @brief The ID, or -1 for a default constructed reference */
+    int get() const
+    {
+      return id_;
+    }
+
+  private:
+    struct Entry;
+    struct Registry;
+
+    static Registry& getRegistry();
+    static Entry* acquire(const std::string& name);
+    static void release(Entry* entry);
+
+    Entry* entry_;
+    int id_;
+  };
+
+  /** @brief Build the compiled form of \e acm. Later changes to \e acm are not reflected. */
+  explicit CompiledAllowedCollisionMatrix(const AllowedCollisionMatrix& acm);
+
+  /** @brief Get the type of the allowed collision between two elements given by their name IDs, with the same
+   *  semantics as AllowedCollisionMatrix::getAllowedCollision(). Return false if no entry or default applies. */
+  bool getAllowedCollision(const NameID& id1, const NameID& id2, AllowedCollision::Type& allowed_collision) const
+  {
+    std::size_t k = getRow(id1.get()) * (size_ + 1) + getRow(id2.get());
+    if (!found_[k])
+      return false;
+    allowed_collision =
+        conditional_[k] ? AllowedCollision::CONDITIONAL : (allowed_[k] ? AllowedCollision::ALWAYS : AllowedCollision::NEVER);
+    return true;
+  }
+
+private:
+  /** @brief Get the row of a name ID; names unknown to the matrix share the last row */
+  std::size_t getRow(int id) const
+  {
+    return id >= 0 && static_cast<std::size_t>(id) < rows_.size() ? rows_[id] : size_;
+  }
+
+  /** @brief Number of names known to the matrix */
+  std::size_t size_;
+
+  /** @brief The IDs of the names known to the matrix, which keep them from being reused while the matrix exists */
+  std::vector<NameID> name_ids_;
+
+  /** @brief The row of each name ID */
+  std::vector<std::size_t> rows_;
+
+  /** @brief Bit matrices of size (size_ + 1)^2 describing each pair */
+  std::vector<bool> found_;
+  std::vector<bool> allowed_;
+  std::vector<bool> conditional_;
 };
 }  // namespace collision_detection
 
@@ -106,6 +106,26 @@ public:
                                   const robot_state::RobotState& state1, const robot_state::RobotState& state2,
                                   const AllowedCollisionMatrix& acm) const = 0;
 
+  /** \brief Check a batch of states for self collision. Any collision between any pair of links is checked for,
+   *  NO collisions are ignored. The default implementation calls checkSelfCollision() for each state.
+   *  @param req A CollisionBatchRequest object that encapsulates the request used for every state
+   *  @param states The kinematic states for which checks are being made
+   *  @param results The collision results, one per checked state */
+  virtual void checkSelfCollisionBatch(const CollisionBatchRequest& req,
+                                       const std::vector<const robot_state::RobotState*>& states,
+                                       std::vector<CollisionResult>& results) const;
+
+  /** \brief Check a batch of states for self collision. Allowed collisions specified by the allowed collision matrix
+   *  are taken into account. The default implementation calls checkSelfCollision() for each state.
+   *  @param req A CollisionBatchRequest object that encapsulates the request used for every state
+   *  @param states The kinematic states for which checks are being made
+   *  @param results The collision results, one per checked state
+   *  @param acm The allowed collision matrix. */
+  virtual void checkSelfCollisionBatch(const CollisionBatchRequest& req,
+                                       const std::vector<const robot_state::RobotState*>& states,
+                                       std::vector<CollisionResult>& results,
+                                       const AllowedCollisionMatrix& acm) const;
+
   /** \brief Check for collision with a different robot (possibly a different kinematic model as well).
    *  Any collision between any pair of links is checked for, NO collisions are ignored.
    *  @param req A CollisionRequest object that encapsulates the collision request
@@ -110,6 +110,27 @@ public:
                               const robot_state::RobotState& state1, const robot_state::RobotState& state2,
                               const AllowedCollisionMatrix& acm) const;
 
+  /** \brief Check a batch of states of the robot model for collision with itself or the world.
+   *  Any collision between any pair of links is checked for, NO collisions are ignored.
+   *  @param req A CollisionBatchRequest object that encapsulates the request used for every state
+   *  @param robot The collision model for the robot
+   *  @param states The kinematic states for which checks are being made
+   *  @param results The collision results, one per checked state */
+  virtual void checkCollisionBatch(const CollisionBatchRequest& req, const CollisionRobot& robot,
+                                   const std::vector<const robot_state::RobotState*>& states,
+                                   std::vector<CollisionResult>& results) const;
+
+  /** \brief Check a batch of states of the robot model for collision with itself or the world.
+   *  Allowed collisions specified by the allowed collision matrix are taken into account.
+   *  @param req A CollisionBatchRequest object that encapsulates the request used for every state
+   *  @param robot The collision model for the robot
+   *  @param states The kinematic states for which checks are being made
+   *  @param results The collision results, one per checked state
+   *  @param acm The allowed collision matrix. */
+  virtual void checkCollisionBatch(const CollisionBatchRequest& req, const CollisionRobot& robot,
+                                   const std::vector<const robot_state::RobotState*>& states,
+                                   std::vector<CollisionResult>& results, const AllowedCollisionMatrix& acm) const;
+
   /** \brief Check whether the robot model is in collision with the world. Any collisions between a robot link
    *  and the world are considered. Self collisions are not checked.
    *  @param req A CollisionRequest object that encapsulates the collision request
@@ -38,6 +38,8 @@
 #define MOVEIT_COLLISION_DETECTION_WORLD_
 
 #include <moveit/macros/class_forward.h>
+#include <moveit/collision_detection/aabb_tree.h>
+#include <limits>
 #include <string>
 #include <vector>
 #include <map>
@@ -178,6 +180,88 @@ public:
    * the memory is freed. */
   void clearObjects();
 
+  /** \brief Start a batch of changes.
+   * Until the matching commitTransaction(), changes to objects are not reported to observers one by one. Instead,
+   * all changes to an object are coalesced and reported once when the transaction is committed, so that observers
+   * (e.g. collision worlds) update their representation of the object only once per batch. Transactions may be
+   * nested; only committing the outermost one notifies the observers.
+   * \note Observers see the state of the world from before the transaction until it is committed. */
+  void beginTransaction();
+
+  /** \brief Finish a batch of changes started with beginTransaction().
+   * For every object changed in the batch, observers receive a single notification describing the net change:
+   * CREATE | ADD_SHAPE for objects that did not exist before, DESTROY for objects that do not exist anymore and the
+   * accumulated MOVE_SHAPE, ADD_SHAPE and REMOVE_SHAPE bits otherwise. An object that was destroyed and recreated
+   * within the batch is reported as DESTROY followed by CREATE | ADD_SHAPE. Objects that were created and removed
+   * again are not reported at all. Notifications are sent in the order the objects were first changed. */
+  void commitTransaction();
+
+  /** \brief Check whether changes are currently batched by a transaction */
+  bool inTransaction() const
+  {
+    return transaction_depth_ > 0;
+  }
+
+  /** \brief Scoped transaction: calls beginTransaction() on construction and commitTransaction() on destruction */
+  class Transaction
+  {
+  public:
+    Transaction(World& world) : world_(world)
+    {
+      world_.beginTransaction();
+    }
+    ~Transaction()
+    {
+      world_.commitTransaction();
+    }
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+  private:
+    World& world_;
+  };
+
+  /**********************************************************************/
+  /* Spatial queries                                                    */
+  /**********************************************************************/
+
+  /** \brief Enable or disable the spatial index over the bounding boxes of the objects.
+   * While enabled, an AABBTree over the axis-aligned bounding boxes of all objects is maintained incrementally as
+   * objects change, so that the region queries below only visit the objects close to the query region. Without the
+   * index, the queries compute the bounding boxes of all objects. The index is disabled by default; copies of the
+   * world inherit it. */
+  void setSpatialIndexEnabled(bool enable);
+
+  /** \brief Check whether the spatial index is maintained */
+  bool isSpatialIndexEnabled() const
+  {
+    return static_cast<bool>(spatial_index_);
+  }
+
+  /** \brief Get the axis-aligned bounding box of an object in the world frame.
+   * Planes are bounded by UNBOUNDED_EXTENT. Returns an empty box if the object does not exist. */
+  Eigen::AlignedBox3d getObjectAABB(const std::string& id) const;
+
+  /** \brief Compute the axis-aligned bounding box of an object in the world frame */
+  static Eigen::AlignedBox3d computeObjectAABB(const Object& obj);
+
+  /** \brief Half the size of the bounding box used for unbounded shapes (planes) */
+  static const double UNBOUNDED_EXTENT;
+
+  /** \brief Get the ids of the objects whose bounding box intersects \e box, in alphabetical order */
+  std::vector<std::string> getObjectsInBox(const Eigen::AlignedBox3d& box) const;
+
+  /** \brief Get the ids of the objects whose bounding box intersects the sphere at \e center with radius \e radius,
+   * in alphabetical order */
+  std::vector<std::string> getObjectsInSphere(const Eigen::Vector3d& center, double radius) const;
+
+  /** \brief Get the ids of the objects whose bounding box is hit by the ray starting at \e origin along \e direction
+   * within \e max_distance (in multiples of the length of \e direction), ordered by the distance at which the ray
+   * enters the boxes. The optional \e distances receive these distances. */
+  std::vector<std::string> getObjectsAlongRay(const Eigen::Vector3d& origin, const Eigen::Vector3d& direction,
+                                              double max_distance = std::numeric_limits<double>::infinity(),
+                                              std::vector<double>* distances = nullptr) const;
+
   enum ActionBits
   {
     UNINITIALIZED = 0,
@@ -244,12 +328,25 @@ public:
   void notifyObserverAllObjects(const ObserverHandle observer_handle, Action action) const;
 
 private:
-  /** notify all observers of a change */
+  /** notify all observers of a change, or record it if a transaction is active */
   void notify(const ObjectConstPtr&, Action);
 
+  /** call the callbacks of all observers */
+  void notifyObservers(const ObjectConstPtr&, Action);
+
+  /** coalesce a change into the pending changes of the active transaction */
+  void recordChange(const ObjectConstPtr&, Action);
+
   /** send notification of change to all objects. */
   void notifyAll(Action action);
 
+  /** update the bounding box of a changed object in the spatial index */
+  void updateSpatialIndex(const ObjectConstPtr&, Action);
+
+  /** call \e visit(id, box) for all objects whose bounding box satisfies \e overlaps */
+  template <typename Overlaps, typename Visit>
+  void queryObjects(const Overlaps& overlaps, const Visit& visit) const;
+
   /** \brief Make sure that the object named \e id is known only to this
    * instance of the World. If the object is known outside of it, a
    * clone is made so that it can be safely modified later on. */
@@ -272,6 +369,30 @@ private:
     ObserverCallbackFn callback_;
   };
   std::vector<Observer*> observers_;
+
+  /* the net change of an object within the active transaction */
+  struct PendingChange
+  {
+    std::string id_;
+    /* whether observers knew the object before the transaction */
+    bool existed_;
+    /* the object known to observers, if it was destroyed during the transaction */
+    ObjectConstPtr destroyed_;
+    /* ActionBits accumulated since the object was (re)created or since the transaction started */
+    int action_;
+  };
+
+  /* nesting depth of beginTransaction() calls */
+  unsigned int transaction_depth_;
+
+  /* changes recorded in the active transaction, in the order the objects were first changed */
+  std::vector<PendingChange> pending_changes_;
+  std::map<std::string, std::size_t> pending_index_;
+
+  /* bounding boxes of the objects, if the spatial index is enabled */
+  std::unique_ptr<AABBTree> spatial_index_;
+  /* the leaf of each object in spatial_index_ */
+  std::map<std::string, int> spatial_index_leaves_;
 };
 }  // namespace collision_detection
 
@@ -0,0 +1,253 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/aabb_tree.h>
+#include <algorithm>
+
+namespace collision_detection
+{
+namespace
+{
+double surfaceArea(const AABBTree::Box& box)
+{
+  const Eigen::Vector3d d = box.sizes();
+  return 2.0 * (d.x() * d.y() + d.y() * d.z() + d.z() * d.x());
+}
+}  // namespace
+
+const int AABBTree::NULL_NODE;
+
+AABBTree::AABBTree() : root_(NULL_NODE), free_list_(NULL_NODE), leaf_count_(0)
+{
+}
+
+int AABBTree::insert(const std::string& id, const Box& box)
+{
+  int leaf = allocateNode();
+  nodes_[leaf].box_ = box;
+  nodes_[leaf].id_ = id;
+  insertLeaf(leaf);
+  ++leaf_count_;
+  return leaf;
+}
+
+void AABBTree::remove(int leaf)
+{
+  removeLeaf(leaf);
+  freeNode(leaf);
+  --leaf_count_;
+}
+
+void AABBTree::update(int leaf, const Box& box)
+{
+  removeLeaf(leaf);
+  nodes_[leaf].box_ = box;
+  insertLeaf(leaf);
+}
+
+void AABBTree::clear()
+{
+  nodes_.clear();
+  root_ = NULL_NODE;
+  free_list_ = NULL_NODE;
+  leaf_count_ = 0;
+}
+
+int AABBTree::allocateNode()
+{
+  int node;
+  if (free_list_ != NULL_NODE)
+  {
+    node = free_list_;
+    free_list_ = nodes_[node].parent_;
+  }
+  else
+  {
+    node = nodes_.size();
+    nodes_.emplace_back();
+  }
+  nodes_[node].parent_ = NULL_NODE;
+  nodes_[node].left_ = NULL_NODE;
+  nodes_[node].right_ = NULL_NODE;
+  nodes_[node].height_ = 0;
+  return node;
+}
+
+void AABBTree::freeNode(int node)
+{
+  nodes_[node].parent_ = free_list_;
+  nodes_[node].height_ = -1;
+  nodes_[node].id_.clear();
+  free_list_ = node;
+}
+
+void AABBTree::insertLeaf(int leaf)
+{
+  if (root_ == NULL_NODE)
+  {
+    root_ = leaf;
+    nodes_[leaf].parent_ = NULL_NODE;
+    return;
+  }
+
+  // descend to the sibling that minimizes the surface area added to the tree
+  const Box box = nodes_[leaf].box_;
+  int sibling = root_;
+  while (nodes_[sibling].left_ != NULL_NODE)
+  {
+    const Node& node = nodes_[sibling];
+    double combined_area = surfaceArea(node.box_.merged(box));
+    // cost of creating a new parent for this node and the new leaf
+    double cost = 2.0 * combined_area;
+    // minimum cost of pushing the leaf further down the tree
+    double inheritance_cost = 2.0 * (combined_area - surfaceArea(node.box_));
+
+    double child_cost[2];
+    const int children[2] = { node.left_, node.right_ };
+    for (int i = 0; i < 2; ++i)
+    {
+      const Node& child = nodes_[children[i]];
+      child_cost[i] = surfaceArea(child.box_.merged(box)) + inheritance_cost;
+      if (child.left_ != NULL_NODE)
+        child_cost[i] -= surfaceArea(child.box_);
+    }
+
+    if (cost < child_cost[0] && cost < child_cost[1])
+      break;
+    sibling = child_cost[0] < child_cost[1] ? children[0] : children[1];
+  }
+
+  int old_parent = nodes_[sibling].parent_;
+  int new_parent = allocateNode();
+  nodes_[new_parent].parent_ = old_parent;
+  nodes_[new_parent].left_ = sibling;
+  nodes_[new_parent].right_ = leaf;
+  nodes_[sibling].parent_ = new_parent;
+  nodes_[leaf].parent_ = new_parent;
+  if (old_parent == NULL_NODE)
+    root_ = new_parent;
+  else if (nodes_[old_parent].left_ == sibling)
+    nodes_[old_parent].left_ = new_parent;
+  else
+    nodes_[old_parent].right_ = new_parent;
+
+  refit(new_parent);
+}
+
+void AABBTree::removeLeaf(int leaf)
+{
+  if (leaf == root_)
+  {
+    root_ = NULL_NODE;
+    return;
+  }
+
+  int parent = nodes_[leaf].parent_;
+  int grand_parent = nodes_[parent].parent_;
+  int sibling = nodes_[parent].left_ == leaf ? nodes_[parent].right_ : nodes_[parent].left_;
+  freeNode(parent);
+
+  // the sibling takes the place of the parent
+  nodes_[sibling].parent_ = grand_parent;
+  if (grand_parent == NULL_NODE)
+    root_ = sibling;
+  else
+  {
+    if (nodes_[grand_parent].left_ == parent)
+      nodes_[grand_parent].left_ = sibling;
+    else
+      nodes_[grand_parent].right_ = sibling;
+    refit(grand_parent);
+  }
+}
+
+void AABBTree::refit(int node)
+{
+  while (node != NULL_NODE)
+  {
+    node = balance(node);
+    Node& n = nodes_[node];
+    n.height_ = 1 + std::max(nodes_[n.left_].height_, nodes_[n.right_].height_);
+    n.box_ = nodes_[n.left_].box_.merged(nodes_[n.right_].box_);
+    node = n.parent_;
+  }
+}
+
+int AABBTree::balance(int node)
+{
+  const Node& n = nodes_[node];
+  if (n.left_ == NULL_NODE || n.height_ < 2)
+    return node;
+  int difference = nodes_[n.right_].height_ - nodes_[n.left_].height_;
+  if (difference > 1)
+    return rotate(node, n.right_);
+  if (difference < -1)
+    return rotate(node, n.left_);
+  return node;
+}
+
+int AABBTree::rotate(int node, int up)
+{
+  Node& a = nodes_[node];
+  Node& u = nodes_[up];
+
+  // u takes the place of a
+  u.parent_ = a.parent_;
+  a.parent_ = up;
+  if (u.parent_ == NULL_NODE)
+    root_ = up;
+  else if (nodes_[u.parent_].left_ == node)
+    nodes_[u.parent_].left_ = up;
+  else
+    nodes_[u.parent_].right_ = up;
+
+  // u keeps its taller child and adopts a, which takes the other child of u in place of u
+  int keep = u.left_, give = u.right_;
+  if (nodes_[give].height_ > nodes_[keep].height_)
+    std::swap(keep, give);
+  u.left_ = node;
+  u.right_ = keep;
+  if (a.left_ == up)
+    a.left_ = give;
+  else
+    a.right_ = give;
+  nodes_[give].parent_ = node;
+
+  a.box_ = nodes_[a.left_].box_.merged(nodes_[a.right_].box_);
+  a.height_ = 1 + std::max(nodes_[a.left_].height_, nodes_[a.right_].height_);
+  u.box_ = a.box_.merged(nodes_[keep].box_);
+  u.height_ = 1 + std::max(a.height_, nodes_[keep].height_);
+  return up;
+}
+}  // namespace collision_detection
@@ -0,0 +1,211 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_detection/collision_common.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace collision_detection
+{
+namespace
+{
+std::unique_ptr<DistanceCache>& threadDistanceCache()
+{
+  // each thread owns its cache, so it is never used by concurrent queries
+  static thread_local std::unique_ptr<DistanceCache> cache;
+  return cache;
+}
+
+/* Worker threads shared by all collision batches. The threads persist across batches, so the per-thread caches of the
+   collision detectors, like the FCL broadphase, are reused instead of being rebuilt for every batch. */
+class BatchThreadPool
+{
+public:
+  static BatchThreadPool& instance()
+  {
+    static BatchThreadPool pool;
+    return pool;
+  }
+
+  ~BatchThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_available_.notify_all();
+    for (std::thread& thread : threads_)
+      thread.join();
+  }
+
+  /* Run task in the calling thread and in up to helper_count pool threads, returning once all of them are done */
+  void run(std::size_t helper_count, const std::function<void()>& task)
+  {
+    // a batch started by a pool thread runs in that thread only, as the other pool threads may be waiting for it
+    if (helper_count == 0 || isPoolThread())
+    {
+      task();
+      return;
+    }
+
+    Job job{ &task, helper_count };
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      while (threads_.size() < helper_count)
+        threads_.emplace_back(&BatchThreadPool::work, this);
+      job_queue_.insert(job_queue_.end(), helper_count, &job);
+    }
+    work_available_.notify_all();
+
+    task();
+
+    // once the caller is done, the task is out of work, so helpers that did not start yet are not needed anymore
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::size_t queued_count = job_queue_.size();
+    job_queue_.erase(std::remove(job_queue_.begin(), job_queue_.end(), &job), job_queue_.end());
+    job.pending -= queued_count - job_queue_.size();
+    job_done_.wait(lock, [&job] { return job.pending == 0; });
+  }
+
+private:
+  struct Job
+  {
+    const std::function<void()>* task;
+    std::size_t pending;  // helpers that were queued or are running, guarded by mutex_
+  };
+
+  BatchThreadPool() = default;
+
+  static bool& isPoolThread()
+  {
+    static thread_local bool pool_thread = false;
+    return pool_thread;
+  }
+
+  void work()
+  {
+    isPoolThread() = true;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+      work_available_.wait(lock, [this] { return stop_ || !job_queue_.empty(); });
+      if (stop_)
+        return;
+      Job* job = job_queue_.front();
+      job_queue_.pop_front();
+      lock.unlock();
+      (*job->task)();
+      lock.lock();
+      if (--job->pending == 0)
+        job_done_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable job_done_;
+  std::deque<Job*> job_queue_;
+  std::vector<std::thread> threads_;
+  bool stop_ = false;
+};
+}  // namespace
+
+void DistanceCache::enableThreadCache(bool enable)
+{
+  std::unique_ptr<DistanceCache>& cache = threadDistanceCache();
+  if (!enable)
+    cache.reset();
+  else if (!cache)
+    cache.reset(new DistanceCache());
+}
+
+DistanceCache* DistanceCache::getThreadCache()
+{
+  return threadDistanceCache().get();
+}
+
+std::size_t processCollisionBatch(const CollisionBatchRequest& req, std::size_t count,
+                                  std::vector<CollisionResult>& results,
+                                  const std::function<void(std::size_t, CollisionResult&)>& check)
+{
+  return processCollisionBatch(req, count, results,
+                               [&check](std::size_t i, CollisionResult& res, std::size_t) { check(i, res); });
+}
+
+std::size_t processCollisionBatch(const CollisionBatchRequest& req, std::size_t count,
+                                  std::vector<CollisionResult>& results,
+                                  const std::function<void(std::size_t, CollisionResult&, std::size_t)>& check)
+{
+  results.resize(count);
+  for (CollisionResult& res : results)
+    res.clear();
+
+  std::atomic<std::size_t> next(0);
+  std::atomic<std::size_t> next_worker(0);
+  std::atomic<std::size_t> first_collision(count);
+  auto worker = [&]() {
+    const std::size_t worker_index = next_worker++;
+    for (std::size_t i = next++; i < count; i = next++)
+    {
+      // indices are handed out in order, so all states before a colliding one are taken already
+      if (req.stop_at_first_collision && i > first_collision.load())
+        break;
+      check(i, results[i], worker_index);
+      if (results[i].collision)
+      {
+        std::size_t current = first_collision.load();
+        while (i < current && !first_collision.compare_exchange_weak(current, i))
+          ;
+      }
+    }
+  };
+
+  std::size_t num_threads = std::min<std::size_t>(std::max(req.num_threads, 1u), count);
+  if (num_threads > 1)
+    BatchThreadPool::instance().run(num_threads - 1, worker);
+  else
+    worker();
+
+  // states after the first collision may or may not have been checked, so only the checked range is returned
+  if (req.stop_at_first_collision && first_collision.load() < count)
+    results.resize(first_collision.load() + 1);
+
+  return first_collision.load();
+}
+
+}  // end of namespace collision_detection
@@ -36,7 +36,11 @@
 
 #include <moveit/collision_detection/collision_matrix.h>
 #include <boost/bind.hpp>
+#include <atomic>
+#include <deque>
 #include <iomanip>
+#include <mutex>
+#include <unordered_map>
 #include "rclcpp/rclcpp.hpp"
 
 namespace collision_detection
@@ -91,6 +95,7 @@ AllowedCollisionMatrix::AllowedCollisionMatrix(const AllowedCollisionMatrix& acm
   allowed_contacts_ = acm.allowed_contacts_;
   default_entries_ = acm.default_entries_;
   default_allowed_contacts_ = acm.default_allowed_contacts_;
+  compiled_ = std::atomic_load(&acm.compiled_);
 }
 
 bool AllowedCollisionMatrix::getEntry(const std::string& name1, const std::string& name2, DecideContactFn& fn) const
@@ -134,6 +139,7 @@ bool AllowedCollisionMatrix::hasEntry(const std::string& name1, const std::strin
 
 void AllowedCollisionMatrix::setEntry(const std::string& name1, const std::string& name2, bool allowed)
 {
+  compiled_.reset();
   const AllowedCollision::Type v = allowed ? AllowedCollision::ALWAYS : AllowedCollision::NEVER;
   entries_[name1][name2] = entries_[name2][name1] = v;
 
@@ -156,12 +162,14 @@ void AllowedCollisionMatrix::setEntry(const std::string& name1, const std::strin
 
 void AllowedCollisionMatrix::setEntry(const std::string& name1, const std::string& name2, DecideContactFn& fn)
 {
+  compiled_.reset();
   entries_[name1][name2] = entries_[name2][name1] = AllowedCollision::CONDITIONAL;
   allowed_contacts_[name1][name2] = allowed_contacts_[name2][name1] = fn;
 }
 
 void AllowedCollisionMatrix::removeEntry(const std::string& name)
 {
+  compiled_.reset();
   entries_.erase(name);
   allowed_contacts_.erase(name);
   for (auto& entry : entries_)
@@ -172,6 +180,7 @@ void AllowedCollisionMatrix::removeEntry(const std::string& name)
 
 void AllowedCollisionMatrix::removeEntry(const std::string& name1, const std::string& name2)
 {
+  compiled_.reset();
   auto jt = entries_.find(name1);
   if (jt != entries_.end())
   {
@@ -231,6 +240,7 @@ void AllowedCollisionMatrix::setEntry(const std::string& name, bool allowed)
 
 void AllowedCollisionMatrix::setEntry(bool allowed)
 {
+  compiled_.reset();
   const AllowedCollision::Type v = allowed ? AllowedCollision::ALWAYS : AllowedCollision::NEVER;
   for (auto& entry : entries_)
     for (auto& it2 : entry.second)
@@ -239,6 +249,7 @@ void AllowedCollisionMatrix::setEntry(bool allowed)
 
 void AllowedCollisionMatrix::setDefaultEntry(const std::string& name, bool allowed)
 {
+  compiled_.reset();
   const AllowedCollision::Type v = allowed ? AllowedCollision::ALWAYS : AllowedCollision::NEVER;
   default_entries_[name] = v;
   default_allowed_contacts_.erase(name);
@@ -246,6 +257,7 @@ void AllowedCollisionMatrix::setDefaultEntry(const std::string& name, bool allow
 
 void AllowedCollisionMatrix::setDefaultEntry(const std::string& name, DecideContactFn& fn)
 {
+  compiled_.reset();
   default_entries_[name] = AllowedCollision::CONDITIONAL;
   default_allowed_contacts_[name] = fn;
 }
@@ -326,8 +338,21 @@ bool AllowedCollisionMatrix::getAllowedCollision(const std::string& name1, const
   }
 }
 
+CompiledAllowedCollisionMatrixConstPtr AllowedCollisionMatrix::getCompiled() const
+{
+  // concurrent callers may compile twice, but always get a complete instance
+  CompiledAllowedCollisionMatrixConstPtr compiled = std::atomic_load(&compiled_);
+  if (!compiled)
+  {
+    compiled = std::make_shared<const CompiledAllowedCollisionMatrix>(*this);
+    std::atomic_store(&compiled_, compiled);
+  }
+  return compiled;
+}
+
 void AllowedCollisionMatrix::clear()
 {
+  compiled_.reset();
   entries_.clear();
   allowed_contacts_.clear();
   default_entries_.clear();
@@ -430,4 +455,160 @@ void AllowedCollisionMatrix::print(std::ostream& out) const
   }
 }
 
+struct CompiledAllowedCollisionMatrix::NameID::Entry
+{
+  std::string name;
+  int id;
+  std::atomic<std::size_t> refs;
+};
+
+struct CompiledAllowedCollisionMatrix::NameID::Registry
+{
+  std::mutex lock;
+  std::unordered_map<std::string, Entry*> entries;
+
+  /// All entries ever created, indexed by ID; a deque keeps their addresses stable
+  std::deque<Entry> storage;
+
+  /// Entries of names that are no longer referenced, whose IDs can be reused
+  std::vector<Entry*> unused;
+};
+
+CompiledAllowedCollisionMatrix::NameID::Registry& CompiledAllowedCollisionMatrix::NameID::getRegistry()
+{
+  // never destroyed, so references held by static objects can still be released at exit
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+CompiledAllowedCollisionMatrix::NameID::NameID(const std::string& name) : entry_(acquire(name)), id_(entry_->id)
+{
+}
+
+CompiledAllowedCollisionMatrix::NameID::NameID(const NameID& other) : entry_(other.entry_), id_(other.id_)
+{
+  if (entry_)
+    ++entry_->refs;
+}
+
+CompiledAllowedCollisionMatrix::NameID& CompiledAllowedCollisionMatrix::NameID::operator=(const NameID& other)
+{
+  if (other.entry_)
+    ++other.entry_->refs;
+  if (entry_)
+    release(entry_);
+  entry_ = other.entry_;
+  id_ = other.id_;
+  return *this;
+}
+
+CompiledAllowedCollisionMatrix::NameID::~NameID()
+{
+  if (entry_)
+    release(entry_);
+}
+
+CompiledAllowedCollisionMatrix::NameID::Entry* CompiledAllowedCollisionMatrix::NameID::acquire(const std::string& name)
+{
+  Registry& registry = getRegistry();
+  std::lock_guard<std::mutex> slock(registry.lock);
+  Entry*& entry = registry.entries[name];
+  if (entry)
+  {
+    ++entry->refs;
+    return entry;
+  }
+  if (registry.unused.empty())
+  {
+    registry.storage.emplace_back();
+    entry = &registry.storage.back();
+    entry->id = static_cast<int>(registry.storage.size() - 1);
+  }
+  else
+  {
+    entry = registry.unused.back();
+    registry.unused.pop_back();
+  }
+  entry->name = name;
+  entry->refs = 1;
+  return entry;
+}
+
+void CompiledAllowedCollisionMatrix::NameID::release(Entry* entry)
+{
+  if (--entry->refs > 0)
+    return;
+  Registry& registry = getRegistry();
+  std::lock_guard<std::mutex> slock(registry.lock);
+  // the name may have been acquired again, or already been released by another thread, before the lock was taken
+  auto it = registry.entries.find(entry->name);
+  if (entry->refs == 0 && it != registry.entries.end() && it->second == entry)
+  {
+    registry.entries.erase(it);
+    registry.unused.push_back(entry);
+  }
+}
+
+CompiledAllowedCollisionMatrix::CompiledAllowedCollisionMatrix(const AllowedCollisionMatrix& acm)
+{
+  std::map<std::string, std::size_t> row_of_name;
+  for (const auto& entry : acm.entries_)
+    row_of_name.insert(std::make_pair(entry.first, 0));
+  for (const auto& entry : acm.default_entries_)
+    row_of_name.insert(std::make_pair(entry.first, 0));
+  size_ = row_of_name.size();
+
+  std::size_t row = 0;
+  name_ids_.reserve(size_);
+  for (auto& name_row : row_of_name)
+  {
+    name_row.second = row++;
+    name_ids_.push_back(NameID(name_row.first));
+    std::size_t id = name_ids_.back().get();
+    if (id >= rows_.size())
+      rows_.resize(id + 1, size_);
+    rows_[id] = name_row.second;
+  }
+
+  // the last row and column stand for all names unknown to the matrix
+  const std::size_t n = size_ + 1;
+  found_.resize(n * n, false);
+  allowed_.resize(n * n, false);
+  conditional_.resize(n * n, false);
+  auto set = [this](std::size_t k, AllowedCollision::Type type) {
+    found_[k] = true;
+    allowed_[k] = type == AllowedCollision::ALWAYS;
+    conditional_[k] = type == AllowedCollision::CONDITIONAL;
+  };
+
+  for (const auto& entry : acm.entries_)
+  {
+    std::size_t i = row_of_name[entry.first];
+    for (const auto& pair_entry : entry.second)
+      set(i * n + row_of_name[pair_entry.first], pair_entry.second);
+  }
+
+  // default values take precedence, as in AllowedCollisionMatrix::getAllowedCollision()
+  std::vector<const AllowedCollision::Type*> defaults(n, nullptr);
+  for (const auto& entry : acm.default_entries_)
+    defaults[row_of_name[entry.first]] = &entry.second;
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+    {
+      const AllowedCollision::Type* t1 = defaults[i];
+      const AllowedCollision::Type* t2 = defaults[j];
+      if (t1 && t2)
+      {
+        if (*t1 == AllowedCollision::NEVER || *t2 == AllowedCollision::NEVER)
+          set(i * n + j, AllowedCollision::NEVER);
+        else if (*t1 == AllowedCollision::CONDITIONAL || *t2 == AllowedCollision::CONDITIONAL)
+          set(i * n + j, AllowedCollision::CONDITIONAL);
+        else
+          set(i * n + j, AllowedCollision::ALWAYS);
+      }
+      else if (t1 || t2)
+        set(i * n + j, t1 ? *t1 : *t2);
+    }
+}
+
 }  // end of namespace collision_detection
@@ -257,6 +257,23 @@ void CollisionRobot::getScale(std::vector<moveit_msgs::msg::LinkScale>& scale) c
   }
 }
 
+void CollisionRobot::checkSelfCollisionBatch(const CollisionBatchRequest& req,
+                                             const std::vector<const robot_state::RobotState*>& states,
+                                             std::vector<CollisionResult>& results) const
+{
+  processCollisionBatch(req, states.size(), results,
+                        [&](std::size_t i, CollisionResult& res) { checkSelfCollision(req, res, *states[i]); });
+}
+
+void CollisionRobot::checkSelfCollisionBatch(const CollisionBatchRequest& req,
+                                             const std::vector<const robot_state::RobotState*>& states,
+                                             std::vector<CollisionResult>& results,
+                                             const AllowedCollisionMatrix& acm) const
+{
+  processCollisionBatch(req, states.size(), results,
+                        [&](std::size_t i, CollisionResult& res) { checkSelfCollision(req, res, *states[i], acm); });
+}
+
 void CollisionRobot::updatedPaddingOrScaling(const std::vector<std::string>& links)
 {
 }
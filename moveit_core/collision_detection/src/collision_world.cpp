@@ -84,6 +84,24 @@ void CollisionWorld::checkCollision(const CollisionRequest& req, CollisionResult
     checkRobotCollision(req, res, robot, state1, state2, acm);
 }
 
+void CollisionWorld::checkCollisionBatch(const CollisionBatchRequest& req, const CollisionRobot& robot,
+                                         const std::vector<const robot_state::RobotState*>& states,
+                                         std::vector<CollisionResult>& results) const
+{
+  processCollisionBatch(req, states.size(), results, [&](std::size_t i, CollisionResult& res) {
+    checkCollision(req, res, robot, *states[i]);
+  });
+}
+
+void CollisionWorld::checkCollisionBatch(const CollisionBatchRequest& req, const CollisionRobot& robot,
+                                         const std::vector<const robot_state::RobotState*>& states,
+                                         std::vector<CollisionResult>& results, const AllowedCollisionMatrix& acm) const
+{
+  processCollisionBatch(req, states.size(), results, [&](std::size_t i, CollisionResult& res) {
+    checkCollision(req, res, robot, *states[i], acm);
+  });
+}
+
 void CollisionWorld::setWorld(const WorldPtr& world)
 {
   world_ = world;
@@ -35,6 +35,11 @@
 /* Author: Acorn Pooley, Ioan Sucan */
 
 #include <moveit/collision_detection/world.h>
+#include <moveit/robot_model/aabb.h>
+#include <geometric_shapes/shapes.h>
+#include <geometric_shapes/shape_operations.h>
+#include <octomap/octomap.h>
+#include <algorithm>
 #include "rclcpp/rclcpp.hpp"
 
 namespace collision_detection
@@ -42,13 +47,20 @@ namespace collision_detection
 // Logger
 rclcpp::Logger LOGGER_WORLD = rclcpp::get_logger("moveit").get_child("collision_detection");
 
-World::World()
+World::World() : transaction_depth_(0)
 {
 }
 
-World::World(const World& other)
+const double World::UNBOUNDED_EXTENT = 1e100;
+
+World::World(const World& other) : transaction_depth_(0)
 {
   objects_ = other.objects_;
+  if (other.spatial_index_)
+  {
+    spatial_index_.reset(new AABBTree(*other.spatial_index_));
+    spatial_index_leaves_ = other.spatial_index_leaves_;
+  }
 }
 
 World::~World()
@@ -246,7 +258,75 @@ void World::notifyAll(Action action)
     notify(it->second, action);
 }
 
+void World::beginTransaction()
+{
+  ++transaction_depth_;
+}
+
+void World::commitTransaction()
+{
+  if (transaction_depth_ == 0)
+  {
+    RCLCPP_ERROR(LOGGER_WORLD, "commitTransaction() called without matching beginTransaction()");
+    return;
+  }
+  if (--transaction_depth_ > 0)
+    return;
+
+  std::vector<PendingChange> changes;
+  changes.swap(pending_changes_);
+  pending_index_.clear();
+
+  for (const PendingChange& change : changes)
+  {
+    if (change.destroyed_)
+      notifyObservers(change.destroyed_, DESTROY);
+
+    auto it = objects_.find(change.id_);
+    if (it == objects_.end())
+      continue;
+    // objects unknown to the observers are reported as new ones, no matter what happened to them in between
+    int action = change.existed_ && !change.destroyed_ ? change.action_ : int(CREATE | ADD_SHAPE);
+    if (action != UNINITIALIZED)
+      notifyObservers(it->second, Action(action));
+  }
+}
+
+void World::recordChange(const ObjectConstPtr& obj, Action action)
+{
+  auto index = pending_index_.find(obj->id_);
+  if (index == pending_index_.end())
+  {
+    PendingChange change;
+    change.id_ = obj->id_;
+    change.existed_ = !(action & CREATE);
+    change.action_ = UNINITIALIZED;
+    index = pending_index_.insert(std::make_pair(obj->id_, pending_changes_.size())).first;
+    pending_changes_.push_back(change);
+  }
+
+  PendingChange& change = pending_changes_[index->second];
+  if (action & DESTROY)
+  {
+    // only the first destruction matters: later incarnations of the object were never seen by observers
+    if (change.existed_ && !change.destroyed_)
+      change.destroyed_ = obj;
+    change.action_ = UNINITIALIZED;
+  }
+  else
+    change.action_ |= action;
+}
+
 void World::notify(const ObjectConstPtr& obj, Action action)
+{
+  updateSpatialIndex(obj, action);
+  if (transaction_depth_ > 0)
+    recordChange(obj, action);
+  else
+    notifyObservers(obj, action);
+}
+
+void World::notifyObservers(const ObjectConstPtr& obj, Action action)
 {
   for (std::vector<Observer*>::const_iterator obs = observers_.begin(); obs != observers_.end(); ++obs)
     (*obs)->callback_(obj, action);
@@ -266,4 +346,190 @@ void World::notifyObserverAllObjects(const ObserverHandle observer_handle, Actio
   }
 }
 
+namespace
+{
+// Compute the distance along the ray at which it enters the box, if it does so within [0, max_distance]
+bool intersectRay(const Eigen::AlignedBox3d& box, const Eigen::Vector3d& origin, const Eigen::Vector3d& direction,
+                  double max_distance, double& distance)
+{
+  double t_min = 0.0;
+  double t_max = max_distance;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (direction[i] == 0.0)
+    {
+      if (origin[i] < box.min()[i] || origin[i] > box.max()[i])
+        return false;
+      continue;
+    }
+    double t1 = (box.min()[i] - origin[i]) / direction[i];
+    double t2 = (box.max()[i] - origin[i]) / direction[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    t_min = std::max(t_min, t1);
+    t_max = std::min(t_max, t2);
+    if (t_min > t_max)
+      return false;
+  }
+  distance = t_min;
+  return true;
+}
+}  // namespace
+
+Eigen::AlignedBox3d World::computeObjectAABB(const Object& obj)
+{
+  moveit::core::AABB aabb;
+  for (std::size_t i = 0; i < obj.shapes_.size(); ++i)
+  {
+    const shapes::Shape* shape = obj.shapes_[i].get();
+    const Eigen::Isometry3d& pose = obj.shape_poses_[i];
+    switch (shape->type)
+    {
+      case shapes::PLANE:
+        aabb.extend(Eigen::Vector3d::Constant(UNBOUNDED_EXTENT));
+        aabb.extend(Eigen::Vector3d::Constant(-UNBOUNDED_EXTENT));
+        break;
+      case shapes::MESH:
+      {
+        // computeShapeExtents() does not account for the offset of the mesh origin
+        const shapes::Mesh* mesh = static_cast<const shapes::Mesh*>(shape);
+        for (unsigned int j = 0; j < mesh->vertex_count; ++j)
+          aabb.extend(pose * Eigen::Map<const Eigen::Vector3d>(mesh->vertices + 3 * j));
+        break;
+      }
+      case shapes::OCTREE:
+      {
+        const octomap::OcTree& tree = *static_cast<const shapes::OcTree*>(shape)->octree;
+        if (tree.size() == 0)
+          break;
+        Eigen::Vector3d min, max;
+        tree.getMetricMin(min.x(), min.y(), min.z());
+        tree.getMetricMax(max.x(), max.y(), max.z());
+        aabb.extendWithTransformedBox(pose * Eigen::Translation3d(0.5 * (min + max)), max - min);
+        break;
+      }
+      default:
+        aabb.extendWithTransformedBox(pose, shapes::computeShapeExtents(shape));
+    }
+  }
+  // keep objects without volume (e.g. empty octrees) in the index at their origin
+  if (aabb.isEmpty() && !obj.shape_poses_.empty())
+    aabb.extend(obj.shape_poses_[0].translation());
+  return aabb;
+}
+
+void World::setSpatialIndexEnabled(bool enable)
+{
+  spatial_index_leaves_.clear();
+  if (!enable)
+  {
+    spatial_index_.reset();
+    return;
+  }
+
+  spatial_index_.reset(new AABBTree());
+  for (const auto& object : objects_)
+    spatial_index_leaves_[object.first] = spatial_index_->insert(object.first, computeObjectAABB(*object.second));
+}
+
+void World::updateSpatialIndex(const ObjectConstPtr& obj, Action action)
+{
+  if (!spatial_index_)
+    return;
+
+  auto leaf = spatial_index_leaves_.find(obj->id_);
+  if (action & DESTROY)
+  {
+    if (leaf != spatial_index_leaves_.end())
+    {
+      spatial_index_->remove(leaf->second);
+      spatial_index_leaves_.erase(leaf);
+    }
+  }
+  else if (leaf == spatial_index_leaves_.end())
+    spatial_index_leaves_[obj->id_] = spatial_index_->insert(obj->id_, computeObjectAABB(*obj));
+  else
+    spatial_index_->update(leaf->second, computeObjectAABB(*obj));
+}
+
+Eigen::AlignedBox3d World::getObjectAABB(const std::string& id) const
+{
+  if (spatial_index_)
+  {
+    auto leaf = spatial_index_leaves_.find(id);
+    if (leaf != spatial_index_leaves_.end())
+      return spatial_index_->getBox(leaf->second);
+  }
+  else
+  {
+    auto it = objects_.find(id);
+    if (it != objects_.end())
+      return computeObjectAABB(*it->second);
+  }
+  return Eigen::AlignedBox3d();
+}
+
+template <typename Overlaps, typename Visit>
+void World::queryObjects(const Overlaps& overlaps, const Visit& visit) const
+{
+  if (spatial_index_)
+  {
+    spatial_index_->query(overlaps, visit);
+    return;
+  }
+
+  for (const auto& object : objects_)
+  {
+    Eigen::AlignedBox3d box = computeObjectAABB(*object.second);
+    if (overlaps(box))
+      visit(object.first, box);
+  }
+}
+
+std::vector<std::string> World::getObjectsInBox(const Eigen::AlignedBox3d& box) const
+{
+  std::vector<std::string> ids;
+  queryObjects([&box](const Eigen::AlignedBox3d& other) { return box.intersects(other); },
+               [&ids](const std::string& id, const Eigen::AlignedBox3d&) { ids.push_back(id); });
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+std::vector<std::string> World::getObjectsInSphere(const Eigen::Vector3d& center, double radius) const
+{
+  std::vector<std::string> ids;
+  if (radius < 0.0)
+    return ids;
+  const double squared_radius = radius * radius;
+  queryObjects(
+      [&](const Eigen::AlignedBox3d& box) { return box.squaredExteriorDistance(center) <= squared_radius; },
+      [&ids](const std::string& id, const Eigen::AlignedBox3d&) { ids.push_back(id); });
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+std::vector<std::string> World::getObjectsAlongRay(const Eigen::Vector3d& origin, const Eigen::Vector3d& direction,
+                                                   double max_distance, std::vector<double>* distances) const
+{
+  std::vector<std::pair<double, std::string>> hits;
+  // set by the overlap test of each leaf right before it is visited
+  double distance;
+  queryObjects(
+      [&](const Eigen::AlignedBox3d& box) { return intersectRay(box, origin, direction, max_distance, distance); },
+      [&](const std::string& id, const Eigen::AlignedBox3d&) { hits.push_back(std::make_pair(distance, id)); });
+  std::sort(hits.begin(), hits.end());
+
+  std::vector<std::string> ids;
+  ids.reserve(hits.size());
+  if (distances)
+    distances->clear();
+  for (const auto& hit : hits)
+  {
+    ids.push_back(hit.second);
+    if (distances)
+      distances->push_back(hit.first);
+  }
+  return ids;
+}
+
 }  // end of namespace collision_detection
@@ -0,0 +1,125 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <gtest/gtest.h>
+#include <moveit/collision_detection/collision_common.h>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+TEST(CollisionBatch, ChecksAllStates)
+{
+  collision_detection::CollisionBatchRequest req;
+  std::vector<collision_detection::CollisionResult> results;
+  for (unsigned int num_threads : { 1, 4 })
+  {
+    req.num_threads = num_threads;
+    std::size_t first = collision_detection::processCollisionBatch(
+        req, 100, results, [](std::size_t i, collision_detection::CollisionResult& res) { res.collision = i % 7 == 3; });
+    EXPECT_EQ(first, 3u);
+    ASSERT_EQ(results.size(), 100u);
+    for (std::size_t i = 0; i < results.size(); ++i)
+      EXPECT_EQ(results[i].collision, i % 7 == 3);
+  }
+}
+
+TEST(CollisionBatch, StopAtFirstCollision)
+{
+  collision_detection::CollisionBatchRequest req;
+  req.stop_at_first_collision = true;
+  std::vector<collision_detection::CollisionResult> results;
+  for (unsigned int num_threads : { 1, 4 })
+  {
+    // the results end with the first colliding state, all states before it are checked
+    req.num_threads = num_threads;
+    std::size_t first = collision_detection::processCollisionBatch(
+        req, 100, results, [](std::size_t i, collision_detection::CollisionResult& res) { res.collision = i >= 42; });
+    EXPECT_EQ(first, 42u);
+    ASSERT_EQ(results.size(), 43u);
+    for (std::size_t i = 0; i < results.size(); ++i)
+      EXPECT_EQ(results[i].collision, i == 42);
+
+    // without a collision, all states are checked
+    first = collision_detection::processCollisionBatch(
+        req, 100, results, [](std::size_t, collision_detection::CollisionResult& res) { res.collision = false; });
+    EXPECT_EQ(first, 100u);
+    EXPECT_EQ(results.size(), 100u);
+  }
+}
+
+TEST(CollisionBatch, ReusesWorkerThreads)
+{
+  collision_detection::CollisionBatchRequest req;
+  req.num_threads = 4;
+  std::vector<collision_detection::CollisionResult> results;
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  auto check = [&](std::size_t, collision_detection::CollisionResult&) {
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  };
+
+  // the threads of later batches are the ones of the first batch, so their thread local caches are kept
+  collision_detection::processCollisionBatch(req, 200, results, check);
+  const std::set<std::thread::id> first_threads = threads;
+  EXPECT_GT(first_threads.size(), 1u);
+  for (int batch = 0; batch < 5; ++batch)
+    collision_detection::processCollisionBatch(req, 200, results, check);
+  EXPECT_EQ(threads, first_threads);
+}
+
+TEST(CollisionBatch, NestedBatch)
+{
+  // a batch started from a worker thread runs in that thread instead of waiting for the busy workers
+  collision_detection::CollisionBatchRequest req;
+  req.num_threads = 4;
+  std::vector<collision_detection::CollisionResult> results;
+  collision_detection::processCollisionBatch(req, 16, results, [&req](std::size_t, collision_detection::CollisionResult& res) {
+    std::vector<collision_detection::CollisionResult> nested_results;
+    collision_detection::processCollisionBatch(
+        req, 16, nested_results, [](std::size_t, collision_detection::CollisionResult& res) { res.collision = true; });
+    res.collision = nested_results.size() == 16;
+  });
+  ASSERT_EQ(results.size(), 16u);
+  for (const collision_detection::CollisionResult& res : results)
+    EXPECT_TRUE(res.collision);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+
+#include <gtest/gtest.h>
+#include <moveit/collision_detection/collision_matrix.h>
+
+using collision_detection::AllowedCollision::Type;
+using NameID = collision_detection::CompiledAllowedCollisionMatrix::NameID;
+
+namespace
+{
+void expectCompiledMatches(const collision_detection::AllowedCollisionMatrix& acm, const std::vector<std::string>& names)
+{
+  collision_detection::CompiledAllowedCollisionMatrixConstPtr compiled = acm.getCompiled();
+  for (const std::string& name1 : names)
+    for (const std::string& name2 : names)
+    {
+      Type type, compiled_type;
+      bool found = acm.getAllowedCollision(name1, name2, type);
+      bool compiled_found =
+          compiled->getAllowedCollision(NameID(name1), NameID(name2), compiled_type);
+      EXPECT_EQ(found, compiled_found) << name1 << " " << name2;
+      if (found && compiled_found)
+        EXPECT_EQ(type, compiled_type) << name1 << " " << name2;
+    }
+}
+}  // namespace
+
+TEST(AllowedCollisionMatrix, CompiledMatchesEntries)
+{
+  std::vector<std::string> names = { "link_a", "link_b", "link_c", "object" };
+  collision_detection::AllowedCollisionMatrix acm(names, false);
+  acm.setEntry("link_a", "link_b", true);
+  collision_detection::DecideContactFn fn = [](collision_detection::Contact&) { return true; };
+  acm.setEntry("link_b", "link_c", fn);
+
+  // a name unknown to the matrix
+  names.push_back("unknown");
+  expectCompiledMatches(acm, names);
+
+  // default entries take precedence, also for names unknown to the matrix
+  acm.setDefaultEntry("object", true);
+  acm.setDefaultEntry("link_only_default", false);
+  names.push_back("link_only_default");
+  expectCompiledMatches(acm, names);
+
+  acm.removeEntry("link_a");
+  expectCompiledMatches(acm, names);
+}
+
+TEST(AllowedCollisionMatrix, CompiledIsRebuiltOnChange)
+{
+  collision_detection::AllowedCollisionMatrix acm;
+  acm.setEntry("link_a", "link_b", false);
+  collision_detection::CompiledAllowedCollisionMatrixConstPtr compiled = acm.getCompiled();
+  EXPECT_EQ(compiled, acm.getCompiled());
+
+  NameID id_a("link_a");
+  NameID id_b("link_b");
+  EXPECT_EQ(id_a.get(), NameID("link_a").get());
+  EXPECT_NE(id_a.get(), id_b.get());
+
+  acm.setEntry("link_a", "link_b", true);
+  Type type;
+  ASSERT_TRUE(acm.getCompiled()->getAllowedCollision(id_a, id_b, type));
+  EXPECT_EQ(type, collision_detection::AllowedCollision::ALWAYS);
+
+  // the previously compiled form is not affected by the change
+  ASSERT_TRUE(compiled->getAllowedCollision(id_a, id_b, type));
+  EXPECT_EQ(type, collision_detection::AllowedCollision::NEVER);
+
+  acm.clear();
+  EXPECT_FALSE(acm.getCompiled()->getAllowedCollision(id_a, id_b, type));
+}
+
+TEST(AllowedCollisionMatrix, NameIDsAreReused)
+{
+  int id;
+  {
+    NameID transient("transient_object_1");
+    NameID copy = transient;
+    id = copy.get();
+    EXPECT_EQ(id, transient.get());
+  }
+  // the ID is free again once no reference is left
+  EXPECT_EQ(id, NameID("transient_object_2").get());
+
+  // the compiled form keeps the IDs of its names, so names checked later are still found
+  collision_detection::AllowedCollisionMatrix acm;
+  acm.setEntry("transient_object_3", "transient_object_4", true);
+  collision_detection::CompiledAllowedCollisionMatrixConstPtr compiled = acm.getCompiled();
+  NameID other("transient_object_5");
+  Type type;
+  ASSERT_TRUE(compiled->getAllowedCollision(NameID("transient_object_3"), NameID("transient_object_4"), type));
+  EXPECT_EQ(type, collision_detection::AllowedCollision::ALWAYS);
+  EXPECT_FALSE(compiled->getAllowedCollision(other, NameID("transient_object_4"), type));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -38,6 +38,7 @@
 #include <moveit/collision_detection/world.h>
 #include <geometric_shapes/shapes.h>
 #include <boost/bind.hpp>
+#include <random>
 
 TEST(World, AddRemoveShape)
 {
@@ -365,6 +366,192 @@ TEST(World, TrackChanges)
   EXPECT_EQ(4, ta3.cnt_);
 }
 
+static void RecordChangesNotify(std::vector<std::pair<std::string, int>>* changes,
+                                const collision_detection::World::ObjectConstPtr& obj,
+                                collision_detection::World::Action action)
+{
+  changes->push_back(std::make_pair(obj->id_, int(action)));
+}
+
+TEST(World, TransactionCoalescesChanges)
+{
+  collision_detection::World world;
+
+  std::vector<std::pair<std::string, int>> changes;
+  world.addObserver(boost::bind(RecordChangesNotify, &changes, _1, _2));
+
+  shapes::ShapePtr ball(new shapes::Sphere(1.0));
+  shapes::ShapePtr box(new shapes::Box(1, 2, 3));
+  shapes::ShapePtr cyl(new shapes::Cylinder(4, 5));
+
+  world.addToObject("moved", ball, Eigen::Isometry3d::Identity());
+  world.addToObject("replaced", box, Eigen::Isometry3d::Identity());
+  world.addToObject("removed", cyl, Eigen::Isometry3d::Identity());
+  world.addToObject("grown", ball, Eigen::Isometry3d::Identity());
+  changes.clear();
+
+  {
+    collision_detection::World::Transaction transaction(world);
+    world.moveShapeInObject("moved", ball, Eigen::Isometry3d(Eigen::Translation3d(0, 0, 1)));
+    world.moveObject("moved", Eigen::Isometry3d(Eigen::Translation3d(0, 1, 0)));
+    world.removeObject("replaced");
+    world.addToObject("replaced", cyl, Eigen::Isometry3d::Identity());
+    world.moveShapeInObject("removed", cyl, Eigen::Isometry3d(Eigen::Translation3d(1, 0, 0)));
+    world.removeObject("removed");
+    world.addToObject("created", box, Eigen::Isometry3d::Identity());
+    world.moveShapeInObject("created", box, Eigen::Isometry3d(Eigen::Translation3d(1, 0, 0)));
+    world.addToObject("transient", box, Eigen::Isometry3d::Identity());
+    world.removeObject("transient");
+    world.addToObject("grown", box, Eigen::Isometry3d::Identity());
+    world.moveShapeInObject("grown", ball, Eigen::Isometry3d(Eigen::Translation3d(1, 0, 0)));
+
+    // nested transactions only notify when the outermost one is committed
+    world.beginTransaction();
+    world.moveObject("moved", Eigen::Isometry3d(Eigen::Translation3d(0, 1, 0)));
+    world.commitTransaction();
+
+    EXPECT_TRUE(world.inTransaction());
+    EXPECT_TRUE(changes.empty());
+  }
+  EXPECT_FALSE(world.inTransaction());
+
+  std::vector<std::pair<std::string, int>> expected = {
+    { "moved", collision_detection::World::MOVE_SHAPE },
+    { "replaced", collision_detection::World::DESTROY },
+    { "replaced", collision_detection::World::CREATE | collision_detection::World::ADD_SHAPE },
+    { "removed", collision_detection::World::DESTROY },
+    { "created", collision_detection::World::CREATE | collision_detection::World::ADD_SHAPE },
+    { "grown", collision_detection::World::ADD_SHAPE | collision_detection::World::MOVE_SHAPE },
+  };
+  EXPECT_EQ(expected, changes);
+
+  // the world itself is updated immediately
+  EXPECT_TRUE(world.hasObject("created"));
+  EXPECT_FALSE(world.hasObject("removed"));
+  EXPECT_FALSE(world.hasObject("transient"));
+  EXPECT_EQ(cyl, world.getObject("replaced")->shapes_[0]);
+  EXPECT_TRUE(world.getObject("moved")->shape_poses_[0].translation().isApprox(Eigen::Vector3d(0, 2, 1)));
+
+  // an empty transaction does not notify
+  changes.clear();
+  world.beginTransaction();
+  world.commitTransaction();
+  EXPECT_TRUE(changes.empty());
+}
+
+TEST(World, SpatialQueries)
+{
+  collision_detection::World world;
+  world.setSpatialIndexEnabled(true);
+  EXPECT_TRUE(world.isSpatialIndexEnabled());
+
+  shapes::ShapePtr ball(new shapes::Sphere(0.5));
+  shapes::ShapePtr box(new shapes::Box(1, 2, 4));
+  shapes::ShapePtr plane(new shapes::Plane(0, 0, 1, 0));
+  shapes::Mesh* mesh = new shapes::Mesh(3, 1);
+  const double vertices[9] = { 5, 0, 0, 6, 0, 0, 5, 1, 0 };
+  std::copy(vertices, vertices + 9, mesh->vertices);
+  mesh->triangles[0] = 0;
+  mesh->triangles[1] = 1;
+  mesh->triangles[2] = 2;
+
+  world.addToObject("ball", ball, Eigen::Isometry3d(Eigen::Translation3d(0, 0, 0)));
+  world.addToObject("box", box,
+                    Eigen::Translation3d(3, 0, 0) * Eigen::AngleAxisd(M_PI / 2, Eigen::Vector3d::UnitX()));
+  world.addToObject("mesh", shapes::ShapeConstPtr(mesh), Eigen::Isometry3d(Eigen::Translation3d(0, 0, 1)));
+
+  // the box is rotated around x, so its y and z extents are swapped
+  Eigen::AlignedBox3d aabb = world.getObjectAABB("box");
+  EXPECT_TRUE(aabb.min().isApprox(Eigen::Vector3d(2.5, -2, -1)));
+  EXPECT_TRUE(aabb.max().isApprox(Eigen::Vector3d(3.5, 2, 1)));
+  // meshes are bounded by their transformed vertices
+  aabb = world.getObjectAABB("mesh");
+  EXPECT_TRUE(aabb.min().isApprox(Eigen::Vector3d(5, 0, 1)));
+  EXPECT_TRUE(aabb.max().isApprox(Eigen::Vector3d(6, 1, 1)));
+  EXPECT_TRUE(world.getObjectAABB("missing").isEmpty());
+
+  typedef std::vector<std::string> Ids;
+  EXPECT_EQ(Ids({ "ball", "box" }), world.getObjectsInBox(Eigen::AlignedBox3d(Eigen::Vector3d(0, -1, -1),
+                                                                               Eigen::Vector3d(3, 1, 1))));
+  EXPECT_EQ(Ids({ "mesh" }), world.getObjectsInBox(Eigen::AlignedBox3d(Eigen::Vector3d(5.5, 0.5, 0),
+                                                                        Eigen::Vector3d(7, 2, 2))));
+  EXPECT_EQ(Ids({ "ball" }), world.getObjectsInSphere(Eigen::Vector3d(0, 0, 1), 0.6));
+  EXPECT_EQ(Ids({ "ball", "box" }), world.getObjectsInSphere(Eigen::Vector3d(1.5, 0, 0), 1.1));
+  EXPECT_TRUE(world.getObjectsInSphere(Eigen::Vector3d(0, 0, 10), 1).empty());
+
+  std::vector<double> distances;
+  EXPECT_EQ(Ids({ "ball", "box" }),
+            world.getObjectsAlongRay(Eigen::Vector3d(-2, 0, 0), Eigen::Vector3d(1, 0, 0), 10, &distances));
+  ASSERT_EQ(2u, distances.size());
+  EXPECT_NEAR(1.5, distances[0], 1e-9);
+  EXPECT_NEAR(4.5, distances[1], 1e-9);
+  EXPECT_EQ(Ids({ "ball" }), world.getObjectsAlongRay(Eigen::Vector3d(-2, 0, 0), Eigen::Vector3d(1, 0, 0), 3));
+
+  // the index follows changes to the objects
+  world.moveObject("ball", Eigen::Isometry3d(Eigen::Translation3d(0, 0, 10)));
+  EXPECT_EQ(Ids({ "ball" }), world.getObjectsInSphere(Eigen::Vector3d(0, 0, 10), 1));
+  world.removeObject("box");
+  EXPECT_TRUE(world.getObjectsInBox(Eigen::AlignedBox3d(Eigen::Vector3d(2, -1, -1), Eigen::Vector3d(4, 1, 1))).empty());
+  world.addToObject("plane", plane, Eigen::Isometry3d::Identity());
+  EXPECT_EQ(Ids({ "plane" }), world.getObjectsInSphere(Eigen::Vector3d(100, 100, 100), 1));
+
+  // copies inherit the index, queries without the index give the same results
+  collision_detection::World copy(world);
+  EXPECT_TRUE(copy.isSpatialIndexEnabled());
+  EXPECT_EQ(Ids({ "ball", "plane" }), copy.getObjectsInSphere(Eigen::Vector3d(0, 0, 10), 1));
+  copy.setSpatialIndexEnabled(false);
+  EXPECT_FALSE(copy.isSpatialIndexEnabled());
+  EXPECT_EQ(Ids({ "ball", "plane" }), copy.getObjectsInSphere(Eigen::Vector3d(0, 0, 10), 1));
+
+  world.clearObjects();
+  EXPECT_TRUE(world.getObjectsInSphere(Eigen::Vector3d(0, 0, 10), 1).empty());
+}
+
+TEST(World, SpatialIndexMatchesBruteForce)
+{
+  collision_detection::World indexed;
+  indexed.setSpatialIndexEnabled(true);
+  collision_detection::World plain;
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> position(-10.0, 10.0);
+  std::uniform_real_distribution<double> size(0.1, 2.0);
+  std::uniform_int_distribution<int> object(0, 199);
+  std::uniform_int_distribution<int> operation(0, 2);
+
+  std::vector<shapes::ShapeConstPtr> shapes(200);
+  for (int i = 0; i < 1000; ++i)
+  {
+    int index = object(gen);
+    std::string id = "object" + std::to_string(index);
+    Eigen::Isometry3d pose(Eigen::Translation3d(position(gen), position(gen), position(gen)));
+    int op = operation(gen);
+    if (!plain.hasObject(id) || op == 0)
+    {
+      shapes[index].reset(new shapes::Box(size(gen), size(gen), size(gen)));
+      indexed.addToObject(id, shapes[index], pose);
+      plain.addToObject(id, shapes[index], pose);
+    }
+    else if (op == 1)
+    {
+      indexed.moveShapeInObject(id, shapes[index], pose);
+      plain.moveShapeInObject(id, shapes[index], pose);
+    }
+    else
+    {
+      indexed.removeObject(id);
+      plain.removeObject(id);
+    }
+
+    Eigen::Vector3d center(position(gen), position(gen), position(gen));
+    double radius = 2.0 * size(gen);
+    ASSERT_EQ(plain.getObjectsInSphere(center, radius), indexed.getObjectsInSphere(center, radius));
+    Eigen::AlignedBox3d box(center, center + Eigen::Vector3d::Constant(radius));
+    ASSERT_EQ(plain.getObjectsInBox(box), indexed.getObjectsInBox(box));
+    ASSERT_EQ(plain.getObjectsAlongRay(center, -center), indexed.getObjectsAlongRay(center, -center));
+  }
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -52,28 +52,70 @@
 #include <fcl/distance.h>
 #endif
 
+#include <Eigen/Core>
+#include <map>
 #include <memory>
 #include <set>
+#include <unordered_map>
 
 
 namespace collision_detection
 {
+/** \brief Bounding volumes of a collision geometry in its local frame, used to reject pairs of geometries before the
+    narrowphase check */
+struct FCLGeometryBound
+{
+  FCLGeometryBound()
+    : sphere_center(Eigen::Vector3d::Zero())
+    , sphere_radius(-1.0)
+    , has_obb(false)
+    , obb_axes(Eigen::Matrix3d::Identity())
+    , obb_center(Eigen::Vector3d::Zero())
+    , obb_half_extents(Eigen::Vector3d::Zero())
+  {
+  }
+
+  /// The center of a bounding sphere
+  Eigen::Vector3d sphere_center;
+
+  /// The radius of the bounding sphere, negative for unbounded geometries (planes, octrees)
+  double sphere_radius;
+
+  /// True if the geometry has an oriented bounding box; spheres do not need one
+  bool has_obb;
+
+  /// The axes of the oriented bounding box (as columns), its center and its half extents along the axes
+  Eigen::Matrix3d obb_axes;
+  Eigen::Vector3d obb_center;
+  Eigen::Vector3d obb_half_extents;
+};
+
+/** \brief Compute the bounding volumes of \e shape */
+void computeGeometryBound(const shapes::Shape& shape, FCLGeometryBound& bound);
+
+/** \brief Check if the bounding volumes of two geometries at the given poses are disjoint, in which case the
+    geometries can not collide */
+bool boundsDisjoint(const FCLGeometryBound& b1, const Eigen::Matrix3d& rotation1, const Eigen::Vector3d& translation1,
+                    const FCLGeometryBound& b2, const Eigen::Matrix3d& rotation2, const Eigen::Vector3d& translation2);
+
 MOVEIT_STRUCT_FORWARD(CollisionGeometryData)
 
 struct CollisionGeometryData
 {
-  CollisionGeometryData(const robot_model::LinkModel* link, int index) : type(BodyTypes::ROBOT_LINK), shape_index(index)
+  CollisionGeometryData(const robot_model::LinkModel* link, int index)
+    : type(BodyTypes::ROBOT_LINK), shape_index(index), name_id(link->getName())
   {
     ptr.link = link;
   }
 
   CollisionGeometryData(const robot_state::AttachedBody* ab, int index)
-    : type(BodyTypes::ROBOT_ATTACHED), shape_index(index)
+    : type(BodyTypes::ROBOT_ATTACHED), shape_index(index), name_id(ab->getName())
   {
     ptr.ab = ab;
   }
 
-  CollisionGeometryData(const World::Object* obj, int index) : type(BodyTypes::WORLD_OBJECT), shape_index(index)
+  CollisionGeometryData(const World::Object* obj, int index)
+    : type(BodyTypes::WORLD_OBJECT), shape_index(index), name_id(obj->id_)
   {
     ptr.obj = obj;
   }
@@ -114,6 +156,13 @@ struct CollisionGeometryData
 
   BodyType type;
   int shape_index;
+
+  /** \brief The ID of getID() for lookups in a CompiledAllowedCollisionMatrix */
+  CompiledAllowedCollisionMatrix::NameID name_id;
+
+  /** \brief The bounding volumes of the geometry this data is attached to */
+  FCLGeometryBound bound;
+
   union
   {
     const robot_model::LinkModel* link;
@@ -130,7 +179,11 @@ struct CollisionData
   }
 
   CollisionData(const CollisionRequest* req, CollisionResult* res, const AllowedCollisionMatrix* acm)
-    : req_(req), active_components_only_(NULL), res_(res), acm_(acm), done_(false)
+    : req_(req)
+    , active_components_only_(NULL)
+    , res_(res)
+    , acm_(acm)
+    , done_(false)
   {
   }
 
@@ -155,27 +208,121 @@ struct CollisionData
   /// The user specified collision matrix (may be NULL)
   const AllowedCollisionMatrix* acm_;
 
+  /// Get the compiled form of \e acm_, used to look up pairs by CollisionGeometryData::name_id. It is only built
+  /// once a pair actually needs to be looked up, so checks that are filtered before never compile the matrix.
+  const CompiledAllowedCollisionMatrix& getCompiledACM()
+  {
+    if (!acm_compiled_)
+      acm_compiled_ = acm_->getCompiled();
+    return *acm_compiled_;
+  }
+
+  /// The compiled form of \e acm_, if already needed
+  CompiledAllowedCollisionMatrixConstPtr acm_compiled_;
+
   /// Flag indicating whether collision checking is complete
   bool done_;
 };
 
+/** \brief The data the FCL collision detector keeps in a DistanceCache.
+
+    For each pair of geometries it stores the distance computed at the poses of the last evaluation. As no point of a
+    geometry moves farther than its motion bound, the distance at new poses is at least the stored distance minus the
+    motion bounds of both geometries. Octrees are excluded, as their content changes without any motion. */
+struct FCLDistanceCacheData : public DistanceCache::Data
+{
+  FCLDistanceCacheData() : cleanup_size(4096)
+  {
+  }
+
+  struct PairBound
+  {
+    /// The geometries of the pair, ordered by address, to detect geometries that were freed and reallocated
+    std::weak_ptr<const fcl::CollisionGeometryd> geometry[2];
+    Eigen::Matrix3d rotation[2];
+    Eigen::Vector3d translation[2];
+    double distance;
+  };
+
+  struct PairHash
+  {
+    std::size_t operator()(const std::pair<const void*, const void*>& key) const
+    {
+      std::hash<const void*> h;
+      return h(key.first) ^ (h(key.second) * 31);
+    }
+  };
+
+  /** \brief Get the bound of the pair of objects, or nullptr if their distance can not be bounded */
+  PairBound* getPairBound(const fcl::CollisionObjectd* o1, const fcl::CollisionObjectd* o2);
+
+  /** \brief Get a lower bound on the current distance of the pair (negative if nothing is known) */
+  static double getLowerBound(const PairBound& bound, const fcl::CollisionObjectd* o1, const fcl::CollisionObjectd* o2);
+
+  /** \brief Store the distance of the pair at the current poses */
+  static void setDistance(PairBound& bound, const fcl::CollisionObjectd* o1, const fcl::CollisionObjectd* o2,
+                          double distance);
+
+  std::unordered_map<std::pair<const void*, const void*>, PairBound, PairHash> pairs;
+
+  /// The number of \e pairs at which entries of freed geometries are removed
+  std::size_t cleanup_size;
+
+  /// The closest pair of objects found by the last query on each set of objects (robot broadphase or world).
+  /// The pointers are only compared to the objects of later queries, never dereferenced.
+  std::map<const void*, std::pair<const fcl::CollisionObjectd*, const fcl::CollisionObjectd*> > witnesses;
+};
+
 struct DistanceData
 {
-  DistanceData(const DistanceRequest* req, DistanceResult* res) : req(req), res(res), done(false)
+  DistanceData(const DistanceRequest* req, DistanceResult* res)
+    : req(req)
+    , res(res)
+    , done(false)
+    , cache(nullptr)
+    , cache_context(nullptr)
   {
+    witness[0] = witness[1] = nullptr;
   }
   ~DistanceData()
   {
   }
 
+  /** \brief Use the distance cache of the request (if any) for a query on the objects identified by \e context.
+      Returns the closest pair of the previous query on \e context, if it is worth checking first. */
+  std::pair<const fcl::CollisionObjectd*, const fcl::CollisionObjectd*> enableCache(const void* context);
+
+  /** \brief Remember the closest pair of this query in the cache */
+  void updateCache();
+
   /// Distance query request information
   const DistanceRequest* req;
 
   /// Distance query results information
   DistanceResult* res;
 
+  /// Get the compiled form of the collision matrix of the request, built once a pair needs to be looked up
+  const CompiledAllowedCollisionMatrix& getCompiledACM()
+  {
+    if (!acm_compiled)
+      acm_compiled = req->acm->getCompiled();
+    return *acm_compiled;
+  }
+
+  /// The compiled form of the collision matrix of the request, if already needed
+  CompiledAllowedCollisionMatrixConstPtr acm_compiled;
+
   /// Indicates if distance query is finished.
   bool done;
+
+  /// The data of the distance cache used by this query (may be nullptr)
+  FCLDistanceCacheData* cache;
+
+  /// The set of objects this query is on, used as key for the closest pair in \e cache
+  const void* cache_context;
+
+  /// The closest pair found so far, only maintained if \e cache is set
+  const fcl::CollisionObjectd* witness[2];
 };
 
 MOVEIT_STRUCT_FORWARD(FCLGeometry)
@@ -210,7 +357,9 @@ struct FCLGeometry
     if (!newType && collision_geometry_data_)
       if (collision_geometry_data_->ptr.raw == reinterpret_cast<const void*>(data))
         return;
+    FCLGeometryBound bound = collision_geometry_data_ ? collision_geometry_data_->bound : FCLGeometryBound();
     collision_geometry_data_.reset(new CollisionGeometryData(data, shape_index));
+    collision_geometry_data_->bound = bound;
     collision_geometry_->setUserData(collision_geometry_data_.get());
   }
 
@@ -237,10 +386,35 @@ struct FCLManager
   std::shared_ptr<fcl::BroadPhaseCollisionManagerd> manager_;
 };
 
+/** \brief The collision objects of a robot moving between two states, used for continuous collision checking.
+
+    The objects are placed at the start of the motion and the user data of each object points to its pose at the end
+    of the motion in \e end_transforms_. The AABB of each object encloses its swept volume, so broadphase managers
+    report every pair that may collide during the motion. */
+struct FCLContinuousObject
+{
+  FCLObject object_;
+  std::vector<fcl::Transform3d, Eigen::aligned_allocator<fcl::Transform3d>> end_transforms_;
+};
+
 bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data);
 
+/** \brief Broadphase callback for continuous checks: objects move linearly from their current transform to the one
+    stored in their user data (objects without user data do not move). \e data points to a CollisionData. */
+bool continuousCollisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data);
+
 bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data, double& min_dist);
 
+/** \brief Find \e object in \e objects, returning nullptr if it is not there */
+inline fcl::CollisionObjectd* findCollisionObject(const std::vector<FCLCollisionObjectPtr>& objects,
+                                                  const fcl::CollisionObjectd* object)
+{
+  for (const FCLCollisionObjectPtr& o : objects)
+    if (o.get() == object)
+      return o.get();
+  return nullptr;
+}
+
 FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape, const robot_model::LinkModel* link,
                                             int shape_index);
 FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape, const robot_state::AttachedBody* ab,
@@ -83,7 +83,21 @@ public:
 protected:
   void updatedPaddingOrScaling(const std::vector<std::string>& links) override;
   void constructFCLObject(const robot_state::RobotState& state, FCLObject& fcl_obj) const;
+  void constructAttachedBodyFCLObject(const robot_state::RobotState& state, FCLObject& fcl_obj) const;
+
+  /** \brief Construct the collision objects of the robot moving from \e state1 to \e state2. Attached bodies are
+      taken from \e state1 and are expected to be attached in \e state2 as well. */
+  void constructFCLObject(const robot_state::RobotState& state1, const robot_state::RobotState& state2,
+                          FCLContinuousObject& fcl_obj) const;
   void allocSelfCollisionBroadPhase(const robot_state::RobotState& state, FCLManager& manager) const;
+
+  /** \brief Get the broadphase manager the calling thread keeps for this robot, updated to \e state.
+
+      The manager holds the objects of the links and of the bodies attached in \e state, in this order. The manager
+      and its collision objects persist across calls; only the objects whose collision body transform differs from
+      the previous call are refit. Objects of attached bodies are kept until the body is attached with different
+      shapes or its shapes are destroyed. */
+  const FCLManager& getBroadPhase(const robot_state::RobotState& state) const;
   void getAttachedBodyObjects(const robot_state::AttachedBody* ab, std::vector<FCLGeometryConstPtr>& geoms) const;
 
   void checkSelfCollisionHelper(const CollisionRequest& req, CollisionResult& res, const robot_state::RobotState& state,
@@ -92,8 +106,21 @@ protected:
                                  const robot_state::RobotState& state, const CollisionRobot& other_robot,
                                  const robot_state::RobotState& other_state, const AllowedCollisionMatrix* acm) const;
 
+  void checkSelfCollisionCCDHelper(const CollisionRequest& req, CollisionResult& res,
+                                   const robot_state::RobotState& state1, const robot_state::RobotState& state2,
+                                   const AllowedCollisionMatrix* acm) const;
+  void checkOtherCollisionCCDHelper(const CollisionRequest& req, CollisionResult& res,
+                                    const robot_state::RobotState& state1, const robot_state::RobotState& state2,
+                                    const CollisionRobot& other_robot, const robot_state::RobotState& other_state1,
+                                    const robot_state::RobotState& other_state2,
+                                    const AllowedCollisionMatrix* acm) const;
+
   std::vector<FCLGeometryConstPtr> geoms_;
   std::vector<FCLCollisionObjectConstPtr> fcl_objs_;
+
+  /** \brief Identifies the contents of \e geoms_ in the per-thread link broadphase caches. Copies share it,
+      and it is replaced whenever the link geometry changes, which expires the cached managers. */
+  std::shared_ptr<const void> link_broadphase_key_;
 };
 }
 
@@ -84,10 +84,18 @@ protected:
                                  const AllowedCollisionMatrix* acm) const;
   void checkRobotCollisionHelper(const CollisionRequest& req, CollisionResult& res, const CollisionRobot& robot,
                                  const robot_state::RobotState& state, const AllowedCollisionMatrix* acm) const;
+  void checkRobotCollisionCCDHelper(const CollisionRequest& req, CollisionResult& res, const CollisionRobot& robot,
+                                    const robot_state::RobotState& state1, const robot_state::RobotState& state2,
+                                    const AllowedCollisionMatrix* acm) const;
 
   void constructFCLObject(const World::Object* obj, FCLObject& fcl_obj) const;
   void updateFCLObject(const std::string& id);
 
+  /** \brief Move the FCL objects of \e obj to its current shape poses and refit them in the broadphase, keeping
+      their geometry (e.g. the octree shared with an octomap). Returns false if the objects cannot be updated in
+      place, because their shapes changed or they are shared with a copy of this world. */
+  bool moveFCLObject(const World::Object* obj);
+
   std::unique_ptr<fcl::BroadPhaseCollisionManagerd> manager_;
   std::map<std::string, FCLObject> fcl_objs_;
 
@@ -65,6 +65,10 @@ class DistanceRequest;
 using DistanceRequestd = fcl::DistanceRequest;
 class DistanceResult;
 using DistanceResultd = fcl::DistanceResult;
+class ContinuousCollisionRequest;
+using ContinuousCollisionRequestd = fcl::ContinuousCollisionRequest;
+class ContinuousCollisionResult;
+using ContinuousCollisionResultd = fcl::ContinuousCollisionResult;
 class Plane;
 using Planed = fcl::Plane;
 class Sphere;
@@ -94,6 +98,8 @@ class OcTree;
 using OcTreed = fcl::OcTree;
 class OBBRSS;
 using OBBRSSd = fcl::OBBRSS;
+class AABB;
+using AABBd = fcl::AABB;
 class DynamicAABBTreeCollisionManager;
 using DynamicAABBTreeCollisionManagerd = fcl::DynamicAABBTreeCollisionManager;
 }
@@ -41,27 +41,32 @@
 #if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
 #include <fcl/geometry/bvh/BVH_model.h>
 #include <fcl/geometry/octree/octree.h>
+#include <fcl/narrowphase/continuous_collision.h>
 #else
 #include <fcl/BVH/BVH_model.h>
 #include <fcl/shape/geometric_shapes.h>
 #include <fcl/octree.h>
+#include <fcl/continuous_collision.h>
 #endif
 
 #include <boost/thread/mutex.hpp>
+#include <eigen_stl_containers/eigen_stl_containers.h>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 rclcpp::Logger LOGGER_COLLISION_DETECTION = rclcpp::get_logger("collision_detection.fcl");
 
 namespace collision_detection
 {
-bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data)
+namespace
+{
+/** \brief Decide if the pair of geometries needs a narrowphase check, based on the active components, the allowed
+    collision matrix and touch links. If the collision is conditionally allowed, \e dcf is set to the decider. */
+bool needsCollisionCheck(const CollisionGeometryData* cd1, const CollisionGeometryData* cd2, CollisionData* cdata,
+                         DecideContactFn& dcf)
 {
-  CollisionData* cdata = reinterpret_cast<CollisionData*>(data);
-  if (cdata->done_)
-    return true;
-  const CollisionGeometryData* cd1 = static_cast<const CollisionGeometryData*>(o1->collisionGeometry()->getUserData());
-  const CollisionGeometryData* cd2 = static_cast<const CollisionGeometryData*>(o2->collisionGeometry()->getUserData());
-
   // do not collision check geoms part of the same object / link / attached body
   if (cd1->sameObject(*cd2))
     return false;
@@ -85,12 +90,11 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
   }
 
   // use the collision matrix (if any) to avoid certain collision checks
-  DecideContactFn dcf;
   bool always_allow_collision = false;
   if (cdata->acm_)
   {
     AllowedCollision::Type type;
-    bool found = cdata->acm_->getAllowedCollision(cd1->getID(), cd2->getID(), type);
+    bool found = cdata->getCompiledACM().getAllowedCollision(cd1->name_id, cd2->name_id, type);
     if (found)
     {
       // if we have an entry in the collision matrix, we read it
@@ -104,6 +108,7 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
       }
       else if (type == AllowedCollision::CONDITIONAL)
       {
+        // the contact decider is only available by name
         cdata->acm_->getAllowedCollision(cd1->getID(), cd2->getID(), dcf);
         if (cdata->req_->verbose)
           RCLCPP_DEBUG(LOGGER_COLLISION_DETECTION, "Collision between '%s' and '%s' is conditionally allowed",
@@ -149,6 +154,15 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
   if (cdata->req_->verbose)
     RCLCPP_DEBUG(LOGGER_COLLISION_DETECTION, "Actually checking collisions between %s and %s", cd1->getID().c_str(),
                     cd2->getID().c_str());
+  return true;
+}
+
+/** \brief Run the narrowphase check between two objects and store contacts and cost sources in \e cdata as
+    requested. Returns true if the pair is in collision. */
+bool checkCollisionPair(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, const CollisionGeometryData* cd1,
+                        const CollisionGeometryData* cd2, CollisionData* cdata, const DecideContactFn& dcf)
+{
+  bool collision = false;
 
   // see if we need to compute a contact
   std::size_t want_contact_count = 0;
@@ -213,6 +227,7 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
                            cd1->getID().c_str(), cd1->getTypeString().c_str(), cd2->getID().c_str(),
                            cd2->getTypeString().c_str());
           cdata->res_->collision = true;
+          collision = true;
           if (want_contact_count == 0)
             break;
         }
@@ -270,6 +285,7 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
                                                             std::make_pair(cd1->getID(), cd2->getID()) :
                                                             std::make_pair(cd2->getID(), cd1->getID());
         cdata->res_->collision = true;
+        collision = true;
         for (int i = 0; i < num_contacts; ++i)
         {
           Contact c;
@@ -305,6 +321,7 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
       if (num_contacts > 0)
       {
         cdata->res_->collision = true;
+        collision = true;
         if (cdata->req_->verbose)
           RCLCPP_INFO(LOGGER_COLLISION_DETECTION, "Found a contact between '%s' (type '%s') and '%s' (type '%s'), "
                                                     "which constitutes a collision. "
@@ -330,6 +347,12 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
     }
   }
 
+  return collision;
+}
+
+/** \brief Update and return the flag that tells the broadphase to stop */
+bool updateDone(CollisionData* cdata)
+{
   if (cdata->res_->collision)
     if (!cdata->req_->contacts || cdata->res_->contact_count >= cdata->req_->max_contacts)
     {
@@ -352,6 +375,296 @@ bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, voi
   return cdata->done_;
 }
 
+/** \brief The pose at the end of the motion of an object used in continuous checks. Objects that do not carry one
+    in their user data (e.g. world objects) do not move. */
+const fcl::Transform3d& getEndTransform(const fcl::CollisionObjectd* o)
+{
+  return o->getUserData() ? *static_cast<const fcl::Transform3d*>(o->getUserData()) : o->getTransform();
+}
+
+/** \brief Conservative advancement is only implemented in FCL for convex shapes and OBBRSS / RSS meshes; the
+    remaining geometry (planes, octrees) falls back to the sampling based solver. */
+bool supportsConservativeAdvancement(const fcl::CollisionGeometryd* g)
+{
+  switch (g->getNodeType())
+  {
+    case fcl::GEOM_BOX:
+    case fcl::GEOM_SPHERE:
+    case fcl::GEOM_CAPSULE:
+    case fcl::GEOM_CONE:
+    case fcl::GEOM_CYLINDER:
+    case fcl::GEOM_CONVEX:
+    case fcl::BV_RSS:
+    case fcl::BV_OBBRSS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** \brief Get the pose of \e o as rotation and translation */
+void getPose(const fcl::CollisionObjectd* o, Eigen::Matrix3d& rotation, Eigen::Vector3d& translation)
+{
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+  rotation = o->getRotation();
+  translation = o->getTranslation();
+#else
+  const fcl::Quaternion3f& q = o->getQuatRotation();
+  rotation = Eigen::Quaterniond(q.getW(), q.getX(), q.getY(), q.getZ()).toRotationMatrix();
+  const fcl::Vector3d& t = o->getTranslation();
+  translation = Eigen::Vector3d(t[0], t[1], t[2]);
+#endif
+}
+
+/** \brief Bound the distance any point of the geometry of \e o moved since it was at \e rotation, \e translation */
+double getMotionBound(const fcl::CollisionObjectd* o, const Eigen::Matrix3d& rotation,
+                      const Eigen::Vector3d& translation)
+{
+  Eigen::Matrix3d r;
+  Eigen::Vector3d t;
+  getPose(o, r, t);
+  const fcl::CollisionGeometryd* geom = o->collisionGeometry().get();
+  Eigen::Vector3d c(geom->aabb_center[0], geom->aabb_center[1], geom->aabb_center[2]);
+  // all points are within aabb_radius of the center of the local AABB, so they move at most as far as that center
+  // plus the radius times the change of rotation (the Frobenius norm bounds the spectral norm)
+  return (r * c + t - rotation * c - translation).norm() + (r - rotation).norm() * geom->aabb_radius;
+}
+
+/** \brief Compute a bounding sphere of \e points that is close to the smallest one (Ritter's algorithm) */
+void computeBoundingSphere(const EigenSTL::vector_Vector3d& points, Eigen::Vector3d& center, double& radius)
+{
+  // start with the sphere spanned by two points that are far apart
+  std::size_t far1 = 0, far2 = 0;
+  for (std::size_t i = 1; i < points.size(); ++i)
+    if ((points[i] - points[0]).squaredNorm() > (points[far1] - points[0]).squaredNorm())
+      far1 = i;
+  for (std::size_t i = 0; i < points.size(); ++i)
+    if ((points[i] - points[far1]).squaredNorm() > (points[far2] - points[far1]).squaredNorm())
+      far2 = i;
+  center = (points[far1] + points[far2]) / 2.0;
+  radius = (points[far2] - points[far1]).norm() / 2.0;
+
+  // grow the sphere to include the points outside of it
+  for (const Eigen::Vector3d& p : points)
+  {
+    double d = (p - center).norm();
+    if (d > radius)
+    {
+      double new_radius = (radius + d) / 2.0;
+      center += (p - center) * ((new_radius - radius) / d);
+      radius = new_radius;
+    }
+  }
+}
+
+/** \brief Check if two oriented boxes, given in the same frame, are disjoint (separating axis test) */
+bool obbDisjoint(const Eigen::Matrix3d& axes1, const Eigen::Vector3d& center1, const Eigen::Vector3d& half_extents1,
+                 const Eigen::Matrix3d& axes2, const Eigen::Vector3d& center2, const Eigen::Vector3d& half_extents2)
+{
+  // express the second box in the frame of the first one; the epsilon accounts for nearly parallel edges
+  const Eigen::Matrix3d r = axes1.transpose() * axes2;
+  const Eigen::Matrix3d abs_r = r.cwiseAbs().array() + 1e-12;
+  const Eigen::Vector3d t = axes1.transpose() * (center2 - center1);
+  const Eigen::Vector3d& a = half_extents1;
+  const Eigen::Vector3d& b = half_extents2;
+
+  // the face normals of both boxes
+  for (int i = 0; i < 3; ++i)
+    if (std::abs(t[i]) > a[i] + abs_r.row(i).dot(b))
+      return true;
+  for (int i = 0; i < 3; ++i)
+    if (std::abs(t.dot(r.col(i))) > abs_r.col(i).dot(a) + b[i])
+      return true;
+
+  // the cross products of the edge directions
+  for (int i = 0; i < 3; ++i)
+  {
+    const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+    for (int j = 0; j < 3; ++j)
+    {
+      const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+      double ra = a[i1] * abs_r(i2, j) + a[i2] * abs_r(i1, j);
+      double rb = b[j1] * abs_r(i, j2) + b[j2] * abs_r(i, j1);
+      if (std::abs(t[i2] * r(i1, j) - t[i1] * r(i2, j)) > ra + rb)
+        return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+void computeGeometryBound(const shapes::Shape& shape, FCLGeometryBound& bound)
+{
+  bound = FCLGeometryBound();
+  switch (shape.type)
+  {
+    case shapes::SPHERE:
+      bound.sphere_radius = static_cast<const shapes::Sphere&>(shape).radius;
+      break;
+    case shapes::BOX:
+    {
+      const double* size = static_cast<const shapes::Box&>(shape).size;
+      bound.obb_half_extents = Eigen::Vector3d(size[0], size[1], size[2]) / 2.0;
+      bound.sphere_radius = bound.obb_half_extents.norm();
+      bound.has_obb = true;
+      break;
+    }
+    case shapes::CYLINDER:
+    {
+      const shapes::Cylinder& cylinder = static_cast<const shapes::Cylinder&>(shape);
+      bound.obb_half_extents = Eigen::Vector3d(cylinder.radius, cylinder.radius, cylinder.length / 2.0);
+      bound.sphere_radius = bound.obb_half_extents.tail<2>().norm();
+      bound.has_obb = true;
+      break;
+    }
+    case shapes::CONE:
+    {
+      // the apex is at +length/2; the smallest sphere passes through the base circle and the apex, unless the cone
+      // is so wide that the sphere around the base circle already contains the apex
+      const shapes::Cone& cone = static_cast<const shapes::Cone&>(shape);
+      double z = std::max(-cone.length / 2.0, -cone.radius * cone.radius / (2.0 * cone.length));
+      bound.sphere_center = Eigen::Vector3d(0.0, 0.0, z);
+      bound.sphere_radius = std::sqrt(cone.radius * cone.radius + (z + cone.length / 2.0) * (z + cone.length / 2.0));
+      bound.obb_half_extents = Eigen::Vector3d(cone.radius, cone.radius, cone.length / 2.0);
+      bound.has_obb = true;
+      break;
+    }
+    case shapes::MESH:
+    {
+      const shapes::Mesh& mesh = static_cast<const shapes::Mesh&>(shape);
+      if (mesh.vertex_count == 0 || mesh.triangle_count == 0)
+        break;
+      EigenSTL::vector_Vector3d points(mesh.vertex_count);
+      for (unsigned int i = 0; i < mesh.vertex_count; ++i)
+        points[i] = Eigen::Vector3d(mesh.vertices[3 * i], mesh.vertices[3 * i + 1], mesh.vertices[3 * i + 2]);
+      computeBoundingSphere(points, bound.sphere_center, bound.sphere_radius);
+
+      // orient the box along the principal axes of the vertices
+      Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+      for (const Eigen::Vector3d& p : points)
+        mean += p;
+      mean /= points.size();
+      Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+      for (const Eigen::Vector3d& p : points)
+        covariance += (p - mean) * (p - mean).transpose();
+      bound.obb_axes = Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d>(covariance).eigenvectors();
+
+      Eigen::Vector3d min = Eigen::Vector3d::Constant(std::numeric_limits<double>::max());
+      Eigen::Vector3d max = -min;
+      for (const Eigen::Vector3d& p : points)
+      {
+        Eigen::Vector3d q = bound.obb_axes.transpose() * p;
+        min = min.cwiseMin(q);
+        max = max.cwiseMax(q);
+      }
+      bound.obb_center = bound.obb_axes * ((min + max) / 2.0);
+      bound.obb_half_extents = (max - min) / 2.0;
+      bound.has_obb = true;
+
+      // the sphere around the box is smaller for some flat meshes
+      if (bound.obb_half_extents.norm() < bound.sphere_radius)
+      {
+        bound.sphere_center = bound.obb_center;
+        bound.sphere_radius = bound.obb_half_extents.norm();
+      }
+      break;
+    }
+    default:
+      // planes and octrees are not bounded
+      break;
+  }
+}
+
+bool boundsDisjoint(const FCLGeometryBound& b1, const Eigen::Matrix3d& rotation1, const Eigen::Vector3d& translation1,
+                    const FCLGeometryBound& b2, const Eigen::Matrix3d& rotation2, const Eigen::Vector3d& translation2)
+{
+  if (b1.sphere_radius < 0.0 || b2.sphere_radius < 0.0)
+    return false;
+
+  const double r = b1.sphere_radius + b2.sphere_radius;
+  if ((rotation1 * b1.sphere_center + translation1 - rotation2 * b2.sphere_center - translation2).squaredNorm() > r * r)
+    return true;
+
+  if (!b1.has_obb || !b2.has_obb)
+    return false;
+  return obbDisjoint(rotation1 * b1.obb_axes, rotation1 * b1.obb_center + translation1, b1.obb_half_extents,
+                     rotation2 * b2.obb_axes, rotation2 * b2.obb_center + translation2, b2.obb_half_extents);
+}
+
+bool collisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data)
+{
+  CollisionData* cdata = reinterpret_cast<CollisionData*>(data);
+  if (cdata->done_)
+    return true;
+  const CollisionGeometryData* cd1 = static_cast<const CollisionGeometryData*>(o1->collisionGeometry()->getUserData());
+  const CollisionGeometryData* cd2 = static_cast<const CollisionGeometryData*>(o2->collisionGeometry()->getUserData());
+
+  DecideContactFn dcf;
+  if (!needsCollisionCheck(cd1, cd2, cdata, dcf))
+    return false;
+
+  // the broadphase only compares world-aligned boxes; reject pairs whose tighter bounds are disjoint before running
+  // the more expensive narrowphase. FCL reports cost sources from overlapping boxes of the bounding volume hierarchy,
+  // which can exist for disjoint bounds, so cost queries always run the narrowphase.
+  ++cdata->res_->checked_pairs;
+  if (!cdata->req_->cost)
+  {
+    Eigen::Matrix3d r1, r2;
+    Eigen::Vector3d t1, t2;
+    getPose(o1, r1, t1);
+    getPose(o2, r2, t2);
+    if (boundsDisjoint(cd1->bound, r1, t1, cd2->bound, r2, t2))
+    {
+      ++cdata->res_->bound_rejected_pairs;
+      return false;
+    }
+  }
+
+  checkCollisionPair(o1, o2, cd1, cd2, cdata, dcf);
+  return updateDone(cdata);
+}
+
+bool continuousCollisionCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void* data)
+{
+  CollisionData* cdata = reinterpret_cast<CollisionData*>(data);
+  if (cdata->done_)
+    return true;
+  const CollisionGeometryData* cd1 = static_cast<const CollisionGeometryData*>(o1->collisionGeometry()->getUserData());
+  const CollisionGeometryData* cd2 = static_cast<const CollisionGeometryData*>(o2->collisionGeometry()->getUserData());
+
+  DecideContactFn dcf;
+  if (!needsCollisionCheck(cd1, cd2, cdata, dcf))
+    return false;
+
+  fcl::ContinuousCollisionRequestd ccd_req;
+  ccd_req.ccd_motion_type = fcl::CCDM_LINEAR;
+  ccd_req.ccd_solver_type = supportsConservativeAdvancement(o1->collisionGeometry().get()) &&
+                                    supportsConservativeAdvancement(o2->collisionGeometry().get()) ?
+                                fcl::CCDC_CONSERVATIVE_ADVANCEMENT :
+                                fcl::CCDC_NAIVE;
+  fcl::ContinuousCollisionResultd ccd_res;
+  fcl::continuousCollide(o1, getEndTransform(o1), o2, getEndTransform(o2), ccd_req, ccd_res);
+  if (!ccd_res.is_collide)
+    return false;
+
+  // compute contacts (and evaluate the contact decider) at the time of contact
+  fcl::CollisionObjectd c1(std::const_pointer_cast<fcl::CollisionGeometryd>(o1->collisionGeometry()),
+                           ccd_res.contact_tf1);
+  fcl::CollisionObjectd c2(std::const_pointer_cast<fcl::CollisionGeometryd>(o2->collisionGeometry()),
+                           ccd_res.contact_tf2);
+  if (!checkCollisionPair(&c1, &c2, cd1, cd2, cdata, dcf) && !dcf)
+  {
+    // the objects only touch at the time of contact (within the solver tolerance), which still is a collision
+    cdata->res_->collision = true;
+    if (cdata->req_->verbose)
+      RCLCPP_INFO(LOGGER_COLLISION_DETECTION, "Found a continuous collision between '%s' (type '%s') and '%s' "
+                                                "(type '%s') at time %f. Contact information is not available.",
+                     cd1->getID().c_str(), cd1->getTypeString().c_str(), cd2->getID().c_str(),
+                     cd2->getTypeString().c_str(), ccd_res.time_of_contact);
+  }
+  return updateDone(cdata);
+}
+
 struct FCLShapeCache
 {
   using ShapeKey = shapes::ShapeConstWeakPtr;
@@ -427,7 +740,7 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
   {
     AllowedCollision::Type type;
 
-    bool found = cdata->req->acm->getAllowedCollision(cd1->getID(), cd2->getID(), type);
+    bool found = cdata->getCompiledACM().getAllowedCollision(cd1->name_id, cd2->name_id, type);
     if (found)
     {
       // if we have an entry in the collision matrix, we read it
@@ -506,8 +819,28 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
     }
   }
 
+  // with a distance cache, skip pairs that are provably too far apart to change the result
+  FCLDistanceCacheData::PairBound* pair_bound = nullptr;
+  if (cdata->cache)
+  {
+    double threshold = cdata->req->distance_threshold;
+    if (cdata->req->type == DistanceRequestType::GLOBAL)
+      threshold = std::min(threshold, cdata->res->minimum_distance.distance);
+    // nothing is recorded for pairs this far apart, so the broadphase does not need to report them either;
+    // this does not hold once a collision is found, as its signed distance may be lower than any threshold
+    if (threshold > 0.0)
+      min_dist = threshold;
+
+    pair_bound = cdata->cache->getPairBound(o1, o2);
+    threshold = std::min(threshold, dist_threshold);
+    if (pair_bound && threshold > 0.0 && FCLDistanceCacheData::getLowerBound(*pair_bound, o1, o2) >= threshold)
+      return cdata->done;
+  }
+
   fcl_result.min_distance = dist_threshold;
   double d = fcl::distance(o1, o2, fcl::DistanceRequestd(cdata->req->enable_nearest_points), fcl_result);
+  if (pair_bound)
+    FCLDistanceCacheData::setDistance(*pair_bound, o1, o2, d);
 
   // Check if either object is already in the map. If not add it or if present
   // check to see if the new distance is closer. If closer remove the existing
@@ -573,6 +906,11 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
     if (dist_result.distance < cdata->res->minimum_distance.distance)
     {
       cdata->res->minimum_distance = dist_result;
+      if (cdata->cache)
+      {
+        cdata->witness[0] = o1;
+        cdata->witness[1] = o2;
+      }
     }
 
     if (dist_result.distance <= 0)
@@ -617,6 +955,89 @@ bool distanceCallback(fcl::CollisionObjectd* o1, fcl::CollisionObjectd* o2, void
   return cdata->done;
 }
 
+FCLDistanceCacheData::PairBound* FCLDistanceCacheData::getPairBound(const fcl::CollisionObjectd* o1,
+                                                                    const fcl::CollisionObjectd* o2)
+{
+  // octrees change their content without being moved, so no bound holds for them
+  if (o1->getObjectType() == fcl::OT_OCTREE || o2->getObjectType() == fcl::OT_OCTREE)
+    return nullptr;
+
+  if (o2->collisionGeometry().get() < o1->collisionGeometry().get())
+    std::swap(o1, o2);
+  std::pair<const void*, const void*> key(o1->collisionGeometry().get(), o2->collisionGeometry().get());
+
+  auto it = pairs.find(key);
+  if (it == pairs.end())
+  {
+    // drop the pairs of geometries that no longer exist before growing further
+    if (pairs.size() >= cleanup_size)
+    {
+      for (auto jt = pairs.begin(); jt != pairs.end();)
+        jt = jt->second.geometry[0].expired() || jt->second.geometry[1].expired() ? pairs.erase(jt) : std::next(jt);
+      cleanup_size = std::max(cleanup_size, 2 * pairs.size());
+    }
+    it = pairs.insert(std::make_pair(key, PairBound())).first;
+  }
+
+  // a new entry, or one of geometries that were freed and reallocated at the same addresses
+  PairBound& bound = it->second;
+  if (bound.geometry[0].expired() || bound.geometry[1].expired())
+  {
+    bound.geometry[0] = o1->collisionGeometry();
+    bound.geometry[1] = o2->collisionGeometry();
+    bound.distance = -1.0;
+  }
+  return &bound;
+}
+
+double FCLDistanceCacheData::getLowerBound(const PairBound& bound, const fcl::CollisionObjectd* o1,
+                                           const fcl::CollisionObjectd* o2)
+{
+  if (bound.distance <= 0.0)
+    return bound.distance;
+  if (o2->collisionGeometry().get() < o1->collisionGeometry().get())
+    std::swap(o1, o2);
+  return bound.distance - getMotionBound(o1, bound.rotation[0], bound.translation[0]) -
+         getMotionBound(o2, bound.rotation[1], bound.translation[1]);
+}
+
+void FCLDistanceCacheData::setDistance(PairBound& bound, const fcl::CollisionObjectd* o1,
+                                       const fcl::CollisionObjectd* o2, double distance)
+{
+  if (o2->collisionGeometry().get() < o1->collisionGeometry().get())
+    std::swap(o1, o2);
+  getPose(o1, bound.rotation[0], bound.translation[0]);
+  getPose(o2, bound.rotation[1], bound.translation[1]);
+  bound.distance = distance;
+}
+
+std::pair<const fcl::CollisionObjectd*, const fcl::CollisionObjectd*>
+DistanceData::enableCache(const void* context)
+{
+  DistanceCache* distance_cache = req->getCache();
+  if (!distance_cache)
+    return std::make_pair(nullptr, nullptr);
+  cache = &distance_cache->getData<FCLDistanceCacheData>();
+  cache_context = context;
+
+  // only queries for the global minimum profit from checking the previous closest pair first,
+  // the other query types would record that pair twice
+  auto it = cache->witnesses.find(context);
+  if (req->type != DistanceRequestType::GLOBAL || it == cache->witnesses.end())
+    return std::make_pair(nullptr, nullptr);
+  return it->second;
+}
+
+void DistanceData::updateCache()
+{
+  if (!cache)
+    return;
+  if (witness[0])
+    cache->witnesses[cache_context] = std::make_pair(witness[0], witness[1]);
+  else
+    cache->witnesses.erase(cache_context);
+}
+
 /* We template the function so we get a different cache for each of the template arguments combinations */
 template <typename BV, typename T>
 FCLShapeCache& GetShapeCache()
@@ -824,7 +1245,9 @@ FCLGeometryConstPtr createCollisionGeometry(const shapes::ShapeConstPtr& shape,
   if (cg_g)
   {
     cg_g->computeLocalAABB();
-    FCLGeometryConstPtr res(new FCLGeometry(cg_g, data, shape_index));
+    FCLGeometry* geometry = new FCLGeometry(cg_g, data, shape_index);
+    computeGeometryBound(*shape, geometry->collision_geometry_data_->bound);
+    FCLGeometryConstPtr res(geometry);
     cache.map_[wptr] = res;
     cache.bumpUseCount();
     return res;
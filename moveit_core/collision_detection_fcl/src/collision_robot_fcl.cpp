@@ -41,12 +41,207 @@
 #include <fcl/broadphase/broadphase_dynamic_AABB_tree.h>
 #endif
 
+#include <algorithm>
+#include <map>
+
 rclcpp::Logger LOGGER_COLLISION_ROBOT_FCL = rclcpp::get_logger("collision_robot.fcl");
 
 namespace collision_detection
 {
+namespace
+{
+/** \brief The collision objects of an attached body, reused across checks */
+struct AttachedBodyObjects
+{
+  /// The shapes the objects were constructed for
+  std::vector<shapes::ShapeConstPtr> shapes_;
+
+  /// One entry per shape; empty if no collision geometry could be constructed for the shape
+  std::vector<FCLGeometryConstPtr> geometries_;
+  std::vector<FCLCollisionObjectPtr> objects_;
+
+  /// The transforms the objects were last updated with
+  EigenSTL::vector_Isometry3d transforms_;
+
+  /// Flag indicating whether the objects are registered with the broadphase manager
+  bool registered_ = false;
+
+  /// Flag indicating whether the body was attached in the state of the current update
+  bool used_ = false;
+};
+
+/** \brief A broadphase manager over the collision objects of one robot, reused across checks */
+struct RobotBroadPhase
+{
+  /// The manager and its objects: first the link objects, then the objects of the attached bodies of the last state
+  FCLManager manager_;
+  std::size_t link_object_count_ = 0;
+
+  /// For every entry in CollisionRobotFCL::geoms_, the index of its object in manager_.object_ (or -1)
+  std::vector<int> object_index_;
+
+  /// The collision body transforms the link objects were last updated with
+  EigenSTL::vector_Isometry3d transforms_;
+
+  /// The objects of the bodies that have been attached to the robot, by name
+  std::map<std::string, AttachedBodyObjects> attached_bodies_;
+
+  /// Scratch buffers for an update
+  std::vector<fcl::CollisionObjectd*> updated_objects_;
+  std::vector<const robot_state::AttachedBody*> state_attached_bodies_;
+};
+
+/** \brief The robot broadphases of one thread, keyed on CollisionRobotFCL::link_broadphase_key_ */
+struct RobotBroadPhaseCache
+{
+  using Key = std::weak_ptr<const void>;
+  using Map = std::map<Key, RobotBroadPhase, std::owner_less<Key>>;
+
+  /// Remove the broadphases of robots (or geometry) that no longer exist
+  void clean()
+  {
+    for (auto it = map_.begin(); it != map_.end();)
+      if (it->first.expired())
+        it = map_.erase(it);
+      else
+        ++it;
+  }
+
+  Map map_;
+};
+
+/** \brief Bring the attached body objects of \e bp in line with the bodies attached in \e state */
+void updateAttachedBodies(RobotBroadPhase& bp, const robot_state::RobotState& state)
+{
+  fcl::BroadPhaseCollisionManagerd* manager = bp.manager_.manager_.get();
+  std::vector<FCLCollisionObjectPtr>& objects = bp.manager_.object_.collision_objects_;
+  objects.resize(bp.link_object_count_);
+  for (auto& entry : bp.attached_bodies_)
+    entry.second.used_ = false;
+
+  fcl::Transform3d fcl_tf;
+  state.getAttachedBodies(bp.state_attached_bodies_);
+  for (const robot_state::AttachedBody* body : bp.state_attached_bodies_)
+  {
+    AttachedBodyObjects& abo = bp.attached_bodies_[body->getName()];
+    const std::vector<shapes::ShapeConstPtr>& shapes = body->getShapes();
+    if (abo.shapes_ != shapes)
+    {
+      // the body was attached with different shapes than the cached ones
+      if (abo.registered_)
+        for (const FCLCollisionObjectPtr& obj : abo.objects_)
+          if (obj)
+            manager->unregisterObject(obj.get());
+      abo.registered_ = false;
+      abo.shapes_ = shapes;
+      abo.geometries_.assign(shapes.size(), FCLGeometryConstPtr());
+      abo.objects_.assign(shapes.size(), FCLCollisionObjectPtr());
+      abo.transforms_.resize(shapes.size());
+      for (std::size_t k = 0; k < shapes.size(); ++k)
+      {
+        FCLGeometryConstPtr g = createCollisionGeometry(shapes[k], body, k);
+        if (g && g->collision_geometry_)
+        {
+          abo.geometries_[k] = g;
+          abo.objects_[k].reset(new fcl::CollisionObjectd(g->collision_geometry_));
+        }
+      }
+    }
+
+    // copies of a state hold copies of its attached bodies, so the geometry data is pointed to the current one
+    const EigenSTL::vector_Isometry3d& ab_t = body->getGlobalCollisionBodyTransforms();
+    for (std::size_t k = 0; k < abo.objects_.size(); ++k)
+      if (abo.objects_[k])
+      {
+        abo.geometries_[k]->collision_geometry_data_->ptr.ab = body;
+        if (!abo.registered_ || ab_t[k].matrix() != abo.transforms_[k].matrix())
+        {
+          abo.transforms_[k] = ab_t[k];
+          transform2fcl(ab_t[k], fcl_tf);
+          abo.objects_[k]->setTransform(fcl_tf);
+          abo.objects_[k]->computeAABB();
+          if (abo.registered_)
+            bp.updated_objects_.push_back(abo.objects_[k].get());
+          else
+            manager->registerObject(abo.objects_[k].get());
+        }
+        objects.push_back(abo.objects_[k]);
+      }
+    abo.registered_ = true;
+    abo.used_ = true;
+  }
+
+  // bodies that are not attached in this state leave the manager; their objects are kept until their shapes are gone
+  for (auto it = bp.attached_bodies_.begin(); it != bp.attached_bodies_.end();)
+  {
+    AttachedBodyObjects& abo = it->second;
+    if (!abo.used_ && abo.registered_)
+    {
+      for (const FCLCollisionObjectPtr& obj : abo.objects_)
+        if (obj)
+          manager->unregisterObject(obj.get());
+      abo.registered_ = false;
+    }
+    if (!abo.used_ && std::all_of(abo.shapes_.begin(), abo.shapes_.end(),
+                                  [](const shapes::ShapeConstPtr& shape) { return shape.use_count() == 1; }))
+      it = bp.attached_bodies_.erase(it);
+    else
+      ++it;
+  }
+}
+
+/** \brief A collision object whose AABB is set explicitly instead of being computed from its transform */
+class SweptCollisionObject : public fcl::CollisionObjectd
+{
+public:
+  explicit SweptCollisionObject(const fcl::CollisionObjectd& prototype) : fcl::CollisionObjectd(prototype)
+  {
+  }
+
+  void setAABB(const fcl::AABBd& swept_aabb)
+  {
+    aabb = swept_aabb;
+  }
+};
+
+/** \brief Add a collision object placed at \e start to \e fcl_obj, whose AABB encloses the linear motion of
+    \e prototype's geometry from \e start to \e end. */
+void addSweptCollisionObject(const fcl::CollisionObjectd& prototype, const Eigen::Isometry3d& start,
+                             const Eigen::Isometry3d& end, FCLContinuousObject& fcl_obj)
+{
+  auto coll_obj = new SweptCollisionObject(prototype);
+  coll_obj->setTransform(transform2fcl(start));
+  coll_obj->computeAABB();
+  fcl::AABBd swept_aabb = coll_obj->getAABB();
+
+  fcl::CollisionObjectd end_obj(prototype);
+  end_obj.setTransform(transform2fcl(end));
+  end_obj.computeAABB();
+  swept_aabb += end_obj.getAABB();
+
+  // the rotation moves points off the straight line between their start and end position by at most
+  // r * (1 - cos(angle / 2)), where r bounds the distance of the geometry from its origin
+  double angle = Eigen::AngleAxisd(start.linear().transpose() * end.linear()).angle();
+  if (angle > 0.0)
+  {
+    const fcl::CollisionGeometryd* geom = prototype.collisionGeometry().get();
+#if (MOVEIT_FCL_VERSION >= FCL_VERSION_CHECK(0, 6, 0))
+    double r = geom->aabb_center.norm() + geom->aabb_radius;
+#else
+    double r = geom->aabb_center.length() + geom->aabb_radius;
+#endif
+    double d = r * (1.0 - cos(angle / 2.0));
+    swept_aabb.expand(fcl::Vector3d(d, d, d));
+  }
+  coll_obj->setAABB(swept_aabb);
+
+  fcl_obj.object_.collision_objects_.push_back(FCLCollisionObjectPtr(coll_obj));
+  fcl_obj.end_transforms_.push_back(transform2fcl(end));
+}
+}  // namespace
+
 CollisionRobotFCL::CollisionRobotFCL(const robot_model::RobotModelConstPtr& model, double padding, double scale)
-  : CollisionRobot(model, padding, scale)
+  : CollisionRobot(model, padding, scale), link_broadphase_key_(std::make_shared<char>())
 {
   const std::vector<const robot_model::LinkModel*>& links = robot_model_->getLinkModelsWithCollisionGeometry();
   std::size_t index;
@@ -79,6 +274,7 @@ CollisionRobotFCL::CollisionRobotFCL(const CollisionRobotFCL& other) : Collision
 {
   geoms_ = other.geoms_;
   fcl_objs_ = other.fcl_objs_;
+  link_broadphase_key_ = other.link_broadphase_key_;
 }
 
 void CollisionRobotFCL::getAttachedBodyObjects(const robot_state::AttachedBody* ab,
@@ -110,7 +306,14 @@ void CollisionRobotFCL::constructFCLObject(const robot_state::RobotState& state,
       fcl_obj.collision_objects_.push_back(FCLCollisionObjectPtr(coll_obj));
     }
 
-  // TODO: Implement a method for caching fcl::CollisionObject's for robot_state::AttachedBody's
+  constructAttachedBodyFCLObject(state, fcl_obj);
+}
+
+void CollisionRobotFCL::constructAttachedBodyFCLObject(const robot_state::RobotState& state, FCLObject& fcl_obj) const
+{
+  fcl::Transform3d fcl_tf;
+
+  // checks of this robot use the objects cached by getBroadPhase(); these are built anew on every call
   std::vector<const robot_state::AttachedBody*> ab;
   state.getAttachedBodies(ab);
   for (auto& body : ab)
@@ -131,6 +334,53 @@ void CollisionRobotFCL::constructFCLObject(const robot_state::RobotState& state,
   }
 }
 
+void CollisionRobotFCL::constructFCLObject(const robot_state::RobotState& state1,
+                                           const robot_state::RobotState& state2, FCLContinuousObject& fcl_obj) const
+{
+  fcl_obj.object_.collision_objects_.reserve(geoms_.size());
+  fcl_obj.end_transforms_.reserve(geoms_.size());
+
+  for (std::size_t i = 0; i < geoms_.size(); ++i)
+    if (geoms_[i] && geoms_[i]->collision_geometry_)
+    {
+      const robot_model::LinkModel* link = geoms_[i]->collision_geometry_data_->ptr.link;
+      int shape_index = geoms_[i]->collision_geometry_data_->shape_index;
+      addSweptCollisionObject(*fcl_objs_[i], state1.getCollisionBodyTransform(link, shape_index),
+                              state2.getCollisionBodyTransform(link, shape_index), fcl_obj);
+    }
+
+  std::vector<const robot_state::AttachedBody*> ab;
+  state1.getAttachedBodies(ab);
+  for (auto& body : ab)
+  {
+    const robot_state::AttachedBody* end_body = state2.getAttachedBody(body->getName());
+    if (!end_body || end_body->getShapes().size() != body->getShapes().size())
+    {
+      RCLCPP_ERROR(LOGGER_COLLISION_ROBOT_FCL, "Attached body '%s' differs between the start and end state of the "
+                                                "motion. It is checked as not moving.",
+                   body->getName().c_str());
+      end_body = body;
+    }
+
+    const std::vector<shapes::ShapeConstPtr>& shapes = body->getShapes();
+    const EigenSTL::vector_Isometry3d& start_t = body->getGlobalCollisionBodyTransforms();
+    const EigenSTL::vector_Isometry3d& end_t = end_body->getGlobalCollisionBodyTransforms();
+    for (std::size_t k = 0; k < shapes.size(); ++k)
+    {
+      FCLGeometryConstPtr g = createCollisionGeometry(shapes[k], body, k);
+      if (g && g->collision_geometry_)
+      {
+        addSweptCollisionObject(fcl::CollisionObjectd(g->collision_geometry_), start_t[k], end_t[k], fcl_obj);
+        fcl_obj.object_.collision_geometry_.push_back(g);
+      }
+    }
+  }
+
+  // the end transforms do not move anymore, so the objects can refer to them now
+  for (std::size_t i = 0; i < fcl_obj.object_.collision_objects_.size(); ++i)
+    fcl_obj.object_.collision_objects_[i]->setUserData(&fcl_obj.end_transforms_[i]);
+}
+
 void CollisionRobotFCL::allocSelfCollisionBroadPhase(const robot_state::RobotState& state, FCLManager& manager) const
 {
   auto m = new fcl::DynamicAABBTreeCollisionManagerd();
@@ -141,6 +391,64 @@ void CollisionRobotFCL::allocSelfCollisionBroadPhase(const robot_state::RobotSta
   // manager.manager_->update();
 }
 
+const FCLManager& CollisionRobotFCL::getBroadPhase(const robot_state::RobotState& state) const
+{
+  // one cache per thread, so concurrent checks with the same robot do not need any locking
+  static thread_local RobotBroadPhaseCache cache;
+
+  fcl::Transform3d fcl_tf;
+  auto it = cache.map_.find(link_broadphase_key_);
+  if (it == cache.map_.end())
+  {
+    cache.clean();
+    it = cache.map_.insert(std::make_pair(RobotBroadPhaseCache::Key(link_broadphase_key_), RobotBroadPhase())).first;
+    RobotBroadPhase& bp = it->second;
+    bp.manager_.manager_.reset(new fcl::DynamicAABBTreeCollisionManagerd());
+    bp.object_index_.assign(geoms_.size(), -1);
+    bp.transforms_.resize(geoms_.size());
+    bp.manager_.object_.collision_objects_.reserve(geoms_.size());
+    for (std::size_t i = 0; i < geoms_.size(); ++i)
+      if (geoms_[i] && geoms_[i]->collision_geometry_)
+      {
+        bp.transforms_[i] = state.getCollisionBodyTransform(geoms_[i]->collision_geometry_data_->ptr.link,
+                                                            geoms_[i]->collision_geometry_data_->shape_index);
+        transform2fcl(bp.transforms_[i], fcl_tf);
+        auto coll_obj = new fcl::CollisionObjectd(*fcl_objs_[i]);
+        coll_obj->setTransform(fcl_tf);
+        coll_obj->computeAABB();
+        bp.object_index_[i] = bp.manager_.object_.collision_objects_.size();
+        bp.manager_.object_.collision_objects_.push_back(FCLCollisionObjectPtr(coll_obj));
+      }
+    bp.link_object_count_ = bp.manager_.object_.collision_objects_.size();
+    bp.manager_.object_.registerTo(bp.manager_.manager_.get());
+    updateAttachedBodies(bp, state);
+    return bp.manager_;
+  }
+
+  // only refit the objects whose transform changed since the previous call on this thread
+  RobotBroadPhase& bp = it->second;
+  bp.updated_objects_.clear();
+  for (std::size_t i = 0; i < geoms_.size(); ++i)
+    if (bp.object_index_[i] >= 0)
+    {
+      const Eigen::Isometry3d& tf = state.getCollisionBodyTransform(geoms_[i]->collision_geometry_data_->ptr.link,
+                                                                    geoms_[i]->collision_geometry_data_->shape_index);
+      if (tf.matrix() != bp.transforms_[i].matrix())
+      {
+        bp.transforms_[i] = tf;
+        transform2fcl(tf, fcl_tf);
+        fcl::CollisionObjectd* coll_obj = bp.manager_.object_.collision_objects_[bp.object_index_[i]].get();
+        coll_obj->setTransform(fcl_tf);
+        coll_obj->computeAABB();
+        bp.updated_objects_.push_back(coll_obj);
+      }
+    }
+  updateAttachedBodies(bp, state);
+  if (!bp.updated_objects_.empty())
+    bp.manager_.manager_->update(bp.updated_objects_);
+  return bp.manager_;
+}
+
 void CollisionRobotFCL::checkSelfCollision(const CollisionRequest& req, CollisionResult& res,
                                            const robot_state::RobotState& state) const
 {
@@ -158,22 +466,21 @@ void CollisionRobotFCL::checkSelfCollision(const CollisionRequest& req, Collisio
                                            const robot_state::RobotState& state1,
                                            const robot_state::RobotState& state2) const
 {
-  RCLCPP_ERROR(LOGGER_COLLISION_ROBOT_FCL, "FCL continuous collision checking not yet implemented");
+  checkSelfCollisionCCDHelper(req, res, state1, state2, nullptr);
 }
 
 void CollisionRobotFCL::checkSelfCollision(const CollisionRequest& req, CollisionResult& res,
                                            const robot_state::RobotState& state1, const robot_state::RobotState& state2,
                                            const AllowedCollisionMatrix& acm) const
 {
-  RCLCPP_ERROR(LOGGER_COLLISION_ROBOT_FCL, "FCL continuous collision checking not yet implemented");
+  checkSelfCollisionCCDHelper(req, res, state1, state2, &acm);
 }
 
 void CollisionRobotFCL::checkSelfCollisionHelper(const CollisionRequest& req, CollisionResult& res,
                                                  const robot_state::RobotState& state,
                                                  const AllowedCollisionMatrix* acm) const
 {
-  FCLManager manager;
-  allocSelfCollisionBroadPhase(state, manager);
+  const FCLManager& manager = getBroadPhase(state);
   CollisionData cd(&req, &res, acm);
   cd.enableGroup(getRobotModel());
   manager.manager_->collide(&cd, &collisionCallback);
@@ -205,13 +512,42 @@ void CollisionRobotFCL::checkOtherCollision(const CollisionRequest& req, Collisi
   checkOtherCollisionHelper(req, res, state, other_robot, other_state, &acm);
 }
 
+void CollisionRobotFCL::checkSelfCollisionCCDHelper(const CollisionRequest& req, CollisionResult& res,
+                                                    const robot_state::RobotState& state1,
+                                                    const robot_state::RobotState& state2,
+                                                    const AllowedCollisionMatrix* acm) const
+{
+  FCLContinuousObject fcl_obj;
+  constructFCLObject(state1, state2, fcl_obj);
+  fcl::DynamicAABBTreeCollisionManagerd manager;
+  fcl_obj.object_.registerTo(&manager);
+
+  CollisionData cd(&req, &res, acm);
+  cd.enableGroup(getRobotModel());
+  manager.collide(&cd, &continuousCollisionCallback);
+
+  if (req.distance)
+  {
+    DistanceRequest dreq;
+    DistanceResult dres1, dres2;
+
+    dreq.group_name = req.group_name;
+    dreq.acm = acm;
+    dreq.enableGroup(getRobotModel());
+    // only the end points of the motion are considered for the distance
+    distanceSelf(dreq, dres1, state1);
+    distanceSelf(dreq, dres2, state2);
+    res.distance = std::min(dres1.minimum_distance.distance, dres2.minimum_distance.distance);
+  }
+}
+
 void CollisionRobotFCL::checkOtherCollision(const CollisionRequest& req, CollisionResult& res,
                                             const robot_state::RobotState& state1,
                                             const robot_state::RobotState& state2, const CollisionRobot& other_robot,
                                             const robot_state::RobotState& other_state1,
                                             const robot_state::RobotState& other_state2) const
 {
-  RCLCPP_ERROR(LOGGER_COLLISION_ROBOT_FCL, "FCL continuous collision checking not yet implemented");
+  checkOtherCollisionCCDHelper(req, res, state1, state2, other_robot, other_state1, other_state2, nullptr);
 }
 
 void CollisionRobotFCL::checkOtherCollision(const CollisionRequest& req, CollisionResult& res,
@@ -221,7 +557,7 @@ void CollisionRobotFCL::checkOtherCollision(const CollisionRequest& req, Collisi
                                             const robot_state::RobotState& other_state2,
                                             const AllowedCollisionMatrix& acm) const
 {
-  RCLCPP_ERROR(LOGGER_COLLISION_ROBOT_FCL, "FCL continuous collision checking not yet implemented");
+  checkOtherCollisionCCDHelper(req, res, state1, state2, other_robot, other_state1, other_state2, &acm);
 }
 
 void CollisionRobotFCL::checkOtherCollisionHelper(const CollisionRequest& req, CollisionResult& res,
@@ -230,9 +566,9 @@ void CollisionRobotFCL::checkOtherCollisionHelper(const CollisionRequest& req, C
                                                   const robot_state::RobotState& other_state,
                                                   const AllowedCollisionMatrix* acm) const
 {
-  FCLManager manager;
-  allocSelfCollisionBroadPhase(state, manager);
+  const FCLManager& manager = getBroadPhase(state);
 
+  // the other robot may share this thread's broadphase (e.g. a copy of this robot), so it is built separately
   const CollisionRobotFCL& fcl_rob = dynamic_cast<const CollisionRobotFCL&>(other_robot);
   FCLObject other_fcl_obj;
   fcl_rob.constructFCLObject(other_state, other_fcl_obj);
@@ -255,8 +591,48 @@ void CollisionRobotFCL::checkOtherCollisionHelper(const CollisionRequest& req, C
   }
 }
 
+void CollisionRobotFCL::checkOtherCollisionCCDHelper(const CollisionRequest& req, CollisionResult& res,
+                                                     const robot_state::RobotState& state1,
+                                                     const robot_state::RobotState& state2,
+                                                     const CollisionRobot& other_robot,
+                                                     const robot_state::RobotState& other_state1,
+                                                     const robot_state::RobotState& other_state2,
+                                                     const AllowedCollisionMatrix* acm) const
+{
+  FCLContinuousObject fcl_obj;
+  constructFCLObject(state1, state2, fcl_obj);
+  fcl::DynamicAABBTreeCollisionManagerd manager;
+  fcl_obj.object_.registerTo(&manager);
+
+  const CollisionRobotFCL& fcl_rob = dynamic_cast<const CollisionRobotFCL&>(other_robot);
+  FCLContinuousObject other_fcl_obj;
+  fcl_rob.constructFCLObject(other_state1, other_state2, other_fcl_obj);
+
+  CollisionData cd(&req, &res, acm);
+  cd.enableGroup(getRobotModel());
+  for (std::size_t i = 0; !cd.done_ && i < other_fcl_obj.object_.collision_objects_.size(); ++i)
+    manager.collide(other_fcl_obj.object_.collision_objects_[i].get(), &cd, &continuousCollisionCallback);
+
+  if (req.distance)
+  {
+    DistanceRequest dreq;
+    DistanceResult dres1, dres2;
+
+    dreq.group_name = req.group_name;
+    dreq.acm = acm;
+    dreq.enableGroup(getRobotModel());
+    // only the end points of the motion are considered for the distance
+    distanceOther(dreq, dres1, state1, other_robot, other_state1);
+    distanceOther(dreq, dres2, state2, other_robot, other_state2);
+    res.distance = std::min(dres1.minimum_distance.distance, dres2.minimum_distance.distance);
+  }
+}
+
 void CollisionRobotFCL::updatedPaddingOrScaling(const std::vector<std::string>& links)
 {
+  // the geometry changes, so cached link broadphases must not be reused
+  link_broadphase_key_ = std::make_shared<char>();
+
   std::size_t index;
   for (const auto& link : links)
   {
@@ -283,20 +659,30 @@ void CollisionRobotFCL::updatedPaddingOrScaling(const std::vector<std::string>&
 void CollisionRobotFCL::distanceSelf(const DistanceRequest& req, DistanceResult& res,
                                      const robot_state::RobotState& state) const
 {
-  FCLManager manager;
-  allocSelfCollisionBroadPhase(state, manager);
+  const FCLManager& manager = getBroadPhase(state);
   DistanceData drd(&req, &res);
 
-  manager.manager_->distance(&drd, &distanceCallback);
+  // with a distance cache, start with the closest pair of the previous query so the broadphase prunes farther pairs
+  auto previous = drd.enableCache(manager.manager_.get());
+  if (previous.first)
+  {
+    fcl::CollisionObjectd* o1 = findCollisionObject(manager.object_.collision_objects_, previous.first);
+    fcl::CollisionObjectd* o2 = findCollisionObject(manager.object_.collision_objects_, previous.second);
+    double min_dist = std::numeric_limits<double>::max();
+    if (o1 && o2)
+      distanceCallback(o1, o2, &drd, min_dist);
+  }
+
+  if (!drd.done)
+    manager.manager_->distance(&drd, &distanceCallback);
+  drd.updateCache();
 }
 
 void CollisionRobotFCL::distanceOther(const DistanceRequest& req, DistanceResult& res,
                                       const robot_state::RobotState& state, const CollisionRobot& other_robot,
                                       const robot_state::RobotState& other_state) const
 {
-  FCLManager manager;
-  allocSelfCollisionBroadPhase(state, manager);
-
+  const FCLManager& manager = getBroadPhase(state);
   const CollisionRobotFCL& fcl_rob = dynamic_cast<const CollisionRobotFCL&>(other_robot);
   FCLObject other_fcl_obj;
   fcl_rob.constructFCLObject(other_state, other_fcl_obj);
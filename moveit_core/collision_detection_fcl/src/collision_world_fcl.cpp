@@ -117,7 +117,7 @@ void CollisionWorldFCL::checkRobotCollision(const CollisionRequest& req, Collisi
                                             const CollisionRobot& robot, const robot_state::RobotState& state1,
                                             const robot_state::RobotState& state2) const
 {
-  RCLCPP_ERROR(LOGGER_COLLISION_WORLD, "FCL continuous collision checking not yet implemented");
+  checkRobotCollisionCCDHelper(req, res, robot, state1, state2, nullptr);
 }
 
 void CollisionWorldFCL::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
@@ -125,7 +125,37 @@ void CollisionWorldFCL::checkRobotCollision(const CollisionRequest& req, Collisi
                                             const robot_state::RobotState& state2,
                                             const AllowedCollisionMatrix& acm) const
 {
-  RCLCPP_ERROR(LOGGER_COLLISION_WORLD, "FCL continuous collision checking not yet implemented");
+  checkRobotCollisionCCDHelper(req, res, robot, state1, state2, &acm);
+}
+
+void CollisionWorldFCL::checkRobotCollisionCCDHelper(const CollisionRequest& req, CollisionResult& res,
+                                                     const CollisionRobot& robot,
+                                                     const robot_state::RobotState& state1,
+                                                     const robot_state::RobotState& state2,
+                                                     const AllowedCollisionMatrix* acm) const
+{
+  const CollisionRobotFCL& robot_fcl = dynamic_cast<const CollisionRobotFCL&>(robot);
+  FCLContinuousObject fcl_obj;
+  robot_fcl.constructFCLObject(state1, state2, fcl_obj);
+
+  CollisionData cd(&req, &res, acm);
+  cd.enableGroup(robot.getRobotModel());
+  for (std::size_t i = 0; !cd.done_ && i < fcl_obj.object_.collision_objects_.size(); ++i)
+    manager_->collide(fcl_obj.object_.collision_objects_[i].get(), &cd, &continuousCollisionCallback);
+
+  if (req.distance)
+  {
+    DistanceRequest dreq;
+    DistanceResult dres1, dres2;
+
+    dreq.group_name = req.group_name;
+    dreq.acm = acm;
+    dreq.enableGroup(robot.getRobotModel());
+    // only the end points of the motion are considered for the distance
+    distanceRobot(dreq, dres1, robot, state1);
+    distanceRobot(dreq, dres2, robot, state2);
+    res.distance = std::min(dres1.minimum_distance.distance, dres2.minimum_distance.distance);
+  }
 }
 
 void CollisionWorldFCL::checkRobotCollisionHelper(const CollisionRequest& req, CollisionResult& res,
@@ -133,8 +163,7 @@ void CollisionWorldFCL::checkRobotCollisionHelper(const CollisionRequest& req, C
                                                   const AllowedCollisionMatrix* acm) const
 {
   const CollisionRobotFCL& robot_fcl = dynamic_cast<const CollisionRobotFCL&>(robot);
-  FCLObject fcl_obj;
-  robot_fcl.constructFCLObject(state, fcl_obj);
+  const FCLObject& fcl_obj = robot_fcl.getBroadPhase(state).object_;
 
   CollisionData cd(&req, &res, acm);
   cd.enableGroup(robot.getRobotModel());
@@ -235,6 +264,31 @@ void CollisionWorldFCL::updateFCLObject(const std::string& id)
   // manager_->update();
 }
 
+bool CollisionWorldFCL::moveFCLObject(const World::Object* obj)
+{
+  auto it = fcl_objs_.find(obj->id_);
+  if (it == fcl_objs_.end() || it->second.collision_objects_.size() != obj->shapes_.size())
+    return false;
+
+  // objects copied from another world are registered with its manager too, and the world object itself is
+  // replaced when it was shared on modification
+  FCLObject& fcl_obj = it->second;
+  for (std::size_t i = 0; i < fcl_obj.collision_objects_.size(); ++i)
+    if (!fcl_obj.collision_objects_[i].unique() || fcl_obj.collision_geometry_[i]->collision_geometry_data_->ptr.obj != obj)
+      return false;
+
+  std::vector<fcl::CollisionObjectd*> moved(fcl_obj.collision_objects_.size());
+  for (std::size_t i = 0; i < obj->shapes_.size(); ++i)
+  {
+    fcl::CollisionObjectd* co = fcl_obj.collision_objects_[i].get();
+    co->setTransform(transform2fcl(obj->shape_poses_[i]));
+    co->computeAABB();
+    moved[i] = co;
+  }
+  manager_->update(moved);
+  return true;
+}
+
 void CollisionWorldFCL::setWorld(const WorldPtr& world)
 {
   if (world == getWorld())
@@ -270,6 +324,12 @@ void CollisionWorldFCL::notifyObjectChange(const ObjectConstPtr& obj, World::Act
     }
     cleanCollisionGeometryCache();
   }
+  else if (action == World::MOVE_SHAPE)
+  {
+    // only poses changed; the geometry (e.g. a large octree) does not need to be rebuilt
+    if (!moveFCLObject(obj.get()))
+      updateFCLObject(obj->id_);
+  }
   else
   {
     updateFCLObject(obj->id_);
@@ -282,12 +342,32 @@ void CollisionWorldFCL::distanceRobot(const DistanceRequest& req, DistanceResult
                                       const robot_state::RobotState& state) const
 {
   const CollisionRobotFCL& robot_fcl = dynamic_cast<const CollisionRobotFCL&>(robot);
-  FCLObject fcl_obj;
-  robot_fcl.constructFCLObject(state, fcl_obj);
+  const FCLObject& fcl_obj = robot_fcl.getBroadPhase(state).object_;
 
   DistanceData drd(&req, &res);
+
+  // with a distance cache, start with the closest pair of the previous query so the broadphase prunes farther pairs
+  auto previous = drd.enableCache(&fcl_obj);
+  if (previous.first)
+  {
+    fcl::CollisionObjectd* robot_obj = findCollisionObject(fcl_obj.collision_objects_, previous.first);
+    const fcl::CollisionObjectd* world_obj_ptr = previous.second;
+    if (!robot_obj)
+    {
+      robot_obj = findCollisionObject(fcl_obj.collision_objects_, previous.second);
+      world_obj_ptr = previous.first;
+    }
+    fcl::CollisionObjectd* world_obj = nullptr;
+    for (auto it = fcl_objs_.begin(); robot_obj && !world_obj && it != fcl_objs_.end(); ++it)
+      world_obj = findCollisionObject(it->second.collision_objects_, world_obj_ptr);
+    double min_dist = std::numeric_limits<double>::max();
+    if (robot_obj && world_obj)
+      distanceCallback(robot_obj, world_obj, &drd, min_dist);
+  }
+
   for (std::size_t i = 0; !drd.done && i < fcl_obj.collision_objects_.size(); ++i)
     manager_->distance(fcl_obj.collision_objects_[i].get(), &drd, &distanceCallback);
+  drd.updateCache();
 }
 
 void CollisionWorldFCL::distanceWorld(const DistanceRequest& req, DistanceResult& res,
@@ -0,0 +1,123 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2026, The MoveIt Contributors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the names of the authors nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+
+/* Benchmark of self-collision checks with a fresh vs. a persistent broadphase */
+
+#include <moveit_resources/config.h>
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/collision_detection_fcl/collision_robot_fcl.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <chrono>
+#include <gtest/gtest.h>
+
+// Exposes the broadphase that was allocated for every self-collision check before it became persistent
+class FreshBroadPhaseCollisionRobot : public collision_detection::CollisionRobotFCL
+{
+public:
+  using CollisionRobotFCL::CollisionRobotFCL;
+
+  void checkSelfCollisionFresh(const collision_detection::CollisionRequest& req,
+                               collision_detection::CollisionResult& res, const robot_state::RobotState& state,
+                               const collision_detection::AllowedCollisionMatrix& acm) const
+  {
+    collision_detection::FCLManager manager;
+    allocSelfCollisionBroadPhase(state, manager);
+    collision_detection::CollisionData cd(&req, &res, &acm);
+    cd.enableGroup(getRobotModel());
+    manager.manager_->collide(&cd, &collision_detection::collisionCallback);
+  }
+};
+
+// Run self-collision checks on random states of a robot and report checks per second for both broadphase variants
+void benchmarkSelfCollision(const std::string& robot_name, unsigned int num_states, unsigned int runs)
+{
+  robot_model::RobotModelPtr model = moveit::core::loadTestingRobotModel(robot_name);
+  ASSERT_TRUE(bool(model));
+  FreshBroadPhaseCollisionRobot crobot(model);
+  collision_detection::AllowedCollisionMatrix acm(model->getLinkModelNamesWithCollisionGeometry(), false);
+  collision_detection::CollisionRequest req;
+
+  std::vector<robot_state::RobotStatePtr> states;
+  for (unsigned int i = 0; i < num_states; ++i)
+  {
+    states.push_back(std::make_shared<robot_state::RobotState>(model));
+    states.back()->setToRandomPositions();
+    states.back()->update();
+  }
+
+  unsigned int fresh_collisions = 0, persistent_collisions = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < runs; ++r)
+    for (const robot_state::RobotStatePtr& state : states)
+    {
+      collision_detection::CollisionResult res;
+      crobot.checkSelfCollisionFresh(req, res, *state, acm);
+      fresh_collisions += res.collision;
+    }
+  std::chrono::duration<double> fresh = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < runs; ++r)
+    for (const robot_state::RobotStatePtr& state : states)
+    {
+      collision_detection::CollisionResult res;
+      crobot.checkSelfCollision(req, res, *state, acm);
+      persistent_collisions += res.collision;
+    }
+  std::chrono::duration<double> persistent = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(fresh_collisions, persistent_collisions);
+  const double checks = num_states * runs;
+  std::cerr << robot_name << ": fresh broadphase " << checks / fresh.count() << " checks/s, persistent broadphase "
+            << checks / persistent.count() << " checks/s (" << 100. * persistent.count() / fresh.count() << "%)"
+            << std::endl;
+}
+
+TEST(CollisionRobotFCLTiming, SelfCollisionPanda)
+{
+  benchmarkSelfCollision("panda", 1000, 20);
+}
+
+TEST(CollisionRobotFCLTiming, SelfCollisionPR2)
+{
+  benchmarkSelfCollision("pr2", 1000, 20);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,142 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2026, The MoveIt Contributors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the names of the authors nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+/* Benchmark of moving a large octomap in the FCL collision world: rebuilding vs. refitting its FCL object */
+
+#include <moveit_resources/config.h>
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/collision_detection_fcl/collision_world_fcl.h>
+#include <moveit/collision_detection_fcl/collision_robot_fcl.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <geometric_shapes/shapes.h>
+#include <octomap/octomap.h>
+#include <chrono>
+#include <random>
+#include <gtest/gtest.h>
+
+// Exposes the rebuild of a world object's FCL objects, which every MOVE_SHAPE notification used to trigger
+class RebuildingCollisionWorld : public collision_detection::CollisionWorldFCL
+{
+public:
+  using CollisionWorldFCL::CollisionWorldFCL;
+
+  void rebuild(const std::string& id)
+  {
+    updateFCLObject(id);
+  }
+};
+
+// Create an octree with resolution \e resolution, occupied in a fraction \e fill of the cells of a 4m x 4m x 2m volume
+std::shared_ptr<octomap::OcTree> createOctree(double resolution, double fill)
+{
+  std::shared_ptr<octomap::OcTree> octree = std::make_shared<octomap::OcTree>(resolution);
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  for (double x = -2.0; x < 2.0; x += resolution)
+    for (double y = -2.0; y < 2.0; y += resolution)
+      for (double z = 0.0; z < 2.0; z += resolution)
+        if (dist(gen) < fill)
+          octree->updateNode(octomap::point3d(x, y, z), true, true);
+  octree->updateInnerOccupancy();
+  return octree;
+}
+
+void benchmarkOctreeUpdates(double resolution, double fill, unsigned int runs)
+{
+  robot_model::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  ASSERT_TRUE(bool(model));
+  collision_detection::CollisionRobotFCL crobot(model);
+  RebuildingCollisionWorld cworld;
+  robot_state::RobotState state(model);
+  state.setToDefaultValues();
+  state.update();
+
+  std::shared_ptr<octomap::OcTree> octree = createOctree(resolution, fill);
+  shapes::ShapeConstPtr map(new shapes::OcTree(octree));
+  cworld.getWorld()->addToObject("map", map, Eigen::Isometry3d::Identity());
+
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < runs; ++r)
+  {
+    cworld.getWorld()->removeObject("map");
+    cworld.getWorld()->addToObject("map", shapes::ShapeConstPtr(new shapes::OcTree(octree)),
+                                   Eigen::Isometry3d::Identity());
+  }
+  std::chrono::duration<double> replace = std::chrono::steady_clock::now() - start;
+  map = cworld.getWorld()->getObject("map")->shapes_[0];
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < runs; ++r)
+  {
+    cworld.getWorld()->moveShapeInObject("map", map, Eigen::Isometry3d(Eigen::Translation3d(0.001 * (r % 2), 0, 0)));
+    cworld.rebuild("map");
+  }
+  std::chrono::duration<double> rebuild = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < runs; ++r)
+    cworld.getWorld()->moveShapeInObject("map", map, Eigen::Isometry3d(Eigen::Translation3d(0.001 * (r % 2), 0, 0)));
+  std::chrono::duration<double> refit = std::chrono::steady_clock::now() - start;
+
+  collision_detection::CollisionRequest req;
+  start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < runs; ++r)
+  {
+    collision_detection::CollisionResult res;
+    cworld.checkRobotCollision(req, res, crobot, state);
+  }
+  std::chrono::duration<double> check = std::chrono::steady_clock::now() - start;
+
+  std::cerr << "octree with " << octree->getNumLeafNodes() << " leaves at " << resolution
+            << "m: replace object " << 1000. * replace.count() / runs << "ms, move + rebuild "
+            << 1000. * rebuild.count() / runs << "ms (includes refit), move + refit " << 1000. * refit.count() / runs
+            << "ms, robot collision check " << 1000. * check.count() / runs << "ms" << std::endl;
+}
+
+TEST(CollisionWorldFCLTiming, OctreeUpdates5cm)
+{
+  benchmarkOctreeUpdates(0.05, 0.1, 100);
+}
+
+TEST(CollisionWorldFCLTiming, OctreeUpdates2cm)
+{
+  benchmarkOctreeUpdates(0.02, 0.05, 100);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
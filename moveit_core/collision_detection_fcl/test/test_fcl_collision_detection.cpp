@@ -42,6 +42,8 @@
 
 #include <urdf_parser/urdf_parser.h>
 #include <geometric_shapes/shape_operations.h>
+#include <octomap/octomap.h>
+#include <random_numbers/random_numbers.h>
 
 #include <gtest/gtest.h>
 #include <sstream>
@@ -143,6 +145,44 @@ TEST_F(FclCollisionDetectionTester, LinksInCollision)
   ASSERT_TRUE(res3.collision);
 }
 
+TEST_F(FclCollisionDetectionTester, LinkBroadPhaseFollowsState)
+{
+  collision_detection::CollisionRequest req;
+
+  robot_state::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  acm_->setEntry("r_gripper_palm_link", "l_gripper_palm_link", false);
+
+  // the broadphase of this thread is reused between the checks, so it must pick up every transform change
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    robot_state.setToDefaultValues();
+    robot_state.update();
+    collision_detection::CollisionResult res1;
+    crobot_->checkSelfCollision(req, res1, robot_state, *acm_);
+    EXPECT_FALSE(res1.collision);
+
+    Eigen::Isometry3d offset = Eigen::Isometry3d::Identity();
+    offset.translation().x() = .01;
+    robot_state.updateStateWithLinkAt("r_gripper_palm_link", Eigen::Isometry3d::Identity());
+    robot_state.updateStateWithLinkAt("l_gripper_palm_link", offset);
+    robot_state.update();
+    collision_detection::CollisionResult res2;
+    crobot_->checkSelfCollision(req, res2, robot_state, *acm_);
+    EXPECT_TRUE(res2.collision);
+  }
+
+  // changing the padding must not reuse the broadphase built for the old geometry
+  robot_state.setToDefaultValues();
+  robot_state.update();
+  crobot_->setLinkPadding("r_gripper_palm_link", 1.0);
+  collision_detection::CollisionResult res3;
+  crobot_->checkSelfCollision(req, res3, robot_state, *acm_);
+  EXPECT_TRUE(res3.collision);
+}
+
 TEST_F(FclCollisionDetectionTester, ContactReporting)
 {
   collision_detection::CollisionRequest req;
@@ -334,6 +374,106 @@ TEST_F(FclCollisionDetectionTester, AttachedBodyTester)
   ASSERT_TRUE(res.collision);
 }
 
+TEST_F(FclCollisionDetectionTester, AttachedBodyObjectsFollowState)
+{
+  collision_detection::CollisionRequest req;
+
+  robot_state::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  std::vector<shapes::ShapeConstPtr> shapes(1, shapes::ShapeConstPtr(new shapes::Box(.1, .1, .1)));
+  EigenSTL::vector_Isometry3d poses(1, Eigen::Isometry3d::Identity());
+  std::vector<std::string> touch_links;
+  robot_state.attachBody("box", shapes, poses, touch_links, "r_gripper_palm_link");
+  robot_state.update();
+
+  collision_detection::CollisionResult res1;
+  crobot_->checkSelfCollision(req, res1, robot_state, *acm_);
+  EXPECT_TRUE(res1.collision);
+
+  // a copy of the state holds its own copy of the attached body, which reuses the cached objects
+  robot_state::RobotState state_copy(robot_state);
+  collision_detection::CollisionResult res2;
+  crobot_->checkSelfCollision(req, res2, state_copy, *acm_);
+  EXPECT_TRUE(res2.collision);
+
+  robot_state.clearAttachedBody("box");
+  robot_state.update();
+  collision_detection::CollisionResult res3;
+  crobot_->checkSelfCollision(req, res3, robot_state, *acm_);
+  EXPECT_FALSE(res3.collision);
+
+  // attaching the same shapes at a different pose moves the cached objects
+  poses[0].translation().x() = 2.0;
+  robot_state.attachBody("box", shapes, poses, touch_links, "r_gripper_palm_link");
+  robot_state.update();
+  collision_detection::CollisionResult res4;
+  crobot_->checkSelfCollision(req, res4, robot_state, *acm_);
+  EXPECT_FALSE(res4.collision);
+}
+
+TEST_F(FclCollisionDetectionTester, ContinuousSelfCollision)
+{
+  collision_detection::CollisionRequest req;
+
+  robot_state::RobotState state1(robot_model_);
+  state1.setToDefaultValues();
+  state1.update();
+
+  robot_state::RobotState state2(state1);
+  collision_detection::CollisionResult res1;
+  crobot_->checkSelfCollision(req, res1, state1, state2, *acm_);
+  EXPECT_FALSE(res1.collision);
+
+  Eigen::Isometry3d offset = Eigen::Isometry3d::Identity();
+  offset.translation().x() = .01;
+  state2.updateStateWithLinkAt("r_gripper_palm_link", Eigen::Isometry3d::Identity());
+  state2.updateStateWithLinkAt("l_gripper_palm_link", offset);
+  state2.update();
+  acm_->setEntry("r_gripper_palm_link", "l_gripper_palm_link", false);
+
+  collision_detection::CollisionResult res2;
+  crobot_->checkSelfCollision(req, res2, state1, state2, *acm_);
+  EXPECT_TRUE(res2.collision);
+}
+
+TEST_F(FclCollisionDetectionTester, ContinuousWorldCollision)
+{
+  collision_detection::CollisionRequest req;
+
+  // a thin wall the robot base passes through, without touching it at either end of the motion
+  shapes::ShapeConstPtr wall(new shapes::Box(.02, 10.0, 3.0));
+  cworld_->getWorld()->addToObject("wall", wall, Eigen::Isometry3d::Identity());
+
+  robot_state::RobotState state1(robot_model_);
+  state1.setToDefaultValues();
+  state1.setVariablePosition("world_joint/x", -3.0);
+  state1.update();
+
+  robot_state::RobotState state2(state1);
+  state2.setVariablePosition("world_joint/x", 3.0);
+  state2.update();
+
+  collision_detection::CollisionResult res1;
+  cworld_->checkRobotCollision(req, res1, *crobot_, state1, *acm_);
+  EXPECT_FALSE(res1.collision);
+  collision_detection::CollisionResult res2;
+  cworld_->checkRobotCollision(req, res2, *crobot_, state2, *acm_);
+  EXPECT_FALSE(res2.collision);
+
+  collision_detection::CollisionResult res3;
+  cworld_->checkRobotCollision(req, res3, *crobot_, state1, state2, *acm_);
+  EXPECT_TRUE(res3.collision);
+
+  // moving away from the wall is fine
+  state2.setVariablePosition("world_joint/x", -4.0);
+  state2.update();
+  collision_detection::CollisionResult res4;
+  cworld_->checkRobotCollision(req, res4, *crobot_, state1, state2, *acm_);
+  EXPECT_FALSE(res4.collision);
+}
+
 TEST_F(FclCollisionDetectionTester, DiffSceneTester)
 {
   robot_state::RobotState robot_state(robot_model_);
@@ -493,6 +633,112 @@ TEST_F(FclCollisionDetectionTester, MoveMesh)
   }
 }
 
+TEST_F(FclCollisionDetectionTester, MoveOctreeInPlace)
+{
+  robot_state::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  // a small occupied region inside the robot base
+  std::shared_ptr<octomap::OcTree> octree = std::make_shared<octomap::OcTree>(0.02);
+  for (double x = -0.1; x < 0.1; x += 0.02)
+    for (double y = -0.1; y < 0.1; y += 0.02)
+      octree->updateNode(octomap::point3d(x, y, 0.15), true);
+  shapes::ShapeConstPtr map(new shapes::OcTree(octree));
+  cworld_->getWorld()->addToObject("map", map, Eigen::Isometry3d::Identity());
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res1;
+  cworld_->checkRobotCollision(req, res1, *crobot_, robot_state, *acm_);
+  EXPECT_TRUE(res1.collision);
+
+  // a copy of the world shares the FCL objects, which must not move along with the original
+  collision_detection::WorldPtr world_copy(new collision_detection::World(*cworld_->getWorld()));
+  DefaultCWorldType cworld_copy(dynamic_cast<const DefaultCWorldType&>(*cworld_), world_copy);
+
+  cworld_->getWorld()->moveShapeInObject("map", map, Eigen::Isometry3d(Eigen::Translation3d(5.0, 0.0, 0.0)));
+  collision_detection::CollisionResult res2;
+  cworld_->checkRobotCollision(req, res2, *crobot_, robot_state, *acm_);
+  EXPECT_FALSE(res2.collision);
+
+  collision_detection::CollisionResult res3;
+  cworld_copy.checkRobotCollision(req, res3, *crobot_, robot_state, *acm_);
+  EXPECT_TRUE(res3.collision);
+
+  // moving it back refits the same objects
+  cworld_->getWorld()->moveShapeInObject("map", map, Eigen::Isometry3d::Identity());
+  collision_detection::CollisionResult res4;
+  cworld_->checkRobotCollision(req, res4, *crobot_, robot_state, *acm_);
+  EXPECT_TRUE(res4.collision);
+}
+
+TEST_F(FclCollisionDetectionTester, DistanceCacheMatchesUncachedQueries)
+{
+  collision_detection::AllowedCollisionMatrix acm;
+  const std::vector<std::string>& links = robot_model_->getLinkModelNamesWithCollisionGeometry();
+  acm.setEntry(links, links, false);
+  for (const srdf::Model::DisabledCollision& dc : robot_model_->getSRDF()->getDisabledCollisionPairs())
+    acm.setEntry(dc.link1_, dc.link2_, true);
+
+  cworld_->getWorld()->addToObject("box", shapes::ShapeConstPtr(new shapes::Box(0.2, 0.2, 0.2)),
+                                   Eigen::Isometry3d(Eigen::Translation3d(0.8, 0.3, 0.9)));
+  cworld_->getWorld()->addToObject("sphere", shapes::ShapeConstPtr(new shapes::Sphere(0.1)),
+                                   Eigen::Isometry3d(Eigen::Translation3d(0.6, -0.4, 1.1)));
+
+  collision_detection::DistanceCache cache;
+  collision_detection::DistanceRequest req;
+  req.acm = &acm;
+  collision_detection::DistanceRequest cached_req = req;
+  cached_req.cache = &cache;
+  collision_detection::DistanceRequest single_req = req;
+  single_req.type = collision_detection::DistanceRequestType::SINGLE;
+  single_req.distance_threshold = 0.3;
+
+  auto expect_same = [](const collision_detection::DistanceResult& res,
+                        const collision_detection::DistanceResult& cached_res) {
+    EXPECT_EQ(res.collision, cached_res.collision);
+    EXPECT_EQ(res.distances.size(), cached_res.distances.size());
+    if (!res.collision)
+      EXPECT_NEAR(res.minimum_distance.distance, cached_res.minimum_distance.distance, 1e-9);
+  };
+
+  // small steps towards random targets, like consecutive queries of a planner or controller
+  random_numbers::RandomNumberGenerator rng(42);
+  robot_state::RobotState start(robot_model_), target(robot_model_), state(robot_model_);
+  start.setToDefaultValues();
+  for (unsigned int i = 0; i < 5; ++i)
+  {
+    target.setToRandomPositions(robot_model_->getJointModelGroup("right_arm"), rng);
+    for (unsigned int step = 0; step <= 20; ++step)
+    {
+      start.interpolate(target, step / 20.0, state);
+      state.update();
+
+      collision_detection::DistanceResult res, cached_res;
+      crobot_->distanceSelf(req, res, state);
+      crobot_->distanceSelf(cached_req, cached_res, state);
+      expect_same(res, cached_res);
+
+      res.clear();
+      cached_res.clear();
+      cworld_->distanceRobot(req, res, *crobot_, state);
+      cworld_->distanceRobot(cached_req, cached_res, *crobot_, state);
+      expect_same(res, cached_res);
+
+      // the cache of the thread is used by requests without a cache
+      res.clear();
+      cached_res.clear();
+      cworld_->distanceRobot(single_req, res, *crobot_, state);
+      collision_detection::DistanceCache::enableThreadCache(true);
+      cworld_->distanceRobot(single_req, cached_res, *crobot_, state);
+      collision_detection::DistanceCache::enableThreadCache(false);
+      expect_same(res, cached_res);
+    }
+    start = target;
+  }
+  EXPECT_EQ(collision_detection::DistanceCache::getThreadCache(), nullptr);
+}
+
 TEST_F(FclCollisionDetectionTester, TestChangingShapeSize)
 {
   robot_state::RobotState robot_state1(robot_model_);
@@ -543,6 +789,74 @@ TEST_F(FclCollisionDetectionTester, TestChangingShapeSize)
   }
 }
 
+TEST(FclGeometryBound, DisjointBoundsMeanNoCollision)
+{
+  collision_detection::FCLGeometryBound bound;
+  collision_detection::computeGeometryBound(shapes::Box(0.8, 0.1, 0.1), bound);
+  ASSERT_TRUE(bound.has_obb);
+  EXPECT_NEAR(bound.sphere_radius, Eigen::Vector3d(0.4, 0.05, 0.05).norm(), 1e-12);
+
+  // two parallel thin boxes side by side: the spheres overlap, the boxes do not
+  Eigen::Matrix3d identity = Eigen::Matrix3d::Identity();
+  EXPECT_TRUE(collision_detection::boundsDisjoint(bound, identity, Eigen::Vector3d::Zero(), bound, identity,
+                                                  Eigen::Vector3d(0.0, 0.2, 0.0)));
+  EXPECT_FALSE(collision_detection::boundsDisjoint(bound, identity, Eigen::Vector3d::Zero(), bound, identity,
+                                                   Eigen::Vector3d(0.0, 0.09, 0.0)));
+
+  // bounds are conservative: if they are disjoint, no point of one box is inside the other one
+  random_numbers::RandomNumberGenerator rng(42);
+  for (unsigned int i = 0; i < 1000; ++i)
+  {
+    double q1[4], q2[4];
+    rng.quaternion(q1);
+    rng.quaternion(q2);
+    Eigen::Matrix3d r1 = Eigen::Quaterniond(q1[3], q1[0], q1[1], q1[2]).toRotationMatrix();
+    Eigen::Matrix3d r2 = Eigen::Quaterniond(q2[3], q2[0], q2[1], q2[2]).toRotationMatrix();
+    Eigen::Vector3d t1(rng.uniformReal(-0.5, 0.5), rng.uniformReal(-0.5, 0.5), rng.uniformReal(-0.5, 0.5));
+    Eigen::Vector3d t2(rng.uniformReal(-0.5, 0.5), rng.uniformReal(-0.5, 0.5), rng.uniformReal(-0.5, 0.5));
+    if (!collision_detection::boundsDisjoint(bound, r1, t1, bound, r2, t2))
+      continue;
+    for (double x = -0.4; x <= 0.4; x += 0.05)
+      for (double y : { -0.05, 0.0, 0.05 })
+        for (double z : { -0.05, 0.0, 0.05 })
+        {
+          Eigen::Vector3d p = r2.transpose() * (r1 * Eigen::Vector3d(x, y, z) + t1 - t2);
+          EXPECT_FALSE(std::abs(p.x()) < 0.4 && std::abs(p.y()) < 0.05 && std::abs(p.z()) < 0.05);
+        }
+  }
+}
+
+TEST_F(FclCollisionDetectionTester, BoundsRejectPairsBeforeNarrowphase)
+{
+  collision_detection::AllowedCollisionMatrix acm;
+  const std::vector<std::string>& links = robot_model_->getLinkModelNamesWithCollisionGeometry();
+  acm.setEntry(links, links, false);
+  for (const srdf::Model::DisabledCollision& dc : robot_model_->getSRDF()->getDisabledCollisionPairs())
+    acm.setEntry(dc.link1_, dc.link2_, true);
+
+  robot_state::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  crobot_->checkSelfCollision(req, res, robot_state, acm);
+  EXPECT_FALSE(res.collision);
+  EXPECT_GT(res.checked_pairs, 0u);
+  EXPECT_GT(res.bound_rejected_pairs, 0u);
+  EXPECT_LE(res.bound_rejected_pairs, res.checked_pairs);
+
+  res.clear();
+  EXPECT_EQ(res.checked_pairs, 0u);
+  EXPECT_EQ(res.bound_rejected_pairs, 0u);
+
+  // cost sources come from the narrowphase, so cost queries check every pair in detail
+  req.cost = true;
+  crobot_->checkSelfCollision(req, res, robot_state, acm);
+  EXPECT_GT(res.checked_pairs, 0u);
+  EXPECT_EQ(res.bound_rejected_pairs, 0u);
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,144 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_COLLISION_DISTANCE_FIELD_COLLISION_COMMON_SPHERES_
+#define MOVEIT_COLLISION_DISTANCE_FIELD_COLLISION_COMMON_SPHERES_
+
+#include <geometric_shapes/shapes.h>
+#include <Eigen/Geometry>
+#include <cstddef>
+#include <vector>
+
+namespace collision_detection
+{
+/** \brief How shapes are approximated by spheres */
+enum class SphereApproximation
+{
+  /** \brief The spheres of the bounding cylinder axis used by the distance field checker (see
+      determineCollisionSpheres()). They may not cover the ends of a shape. */
+  APPROXIMATE,
+
+  /** \brief Spheres that cover each shape entirely, so no collision is missed */
+  CONSERVATIVE
+};
+
+/** \brief A set of spheres in structure-of-arrays layout, so the kernels below can test several spheres with one
+    instruction. Also stores a bounding sphere of the whole set. */
+struct SphereSet
+{
+  SphereSet() : bound_center(Eigen::Vector3d::Zero()), bound_radius(-1.0)
+  {
+  }
+
+  std::size_t size() const
+  {
+    return x.size();
+  }
+
+  bool empty() const
+  {
+    return x.empty();
+  }
+
+  void clear()
+  {
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+    bound_radius = -1.0;
+  }
+
+  void add(const Eigen::Vector3d& center, double r)
+  {
+    x.push_back(center.x());
+    y.push_back(center.y());
+    z.push_back(center.z());
+    radius.push_back(r);
+  }
+
+  /** \brief Compute \e bound_center and \e bound_radius from the spheres (the bound is not minimal) */
+  void updateBound();
+
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+  std::vector<double> radius;
+
+  /** \brief A sphere enclosing all spheres of the set; the radius is negative for an empty set */
+  Eigen::Vector3d bound_center;
+  double bound_radius;
+};
+
+/** \brief Set \e out to the spheres of \e in transformed by \e pose, including the bound */
+void transformSpheres(const SphereSet& in, const Eigen::Isometry3d& pose, SphereSet& out);
+
+/** \brief Append spheres approximating \e shape at \e pose to \e spheres. The shape is scaled and padded like
+    bodies::Body does, and \e sphere_padding is added to the radius of every sphere. Occupied octree cells become one
+    sphere each. Returns false for unbounded shapes (planes), which can not be approximated. */
+bool decomposeShape(const shapes::ShapeConstPtr& shape, const Eigen::Isometry3d& pose, double scale, double padding,
+                    SphereApproximation approximation, double sphere_padding, SphereSet& spheres);
+
+/** \brief Check if the sphere (\e center, \e radius) overlaps any sphere of \e spheres. If \e index is given, it is set
+    to the first overlapping sphere. */
+bool sphereOverlaps(const Eigen::Vector3d& center, double radius, const SphereSet& spheres,
+                    std::size_t* index = nullptr);
+
+/** \brief Set \e indices to all spheres of \e spheres that overlap the sphere (\e center, \e radius) */
+void findOverlappingSpheres(const Eigen::Vector3d& center, double radius, const SphereSet& spheres,
+                            std::vector<std::size_t>& indices);
+
+/** \brief Check if any sphere of \e a overlaps any sphere of \e b. If \e index_a and \e index_b are given, they are set
+    to an overlapping pair. */
+bool spheresOverlap(const SphereSet& a, const SphereSet& b, std::size_t* index_a = nullptr,
+                    std::size_t* index_b = nullptr);
+
+/** \brief Get the minimum over all pairs of the distance between the sphere surfaces (negative for overlaps) */
+double spheresDistance(const SphereSet& a, const SphereSet& b);
+
+/** \brief Check if the kernels use AVX2 instructions on this CPU */
+bool sphereKernelsUseAVX2();
+
+/** \brief Reference implementations of the kernels without SIMD instructions */
+namespace scalar
+{
+bool sphereOverlaps(const Eigen::Vector3d& center, double radius, const SphereSet& spheres,
+                    std::size_t* index = nullptr);
+void findOverlappingSpheres(const Eigen::Vector3d& center, double radius, const SphereSet& spheres,
+                            std::vector<std::size_t>& indices);
+double spheresDistance(const SphereSet& a, const SphereSet& b);
+}  // namespace scalar
+}  // namespace collision_detection
+
+#endif
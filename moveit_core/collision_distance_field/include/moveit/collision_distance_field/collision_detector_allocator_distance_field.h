@@ -49,7 +49,7 @@ class CollisionDetectorAllocatorDistanceField
                                                 CollisionDetectorAllocatorDistanceField>
 {
 public:
-  static const std::string NAME;  // defined in collision_world_distance_field.cpp
+  static const std::string NAME_;  // defined in collision_world_distance_field.cpp
 };
 }
 
@@ -49,7 +49,7 @@ class CollisionDetectorAllocatorHybrid
                                                 CollisionDetectorAllocatorHybrid>
 {
 public:
-  static const std::string NAME;  // defined in collision_world_hybrid.cpp
+  static const std::string NAME_;  // defined in collision_world_hybrid.cpp
 };
 }
 
@@ -0,0 +1,143 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_COLLISION_DISTANCE_FIELD_COLLISION_ROBOT_SPHERES_
+#define MOVEIT_COLLISION_DISTANCE_FIELD_COLLISION_ROBOT_SPHERES_
+
+#include <moveit/collision_detection_fcl/collision_robot_fcl.h>
+#include <moveit/collision_distance_field/collision_common_spheres.h>
+
+namespace collision_detection
+{
+/** \brief The spheres of a robot link or of a body attached to it, in the world frame */
+struct RobotBodySpheres
+{
+  /** \brief The link, or the link the body is attached to */
+  const robot_model::LinkModel* link;
+
+  /** \brief The attached body, or nullptr for the spheres of the link itself */
+  const robot_state::AttachedBody* attached_body;
+
+  /** \brief The ID of the link or attached body in CompiledAllowedCollisionMatrix */
+  CompiledAllowedCollisionMatrix::NameID name_id;
+
+  SphereSet spheres;
+
+  const std::string& getID() const
+  {
+    return attached_body ? attached_body->getName() : link->getName();
+  }
+};
+
+/** \brief A collision robot that checks discrete collisions on sphere approximations of its links.
+
+    Pairs of bodies whose spheres do not overlap are not in collision (in conservative mode). If spheres overlap and
+    refinement is enabled (the default), the state is checked again with FCL, so the results are exact; otherwise the
+    overlap is reported as a collision with an approximate contact. Distance and cost queries, continuous checks and
+    checks against other robots are always answered by FCL. */
+class CollisionRobotSpheres : public CollisionRobotFCL
+{
+public:
+  CollisionRobotSpheres(const robot_model::RobotModelConstPtr& robot_model, double padding = 0.0,
+                        double scale = 1.0);
+
+  CollisionRobotSpheres(const CollisionRobotSpheres& other);
+
+  /** \brief Set how links are approximated by spheres and the padding added to every sphere */
+  void setApproximation(SphereApproximation approximation, double sphere_padding);
+
+  SphereApproximation getApproximation() const
+  {
+    return approximation_;
+  }
+
+  double getSpherePadding() const
+  {
+    return sphere_padding_;
+  }
+
+  /** \brief Enable or disable checking states with FCL when spheres overlap */
+  void setRefineContacts(bool refine)
+  {
+    refine_contacts_ = refine;
+  }
+
+  bool getRefineContacts() const
+  {
+    return refine_contacts_;
+  }
+
+  /** \brief Set \e bodies to the spheres of the links (with geometry) and attached bodies of \e state */
+  void getPosedSpheres(const robot_state::RobotState& state, std::vector<RobotBodySpheres>& bodies) const;
+
+  void checkSelfCollision(const CollisionRequest& req, CollisionResult& res,
+                          const robot_state::RobotState& state) const override;
+  void checkSelfCollision(const CollisionRequest& req, CollisionResult& res, const robot_state::RobotState& state,
+                          const AllowedCollisionMatrix& acm) const override;
+  using CollisionRobotFCL::checkSelfCollision;
+
+protected:
+  void updatedPaddingOrScaling(const std::vector<std::string>& links) override;
+
+  /** \brief Compute the spheres of all links in their link frames */
+  void decomposeLinks();
+
+  void checkSelfCollisionSpheres(const CollisionRequest& req, CollisionResult& res,
+                                 const robot_state::RobotState& state, const AllowedCollisionMatrix* acm) const;
+
+  SphereApproximation approximation_;
+  double sphere_padding_;
+  bool refine_contacts_;
+
+  /** \brief The spheres of each link in its frame, indexed by link index */
+  std::vector<SphereSet> link_spheres_;
+
+  /** \brief The IDs of the link names in CompiledAllowedCollisionMatrix, indexed by link index */
+  std::vector<CompiledAllowedCollisionMatrix::NameID> link_name_ids_;
+};
+
+/** \brief Check if a pair of robot bodies needs a collision check, based on the active components, the touch links
+    of attached bodies and the allowed collision matrix (may be nullptr) */
+bool needsSphereCheck(const RobotBodySpheres& b1, const RobotBodySpheres& b2,
+                      const std::set<const robot_model::LinkModel*>* active_components,
+                      const CompiledAllowedCollisionMatrix* acm);
+
+/** \brief Record a collision between \e spheres1 and \e spheres2 found at the overlapping spheres \e index1 and \e index2
+    in \e res, adding an approximate contact if requested. Returns true when the check can stop. */
+bool addSphereContact(const CollisionRequest& req, CollisionResult& res, const SphereSet& spheres1,
+                      std::size_t index1, const std::string& name1, BodyType type1, const SphereSet& spheres2,
+                      std::size_t index2, const std::string& name2, BodyType type2);
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_COLLISION_DISTANCE_FIELD_COLLISION_WORLD_SPHERES_
+#define MOVEIT_COLLISION_DISTANCE_FIELD_COLLISION_WORLD_SPHERES_
+
+#include <moveit/collision_detection_fcl/collision_world_fcl.h>
+#include <moveit/collision_distance_field/collision_robot_spheres.h>
+
+namespace collision_detection
+{
+/** \brief A collision world that checks discrete robot collisions on sphere approximations of the world objects.
+
+    The spheres of each object are split into blocks of neighboring spheres (octree cells are enumerated in spatial
+    order), and the bounding spheres of all blocks are searched with one kernel call per robot body. As for
+    CollisionRobotSpheres, overlaps are refined with FCL by default. Worlds with unbounded objects (planes) and all
+    other queries are handled by FCL. */
+class CollisionWorldSpheres : public CollisionWorldFCL
+{
+public:
+  CollisionWorldSpheres();
+  explicit CollisionWorldSpheres(const WorldPtr& world);
+  CollisionWorldSpheres(const CollisionWorldSpheres& other, const WorldPtr& world);
+  ~CollisionWorldSpheres() override;
+
+  /** \brief Set how objects are approximated by spheres and the padding added to every sphere */
+  void setApproximation(SphereApproximation approximation, double sphere_padding);
+
+  SphereApproximation getApproximation() const
+  {
+    return approximation_;
+  }
+
+  double getSpherePadding() const
+  {
+    return sphere_padding_;
+  }
+
+  /** \brief Enable or disable checking states with FCL when spheres overlap */
+  void setRefineContacts(bool refine)
+  {
+    refine_contacts_ = refine;
+  }
+
+  bool getRefineContacts() const
+  {
+    return refine_contacts_;
+  }
+
+  void checkRobotCollision(const CollisionRequest& req, CollisionResult& res, const CollisionRobot& robot,
+                           const robot_state::RobotState& state) const override;
+  void checkRobotCollision(const CollisionRequest& req, CollisionResult& res, const CollisionRobot& robot,
+                           const robot_state::RobotState& state, const AllowedCollisionMatrix& acm) const override;
+  using CollisionWorldFCL::checkRobotCollision;
+
+  void setWorld(const WorldPtr& world) override;
+
+protected:
+  /** \brief The spheres of a world object */
+  struct ObjectSpheres
+  {
+    std::string id;
+
+    /** \brief The ID of \e id in CompiledAllowedCollisionMatrix */
+    CompiledAllowedCollisionMatrix::NameID name_id;
+
+    /** \brief True if some shape of the object can not be approximated by spheres */
+    bool unbounded;
+
+    /** \brief Blocks of at most BLOCK_SIZE neighboring spheres, each with its bound */
+    std::vector<SphereSet> blocks;
+  };
+
+  static const std::size_t BLOCK_SIZE = 32;
+
+  void checkRobotCollisionSpheres(const CollisionRequest& req, CollisionResult& res, const CollisionRobot& robot,
+                                  const robot_state::RobotState& state, const AllowedCollisionMatrix* acm) const;
+
+  void updateObjectSpheres(const World::Object& obj);
+  void updateBlockIndex();
+
+  SphereApproximation approximation_;
+  double sphere_padding_;
+  bool refine_contacts_;
+
+  std::map<std::string, ObjectSpheres> object_spheres_;
+
+  /** \brief The bounding spheres of all blocks of all objects, with the block and its object for each of them */
+  SphereSet block_bounds_;
+  std::vector<const SphereSet*> blocks_;
+  std::vector<const ObjectSpheres*> block_objects_;
+
+  /** \brief The number of objects that can not be approximated by spheres */
+  std::size_t unbounded_objects_;
+
+private:
+  void notifyObjectChange(const ObjectConstPtr& obj, World::Action action);
+  World::ObserverHandle observer_handle_;
+};
+}
+
+#endif
@@ -0,0 +1,403 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_distance_field/collision_common_spheres.h>
+#include <moveit/collision_distance_field/collision_distance_field_types.h>
+#include <geometric_shapes/bodies.h>
+#include <geometric_shapes/body_operations.h>
+#include <octomap/OcTree.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+// the AVX2 kernels are compiled for the target only and selected at runtime, so the library still runs without AVX2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MOVEIT_SPHERE_KERNELS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace collision_detection
+{
+void SphereSet::updateBound()
+{
+  if (empty())
+  {
+    bound_radius = -1.0;
+    return;
+  }
+  Eigen::Vector3d min(x[0], y[0], z[0]);
+  Eigen::Vector3d max = min;
+  for (std::size_t i = 1; i < size(); ++i)
+  {
+    min = min.cwiseMin(Eigen::Vector3d(x[i], y[i], z[i]));
+    max = max.cwiseMax(Eigen::Vector3d(x[i], y[i], z[i]));
+  }
+  bound_center = (min + max) / 2.0;
+  bound_radius = 0.0;
+  for (std::size_t i = 0; i < size(); ++i)
+    bound_radius = std::max(bound_radius, (Eigen::Vector3d(x[i], y[i], z[i]) - bound_center).norm() + radius[i]);
+}
+
+void transformSpheres(const SphereSet& in, const Eigen::Isometry3d& pose, SphereSet& out)
+{
+  const std::size_t n = in.size();
+  out.x.resize(n);
+  out.y.resize(n);
+  out.z.resize(n);
+  out.radius.assign(in.radius.begin(), in.radius.end());
+
+  const Eigen::Matrix3d r = pose.linear();
+  const Eigen::Vector3d t = pose.translation();
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    out.x[i] = r(0, 0) * in.x[i] + r(0, 1) * in.y[i] + r(0, 2) * in.z[i] + t.x();
+    out.y[i] = r(1, 0) * in.x[i] + r(1, 1) * in.y[i] + r(1, 2) * in.z[i] + t.y();
+    out.z[i] = r(2, 0) * in.x[i] + r(2, 1) * in.y[i] + r(2, 2) * in.z[i] + t.z();
+  }
+  out.bound_center = pose * in.bound_center;
+  out.bound_radius = in.bound_radius;
+}
+
+bool decomposeShape(const shapes::ShapeConstPtr& shape, const Eigen::Isometry3d& pose, double scale, double padding,
+                    SphereApproximation approximation, double sphere_padding, SphereSet& spheres)
+{
+  switch (shape->type)
+  {
+    case shapes::PLANE:
+      return false;
+
+    case shapes::SPHERE:
+      spheres.add(pose.translation(),
+                  static_cast<const shapes::Sphere*>(shape.get())->radius * scale + padding + sphere_padding);
+      return true;
+
+    case shapes::OCTREE:
+    {
+      // one sphere per occupied cell, enclosing the cell in conservative mode and inscribed otherwise
+      const std::shared_ptr<const octomap::OcTree>& octree = static_cast<const shapes::OcTree*>(shape.get())->octree;
+      const double factor = approximation == SphereApproximation::CONSERVATIVE ? std::sqrt(3.0) / 2.0 : 0.5;
+      for (auto it = octree->begin_leafs(), end = octree->end_leafs(); it != end; ++it)
+        if (octree->isNodeOccupied(*it))
+          spheres.add(pose * Eigen::Vector3d(it.getX(), it.getY(), it.getZ()),
+                      it.getSize() * factor + padding + sphere_padding);
+      return true;
+    }
+
+    default:
+      break;
+  }
+
+  std::unique_ptr<bodies::Body> body(bodies::createBodyFromShape(shape.get()));
+  if (!body)
+    return false;
+  body->setScale(scale);
+  body->setPadding(padding);
+  body->setPose(pose);
+
+  if (approximation == SphereApproximation::APPROXIMATE)
+  {
+    Eigen::Isometry3d relative_transform;
+    std::vector<CollisionSphere> css = determineCollisionSpheres(body.get(), relative_transform);
+    for (const CollisionSphere& cs : css)
+      spheres.add(pose * cs.relative_vec_, cs.radius_ + sphere_padding);
+
+    // short shapes do not get any spheres along their axis
+    if (css.empty())
+    {
+      bodies::BoundingSphere bs;
+      body->computeBoundingSphere(bs);
+      spheres.add(bs.center, bs.radius + sphere_padding);
+    }
+    return true;
+  }
+
+  // cover the bounding cylinder with spheres of its radius R at spacing s along the axis; each of them encloses a
+  // slice of height s, whose farthest point is sqrt(R^2 + (s/2)^2) away from the center of the sphere
+  bodies::BoundingCylinder cyl;
+  body->computeBoundingCylinder(cyl);
+  const std::size_t count = std::max<std::size_t>(1, std::ceil(cyl.length / std::max(cyl.radius, 1e-6)));
+  const double spacing = cyl.length / count;
+  const double r = std::sqrt(cyl.radius * cyl.radius + spacing * spacing / 4.0) + sphere_padding;
+  for (std::size_t i = 0; i < count; ++i)
+    spheres.add(cyl.pose * Eigen::Vector3d(0.0, 0.0, -cyl.length / 2.0 + spacing * (i + 0.5)), r);
+  return true;
+}
+
+namespace scalar
+{
+bool sphereOverlaps(const Eigen::Vector3d& center, double radius, const SphereSet& spheres, std::size_t* index)
+{
+  for (std::size_t i = 0; i < spheres.size(); ++i)
+  {
+    const double dx = spheres.x[i] - center.x();
+    const double dy = spheres.y[i] - center.y();
+    const double dz = spheres.z[i] - center.z();
+    const double r = spheres.radius[i] + radius;
+    if (dx * dx + dy * dy + dz * dz < r * r)
+    {
+      if (index)
+        *index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+void findOverlappingSpheres(const Eigen::Vector3d& center, double radius, const SphereSet& spheres,
+                            std::vector<std::size_t>& indices)
+{
+  indices.clear();
+  for (std::size_t i = 0; i < spheres.size(); ++i)
+  {
+    const double dx = spheres.x[i] - center.x();
+    const double dy = spheres.y[i] - center.y();
+    const double dz = spheres.z[i] - center.z();
+    const double r = spheres.radius[i] + radius;
+    if (dx * dx + dy * dy + dz * dz < r * r)
+      indices.push_back(i);
+  }
+}
+
+double spheresDistance(const SphereSet& a, const SphereSet& b)
+{
+  double min_distance = std::numeric_limits<double>::max();
+  for (std::size_t i = 0; i < a.size(); ++i)
+    for (std::size_t j = 0; j < b.size(); ++j)
+    {
+      const double dx = b.x[j] - a.x[i];
+      const double dy = b.y[j] - a.y[i];
+      const double dz = b.z[j] - a.z[i];
+      min_distance = std::min(min_distance, std::sqrt(dx * dx + dy * dy + dz * dz) - a.radius[i] - b.radius[j]);
+    }
+  return min_distance;
+}
+}  // namespace scalar
+
+#ifdef MOVEIT_SPHERE_KERNELS_AVX2
+namespace
+{
+__attribute__((target("avx2"))) bool sphereOverlapsAVX2(const Eigen::Vector3d& center, double radius,
+                                                         const SphereSet& spheres, std::size_t* index)
+{
+  const std::size_t n = spheres.size();
+  const __m256d cx = _mm256_set1_pd(center.x());
+  const __m256d cy = _mm256_set1_pd(center.y());
+  const __m256d cz = _mm256_set1_pd(center.z());
+  const __m256d cr = _mm256_set1_pd(radius);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(&spheres.x[i]), cx);
+    const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(&spheres.y[i]), cy);
+    const __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(&spheres.z[i]), cz);
+    const __m256d r = _mm256_add_pd(_mm256_loadu_pd(&spheres.radius[i]), cr);
+    const __m256d d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+    const int mask = _mm256_movemask_pd(_mm256_cmp_pd(d2, _mm256_mul_pd(r, r), _CMP_LT_OQ));
+    if (mask)
+    {
+      if (index)
+        *index = i + __builtin_ctz(mask);
+      return true;
+    }
+  }
+
+  // remaining spheres
+  for (; i < n; ++i)
+  {
+    const double dx = spheres.x[i] - center.x();
+    const double dy = spheres.y[i] - center.y();
+    const double dz = spheres.z[i] - center.z();
+    const double r = spheres.radius[i] + radius;
+    if (dx * dx + dy * dy + dz * dz < r * r)
+    {
+      if (index)
+        *index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+__attribute__((target("avx2"))) void findOverlappingSpheresAVX2(const Eigen::Vector3d& center, double radius,
+                                                                 const SphereSet& spheres,
+                                                                 std::vector<std::size_t>& indices)
+{
+  indices.clear();
+  const std::size_t n = spheres.size();
+  const __m256d cx = _mm256_set1_pd(center.x());
+  const __m256d cy = _mm256_set1_pd(center.y());
+  const __m256d cz = _mm256_set1_pd(center.z());
+  const __m256d cr = _mm256_set1_pd(radius);
+
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(&spheres.x[i]), cx);
+    const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(&spheres.y[i]), cy);
+    const __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(&spheres.z[i]), cz);
+    const __m256d r = _mm256_add_pd(_mm256_loadu_pd(&spheres.radius[i]), cr);
+    const __m256d d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+    int mask = _mm256_movemask_pd(_mm256_cmp_pd(d2, _mm256_mul_pd(r, r), _CMP_LT_OQ));
+    for (; mask; mask &= mask - 1)
+      indices.push_back(i + __builtin_ctz(mask));
+  }
+
+  for (; i < n; ++i)
+  {
+    const double dx = spheres.x[i] - center.x();
+    const double dy = spheres.y[i] - center.y();
+    const double dz = spheres.z[i] - center.z();
+    const double r = spheres.radius[i] + radius;
+    if (dx * dx + dy * dy + dz * dz < r * r)
+      indices.push_back(i);
+  }
+}
+
+__attribute__((target("avx2"))) double spheresDistanceAVX2(const SphereSet& a, const SphereSet& b)
+{
+  const std::size_t n = b.size();
+  double min_distance = std::numeric_limits<double>::max();
+  __m256d min4 = _mm256_set1_pd(min_distance);
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    const __m256d cx = _mm256_set1_pd(a.x[i]);
+    const __m256d cy = _mm256_set1_pd(a.y[i]);
+    const __m256d cz = _mm256_set1_pd(a.z[i]);
+    const __m256d cr = _mm256_set1_pd(a.radius[i]);
+
+    std::size_t j = 0;
+    for (; j + 4 <= n; j += 4)
+    {
+      const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(&b.x[j]), cx);
+      const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(&b.y[j]), cy);
+      const __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(&b.z[j]), cz);
+      const __m256d d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+      const __m256d d = _mm256_sub_pd(_mm256_sqrt_pd(d2), _mm256_add_pd(_mm256_loadu_pd(&b.radius[j]), cr));
+      min4 = _mm256_min_pd(min4, d);
+    }
+    for (; j < n; ++j)
+    {
+      const double dx = b.x[j] - a.x[i];
+      const double dy = b.y[j] - a.y[i];
+      const double dz = b.z[j] - a.z[i];
+      min_distance = std::min(min_distance, std::sqrt(dx * dx + dy * dy + dz * dz) - a.radius[i] - b.radius[j]);
+    }
+  }
+
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, min4);
+  return std::min(min_distance, std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3])));
+}
+
+bool detectAVX2()
+{
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+}  // namespace
+#endif
+
+bool sphereKernelsUseAVX2()
+{
+#ifdef MOVEIT_SPHERE_KERNELS_AVX2
+  static const bool use_avx2 = detectAVX2();
+  return use_avx2;
+#else
+  return false;
+#endif
+}
+
+bool sphereOverlaps(const Eigen::Vector3d& center, double radius, const SphereSet& spheres, std::size_t* index)
+{
+#ifdef MOVEIT_SPHERE_KERNELS_AVX2
+  if (sphereKernelsUseAVX2())
+    return sphereOverlapsAVX2(center, radius, spheres, index);
+#endif
+  return scalar::sphereOverlaps(center, radius, spheres, index);
+}
+
+void findOverlappingSpheres(const Eigen::Vector3d& center, double radius, const SphereSet& spheres,
+                            std::vector<std::size_t>& indices)
+{
+#ifdef MOVEIT_SPHERE_KERNELS_AVX2
+  if (sphereKernelsUseAVX2())
+  {
+    findOverlappingSpheresAVX2(center, radius, spheres, indices);
+    return;
+  }
+#endif
+  scalar::findOverlappingSpheres(center, radius, spheres, indices);
+}
+
+bool spheresOverlap(const SphereSet& a, const SphereSet& b, std::size_t* index_a, std::size_t* index_b)
+{
+  if (a.empty() || b.empty())
+    return false;
+
+  // the set bounds reject most pairs of far apart sets without looking at their spheres
+  if (a.bound_radius >= 0.0 && b.bound_radius >= 0.0 &&
+      (a.bound_center - b.bound_center).squaredNorm() >=
+          (a.bound_radius + b.bound_radius) * (a.bound_radius + b.bound_radius))
+    return false;
+
+  // iterate over the smaller set, so the kernel runs over the larger one
+  const bool swap = a.size() > b.size();
+  const SphereSet& outer = swap ? b : a;
+  const SphereSet& inner = swap ? a : b;
+  for (std::size_t i = 0; i < outer.size(); ++i)
+  {
+    std::size_t j;
+    if (sphereOverlaps(Eigen::Vector3d(outer.x[i], outer.y[i], outer.z[i]), outer.radius[i], inner, &j))
+    {
+      if (index_a)
+        *index_a = swap ? j : i;
+      if (index_b)
+        *index_b = swap ? i : j;
+      return true;
+    }
+  }
+  return false;
+}
+
+double spheresDistance(const SphereSet& a, const SphereSet& b)
+{
+#ifdef MOVEIT_SPHERE_KERNELS_AVX2
+  if (sphereKernelsUseAVX2())
+    return spheresDistanceAVX2(a, b);
+#endif
+  return scalar::spheresDistance(a, b);
+}
+}  // namespace collision_detection
@@ -0,0 +1,14 @@
+#include <moveit/collision_distance_field/collision_detector_spheres_plugin_loader.h>
+#include <pluginlib/class_list_macros.h>
+
+namespace collision_detection
+{
+bool CollisionDetectorSpheresPluginLoader::initialize(const planning_scene::PlanningScenePtr& scene,
+                                                      bool exclusive) const
+{
+  scene->setActiveCollisionDetector(CollisionDetectorAllocatorSpheres::create(), exclusive);
+  return true;
+}
+}
+
+PLUGINLIB_EXPORT_CLASS(collision_detection::CollisionDetectorSpheresPluginLoader, collision_detection::CollisionPlugin)
@@ -0,0 +1,251 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_distance_field/collision_robot_spheres.h>
+
+namespace collision_detection
+{
+static rclcpp::Logger LOGGER_COLLISION_ROBOT_SPHERES = rclcpp::get_logger("collision_detection.spheres");
+
+CollisionRobotSpheres::CollisionRobotSpheres(const robot_model::RobotModelConstPtr& robot_model, double padding,
+                                             double scale)
+  : CollisionRobotFCL(robot_model, padding, scale)
+  , approximation_(SphereApproximation::CONSERVATIVE)
+  , sphere_padding_(0.0)
+  , refine_contacts_(true)
+{
+  decomposeLinks();
+}
+
+CollisionRobotSpheres::CollisionRobotSpheres(const CollisionRobotSpheres& other)
+  : CollisionRobotFCL(other)
+  , approximation_(other.approximation_)
+  , sphere_padding_(other.sphere_padding_)
+  , refine_contacts_(other.refine_contacts_)
+  , link_spheres_(other.link_spheres_)
+  , link_name_ids_(other.link_name_ids_)
+{
+}
+
+void CollisionRobotSpheres::setApproximation(SphereApproximation approximation, double sphere_padding)
+{
+  approximation_ = approximation;
+  sphere_padding_ = sphere_padding;
+  decomposeLinks();
+}
+
+void CollisionRobotSpheres::decomposeLinks()
+{
+  const std::vector<const robot_model::LinkModel*>& links = robot_model_->getLinkModelsWithCollisionGeometry();
+  link_spheres_.assign(robot_model_->getLinkModelCount(), SphereSet());
+  link_name_ids_.assign(robot_model_->getLinkModelCount(), CompiledAllowedCollisionMatrix::NameID());
+  for (const robot_model::LinkModel* link : links)
+  {
+    link_name_ids_[link->getLinkIndex()] = CompiledAllowedCollisionMatrix::NameID(link->getName());
+    SphereSet& spheres = link_spheres_[link->getLinkIndex()];
+    double scale = getLinkScale(link->getName());
+    double padding = getLinkPadding(link->getName());
+    for (std::size_t i = 0; i < link->getShapes().size(); ++i)
+      if (!decomposeShape(link->getShapes()[i], link->getCollisionOriginTransforms()[i], scale, padding,
+                          approximation_, sphere_padding_, spheres))
+        RCLCPP_WARN(LOGGER_COLLISION_ROBOT_SPHERES, "Shape %zu of link '%s' can not be approximated by spheres", i,
+                    link->getName().c_str());
+    spheres.updateBound();
+  }
+}
+
+void CollisionRobotSpheres::updatedPaddingOrScaling(const std::vector<std::string>& links)
+{
+  CollisionRobotFCL::updatedPaddingOrScaling(links);
+  decomposeLinks();
+}
+
+void CollisionRobotSpheres::getPosedSpheres(const robot_state::RobotState& state,
+                                            std::vector<RobotBodySpheres>& bodies) const
+{
+  const std::vector<const robot_model::LinkModel*>& links = robot_model_->getLinkModelsWithCollisionGeometry();
+  std::vector<const robot_state::AttachedBody*> attached_bodies;
+  state.getAttachedBodies(attached_bodies);
+
+  // entries are overwritten in place, so the sphere vectors keep their memory across calls
+  bodies.resize(links.size() + attached_bodies.size());
+  for (std::size_t i = 0; i < links.size(); ++i)
+  {
+    RobotBodySpheres& body = bodies[i];
+    body.link = links[i];
+    body.attached_body = nullptr;
+    body.name_id = link_name_ids_[links[i]->getLinkIndex()];
+    transformSpheres(link_spheres_[links[i]->getLinkIndex()], state.getGlobalLinkTransform(links[i]), body.spheres);
+  }
+
+  for (std::size_t i = 0; i < attached_bodies.size(); ++i)
+  {
+    const robot_state::AttachedBody* ab = attached_bodies[i];
+    RobotBodySpheres& body = bodies[links.size() + i];
+    body.link = ab->getAttachedLink();
+    body.attached_body = ab;
+    body.name_id = CompiledAllowedCollisionMatrix::NameID(ab->getName());
+    body.spheres.clear();
+    for (std::size_t j = 0; j < ab->getShapes().size(); ++j)
+      decomposeShape(ab->getShapes()[j], ab->getGlobalCollisionBodyTransforms()[j], 1.0, 0.0, approximation_,
+                     sphere_padding_, body.spheres);
+    body.spheres.updateBound();
+  }
+}
+
+void CollisionRobotSpheres::checkSelfCollision(const CollisionRequest& req, CollisionResult& res,
+                                               const robot_state::RobotState& state) const
+{
+  checkSelfCollisionSpheres(req, res, state, nullptr);
+}
+
+void CollisionRobotSpheres::checkSelfCollision(const CollisionRequest& req, CollisionResult& res,
+                                               const robot_state::RobotState& state,
+                                               const AllowedCollisionMatrix& acm) const
+{
+  checkSelfCollisionSpheres(req, res, state, &acm);
+}
+
+void CollisionRobotSpheres::checkSelfCollisionSpheres(const CollisionRequest& req, CollisionResult& res,
+                                                      const robot_state::RobotState& state,
+                                                      const AllowedCollisionMatrix* acm) const
+{
+  // spheres do not approximate distances and costs well enough
+  if (req.distance || req.cost)
+  {
+    if (acm)
+      CollisionRobotFCL::checkSelfCollision(req, res, state, *acm);
+    else
+      CollisionRobotFCL::checkSelfCollision(req, res, state);
+    return;
+  }
+
+  // one buffer per thread, so the spheres are not reallocated for every check
+  static thread_local std::vector<RobotBodySpheres> bodies;
+  getPosedSpheres(state, bodies);
+
+  const std::set<const robot_model::LinkModel*>* active_components =
+      robot_model_->hasJointModelGroup(req.group_name) ?
+          &robot_model_->getJointModelGroup(req.group_name)->getUpdatedLinkModelsSet() :
+          nullptr;
+  CompiledAllowedCollisionMatrixConstPtr compiled_acm = acm ? acm->getCompiled() : nullptr;
+
+  for (std::size_t i = 0; i < bodies.size(); ++i)
+    for (std::size_t j = i + 1; j < bodies.size(); ++j)
+    {
+      if (!needsSphereCheck(bodies[i], bodies[j], active_components, compiled_acm.get()))
+        continue;
+
+      std::size_t index1, index2;
+      if (!spheresOverlap(bodies[i].spheres, bodies[j].spheres, &index1, &index2))
+        continue;
+
+      if (refine_contacts_)
+      {
+        if (req.verbose)
+          RCLCPP_INFO(LOGGER_COLLISION_ROBOT_SPHERES, "Spheres of '%s' and '%s' overlap, checking with FCL",
+                      bodies[i].getID().c_str(), bodies[j].getID().c_str());
+        if (acm)
+          CollisionRobotFCL::checkSelfCollision(req, res, state, *acm);
+        else
+          CollisionRobotFCL::checkSelfCollision(req, res, state);
+        return;
+      }
+
+      BodyType type1 = bodies[i].attached_body ? BodyTypes::ROBOT_ATTACHED : BodyTypes::ROBOT_LINK;
+      BodyType type2 = bodies[j].attached_body ? BodyTypes::ROBOT_ATTACHED : BodyTypes::ROBOT_LINK;
+      if (req.verbose)
+        RCLCPP_INFO(LOGGER_COLLISION_ROBOT_SPHERES, "Found a collision between the spheres of '%s' and '%s'",
+                    bodies[i].getID().c_str(), bodies[j].getID().c_str());
+      if (addSphereContact(req, res, bodies[i].spheres, index1, bodies[i].getID(), type1, bodies[j].spheres, index2,
+                           bodies[j].getID(), type2))
+        return;
+    }
+}
+
+bool needsSphereCheck(const RobotBodySpheres& b1, const RobotBodySpheres& b2,
+                      const std::set<const robot_model::LinkModel*>* active_components,
+                      const CompiledAllowedCollisionMatrix* acm)
+{
+  // a link is not checked against itself
+  if (!b1.attached_body && !b2.attached_body && b1.link == b2.link)
+    return false;
+
+  if (active_components && active_components->find(b1.link) == active_components->end() &&
+      active_components->find(b2.link) == active_components->end())
+    return false;
+
+  // links may touch the bodies attached to them
+  if (b1.attached_body && !b2.attached_body && b1.attached_body->getTouchLinks().count(b2.link->getName()))
+    return false;
+  if (b2.attached_body && !b1.attached_body && b2.attached_body->getTouchLinks().count(b1.link->getName()))
+    return false;
+
+  // conditionally allowed collisions are checked, the contact decider is evaluated on refinement
+  AllowedCollision::Type type;
+  return !(acm && acm->getAllowedCollision(b1.name_id, b2.name_id, type) && type == AllowedCollision::ALWAYS);
+}
+
+bool addSphereContact(const CollisionRequest& req, CollisionResult& res, const SphereSet& spheres1,
+                      std::size_t index1, const std::string& name1, BodyType type1, const SphereSet& spheres2,
+                      std::size_t index2, const std::string& name2, BodyType type2)
+{
+  res.collision = true;
+  if (req.contacts && res.contact_count < req.max_contacts)
+  {
+    const std::pair<std::string, std::string> pc = name1 < name2 ? std::make_pair(name1, name2) :
+                                                                     std::make_pair(name2, name1);
+    std::vector<Contact>& contacts = res.contacts[pc];
+    if (contacts.size() < req.max_contacts_per_pair)
+    {
+      Eigen::Vector3d p1(spheres1.x[index1], spheres1.y[index1], spheres1.z[index1]);
+      Eigen::Vector3d p2(spheres2.x[index2], spheres2.y[index2], spheres2.z[index2]);
+      double distance = (p2 - p1).norm();
+
+      // the contact lies in the middle of the overlap of the two spheres
+      Contact c;
+      c.normal = distance > 0.0 ? Eigen::Vector3d((p2 - p1) / distance) : Eigen::Vector3d::UnitZ();
+      c.depth = spheres1.radius[index1] + spheres2.radius[index2] - distance;
+      c.pos = p1 + c.normal * (spheres1.radius[index1] - c.depth / 2.0);
+      c.body_name_1 = name1;
+      c.body_type_1 = type1;
+      c.body_name_2 = name2;
+      c.body_type_2 = type2;
+      contacts.push_back(c);
+      ++res.contact_count;
+    }
+  }
+  return !req.contacts || res.contact_count >= req.max_contacts;
+}
+}  // namespace collision_detection
@@ -0,0 +1,253 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/collision_distance_field/collision_world_spheres.h>
+#include <moveit/collision_distance_field/collision_detector_allocator_spheres.h>
+#include <boost/bind.hpp>
+
+namespace collision_detection
+{
+static rclcpp::Logger LOGGER_COLLISION_WORLD_SPHERES = rclcpp::get_logger("collision_detection.spheres");
+
+const std::string CollisionDetectorAllocatorSpheres::NAME_("SPHERES");
+const std::size_t CollisionWorldSpheres::BLOCK_SIZE;
+
+CollisionWorldSpheres::CollisionWorldSpheres()
+  : CollisionWorldFCL()
+  , approximation_(SphereApproximation::CONSERVATIVE)
+  , sphere_padding_(0.0)
+  , refine_contacts_(true)
+  , unbounded_objects_(0)
+{
+  // request notifications about changes to new world
+  observer_handle_ = getWorld()->addObserver(boost::bind(&CollisionWorldSpheres::notifyObjectChange, this, _1, _2));
+}
+
+CollisionWorldSpheres::CollisionWorldSpheres(const WorldPtr& world)
+  : CollisionWorldFCL(world)
+  , approximation_(SphereApproximation::CONSERVATIVE)
+  , sphere_padding_(0.0)
+  , refine_contacts_(true)
+  , unbounded_objects_(0)
+{
+  // request notifications about changes to new world
+  observer_handle_ = getWorld()->addObserver(boost::bind(&CollisionWorldSpheres::notifyObjectChange, this, _1, _2));
+  getWorld()->notifyObserverAllObjects(observer_handle_, World::CREATE);
+}
+
+CollisionWorldSpheres::CollisionWorldSpheres(const CollisionWorldSpheres& other, const WorldPtr& world)
+  : CollisionWorldFCL(other, world)
+  , approximation_(other.approximation_)
+  , sphere_padding_(other.sphere_padding_)
+  , refine_contacts_(other.refine_contacts_)
+  , object_spheres_(other.object_spheres_)
+  , unbounded_objects_(0)
+{
+  updateBlockIndex();
+
+  // request notifications about changes to new world
+  observer_handle_ = getWorld()->addObserver(boost::bind(&CollisionWorldSpheres::notifyObjectChange, this, _1, _2));
+}
+
+CollisionWorldSpheres::~CollisionWorldSpheres()
+{
+  getWorld()->removeObserver(observer_handle_);
+}
+
+void CollisionWorldSpheres::setApproximation(SphereApproximation approximation, double sphere_padding)
+{
+  approximation_ = approximation;
+  sphere_padding_ = sphere_padding;
+  for (const auto& object : *getWorld())
+    updateObjectSpheres(*object.second);
+  updateBlockIndex();
+}
+
+void CollisionWorldSpheres::setWorld(const WorldPtr& world)
+{
+  if (world == getWorld())
+    return;
+
+  // turn off notifications about old world
+  getWorld()->removeObserver(observer_handle_);
+  object_spheres_.clear();
+  updateBlockIndex();
+
+  CollisionWorldFCL::setWorld(world);
+
+  // request notifications about changes to new world and get notifications for objects already in it
+  observer_handle_ = getWorld()->addObserver(boost::bind(&CollisionWorldSpheres::notifyObjectChange, this, _1, _2));
+  getWorld()->notifyObserverAllObjects(observer_handle_, World::CREATE);
+}
+
+void CollisionWorldSpheres::notifyObjectChange(const ObjectConstPtr& obj, World::Action action)
+{
+  if (action == World::DESTROY)
+    object_spheres_.erase(obj->id_);
+  else
+    updateObjectSpheres(*obj);
+  updateBlockIndex();
+}
+
+void CollisionWorldSpheres::updateObjectSpheres(const World::Object& obj)
+{
+  ObjectSpheres& object = object_spheres_[obj.id_];
+  object.id = obj.id_;
+  object.name_id = CompiledAllowedCollisionMatrix::NameID(obj.id_);
+  object.unbounded = false;
+
+  SphereSet spheres;
+  for (std::size_t i = 0; i < obj.shapes_.size(); ++i)
+    if (!decomposeShape(obj.shapes_[i], obj.shape_poses_[i], 1.0, 0.0, approximation_, sphere_padding_, spheres))
+      object.unbounded = true;
+  if (object.unbounded)
+    RCLCPP_DEBUG(LOGGER_COLLISION_WORLD_SPHERES, "Object '%s' can not be approximated by spheres, checks use FCL",
+                 obj.id_.c_str());
+
+  // consecutive spheres are close to each other, so blocks of them have tight bounds
+  object.blocks.assign((spheres.size() + BLOCK_SIZE - 1) / BLOCK_SIZE, SphereSet());
+  for (std::size_t i = 0; i < spheres.size(); ++i)
+  {
+    SphereSet& block = object.blocks[i / BLOCK_SIZE];
+    block.add(Eigen::Vector3d(spheres.x[i], spheres.y[i], spheres.z[i]), spheres.radius[i]);
+  }
+  for (SphereSet& block : object.blocks)
+    block.updateBound();
+}
+
+void CollisionWorldSpheres::updateBlockIndex()
+{
+  block_bounds_.clear();
+  blocks_.clear();
+  block_objects_.clear();
+  unbounded_objects_ = 0;
+  for (const auto& object : object_spheres_)
+  {
+    if (object.second.unbounded)
+      ++unbounded_objects_;
+    for (const SphereSet& block : object.second.blocks)
+    {
+      block_bounds_.add(block.bound_center, block.bound_radius);
+      blocks_.push_back(&block);
+      block_objects_.push_back(&object.second);
+    }
+  }
+  block_bounds_.updateBound();
+}
+
+void CollisionWorldSpheres::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                                const CollisionRobot& robot,
+                                                const robot_state::RobotState& state) const
+{
+  checkRobotCollisionSpheres(req, res, robot, state, nullptr);
+}
+
+void CollisionWorldSpheres::checkRobotCollision(const CollisionRequest& req, CollisionResult& res,
+                                                const CollisionRobot& robot, const robot_state::RobotState& state,
+                                                const AllowedCollisionMatrix& acm) const
+{
+  checkRobotCollisionSpheres(req, res, robot, state, &acm);
+}
+
+void CollisionWorldSpheres::checkRobotCollisionSpheres(const CollisionRequest& req, CollisionResult& res,
+                                                       const CollisionRobot& robot,
+                                                       const robot_state::RobotState& state,
+                                                       const AllowedCollisionMatrix* acm) const
+{
+  const CollisionRobotSpheres* robot_spheres = dynamic_cast<const CollisionRobotSpheres*>(&robot);
+
+  // spheres do not approximate distances and costs well enough, and planes are not approximated at all
+  if (!robot_spheres || req.distance || req.cost || unbounded_objects_ > 0)
+  {
+    if (acm)
+      CollisionWorldFCL::checkRobotCollision(req, res, robot, state, *acm);
+    else
+      CollisionWorldFCL::checkRobotCollision(req, res, robot, state);
+    return;
+  }
+
+  // one buffer per thread, so the spheres are not reallocated for every check
+  static thread_local std::vector<RobotBodySpheres> bodies;
+  static thread_local std::vector<std::size_t> candidates;
+  robot_spheres->getPosedSpheres(state, bodies);
+
+  const robot_model::RobotModelConstPtr& robot_model = robot.getRobotModel();
+  const std::set<const robot_model::LinkModel*>* active_components =
+      robot_model->hasJointModelGroup(req.group_name) ?
+          &robot_model->getJointModelGroup(req.group_name)->getUpdatedLinkModelsSet() :
+          nullptr;
+  CompiledAllowedCollisionMatrixConstPtr compiled_acm = acm ? acm->getCompiled() : nullptr;
+
+  for (const RobotBodySpheres& body : bodies)
+  {
+    if (body.spheres.empty() ||
+        (active_components && active_components->find(body.link) == active_components->end()))
+      continue;
+
+    findOverlappingSpheres(body.spheres.bound_center, body.spheres.bound_radius, block_bounds_, candidates);
+    for (std::size_t k : candidates)
+    {
+      const ObjectSpheres& object = *block_objects_[k];
+      AllowedCollision::Type type;
+      if (compiled_acm && compiled_acm->getAllowedCollision(body.name_id, object.name_id, type) &&
+          type == AllowedCollision::ALWAYS)
+        continue;
+
+      std::size_t index1, index2;
+      if (!spheresOverlap(body.spheres, *blocks_[k], &index1, &index2))
+        continue;
+
+      if (refine_contacts_)
+      {
+        if (req.verbose)
+          RCLCPP_INFO(LOGGER_COLLISION_WORLD_SPHERES, "Spheres of '%s' and '%s' overlap, checking with FCL",
+                      body.getID().c_str(), object.id.c_str());
+        if (acm)
+          CollisionWorldFCL::checkRobotCollision(req, res, robot, state, *acm);
+        else
+          CollisionWorldFCL::checkRobotCollision(req, res, robot, state);
+        return;
+      }
+
+      if (req.verbose)
+        RCLCPP_INFO(LOGGER_COLLISION_WORLD_SPHERES, "Found a collision between the spheres of '%s' and '%s'",
+                    body.getID().c_str(), object.id.c_str());
+      if (addSphereContact(req, res, body.spheres, index1, body.getID(),
+                           body.attached_body ? BodyTypes::ROBOT_ATTACHED : BodyTypes::ROBOT_LINK, *blocks_[k], index2,
+                           object.id, BodyTypes::WORLD_OBJECT))
+        return;
+    }
+  }
+}
+}  // namespace collision_detection
@@ -0,0 +1,258 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Benchmark of the collision detectors (FCL, HYBRID, SPHERES) on the test robots.
+
+   Run with --benchmark_format=json or --benchmark_out=<file> --benchmark_out_format=json to store the results, and
+   --benchmark_filter=<regex> to select queries, e.g. "WorldCollision/SPHERES/.*octomap". */
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/collision_detection_fcl/collision_detector_allocator_fcl.h>
+#include <moveit/collision_distance_field/collision_detector_allocator_hybrid.h>
+#include <moveit/collision_distance_field/collision_detector_allocator_spheres.h>
+#include <moveit/utils/robot_model_test_utils.h>
+
+#include <geometric_shapes/shape_operations.h>
+#include <octomap/octomap.h>
+#include <random_numbers/random_numbers.h>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+const unsigned int NUM_STATES = 100;
+
+enum class WorldType
+{
+  PRIMITIVES,
+  MESHES,
+  OCTOMAP
+};
+
+const char* getWorldTypeName(WorldType type)
+{
+  switch (type)
+  {
+    case WorldType::PRIMITIVES:
+      return "primitives";
+    case WorldType::MESHES:
+      return "meshes";
+    default:
+      break;
+  }
+  return "octomap";
+}
+
+/** \brief A robot, its collision checkers of one detector and reproducible random states */
+struct Setup
+{
+  Setup(const std::string& robot_name, const collision_detection::CollisionDetectorAllocatorPtr& allocator)
+    : robot_model(moveit::core::loadTestingRobotModel(robot_name))
+    , acm(robot_model->getLinkModelNamesWithCollisionGeometry(), false)
+    , world(new collision_detection::World())
+  {
+    for (const srdf::Model::DisabledCollision& dc : robot_model->getSRDF()->getDisabledCollisionPairs())
+      acm.setEntry(dc.link1_, dc.link2_, true);
+
+    crobot = allocator->allocateRobot(robot_model);
+    cworld = allocator->allocateWorld(world);
+
+    // random states of the whole robot, the base stays in place so the world objects around it matter
+    random_numbers::RandomNumberGenerator rng(42);
+    for (unsigned int i = 0; i < NUM_STATES; ++i)
+    {
+      states.emplace_back(robot_model);
+      states.back().setToDefaultValues();
+      for (const robot_model::JointModelGroup* jmg : robot_model->getJointModelGroups())
+        if (jmg->isChain())
+          states.back().setToRandomPositions(jmg, rng);
+      states.back().update();
+    }
+  }
+
+  /** \brief Fill the world with \e count objects of \e type around the robot */
+  void addObjects(WorldType type, unsigned int count)
+  {
+    random_numbers::RandomNumberGenerator rng(7);
+    if (type == WorldType::OCTOMAP)
+    {
+      // a cloud of count cells of 2cm, as produced by a depth sensor
+      std::shared_ptr<octomap::OcTree> octree = std::make_shared<octomap::OcTree>(0.02);
+      for (unsigned int i = 0; i < count; ++i)
+        octree->updateNode(octomap::point3d(rng.uniformReal(-1.0, 1.0), rng.uniformReal(-1.0, 1.0),
+                                            rng.uniformReal(0.0, 1.5)),
+                           true);
+      octree->updateInnerOccupancy();
+      world->addToObject("<octomap>", shapes::ShapeConstPtr(new shapes::OcTree(octree)), Eigen::Isometry3d::Identity());
+      return;
+    }
+
+    shapes::ShapeConstPtr shape;
+    if (type == WorldType::PRIMITIVES)
+      shape.reset(new shapes::Box(0.1, 0.1, 0.1));
+    else
+      shape.reset(shapes::createMeshFromResource(
+          "package://moveit_resources/pr2_description/urdf/meshes/sensors/kinect_v0/kinect.dae"));
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+      pose.translation() = Eigen::Vector3d(rng.uniformReal(-1.0, 1.0), rng.uniformReal(-1.0, 1.0),
+                                           rng.uniformReal(0.0, 1.5));
+      world->addToObject("object" + std::to_string(i), shape, pose);
+    }
+  }
+
+  robot_model::RobotModelPtr robot_model;
+  collision_detection::AllowedCollisionMatrix acm;
+  collision_detection::WorldPtr world;
+  collision_detection::CollisionRobotPtr crobot;
+  collision_detection::CollisionWorldPtr cworld;
+  std::vector<robot_state::RobotState> states;
+};
+
+/** \brief Report how many of the checked states were in collision */
+void setCollisionRate(benchmark::State& st, std::size_t collisions, std::size_t checks)
+{
+  st.counters["collision_rate"] = checks ? static_cast<double>(collisions) / checks : 0.0;
+  st.SetItemsProcessed(checks);
+}
+
+void selfCollision(benchmark::State& st, const std::string& robot_name,
+                   const collision_detection::CollisionDetectorAllocatorPtr& allocator)
+{
+  Setup setup(robot_name, allocator);
+  collision_detection::CollisionRequest req;
+  std::size_t checks = 0, collisions = 0;
+  for (auto _ : st)
+  {
+    collision_detection::CollisionResult res;
+    setup.crobot->checkSelfCollision(req, res, setup.states[checks % NUM_STATES], setup.acm);
+    collisions += res.collision;
+    ++checks;
+  }
+  setCollisionRate(st, collisions, checks);
+}
+
+void worldCollision(benchmark::State& st, const std::string& robot_name,
+                    const collision_detection::CollisionDetectorAllocatorPtr& allocator, WorldType type)
+{
+  Setup setup(robot_name, allocator);
+  setup.addObjects(type, st.range(0));
+  collision_detection::CollisionRequest req;
+  std::size_t checks = 0, collisions = 0;
+  for (auto _ : st)
+  {
+    collision_detection::CollisionResult res;
+    setup.cworld->checkRobotCollision(req, res, *setup.crobot, setup.states[checks % NUM_STATES], setup.acm);
+    collisions += res.collision;
+    ++checks;
+  }
+  setCollisionRate(st, collisions, checks);
+}
+
+void distanceQueries(benchmark::State& st, const std::string& robot_name,
+                     const collision_detection::CollisionDetectorAllocatorPtr& allocator)
+{
+  Setup setup(robot_name, allocator);
+  setup.addObjects(WorldType::PRIMITIVES, st.range(0));
+  collision_detection::DistanceRequest req;
+  req.acm = &setup.acm;
+  std::size_t queries = 0;
+  for (auto _ : st)
+  {
+    collision_detection::DistanceResult res;
+    setup.cworld->distanceRobot(req, res, *setup.crobot, setup.states[queries % NUM_STATES]);
+    benchmark::DoNotOptimize(res.minimum_distance.distance);
+    ++queries;
+  }
+  st.SetItemsProcessed(queries);
+}
+
+void continuousCollision(benchmark::State& st, const std::string& robot_name,
+                         const collision_detection::CollisionDetectorAllocatorPtr& allocator)
+{
+  Setup setup(robot_name, allocator);
+  setup.addObjects(WorldType::PRIMITIVES, st.range(0));
+  collision_detection::CollisionRequest req;
+  std::size_t checks = 0, collisions = 0;
+  for (auto _ : st)
+  {
+    // motions between consecutive random states
+    collision_detection::CollisionResult res;
+    setup.cworld->checkRobotCollision(req, res, *setup.crobot, setup.states[checks % NUM_STATES],
+                                      setup.states[(checks + 1) % NUM_STATES], setup.acm);
+    collisions += res.collision;
+    ++checks;
+  }
+  setCollisionRate(st, collisions, checks);
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  const std::vector<collision_detection::CollisionDetectorAllocatorPtr> allocators = {
+    collision_detection::CollisionDetectorAllocatorFCL::create(),
+    collision_detection::CollisionDetectorAllocatorHybrid::create(),
+    collision_detection::CollisionDetectorAllocatorSpheres::create()
+  };
+
+  for (const std::string robot_name : { "panda", "pr2" })
+    for (const collision_detection::CollisionDetectorAllocatorPtr& allocator : allocators)
+    {
+      const std::string suffix = "/" + allocator->getName() + "/" + robot_name;
+      benchmark::RegisterBenchmark(("SelfCollision" + suffix).c_str(), selfCollision, robot_name, allocator);
+      for (WorldType type : { WorldType::PRIMITIVES, WorldType::MESHES, WorldType::OCTOMAP })
+      {
+        // octomaps are sized in cells, other worlds in objects
+        benchmark::internal::Benchmark* b =
+            benchmark::RegisterBenchmark(("WorldCollision" + suffix + "/" + getWorldTypeName(type)).c_str(),
+                                         worldCollision, robot_name, allocator, type);
+        if (type == WorldType::OCTOMAP)
+          b->Arg(1000)->Arg(10000)->Arg(100000);
+        else
+          b->Arg(1)->Arg(10)->Arg(100);
+      }
+      benchmark::RegisterBenchmark(("Distance" + suffix).c_str(), distanceQueries, robot_name, allocator)->Arg(10);
+      benchmark::RegisterBenchmark(("ContinuousCollision" + suffix).c_str(), continuousCollision, robot_name,
+                                   allocator)
+          ->Arg(10);
+    }
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
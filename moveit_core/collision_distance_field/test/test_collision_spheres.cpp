@@ -0,0 +1,238 @@
+/*********************************************************************
+* Software License Agreement (BSD License)
+*
+*  Copyright (c) 2026, The MoveIt Contributors
+*  All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without
+*  modification, are permitted provided that the following conditions
+*  are met:
+*
+*   * Redistributions of source code must retain the above copyright
+*     notice, this list of conditions and the following disclaimer.
+*   * Redistributions in binary form must reproduce the above
+*     copyright notice, this list of conditions and the following
+*     disclaimer in the documentation and/or other materials provided
+*     with the distribution.
+*   * Neither the names of the authors nor the names of its
+*     contributors may be used to endorse or promote products derived
+*     from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+*  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+*  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+*  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+*  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+*  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+*  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+*  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+*  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+*  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+*  POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************/
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/collision_distance_field/collision_common_spheres.h>
+#include <moveit/collision_distance_field/collision_robot_spheres.h>
+#include <moveit/collision_distance_field/collision_world_spheres.h>
+#include <moveit/utils/robot_model_test_utils.h>
+
+#include <geometric_shapes/shape_operations.h>
+#include <octomap/octomap.h>
+#include <random_numbers/random_numbers.h>
+
+#include <gtest/gtest.h>
+
+class SphereCollisionDetectionTester : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    robot_model_ = moveit::core::loadTestingRobotModel("pr2");
+    robot_model_ok_ = static_cast<bool>(robot_model_);
+
+    acm_.reset(new collision_detection::AllowedCollisionMatrix(robot_model_->getLinkModelNames(), false));
+    for (const srdf::Model::DisabledCollision& dc : robot_model_->getSRDF()->getDisabledCollisionPairs())
+      acm_->setEntry(dc.link1_, dc.link2_, true);
+
+    crobot_fcl_.reset(new collision_detection::CollisionRobotFCL(robot_model_));
+    crobot_.reset(new collision_detection::CollisionRobotSpheres(robot_model_));
+  }
+
+  void TearDown() override
+  {
+  }
+
+protected:
+  bool robot_model_ok_;
+
+  robot_model::RobotModelPtr robot_model_;
+
+  std::shared_ptr<collision_detection::CollisionRobotFCL> crobot_fcl_;
+  std::shared_ptr<collision_detection::CollisionRobotSpheres> crobot_;
+
+  collision_detection::AllowedCollisionMatrixPtr acm_;
+};
+
+TEST(SphereKernels, MatchScalarImplementation)
+{
+  random_numbers::RandomNumberGenerator rng(42);
+  for (std::size_t size : { 1, 3, 7, 8, 9, 31, 100 })
+  {
+    collision_detection::SphereSet a, b;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      a.add(Eigen::Vector3d(rng.uniformReal(-1, 1), rng.uniformReal(-1, 1), rng.uniformReal(-1, 1)),
+            rng.uniformReal(0.01, 0.1));
+      b.add(Eigen::Vector3d(rng.uniformReal(-1, 1), rng.uniformReal(-1, 1), rng.uniformReal(-1, 1)),
+            rng.uniformReal(0.01, 0.1));
+    }
+    a.updateBound();
+    b.updateBound();
+
+    EXPECT_DOUBLE_EQ(collision_detection::spheresDistance(a, b), collision_detection::scalar::spheresDistance(a, b));
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      Eigen::Vector3d center(a.x[i], a.y[i], a.z[i]);
+      std::vector<std::size_t> indices, scalar_indices;
+      collision_detection::findOverlappingSpheres(center, a.radius[i], b, indices);
+      collision_detection::scalar::findOverlappingSpheres(center, a.radius[i], b, scalar_indices);
+      EXPECT_EQ(indices, scalar_indices);
+      EXPECT_EQ(collision_detection::sphereOverlaps(center, a.radius[i], b),
+                collision_detection::scalar::sphereOverlaps(center, a.radius[i], b));
+    }
+  }
+}
+
+TEST(SphereDecomposition, ConservativeSpheresCoverBox)
+{
+  shapes::ShapeConstPtr box(new shapes::Box(0.4, 0.1, 0.2));
+  collision_detection::SphereSet spheres;
+  ASSERT_TRUE(collision_detection::decomposeShape(box, Eigen::Isometry3d::Identity(), 1.0, 0.0,
+                                                  collision_detection::SphereApproximation::CONSERVATIVE, 0.0,
+                                                  spheres));
+  ASSERT_FALSE(spheres.empty());
+
+  // every corner of the box is inside some sphere
+  for (double x : { -0.2, 0.2 })
+    for (double y : { -0.05, 0.05 })
+      for (double z : { -0.1, 0.1 })
+        EXPECT_TRUE(collision_detection::sphereOverlaps(Eigen::Vector3d(x, y, z), 1e-9, spheres));
+
+  shapes::ShapeConstPtr plane(new shapes::Plane(0, 0, 1, 0));
+  EXPECT_FALSE(collision_detection::decomposeShape(plane, Eigen::Isometry3d::Identity(), 1.0, 0.0,
+                                                   collision_detection::SphereApproximation::CONSERVATIVE, 0.0,
+                                                   spheres));
+}
+
+TEST_F(SphereCollisionDetectionTester, InitOK)
+{
+  ASSERT_TRUE(robot_model_ok_);
+}
+
+TEST_F(SphereCollisionDetectionTester, DefaultNotInCollision)
+{
+  robot_state::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  robot_state.update();
+
+  collision_detection::CollisionRequest req;
+  collision_detection::CollisionResult res;
+  crobot_->checkSelfCollision(req, res, robot_state, *acm_);
+  ASSERT_FALSE(res.collision);
+}
+
+TEST_F(SphereCollisionDetectionTester, SelfCollisionMatchesFCL)
+{
+  robot_state::RobotState robot_state(robot_model_);
+  collision_detection::CollisionRequest req;
+
+  for (unsigned int i = 0; i < 500; ++i)
+  {
+    robot_state.setToRandomPositions();
+    robot_state.update();
+
+    collision_detection::CollisionResult res_fcl;
+    crobot_fcl_->checkSelfCollision(req, res_fcl, robot_state, *acm_);
+
+    // refined checks are exact
+    crobot_->setRefineContacts(true);
+    collision_detection::CollisionResult res_refined;
+    crobot_->checkSelfCollision(req, res_refined, robot_state, *acm_);
+    EXPECT_EQ(res_fcl.collision, res_refined.collision);
+
+    // conservative spheres never miss a collision
+    crobot_->setRefineContacts(false);
+    collision_detection::CollisionResult res_spheres;
+    crobot_->checkSelfCollision(req, res_spheres, robot_state, *acm_);
+    if (res_fcl.collision)
+      EXPECT_TRUE(res_spheres.collision);
+  }
+}
+
+TEST_F(SphereCollisionDetectionTester, WorldCollisionMatchesFCL)
+{
+  collision_detection::CollisionWorldFCL cworld_fcl;
+  collision_detection::CollisionWorldSpheres cworld;
+
+  shapes::ShapeConstPtr box(new shapes::Box(0.3, 0.3, 0.3));
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = Eigen::Vector3d(0.6, -0.2, 0.8);
+  cworld_fcl.getWorld()->addToObject("box", box, pose);
+  cworld.getWorld()->addToObject("box", box, pose);
+
+  std::shared_ptr<octomap::OcTree> octree = std::make_shared<octomap::OcTree>(0.05);
+  for (double x = 0.3; x < 0.6; x += 0.05)
+    for (double z = 0.2; z < 0.6; z += 0.05)
+      octree->updateNode(octomap::point3d(x, -0.5, z), true, true);
+  octree->updateInnerOccupancy();
+  shapes::ShapeConstPtr map(new shapes::OcTree(octree));
+  cworld_fcl.getWorld()->addToObject("map", map, Eigen::Isometry3d::Identity());
+  cworld.getWorld()->addToObject("map", map, Eigen::Isometry3d::Identity());
+
+  robot_state::RobotState robot_state(robot_model_);
+  robot_state.setToDefaultValues();
+  const robot_model::JointModelGroup* right_arm = robot_model_->getJointModelGroup("right_arm");
+  collision_detection::CollisionRequest req;
+  unsigned int collisions = 0;
+  for (unsigned int i = 0; i < 500; ++i)
+  {
+    robot_state.setToRandomPositions(right_arm);
+    robot_state.update();
+
+    collision_detection::CollisionResult res_fcl;
+    cworld_fcl.checkRobotCollision(req, res_fcl, *crobot_fcl_, robot_state, *acm_);
+
+    cworld.setRefineContacts(true);
+    collision_detection::CollisionResult res_refined;
+    cworld.checkRobotCollision(req, res_refined, *crobot_, robot_state, *acm_);
+    EXPECT_EQ(res_fcl.collision, res_refined.collision);
+
+    cworld.setRefineContacts(false);
+    collision_detection::CollisionResult res_spheres;
+    cworld.checkRobotCollision(req, res_spheres, *crobot_, robot_state, *acm_);
+    if (res_fcl.collision)
+    {
+      EXPECT_TRUE(res_spheres.collision);
+      ++collisions;
+    }
+  }
+  EXPECT_GT(collisions, 0u);
+
+  // moving an object updates its spheres
+  cworld.getWorld()->moveShapeInObject("box", box, Eigen::Isometry3d(Eigen::Translation3d(10, 10, 10)));
+  cworld.getWorld()->removeObject("map");
+  robot_state.setToDefaultValues();
+  robot_state.update();
+  collision_detection::CollisionResult res;
+  cworld.checkRobotCollision(req, res, *crobot_, robot_state, *acm_);
+  EXPECT_FALSE(res.collision);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
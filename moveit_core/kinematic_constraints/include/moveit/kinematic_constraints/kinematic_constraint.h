@@ -360,7 +360,8 @@ public:
    *
    * @param [in] model The kinematic model used for constraint evaluation
    */
-  OrientationConstraint(const robot_model::RobotModelConstPtr& model) : KinematicConstraint(model), link_model_(NULL)
+  OrientationConstraint(const robot_model::RobotModelConstPtr& model)
+    : KinematicConstraint(model), link_model_(NULL), desired_rotation_frame_link_(NULL)
   {
     type_ = ORIENTATION_CONSTRAINT;
   }
@@ -487,6 +488,8 @@ protected:
                                                    */
   std::string desired_rotation_frame_id_;       /**< \brief The target frame of the transform tree */
   bool mobile_frame_;                           /**< \brief Whether or not the header frame is mobile or fixed */
+  const robot_model::LinkModel* desired_rotation_frame_link_; /**< \brief The link of a mobile header frame, if it is
+                                                                 * one, resolved when configuring the constraint */
   double absolute_x_axis_tolerance_, absolute_y_axis_tolerance_,
       absolute_z_axis_tolerance_; /**< \brief Storage for the tolerances */
 };
@@ -517,7 +520,8 @@ public:
    *
    * @param [in] model The kinematic model used for constraint evaluation
    */
-  PositionConstraint(const robot_model::RobotModelConstPtr& model) : KinematicConstraint(model), link_model_(NULL)
+  PositionConstraint(const robot_model::RobotModelConstPtr& model)
+    : KinematicConstraint(model), constraint_frame_link_(NULL), link_model_(NULL)
   {
     type_ = POSITION_CONSTRAINT;
   }
@@ -649,6 +653,8 @@ protected:
   EigenSTL::vector_Isometry3d constraint_region_pose_; /**< \brief The constraint region pose vector */
   bool mobile_frame_;                                  /**< \brief Whether or not a mobile frame is employed*/
   std::string constraint_frame_id_;                    /**< \brief The constraint frame id */
+  const robot_model::LinkModel* constraint_frame_link_; /**< \brief The link of a mobile constraint frame, if it is
+                                                           * one, resolved when configuring the constraint */
   const robot_model::LinkModel* link_model_;           /**< \brief The link model constraint subject */
 };
 
@@ -842,6 +848,8 @@ protected:
   bool mobile_target_frame_;      /**< \brief True if the target is a non-fixed frame relative to the transform frame */
   std::string target_frame_id_;   /**< \brief The target frame id */
   std::string sensor_frame_id_;   /**< \brief The sensor frame id */
+  const robot_model::LinkModel* target_frame_link_; /**< \brief The link of a mobile target frame, if it is one */
+  const robot_model::LinkModel* sensor_frame_link_; /**< \brief The link of a mobile sensor frame, if it is one */
   Eigen::Isometry3d sensor_pose_; /**< \brief The sensor pose transformed into the transform frame */
   int sensor_view_direction_;     /**< \brief Storage for the sensor view direction */
   Eigen::Isometry3d target_pose_; /**< \brief The target pose transformed into the transform frame */
@@ -61,6 +61,26 @@ static double normalizeAngle(double angle)
   return v;
 }
 
+// Get the link named by a mobile frame, so its transform can be looked up without searching the frame by name.
+// Other frames, e.g. attached bodies, are looked up by name with RobotState::getFrameTransform().
+static const robot_model::LinkModel* resolveMobileFrameLink(const robot_model::RobotModel& model,
+                                                            const std::string& frame)
+{
+  const std::string& name = !frame.empty() && frame[0] == '/' ? frame.substr(1) : frame;
+  // the model frame is fixed, but RobotState considers it identity even if the root link is moved by a joint
+  if (name == model.getModelFrame() || !model.hasLinkModel(name))
+    return nullptr;
+  return model.getLinkModel(name);
+}
+
+// Get the transform of a mobile frame, preferring the link resolved for it
+static inline const Eigen::Isometry3d& getMobileFrameTransform(const robot_state::RobotState& state,
+                                                               const robot_model::LinkModel* link,
+                                                               const std::string& frame)
+{
+  return link ? state.getGlobalLinkTransform(link) : state.getFrameTransform(frame);
+}
+
 KinematicConstraint::KinematicConstraint(const robot_model::RobotModelConstPtr& model)
   : type_(UNKNOWN_CONSTRAINT), robot_model_(model), constraint_weight_(std::numeric_limits<double>::epsilon())
 {
@@ -304,6 +324,7 @@ bool PositionConstraint::configure(const moveit_msgs::msg::PositionConstraint& p
   else
   {
     constraint_frame_id_ = pc.header.frame_id;
+    constraint_frame_link_ = resolveMobileFrameLink(*robot_model_, constraint_frame_id_);
     mobile_frame_ = true;
   }
 
@@ -443,7 +464,8 @@ ConstraintEvaluationResult PositionConstraint::decide(const robot_state::RobotSt
   {
     for (std::size_t i = 0; i < constraint_region_.size(); ++i)
     {
-      Eigen::Isometry3d tmp = state.getFrameTransform(constraint_frame_id_) * constraint_region_pose_[i];
+      Eigen::Isometry3d tmp =
+          getMobileFrameTransform(state, constraint_frame_link_, constraint_frame_id_) * constraint_region_pose_[i];
       bool result = constraint_region_[i]->cloneAt(tmp)->containsPoint(pt, verbose);
       if (result || (i + 1 == constraint_region_pose_.size()))
         return finishPositionConstraintDecision(pt, tmp.translation(), link_model_->getName(), constraint_weight_,
@@ -485,6 +507,7 @@ void PositionConstraint::clear()
   constraint_region_pose_.clear();
   mobile_frame_ = false;
   constraint_frame_id_ = "";
+  constraint_frame_link_ = nullptr;
   link_model_ = nullptr;
 }
 
@@ -529,6 +552,7 @@ bool OrientationConstraint::configure(const moveit_msgs::msg::OrientationConstra
   else
   {
     desired_rotation_frame_id_ = oc.header.frame_id;
+    desired_rotation_frame_link_ = resolveMobileFrameLink(*robot_model_, desired_rotation_frame_id_);
     desired_rotation_matrix_ = Eigen::Matrix3d(q);
     mobile_frame_ = true;
   }
@@ -583,6 +607,7 @@ void OrientationConstraint::clear()
   desired_rotation_matrix_ = Eigen::Matrix3d::Identity();
   desired_rotation_matrix_inv_ = Eigen::Matrix3d::Identity();
   desired_rotation_frame_id_ = "";
+  desired_rotation_frame_link_ = nullptr;
   mobile_frame_ = false;
   absolute_z_axis_tolerance_ = absolute_y_axis_tolerance_ = absolute_x_axis_tolerance_ = 0.0;
 }
@@ -600,7 +625,9 @@ ConstraintEvaluationResult OrientationConstraint::decide(const robot_state::Robo
   Eigen::Vector3d xyz;
   if (mobile_frame_)
   {
-    Eigen::Matrix3d tmp = state.getFrameTransform(desired_rotation_frame_id_).rotation() * desired_rotation_matrix_;
+    Eigen::Matrix3d tmp =
+        getMobileFrameTransform(state, desired_rotation_frame_link_, desired_rotation_frame_id_).rotation() *
+        desired_rotation_matrix_;
     Eigen::Isometry3d diff(tmp.transpose() * state.getGlobalLinkTransform(link_model_).rotation());
     xyz = diff.rotation().eulerAngles(0, 1, 2);
     // 0,1,2 corresponds to XYZ, the convention used in sampling constraints
@@ -658,6 +685,8 @@ void VisibilityConstraint::clear()
   mobile_target_frame_ = false;
   target_frame_id_ = "";
   sensor_frame_id_ = "";
+  target_frame_link_ = nullptr;
+  sensor_frame_link_ = nullptr;
   sensor_pose_ = Eigen::Isometry3d::Identity();
   sensor_view_direction_ = 0;
   target_pose_ = Eigen::Isometry3d::Identity();
@@ -712,6 +741,7 @@ bool VisibilityConstraint::configure(const moveit_msgs::msg::VisibilityConstrain
   else
   {
     target_frame_id_ = vc.target_pose.header.frame_id;
+    target_frame_link_ = resolveMobileFrameLink(*robot_model_, target_frame_id_);
     mobile_target_frame_ = true;
   }
 
@@ -726,6 +756,7 @@ bool VisibilityConstraint::configure(const moveit_msgs::msg::VisibilityConstrain
   else
   {
     sensor_frame_id_ = vc.sensor_pose.header.frame_id;
+    sensor_frame_link_ = resolveMobileFrameLink(*robot_model_, sensor_frame_id_);
     mobile_sensor_frame_ = true;
   }
 
@@ -781,9 +812,11 @@ shapes::Mesh* VisibilityConstraint::getVisibilityCone(const robot_state::RobotSt
   // the current pose of the sensor
 
   const Eigen::Isometry3d& sp =
-      mobile_sensor_frame_ ? state.getFrameTransform(sensor_frame_id_) * sensor_pose_ : sensor_pose_;
+      mobile_sensor_frame_ ? getMobileFrameTransform(state, sensor_frame_link_, sensor_frame_id_) * sensor_pose_ :
+                           sensor_pose_;
   const Eigen::Isometry3d& tp =
-      mobile_target_frame_ ? state.getFrameTransform(target_frame_id_) * target_pose_ : target_pose_;
+      mobile_target_frame_ ? getMobileFrameTransform(state, target_frame_link_, target_frame_id_) * target_pose_ :
+                           target_pose_;
 
   // transform the points on the disc to the desired target frame
   const EigenSTL::vector_Vector3d* points = &points_;
@@ -881,9 +914,11 @@ void VisibilityConstraint::getMarkers(const robot_state::RobotState& state,
   markers.markers.push_back(mk);
 
   const Eigen::Isometry3d& sp =
-      mobile_sensor_frame_ ? state.getFrameTransform(sensor_frame_id_) * sensor_pose_ : sensor_pose_;
+      mobile_sensor_frame_ ? getMobileFrameTransform(state, sensor_frame_link_, sensor_frame_id_) * sensor_pose_ :
+                           sensor_pose_;
   const Eigen::Isometry3d& tp =
-      mobile_target_frame_ ? state.getFrameTransform(target_frame_id_) * target_pose_ : target_pose_;
+      mobile_target_frame_ ? getMobileFrameTransform(state, target_frame_link_, target_frame_id_) * target_pose_ :
+                           target_pose_;
 
   visualization_msgs::msg::Marker mka;
   mka.type = visualization_msgs::msg::Marker::ARROW;
@@ -931,9 +966,11 @@ ConstraintEvaluationResult VisibilityConstraint::decide(const robot_state::Robot
   if (max_view_angle_ > 0.0 || max_range_angle_ > 0.0)
   {
     const Eigen::Isometry3d& sp =
-        mobile_sensor_frame_ ? state.getFrameTransform(sensor_frame_id_) * sensor_pose_ : sensor_pose_;
+        mobile_sensor_frame_ ? getMobileFrameTransform(state, sensor_frame_link_, sensor_frame_id_) * sensor_pose_ :
+                             sensor_pose_;
     const Eigen::Isometry3d& tp =
-        mobile_target_frame_ ? state.getFrameTransform(target_frame_id_) * target_pose_ : target_pose_;
+        mobile_target_frame_ ? getMobileFrameTransform(state, target_frame_link_, target_frame_id_) * target_pose_ :
+                             target_pose_;
 
     // necessary to do subtraction as SENSOR_Z is 0 and SENSOR_X is 2
     const Eigen::Vector3d& normal2 = sp.rotation().col(2 - sensor_view_direction_);
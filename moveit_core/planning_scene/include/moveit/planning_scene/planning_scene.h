@@ -76,6 +76,84 @@ typedef boost::function<bool(const robot_state::RobotState&, bool)> StateFeasibi
     whether the check should be verbose or not. */
 typedef boost::function<bool(const robot_state::RobotState&, const robot_state::RobotState&, bool)> MotionFeasibilityFn;
 
+/** \brief A frame resolved once by PlanningScene::resolveFrame(). Its transform can then be looked up repeatedly
+    without searching links, attached bodies, world objects and fixed transforms by name. */
+struct FrameHandle
+{
+  /** \brief The kind of frame found when resolving it */
+  enum Type
+  {
+    UNKNOWN,
+    MODEL_FRAME,
+    LINK,
+    ATTACHED_BODY,
+    WORLD_OBJECT,
+    FIXED_FRAME
+  };
+
+  FrameHandle() : type(UNKNOWN), link(nullptr), fixed_frame(-1)
+  {
+  }
+
+  Type type;
+
+  /** \brief The name of the frame, without leading slash */
+  std::string id;
+
+  /** \brief The link, for frames of type LINK */
+  const robot_model::LinkModel* link;
+
+  /** \brief The handle of the fixed transform, for frames of type FIXED_FRAME */
+  robot_state::FrameId fixed_frame;
+};
+
+/** \brief Options for checking the validity of a path with PlanningScene::isPathValid() */
+struct PathValidityRequest
+{
+  PathValidityRequest() : verbose(false), first_invalid_only(false), num_threads(1), resolution(0.0)
+  {
+  }
+
+  /** \brief The group to check collisions for. If empty, the whole robot is considered. */
+  std::string group;
+
+  /** \brief Flag indicating whether information about invalid states should be reported */
+  bool verbose;
+
+  /** \brief If true, stop checking once an invalid state is found and report only the first invalid waypoint */
+  bool first_invalid_only;
+
+  /** \brief The number of threads to distribute the collision checks across. With 1, all states are checked in the
+      calling thread. The state feasibility function and the path constraints are always evaluated in the calling
+      thread, as they are not required to be thread-safe. */
+  unsigned int num_threads;
+
+  /** \brief If positive, states are interpolated between consecutive waypoints such that the joint-space distance
+      (RobotState::distance() restricted to \e group, if set) between checked states does not exceed this value */
+  double resolution;
+};
+
+/** \brief The reasons for which PlanningScene::isPathValid() found a path invalid. Interpolated states are reported as
+    the waypoint starting their segment; each list is sorted and unique. */
+struct PathValidityResult
+{
+  PathValidityResult() : goal_violated(false)
+  {
+  }
+
+  /** \brief The waypoints with a state in collision */
+  std::vector<std::size_t> colliding_index;
+
+  /** \brief The waypoints with a state rejected by the state feasibility function */
+  std::vector<std::size_t> infeasible_index;
+
+  /** \brief The waypoints with a state violating the path constraints */
+  std::vector<std::size_t> path_constraints_violated_index;
+
+  /** \brief True if the last waypoint satisfies none of the goal constraints */
+  bool goal_violated;
+};
+
 /** \brief A map from object names (e.g., attached bodies, collision objects) to their colors */
 typedef std::map<std::string, std_msgs::msg::ColorRGBA> ObjectColorMap;
 
@@ -218,6 +296,33 @@ public:
      successful or not. */
   const Eigen::Isometry3d& getFrameTransform(const robot_state::RobotState& state, const std::string& id) const;
 
+  /** \brief Resolve the frame \e id once for repeated lookups with getFrameTransform() and knowsFrameTransform().
+      Links and the model frame are resolved for good, as the robot model does not change. Attached bodies and
+      collision objects are still looked up by name, because they may be added or removed after resolving them.
+      Fixed frames keep precedence over collision objects that are added later with the same name; resolve the
+      frame again after such changes. */
+  FrameHandle resolveFrame(const std::string& id) const
+  {
+    return resolveFrame(getCurrentState(), id);
+  }
+
+  /** \brief Resolve the frame \e id, considering the attached bodies of \e state. See resolveFrame(). */
+  FrameHandle resolveFrame(const robot_state::RobotState& state, const std::string& id) const;
+
+  /** \brief Get the transform corresponding to the resolved frame \e frame in the current state.
+      Return identity when no transform is available. */
+  const Eigen::Isometry3d& getFrameTransform(const FrameHandle& frame) const
+  {
+    return getFrameTransform(getCurrentState(), frame);
+  }
+
+  /** \brief Get the transform corresponding to the resolved frame \e frame in \e state, whose link transforms have
+      to be up to date. Return identity when no transform is available. */
+  const Eigen::Isometry3d& getFrameTransform(const robot_state::RobotState& state, const FrameHandle& frame) const;
+
+  /** \brief Check if a transform to the resolved frame \e frame is known in \e state */
+  bool knowsFrameTransform(const robot_state::RobotState& state, const FrameHandle& frame) const;
+
   /** \brief Check if a transform to the frame \e id is known. This will be known if \e id is a link name, an attached
    * body id or a collision object */
   bool knowsFrameTransform(const std::string& id) const;
@@ -429,6 +534,24 @@ public:
                       const robot_state::RobotState& robot_state,
                       const collision_detection::AllowedCollisionMatrix& acm) const;
 
+  /** \brief Check a batch of states (\e states) for collision, storing one result per state in \e results. Each state
+      is checked like checkCollision() does, with the options of \e req for early exit and threading. When stopping at
+      the first collision, \e results ends with the colliding state. The collision transforms of the states are
+      expected to be up to date. */
+  void checkCollisionBatch(const collision_detection::CollisionBatchRequest& req,
+                           const std::vector<const robot_state::RobotState*>& states,
+                           std::vector<collision_detection::CollisionResult>& results) const
+  {
+    checkCollisionBatch(req, states, results, getAllowedCollisionMatrix());
+  }
+
+  /** \brief Check a batch of states (\e states) for collision, with respect to a given allowed collision matrix
+      (\e acm), storing one result per state in \e results. */
+  void checkCollisionBatch(const collision_detection::CollisionBatchRequest& req,
+                           const std::vector<const robot_state::RobotState*>& states,
+                           std::vector<collision_detection::CollisionResult>& results,
+                           const collision_detection::AllowedCollisionMatrix& acm) const;
+
   /** \brief Check whether the current state is in collision,
       but use a collision_detection::CollisionRobot instance that has no padding.
       Since the function is non-const, the current state transforms are also updated if needed. */
@@ -693,6 +816,27 @@ public:
   /** \brief Load the geometry of the planning scene from a stream at a certain location using offset*/
   bool loadGeometryFromStream(std::istream& in, const Eigen::Isometry3d& offset);
 
+  /** \brief Save a snapshot of the planning scene to a stream, in a versioned binary format. The snapshot contains the
+      world objects including meshes and the octomap, the object colors, the attached bodies, the allowed collision
+      matrix, the fixed transforms and the positions of the current state. If \e compress is true, the content is
+      zlib-compressed. Like in AllowedCollisionMatrix::getMessage(), conditional entries of the allowed collision
+      matrix are saved as not allowed and default entries are only saved for names with entries. */
+  void saveSnapshotToStream(std::ostream& out, bool compress = false) const;
+
+  /** \brief Save a snapshot of the planning scene to the file \e filename. See saveSnapshotToStream(). */
+  bool saveSnapshotToFile(const std::string& filename, bool compress = false) const;
+
+  /** \brief Replace the content of the planning scene by a snapshot read from a stream. The snapshot has to be saved
+      for the same robot model. Return false, leaving the scene unchanged, if the snapshot cannot be read. */
+  bool loadSnapshotFromStream(std::istream& in);
+
+  /** \brief Replace the content of the planning scene by a snapshot stored in \e size bytes at \e data */
+  bool loadSnapshotFromBuffer(const char* data, std::size_t size);
+
+  /** \brief Replace the content of the planning scene by a snapshot read from the file \e filename. The file is
+      memory-mapped, so uncompressed snapshots are read without copying the file first. */
+  bool loadSnapshotFromFile(const std::string& filename);
+
   /** \brief Fill the message \e scene with the differences between this instance of PlanningScene with respect to the
      parent.
       If there is no parent, everything is considered to be a diff and the function behaves like getPlanningSceneMsg()
@@ -930,6 +1074,17 @@ public:
   bool isPathValid(const robot_trajectory::RobotTrajectory& trajectory, const std::string& group = "",
                    bool verbose = false, std::vector<std::size_t>* invalid_index = NULL) const;
 
+  /** \brief Check if a given path is valid, with the options of \e req for threading, early exit and interpolation
+   * between waypoints. Each checked state is tested for collision avoidance, feasibility and satisfaction of \e
+   * path_constraints; the last waypoint also has to satisfy one of \e goal_constraints, if any are given. Invalid
+   * interpolated states are reported as the waypoint starting their segment. Like in the other overloads, the last
+   * waypoint is appended to \e invalid_index once more if it violates the goal constraints. If \e result is given,
+   * it receives the reasons for which the path is invalid. */
+  bool isPathValid(const robot_trajectory::RobotTrajectory& trajectory,
+                   const moveit_msgs::msg::Constraints& path_constraints,
+                   const std::vector<moveit_msgs::msg::Constraints>& goal_constraints, const PathValidityRequest& req,
+                   std::vector<std::size_t>* invalid_index = NULL, PathValidityResult* result = NULL) const;
+
   /** \brief Get the top \e max_costs cost sources for a specified trajectory. The resulting costs are stored in \e
    * costs */
   void getCostSources(const robot_trajectory::RobotTrajectory& trajectory, std::size_t max_costs,
@@ -561,6 +561,25 @@ void PlanningScene::checkCollision(const collision_detection::CollisionRequest&
     getCollisionRobotUnpadded()->checkSelfCollision(req, res, robot_state, acm);
 }
 
+void PlanningScene::checkCollisionBatch(const collision_detection::CollisionBatchRequest& req,
+                                        const std::vector<const robot_state::RobotState*>& states,
+                                        std::vector<collision_detection::CollisionResult>& results,
+                                        const collision_detection::AllowedCollisionMatrix& acm) const
+{
+  const collision_detection::CollisionWorldConstPtr& world = getCollisionWorld();
+  const collision_detection::CollisionRobotConstPtr& robot = getCollisionRobot();
+  const collision_detection::CollisionRobotConstPtr& robot_unpadded = getCollisionRobotUnpadded();
+  collision_detection::processCollisionBatch(
+      req, states.size(), results, [&](std::size_t i, collision_detection::CollisionResult& res) {
+        // check collision with the world using the padded version
+        world->checkRobotCollision(req, res, *robot, *states[i], acm);
+
+        // do self-collision checking with the unpadded version of the robot
+        if (!res.collision || (req.contacts && res.contacts.size() < req.max_contacts))
+          robot_unpadded->checkSelfCollision(req, res, *states[i], acm);
+      });
+}
+
 void PlanningScene::checkCollisionUnpadded(const collision_detection::CollisionRequest& req,
                                            collision_detection::CollisionResult& res)
 {
@@ -1333,6 +1352,8 @@ bool PlanningScene::setPlanningSceneMsg(const moveit_msgs::msg::PlanningScene& s
 
 bool PlanningScene::processPlanningSceneWorldMsg(const moveit_msgs::msg::PlanningSceneWorld& world)
 {
+  // notify the collision detectors only once per changed object
+  collision_detection::World::Transaction transaction(*world_);
   bool result = true;
   for (std::size_t i = 0; i < world.collision_objects.size(); ++i)
     result &= processCollisionObjectMsg(world.collision_objects[i]);
@@ -1913,6 +1934,77 @@ bool PlanningScene::knowsFrameTransform(const robot_state::RobotState& state, co
   return getTransforms().Transforms::canTransform(id);
 }
 
+FrameHandle PlanningScene::resolveFrame(const robot_state::RobotState& state, const std::string& id) const
+{
+  FrameHandle frame;
+  frame.id = !id.empty() && id[0] == '/' ? id.substr(1) : id;
+  if (frame.id.empty())
+    return frame;
+
+  if (frame.id == getRobotModel()->getModelFrame())
+    frame.type = FrameHandle::MODEL_FRAME;
+  else if (getRobotModel()->hasLinkModel(frame.id))
+  {
+    frame.type = FrameHandle::LINK;
+    frame.link = getRobotModel()->getLinkModel(frame.id);
+  }
+  else if (state.hasAttachedBody(frame.id))
+    frame.type = FrameHandle::ATTACHED_BODY;
+  else if (getWorld()->hasObject(frame.id))
+    frame.type = FrameHandle::WORLD_OBJECT;
+  else
+  {
+    frame.fixed_frame = getTransforms().getFrameId(frame.id);
+    if (frame.fixed_frame >= 0)
+      frame.type = FrameHandle::FIXED_FRAME;
+  }
+  return frame;
+}
+
+const Eigen::Isometry3d& PlanningScene::getFrameTransform(const robot_state::RobotState& state,
+                                                          const FrameHandle& frame) const
+{
+  static const Eigen::Isometry3d IDENTITY_TRANSFORM = Eigen::Isometry3d::Identity();
+  switch (frame.type)
+  {
+    case FrameHandle::MODEL_FRAME:
+      return IDENTITY_TRANSFORM;
+    case FrameHandle::LINK:
+      return state.getGlobalLinkTransform(frame.link);
+    case FrameHandle::FIXED_FRAME:
+    {
+      // the handle may stem from another scene, e.g. the parent of this one
+      const robot_state::Transforms& transforms = getTransforms();
+      if (transforms.canTransform(frame.fixed_frame) && transforms.getFrameName(frame.fixed_frame) == frame.id)
+        return transforms.getTransform(frame.fixed_frame);
+      break;
+    }
+    default:
+      break;
+  }
+  return getFrameTransform(state, frame.id);
+}
+
+bool PlanningScene::knowsFrameTransform(const robot_state::RobotState& state, const FrameHandle& frame) const
+{
+  switch (frame.type)
+  {
+    case FrameHandle::MODEL_FRAME:
+    case FrameHandle::LINK:
+      return true;
+    case FrameHandle::FIXED_FRAME:
+    {
+      const robot_state::Transforms& transforms = getTransforms();
+      if (transforms.canTransform(frame.fixed_frame) && transforms.getFrameName(frame.fixed_frame) == frame.id)
+        return true;
+      break;
+    }
+    default:
+      break;
+  }
+  return knowsFrameTransform(state, frame.id);
+}
+
 bool PlanningScene::hasObjectType(const std::string& id) const
 {
   if (object_types_)
@@ -2176,56 +2268,163 @@ bool PlanningScene::isPathValid(const robot_trajectory::RobotTrajectory& traject
                                 const std::vector<moveit_msgs::msg::Constraints>& goal_constraints, const std::string& group,
                                 bool verbose, std::vector<std::size_t>* invalid_index) const
 {
-  bool result = true;
+  // unless all invalid states are requested, the first invalid state decides
+  PathValidityRequest req;
+  req.group = group;
+  req.verbose = verbose;
+  req.first_invalid_only = !invalid_index;
+  return isPathValid(trajectory, path_constraints, goal_constraints, req, invalid_index);
+}
+
+namespace
+{
+// append index to the sorted list indices, unless it is its last element already
+void appendIndex(std::vector<std::size_t>& indices, std::size_t index)
+{
+  if (indices.empty() || indices.back() != index)
+    indices.push_back(index);
+}
+}  // namespace
+
+bool PlanningScene::isPathValid(const robot_trajectory::RobotTrajectory& trajectory,
+                                const moveit_msgs::msg::Constraints& path_constraints,
+                                const std::vector<moveit_msgs::msg::Constraints>& goal_constraints,
+                                const PathValidityRequest& req, std::vector<std::size_t>* invalid_index,
+                                PathValidityResult* result) const
+{
   if (invalid_index)
     invalid_index->clear();
+  if (result)
+    *result = PathValidityResult();
+  std::size_t n_wp = trajectory.getWayPointCount();
+  if (n_wp == 0)
+    return true;
+
   kinematic_constraints::KinematicConstraintSet ks_p(getRobotModel());
   ks_p.add(path_constraints, getTransforms());
-  std::size_t n_wp = trajectory.getWayPointCount();
+  const robot_model::JointModelGroup* jmg =
+      req.group.empty() ? nullptr : getRobotModel()->getJointModelGroup(req.group);
+
+  // the states to check: a waypoint and the fraction of the way towards the next waypoint
+  std::vector<std::pair<std::size_t, double>> samples;
+  samples.reserve(n_wp);
   for (std::size_t i = 0; i < n_wp; ++i)
   {
-    const robot_state::RobotState& st = trajectory.getWayPoint(i);
+    samples.emplace_back(i, 0.0);
+    if (req.resolution > 0.0 && i + 1 < n_wp)
+    {
+      const robot_state::RobotState& from = trajectory.getWayPoint(i);
+      const robot_state::RobotState& to = trajectory.getWayPoint(i + 1);
+      double distance = jmg ? from.distance(to, jmg) : from.distance(to);
+      std::size_t steps = static_cast<std::size_t>(std::ceil(distance / req.resolution));
+      for (std::size_t k = 1; k < steps; ++k)
+        samples.emplace_back(i, static_cast<double>(k) / steps);
+    }
+  }
 
-    bool this_state_valid = true;
-    if (isStateColliding(st, group, verbose))
-      this_state_valid = false;
-    if (!isStateFeasible(st, verbose))
-      this_state_valid = false;
-    if (!ks_p.empty() && !ks_p.decide(st, verbose).satisfied)
-      this_state_valid = false;
+  // get the state of a sample, interpolating into buffer if it is not a waypoint
+  auto get_sample_state = [&trajectory, &samples](std::size_t s, std::unique_ptr<robot_state::RobotState>& buffer)
+      -> const robot_state::RobotState& {
+    const robot_state::RobotState& waypoint = trajectory.getWayPoint(samples[s].first);
+    if (samples[s].second <= 0.0)
+      return waypoint;
+    if (!buffer)
+      buffer.reset(new robot_state::RobotState(waypoint));
+    waypoint.interpolate(trajectory.getWayPoint(samples[s].first + 1), samples[s].second, *buffer);
+    buffer->update();
+    return *buffer;
+  };
+
+  // the feasibility function and the kinematic constraints are not required to be thread-safe, so they are evaluated
+  // in the calling thread; the collision checks are then limited to the samples up to the first invalid one, if
+  // only that is requested
+  std::size_t sample_count = samples.size();
+  std::vector<bool> infeasible(samples.size(), false);
+  std::vector<bool> constraints_violated(samples.size(), false);
+  if (state_feasibility_ || !ks_p.empty())
+  {
+    std::unique_ptr<robot_state::RobotState> buffer;
+    for (std::size_t s = 0; s < sample_count; ++s)
+    {
+      const robot_state::RobotState& st = get_sample_state(s, buffer);
+      infeasible[s] = !isStateFeasible(st, req.verbose);
+      constraints_violated[s] = !ks_p.empty() && !ks_p.decide(st, req.verbose).satisfied;
+      if (req.first_invalid_only && (infeasible[s] || constraints_violated[s]))
+        sample_count = s + 1;
+    }
+  }
 
-    if (!this_state_valid)
+  collision_detection::CollisionBatchRequest batch_req;
+  batch_req.verbose = req.verbose;
+  batch_req.group_name = req.group;
+  batch_req.num_threads = req.num_threads;
+  batch_req.stop_at_first_collision = req.first_invalid_only;
+
+  const collision_detection::CollisionWorldConstPtr& world = getCollisionWorld();
+  const collision_detection::CollisionRobotConstPtr& robot = getCollisionRobot();
+  const collision_detection::CollisionRobotConstPtr& robot_unpadded = getCollisionRobotUnpadded();
+  const collision_detection::AllowedCollisionMatrix& acm = getAllowedCollisionMatrix();
+
+  // each worker interpolates into its own state
+  std::vector<std::unique_ptr<robot_state::RobotState>> buffers(std::max(req.num_threads, 1u));
+  std::vector<collision_detection::CollisionResult> collision_results;
+  collision_detection::processCollisionBatch(
+      batch_req, sample_count, collision_results,
+      [&](std::size_t s, collision_detection::CollisionResult& res, std::size_t worker) {
+        const robot_state::RobotState& st = get_sample_state(s, buffers[worker]);
+        world->checkRobotCollision(batch_req, res, *robot, st, acm);
+        if (!res.collision)
+          robot_unpadded->checkSelfCollision(batch_req, res, st, acm);
+      });
+
+  // the collision results end with the first colliding sample if only the first invalid one is requested
+  bool valid = true;
+  for (std::size_t s = 0; s < collision_results.size(); ++s)
+  {
+    if (!collision_results[s].collision && !infeasible[s] && !constraints_violated[s])
+      continue;
+    valid = false;
+    const std::size_t waypoint = samples[s].first;
+    if (invalid_index)
+      appendIndex(*invalid_index, waypoint);
+    if (result)
     {
-      if (invalid_index)
-        invalid_index->push_back(i);
-      else
-        return false;
-      result = false;
+      if (collision_results[s].collision)
+        appendIndex(result->colliding_index, waypoint);
+      if (infeasible[s])
+        appendIndex(result->infeasible_index, waypoint);
+      if (constraints_violated[s])
+        appendIndex(result->path_constraints_violated_index, waypoint);
     }
+    if (req.first_invalid_only)
+      return false;
+  }
 
-    // check goal for last state
-    if (i + 1 == n_wp && !goal_constraints.empty())
+  // check goal for last state
+  if (!goal_constraints.empty())
+  {
+    const robot_state::RobotState& last = trajectory.getLastWayPoint();
+    bool found = false;
+    for (const moveit_msgs::msg::Constraints& goal : goal_constraints)
     {
-      bool found = false;
-      for (std::size_t k = 0; k < goal_constraints.size(); ++k)
+      if (isStateConstrained(last, goal))
       {
-        if (isStateConstrained(st, goal_constraints[k]))
-        {
-          found = true;
-          break;
-        }
-      }
-      if (!found)
-      {
-        if (verbose)
-          RCLCPP_INFO(LOGGER, "Goal not satisfied");
-        if (invalid_index)
-          invalid_index->push_back(i);
-        result = false;
+        found = true;
+        break;
       }
     }
+    if (!found)
+    {
+      if (req.verbose)
+        RCLCPP_INFO(LOGGER, "Goal not satisfied");
+      if (invalid_index)
+        invalid_index->push_back(n_wp - 1);
+      if (result)
+        result->goal_violated = true;
+      valid = false;
+    }
   }
-  return result;
+  return valid;
 }
 
 bool PlanningScene::isPathValid(const robot_trajectory::RobotTrajectory& trajectory,
@@ -0,0 +1,812 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Binary snapshots of planning scenes */
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/robot_state/attached_body.h>
+#include <geometric_shapes/shapes.h>
+#include <octomap/octomap.h>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+
+namespace planning_scene
+{
+rclcpp::Logger LOGGER_SNAPSHOT = rclcpp::get_logger("moveit").get_child("planning_scene_snapshot");
+
+namespace
+{
+/* Layout of a snapshot, with all values in native byte order:
+   - header: 8 bytes magic, uint32 version, uint32 flags, uint64 size of the uncompressed content
+   - content (zlib-compressed if flagged): robot model name, scene name, state positions, fixed transforms, allowed
+     collision matrix, world objects (with their colors and types) and attached bodies (with their detach postures)
+   Strings are stored as uint32 length followed by the characters, poses as the 12 doubles of the upper 3x4 matrix
+   (column-major) and shapes as uint8 shapes::ShapeType followed by their parameters. Large arrays like mesh vertices
+   are stored as they are laid out in memory, so they can be copied directly from a memory-mapped file. Octrees are
+   stored in the full octomap format, which keeps the occupancy values. */
+const char SNAPSHOT_MAGIC[8] = { 'M', 'O', 'V', 'E', 'I', 'T', 'P', 'S' };
+// version 2 added object types, detach postures and octrees with occupancy values
+const uint32_t SNAPSHOT_VERSION = 2;
+const uint32_t SNAPSHOT_COMPRESSED = 1;
+const std::size_t SNAPSHOT_HEADER_SIZE = sizeof(SNAPSHOT_MAGIC) + 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+// values of entries of the allowed collision matrix
+const uint8_t ACM_NO_ENTRY = 0;
+const uint8_t ACM_NEVER = 1;
+const uint8_t ACM_ALWAYS = 2;
+
+// flags of the optional arrays of a mesh
+const uint8_t MESH_TRIANGLE_NORMALS = 1;
+const uint8_t MESH_VERTEX_NORMALS = 2;
+
+static_assert(sizeof(unsigned int) == sizeof(uint32_t), "mesh triangles are stored as uint32");
+
+class SnapshotWriter
+{
+public:
+  SnapshotWriter(std::string& buffer) : buffer_(buffer)
+  {
+  }
+
+  template <typename T>
+  void write(const T& value)
+  {
+    writeBytes(&value, sizeof(T));
+  }
+
+  void writeBytes(const void* data, std::size_t size)
+  {
+    buffer_.append(static_cast<const char*>(data), size);
+  }
+
+  void writeString(const std::string& s)
+  {
+    write(static_cast<uint32_t>(s.size()));
+    writeBytes(s.data(), s.size());
+  }
+
+  void writeDoubles(const std::vector<double>& values)
+  {
+    write(static_cast<uint32_t>(values.size()));
+    writeBytes(values.data(), values.size() * sizeof(double));
+  }
+
+  void writePose(const Eigen::Isometry3d& pose)
+  {
+    Eigen::Matrix<double, 3, 4> m = pose.matrix().topRows<3>();
+    writeBytes(m.data(), sizeof(double) * m.size());
+  }
+
+  void writeShape(const shapes::Shape& shape)
+  {
+    switch (shape.type)
+    {
+      case shapes::SPHERE:
+        write(static_cast<uint8_t>(shape.type));
+        write(static_cast<const shapes::Sphere&>(shape).radius);
+        break;
+      case shapes::CYLINDER:
+        write(static_cast<uint8_t>(shape.type));
+        write(static_cast<const shapes::Cylinder&>(shape).radius);
+        write(static_cast<const shapes::Cylinder&>(shape).length);
+        break;
+      case shapes::CONE:
+        write(static_cast<uint8_t>(shape.type));
+        write(static_cast<const shapes::Cone&>(shape).radius);
+        write(static_cast<const shapes::Cone&>(shape).length);
+        break;
+      case shapes::BOX:
+        write(static_cast<uint8_t>(shape.type));
+        writeBytes(static_cast<const shapes::Box&>(shape).size, 3 * sizeof(double));
+        break;
+      case shapes::PLANE:
+      {
+        const shapes::Plane& plane = static_cast<const shapes::Plane&>(shape);
+        write(static_cast<uint8_t>(shape.type));
+        write(plane.a);
+        write(plane.b);
+        write(plane.c);
+        write(plane.d);
+        break;
+      }
+      case shapes::MESH:
+      {
+        const shapes::Mesh& mesh = static_cast<const shapes::Mesh&>(shape);
+        write(static_cast<uint8_t>(shape.type));
+        write(static_cast<uint32_t>(mesh.vertex_count));
+        write(static_cast<uint32_t>(mesh.triangle_count));
+        writeBytes(mesh.vertices, 3 * sizeof(double) * mesh.vertex_count);
+        writeBytes(mesh.triangles, 3 * sizeof(uint32_t) * mesh.triangle_count);
+        uint8_t flags = (mesh.triangle_normals ? MESH_TRIANGLE_NORMALS : 0) |
+                        (mesh.vertex_normals ? MESH_VERTEX_NORMALS : 0);
+        write(flags);
+        if (mesh.triangle_normals)
+          writeBytes(mesh.triangle_normals, 3 * sizeof(double) * mesh.triangle_count);
+        if (mesh.vertex_normals)
+          writeBytes(mesh.vertex_normals, 3 * sizeof(double) * mesh.vertex_count);
+        break;
+      }
+      case shapes::OCTREE:
+      {
+        std::ostringstream stream;
+        static_cast<const shapes::OcTree&>(shape).octree->write(stream);
+        write(static_cast<uint8_t>(shape.type));
+        writeString(stream.str());
+        break;
+      }
+      default:
+        RCLCPP_WARN(LOGGER_SNAPSHOT, "Cannot save shape of type %d in snapshot", static_cast<int>(shape.type));
+        write(static_cast<uint8_t>(shapes::UNKNOWN_SHAPE));
+        break;
+    }
+  }
+
+private:
+  std::string& buffer_;
+};
+
+class SnapshotReader
+{
+public:
+  SnapshotReader(const char* data, std::size_t size) : data_(data), end_(data + size), ok_(true)
+  {
+  }
+
+  bool ok() const
+  {
+    return ok_;
+  }
+
+  std::size_t remaining() const
+  {
+    return end_ - data_;
+  }
+
+  template <typename T>
+  bool read(T& value)
+  {
+    return readBytes(&value, sizeof(T));
+  }
+
+  bool readBytes(void* out, std::size_t size)
+  {
+    if (!ok_ || size > remaining())
+      return ok_ = false;
+    std::memcpy(out, data_, size);
+    data_ += size;
+    return true;
+  }
+
+  bool readString(std::string& s)
+  {
+    uint32_t size;
+    if (!read(size) || size > remaining())
+      return ok_ = false;
+    s.assign(data_, size);
+    data_ += size;
+    return true;
+  }
+
+  bool readDoubles(std::vector<double>& values)
+  {
+    uint32_t count;
+    if (!readCount(count, sizeof(double)))
+      return false;
+    values.resize(count);
+    return count == 0 || readBytes(values.data(), count * sizeof(double));
+  }
+
+  bool readPose(Eigen::Isometry3d& pose)
+  {
+    Eigen::Matrix<double, 3, 4> m;
+    if (!readBytes(m.data(), sizeof(double) * m.size()))
+      return false;
+    pose.matrix().topRows<3>() = m;
+    pose.matrix().row(3) << 0.0, 0.0, 0.0, 1.0;
+    return true;
+  }
+
+  /** Read the number of following elements, which occupy at least \e element_size bytes each */
+  bool readCount(uint32_t& count, std::size_t element_size)
+  {
+    if (!read(count) || count > remaining() / element_size)
+      return ok_ = false;
+    return true;
+  }
+
+  /** Read a shape. Unsupported shapes that were skipped when saving result in a null pointer. */
+  shapes::ShapePtr readShape()
+  {
+    uint8_t type;
+    if (!read(type))
+      return shapes::ShapePtr();
+    switch (type)
+    {
+      case shapes::SPHERE:
+      {
+        double radius;
+        if (read(radius))
+          return std::make_shared<shapes::Sphere>(radius);
+        break;
+      }
+      case shapes::CYLINDER:
+      {
+        double radius, length;
+        if (read(radius) && read(length))
+          return std::make_shared<shapes::Cylinder>(radius, length);
+        break;
+      }
+      case shapes::CONE:
+      {
+        double radius, length;
+        if (read(radius) && read(length))
+          return std::make_shared<shapes::Cone>(radius, length);
+        break;
+      }
+      case shapes::BOX:
+      {
+        double size[3];
+        if (readBytes(size, sizeof(size)))
+          return std::make_shared<shapes::Box>(size[0], size[1], size[2]);
+        break;
+      }
+      case shapes::PLANE:
+      {
+        double a, b, c, d;
+        if (read(a) && read(b) && read(c) && read(d))
+          return std::make_shared<shapes::Plane>(a, b, c, d);
+        break;
+      }
+      case shapes::MESH:
+        return readMesh();
+      case shapes::OCTREE:
+      {
+        uint32_t size;
+        if (!read(size) || size > remaining())
+          break;
+        boost::iostreams::stream<boost::iostreams::array_source> stream(data_, size);
+        data_ += size;
+        std::unique_ptr<octomap::AbstractOcTree> tree(octomap::AbstractOcTree::read(stream));
+        if (tree && dynamic_cast<octomap::OcTree*>(tree.get()))
+          return std::make_shared<shapes::OcTree>(
+              std::shared_ptr<const octomap::OcTree>(static_cast<octomap::OcTree*>(tree.release())));
+        break;
+      }
+      case shapes::UNKNOWN_SHAPE:
+        return shapes::ShapePtr();
+      default:
+        break;
+    }
+    ok_ = false;
+    return shapes::ShapePtr();
+  }
+
+private:
+  shapes::ShapePtr readMesh()
+  {
+    uint32_t vertex_count, triangle_count;
+    if (!read(vertex_count) || !read(triangle_count) || vertex_count > remaining() / (3 * sizeof(double)) ||
+        triangle_count > remaining() / (3 * sizeof(uint32_t)))
+    {
+      ok_ = false;
+      return shapes::ShapePtr();
+    }
+
+    std::shared_ptr<shapes::Mesh> mesh = std::make_shared<shapes::Mesh>(vertex_count, triangle_count);
+    uint8_t flags;
+    if (!readBytes(mesh->vertices, 3 * sizeof(double) * vertex_count) ||
+        !readBytes(mesh->triangles, 3 * sizeof(uint32_t) * triangle_count) || !read(flags))
+      return shapes::ShapePtr();
+    for (std::size_t i = 0; i < 3 * triangle_count; ++i)
+      if (mesh->triangles[i] >= vertex_count)
+      {
+        ok_ = false;
+        return shapes::ShapePtr();
+      }
+
+    if (flags & MESH_TRIANGLE_NORMALS)
+    {
+      if (!mesh->triangle_normals)
+        mesh->triangle_normals = new double[3 * triangle_count];
+      if (!readBytes(mesh->triangle_normals, 3 * sizeof(double) * triangle_count))
+        return shapes::ShapePtr();
+    }
+    else
+      mesh->computeTriangleNormals();
+
+    if (flags & MESH_VERTEX_NORMALS)
+    {
+      if (!mesh->vertex_normals)
+        mesh->vertex_normals = new double[3 * vertex_count];
+      if (!readBytes(mesh->vertex_normals, 3 * sizeof(double) * vertex_count))
+        return shapes::ShapePtr();
+    }
+    else
+      mesh->computeVertexNormals();
+    return mesh;
+  }
+
+  const char* data_;
+  const char* end_;
+  bool ok_;
+};
+
+/* The content of a snapshot, read completely before it is applied to a scene */
+struct SnapshotObject
+{
+  std::string id_;
+  std::vector<shapes::ShapeConstPtr> shapes_;
+  EigenSTL::vector_Isometry3d poses_;
+  bool has_color_;
+  std_msgs::msg::ColorRGBA color_;
+  bool has_type_;
+  object_recognition_msgs::msg::ObjectType type_;
+};
+
+struct SnapshotAttachedBody
+{
+  std::string id_;
+  std::string link_;
+  std::vector<shapes::ShapeConstPtr> shapes_;
+  EigenSTL::vector_Isometry3d poses_;
+  std::vector<std::string> touch_links_;
+  trajectory_msgs::msg::JointTrajectory detach_posture_;
+};
+
+struct SnapshotContent
+{
+  std::string name_;
+  std::vector<double> positions_;
+  robot_state::FixedTransformsMap transforms_;
+  collision_detection::AllowedCollisionMatrix acm_;
+  std::vector<SnapshotObject> objects_;
+  std::vector<SnapshotAttachedBody> attached_bodies_;
+};
+
+void writeShapes(SnapshotWriter& writer, const std::vector<shapes::ShapeConstPtr>& shapes,
+                 const EigenSTL::vector_Isometry3d& poses)
+{
+  writer.write(static_cast<uint32_t>(shapes.size()));
+  for (std::size_t i = 0; i < shapes.size(); ++i)
+  {
+    writer.writeShape(*shapes[i]);
+    writer.writePose(poses[i]);
+  }
+}
+
+bool readShapes(SnapshotReader& reader, std::vector<shapes::ShapeConstPtr>& shapes, EigenSTL::vector_Isometry3d& poses)
+{
+  uint32_t count;
+  if (!reader.readCount(count, sizeof(uint8_t) + 12 * sizeof(double)))
+    return false;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    shapes::ShapePtr shape = reader.readShape();
+    Eigen::Isometry3d pose;
+    if (!reader.readPose(pose))
+      return false;
+    if (shape)
+    {
+      shapes.push_back(shape);
+      poses.push_back(pose);
+    }
+  }
+  return reader.ok();
+}
+
+void writeJointTrajectory(SnapshotWriter& writer, const trajectory_msgs::msg::JointTrajectory& trajectory)
+{
+  writer.writeString(trajectory.header.frame_id);
+  writer.write(trajectory.header.stamp.sec);
+  writer.write(trajectory.header.stamp.nanosec);
+  writer.write(static_cast<uint32_t>(trajectory.joint_names.size()));
+  for (const std::string& name : trajectory.joint_names)
+    writer.writeString(name);
+  writer.write(static_cast<uint32_t>(trajectory.points.size()));
+  for (const trajectory_msgs::msg::JointTrajectoryPoint& point : trajectory.points)
+  {
+    writer.writeDoubles(point.positions);
+    writer.writeDoubles(point.velocities);
+    writer.writeDoubles(point.accelerations);
+    writer.writeDoubles(point.effort);
+    writer.write(point.time_from_start.sec);
+    writer.write(point.time_from_start.nanosec);
+  }
+}
+
+bool readJointTrajectory(SnapshotReader& reader, trajectory_msgs::msg::JointTrajectory& trajectory)
+{
+  uint32_t count;
+  if (!reader.readString(trajectory.header.frame_id) || !reader.read(trajectory.header.stamp.sec) ||
+      !reader.read(trajectory.header.stamp.nanosec) || !reader.readCount(count, sizeof(uint32_t)))
+    return false;
+  trajectory.joint_names.resize(count);
+  for (std::string& name : trajectory.joint_names)
+    if (!reader.readString(name))
+      return false;
+
+  if (!reader.readCount(count, 4 * sizeof(uint32_t) + 2 * sizeof(int32_t)))
+    return false;
+  trajectory.points.resize(count);
+  for (trajectory_msgs::msg::JointTrajectoryPoint& point : trajectory.points)
+    if (!reader.readDoubles(point.positions) || !reader.readDoubles(point.velocities) ||
+        !reader.readDoubles(point.accelerations) || !reader.readDoubles(point.effort) ||
+        !reader.read(point.time_from_start.sec) || !reader.read(point.time_from_start.nanosec))
+      return false;
+  return true;
+}
+
+bool readAllowedCollisionMatrix(SnapshotReader& reader, collision_detection::AllowedCollisionMatrix& acm)
+{
+  uint32_t count;
+  if (!reader.readCount(count, sizeof(uint32_t)))
+    return false;
+  std::vector<std::string> names(count);
+  for (std::string& name : names)
+    if (!reader.readString(name))
+      return false;
+
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    uint8_t entry;
+    if (!reader.read(entry))
+      return false;
+    if (entry != ACM_NO_ENTRY)
+      acm.setDefaultEntry(names[i], entry == ACM_ALWAYS);
+    for (std::size_t j = i; j < names.size(); ++j)
+    {
+      if (!reader.read(entry))
+        return false;
+      if (entry != ACM_NO_ENTRY)
+        acm.setEntry(names[i], names[j], entry == ACM_ALWAYS);
+    }
+  }
+  return true;
+}
+
+bool readSnapshotContent(SnapshotReader& reader, const robot_model::RobotModel& model, SnapshotContent& content)
+{
+  std::string model_name;
+  if (!reader.readString(model_name) || !reader.readString(content.name_))
+    return false;
+  if (model_name != model.getName())
+  {
+    RCLCPP_ERROR(LOGGER_SNAPSHOT, "Snapshot was saved for robot model '%s', but the scene uses robot model '%s'",
+                 model_name.c_str(), model.getName().c_str());
+    return false;
+  }
+
+  uint32_t count;
+  if (!reader.readCount(count, sizeof(double)))
+    return false;
+  if (count != model.getVariableCount())
+  {
+    RCLCPP_ERROR(LOGGER_SNAPSHOT, "Snapshot contains %u variables, but the robot model has %u", count,
+                 static_cast<unsigned int>(model.getVariableCount()));
+    return false;
+  }
+  content.positions_.resize(count);
+  if (!reader.readBytes(content.positions_.data(), count * sizeof(double)))
+    return false;
+
+  if (!reader.readCount(count, sizeof(uint32_t) + 12 * sizeof(double)))
+    return false;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    std::string frame;
+    Eigen::Isometry3d pose;
+    if (!reader.readString(frame) || !reader.readPose(pose))
+      return false;
+    content.transforms_[frame] = pose;
+  }
+
+  if (!readAllowedCollisionMatrix(reader, content.acm_))
+    return false;
+
+  if (!reader.readCount(count, 2 * sizeof(uint32_t) + 2 * sizeof(uint8_t)))
+    return false;
+  content.objects_.resize(count);
+  for (SnapshotObject& object : content.objects_)
+  {
+    uint8_t has_color, has_type;
+    if (!reader.readString(object.id_) || !readShapes(reader, object.shapes_, object.poses_) ||
+        !reader.read(has_color))
+      return false;
+    object.has_color_ = has_color != 0;
+    if (object.has_color_ && (!reader.read(object.color_.r) || !reader.read(object.color_.g) ||
+                              !reader.read(object.color_.b) || !reader.read(object.color_.a)))
+      return false;
+    if (!reader.read(has_type))
+      return false;
+    object.has_type_ = has_type != 0;
+    if (object.has_type_ && (!reader.readString(object.type_.key) || !reader.readString(object.type_.db)))
+      return false;
+  }
+
+  // each body has at least its id, link, shapes, touch links and an empty detach posture
+  if (!reader.readCount(count, 8 * sizeof(uint32_t) + sizeof(int32_t)))
+    return false;
+  content.attached_bodies_.resize(count);
+  for (SnapshotAttachedBody& body : content.attached_bodies_)
+  {
+    if (!reader.readString(body.id_) || !reader.readString(body.link_) ||
+        !readShapes(reader, body.shapes_, body.poses_))
+      return false;
+    if (!model.hasLinkModel(body.link_))
+    {
+      RCLCPP_ERROR(LOGGER_SNAPSHOT, "Snapshot attaches '%s' to unknown link '%s'", body.id_.c_str(),
+                   body.link_.c_str());
+      return false;
+    }
+    uint32_t touch_links;
+    if (!reader.readCount(touch_links, sizeof(uint32_t)))
+      return false;
+    body.touch_links_.resize(touch_links);
+    for (std::string& link : body.touch_links_)
+      if (!reader.readString(link))
+        return false;
+    if (!readJointTrajectory(reader, body.detach_posture_))
+      return false;
+  }
+  return reader.ok();
+}
+}  // namespace
+
+void PlanningScene::saveSnapshotToStream(std::ostream& out, bool compress) const
+{
+  std::string content;
+  SnapshotWriter writer(content);
+  writer.writeString(getRobotModel()->getName());
+  writer.writeString(name_);
+
+  const robot_state::RobotState& state = getCurrentState();
+  writer.write(static_cast<uint32_t>(state.getVariableCount()));
+  writer.writeBytes(state.getVariablePositions(), state.getVariableCount() * sizeof(double));
+
+  const robot_state::FixedTransformsMap& transforms = getTransforms().getAllTransforms();
+  writer.write(static_cast<uint32_t>(transforms.size()));
+  for (const std::pair<const std::string, Eigen::Isometry3d>& transform : transforms)
+  {
+    writer.writeString(transform.first);
+    writer.writePose(transform.second);
+  }
+
+  // like in AllowedCollisionMatrix::getMessage(), conditional entries are approximated as not allowed
+  const collision_detection::AllowedCollisionMatrix& acm = getAllowedCollisionMatrix();
+  std::vector<std::string> names;
+  acm.getAllEntryNames(names);
+  writer.write(static_cast<uint32_t>(names.size()));
+  for (const std::string& name : names)
+    writer.writeString(name);
+  for (std::size_t i = 0; i < names.size(); ++i)
+  {
+    collision_detection::AllowedCollision::Type type;
+    bool found = acm.getDefaultEntry(names[i], type);
+    writer.write(!found ? ACM_NO_ENTRY : type == collision_detection::AllowedCollision::ALWAYS ? ACM_ALWAYS : ACM_NEVER);
+    for (std::size_t j = i; j < names.size(); ++j)
+    {
+      found = acm.getEntry(names[i], names[j], type);
+      writer.write(!found ? ACM_NO_ENTRY :
+                            type == collision_detection::AllowedCollision::ALWAYS ? ACM_ALWAYS : ACM_NEVER);
+    }
+  }
+
+  writer.write(static_cast<uint32_t>(world_->size()));
+  for (const std::pair<const std::string, collision_detection::World::ObjectPtr>& object : *world_)
+  {
+    writer.writeString(object.first);
+    writeShapes(writer, object.second->shapes_, object.second->shape_poses_);
+    bool has_color = hasObjectColor(object.first);
+    writer.write(static_cast<uint8_t>(has_color));
+    if (has_color)
+    {
+      const std_msgs::msg::ColorRGBA& color = getObjectColor(object.first);
+      writer.write(color.r);
+      writer.write(color.g);
+      writer.write(color.b);
+      writer.write(color.a);
+    }
+    bool has_type = hasObjectType(object.first);
+    writer.write(static_cast<uint8_t>(has_type));
+    if (has_type)
+    {
+      const object_recognition_msgs::msg::ObjectType& type = getObjectType(object.first);
+      writer.writeString(type.key);
+      writer.writeString(type.db);
+    }
+  }
+
+  std::vector<const robot_state::AttachedBody*> attached_bodies;
+  state.getAttachedBodies(attached_bodies);
+  writer.write(static_cast<uint32_t>(attached_bodies.size()));
+  for (const robot_state::AttachedBody* body : attached_bodies)
+  {
+    writer.writeString(body->getName());
+    writer.writeString(body->getAttachedLinkName());
+    writeShapes(writer, body->getShapes(), body->getFixedTransforms());
+    writer.write(static_cast<uint32_t>(body->getTouchLinks().size()));
+    for (const std::string& link : body->getTouchLinks())
+      writer.writeString(link);
+    writeJointTrajectory(writer, body->getDetachPosture());
+  }
+
+  uint32_t flags = compress ? SNAPSHOT_COMPRESSED : 0;
+  uint64_t content_size = content.size();
+  out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  out.write(reinterpret_cast<const char*>(&SNAPSHOT_VERSION), sizeof(SNAPSHOT_VERSION));
+  out.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+  out.write(reinterpret_cast<const char*>(&content_size), sizeof(content_size));
+  if (compress)
+  {
+    boost::iostreams::filtering_ostream compressed;
+    compressed.push(boost::iostreams::zlib_compressor());
+    compressed.push(out);
+    compressed.write(content.data(), content.size());
+  }
+  else
+    out.write(content.data(), content.size());
+}
+
+bool PlanningScene::saveSnapshotToFile(const std::string& filename, bool compress) const
+{
+  std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+  if (!out.is_open())
+  {
+    RCLCPP_ERROR(LOGGER_SNAPSHOT, "Unable to open '%s' for writing the planning scene snapshot", filename.c_str());
+    return false;
+  }
+  saveSnapshotToStream(out, compress);
+  out.close();
+  return !out.fail();
+}
+
+bool PlanningScene::loadSnapshotFromStream(std::istream& in)
+{
+  std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  return loadSnapshotFromBuffer(data.data(), data.size());
+}
+
+bool PlanningScene::loadSnapshotFromFile(const std::string& filename)
+{
+  boost::iostreams::mapped_file_source file;
+  try
+  {
+    file.open(filename);
+  }
+  catch (std::exception& ex)
+  {
+    RCLCPP_ERROR(LOGGER_SNAPSHOT, "Unable to map planning scene snapshot '%s': %s", filename.c_str(), ex.what());
+    return false;
+  }
+  return loadSnapshotFromBuffer(file.data(), file.size());
+}
+
+bool PlanningScene::loadSnapshotFromBuffer(const char* data, std::size_t size)
+{
+  SnapshotReader header(data, size);
+  char magic[sizeof(SNAPSHOT_MAGIC)];
+  uint32_t version, flags;
+  uint64_t content_size;
+  if (!header.readBytes(magic, sizeof(magic)) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+      !header.read(version) || !header.read(flags) || !header.read(content_size))
+  {
+    RCLCPP_ERROR(LOGGER_SNAPSHOT, "Data is not a planning scene snapshot");
+    return false;
+  }
+  if (version != SNAPSHOT_VERSION)
+  {
+    RCLCPP_ERROR(LOGGER_SNAPSHOT, "Unsupported planning scene snapshot version %u (or byte order)", version);
+    return false;
+  }
+
+  const char* content_data = data + SNAPSHOT_HEADER_SIZE;
+  std::size_t content_bytes = size - SNAPSHOT_HEADER_SIZE;
+  std::string decompressed;
+  if (flags & SNAPSHOT_COMPRESSED)
+  {
+    try
+    {
+      boost::iostreams::filtering_istream in;
+      in.push(boost::iostreams::zlib_decompressor());
+      in.push(boost::iostreams::array_source(content_data, content_bytes));
+      decompressed.reserve(std::min<uint64_t>(content_size, 16 * content_bytes));
+      boost::iostreams::copy(in, boost::iostreams::back_inserter(decompressed));
+    }
+    catch (std::exception& ex)
+    {
+      RCLCPP_ERROR(LOGGER_SNAPSHOT, "Unable to decompress planning scene snapshot: %s", ex.what());
+      return false;
+    }
+    content_data = decompressed.data();
+    content_bytes = decompressed.size();
+  }
+  if (content_bytes != content_size)
+  {
+    RCLCPP_ERROR(LOGGER_SNAPSHOT, "Planning scene snapshot is truncated");
+    return false;
+  }
+
+  SnapshotContent content;
+  SnapshotReader reader(content_data, content_bytes);
+  if (!readSnapshotContent(reader, *getRobotModel(), content))
+  {
+    RCLCPP_ERROR(LOGGER_SNAPSHOT, "Planning scene snapshot is corrupt");
+    return false;
+  }
+
+  name_ = content.name_;
+  getTransformsNonConst().setAllTransforms(content.transforms_);
+  getAllowedCollisionMatrixNonConst() = content.acm_;
+
+  robot_state::RobotState& state = getCurrentStateNonConst();
+  state.clearAttachedBodies();
+  state.setVariablePositions(content.positions_.data());
+  for (const SnapshotAttachedBody& body : content.attached_bodies_)
+    state.attachBody(body.id_, body.shapes_, body.poses_, body.touch_links_, body.link_, body.detach_posture_);
+  state.update();
+
+  // the collision detectors are updated once per object
+  collision_detection::World::Transaction transaction(*world_);
+  for (const std::string& id : world_->getObjectIds())
+  {
+    removeObjectColor(id);
+    removeObjectType(id);
+  }
+  world_->clearObjects();
+  for (const SnapshotObject& object : content.objects_)
+  {
+    if (object.shapes_.empty())
+      continue;
+    world_->addToObject(object.id_, object.shapes_, object.poses_);
+    if (object.has_color_)
+      setObjectColor(object.id_, object.color_);
+    if (object.has_type_)
+      setObjectType(object.id_, object.type_);
+  }
+  return true;
+}
+
+}  // end of namespace planning_scene
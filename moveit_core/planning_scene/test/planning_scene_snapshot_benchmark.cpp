@@ -0,0 +1,149 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+/* Benchmark of saving and loading mesh-heavy planning scenes: text geometry format vs. binary snapshots */
+
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <geometric_shapes/shapes.h>
+#include <boost/filesystem/operations.hpp>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <gtest/gtest.h>
+
+// Create a grid mesh of (n+1)^2 vertices and 2 n^2 triangles
+shapes::ShapeConstPtr createGridMesh(unsigned int n)
+{
+  shapes::Mesh* mesh = new shapes::Mesh((n + 1) * (n + 1), 2 * n * n);
+  for (unsigned int i = 0; i <= n; ++i)
+    for (unsigned int j = 0; j <= n; ++j)
+    {
+      double* v = mesh->vertices + 3 * (i * (n + 1) + j);
+      v[0] = static_cast<double>(i) / n;
+      v[1] = static_cast<double>(j) / n;
+      v[2] = 0.1 * std::sin(10.0 * v[0]) * std::cos(10.0 * v[1]);
+    }
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int j = 0; j < n; ++j)
+    {
+      unsigned int* t = mesh->triangles + 6 * (i * n + j);
+      unsigned int v = i * (n + 1) + j;
+      t[0] = v;
+      t[1] = v + 1;
+      t[2] = v + n + 1;
+      t[3] = v + 1;
+      t[4] = v + n + 2;
+      t[5] = v + n + 1;
+    }
+  mesh->computeTriangleNormals();
+  mesh->computeVertexNormals();
+  return shapes::ShapeConstPtr(mesh);
+}
+
+template <typename Fn>
+double measure(unsigned int runs, const Fn& fn)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int r = 0; r < runs; ++r)
+    fn();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return 1000. * elapsed.count() / runs;
+}
+
+void benchmarkSceneLoading(unsigned int objects, unsigned int grid, unsigned int runs)
+{
+  robot_model::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  ASSERT_TRUE(bool(model));
+  planning_scene::PlanningScene scene(model);
+  for (unsigned int i = 0; i < objects; ++i)
+    scene.getWorldNonConst()->addToObject("mesh" + std::to_string(i), createGridMesh(grid),
+                                          Eigen::Isometry3d(Eigen::Translation3d(i, 0.0, 0.0)));
+
+  std::string text, binary, compressed;
+  double save_text = measure(runs, [&]() {
+    std::stringstream stream;
+    scene.saveGeometryToStream(stream);
+    text = stream.str();
+  });
+  double save_binary = measure(runs, [&]() {
+    std::stringstream stream;
+    scene.saveSnapshotToStream(stream);
+    binary = stream.str();
+  });
+  double save_compressed = measure(runs, [&]() {
+    std::stringstream stream;
+    scene.saveSnapshotToStream(stream, true);
+    compressed = stream.str();
+  });
+
+  planning_scene::PlanningScene loaded(model);
+  double load_text = measure(runs, [&]() {
+    std::stringstream stream(text);
+    loaded.getWorldNonConst()->clearObjects();
+    EXPECT_TRUE(loaded.loadGeometryFromStream(stream));
+  });
+  double load_binary = measure(runs, [&]() { EXPECT_TRUE(loaded.loadSnapshotFromBuffer(binary.data(), binary.size())); });
+  double load_compressed =
+      measure(runs, [&]() { EXPECT_TRUE(loaded.loadSnapshotFromBuffer(compressed.data(), compressed.size())); });
+
+  std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+  ASSERT_TRUE(scene.saveSnapshotToFile(filename));
+  double load_mapped = measure(runs, [&]() { EXPECT_TRUE(loaded.loadSnapshotFromFile(filename)); });
+  boost::filesystem::remove(filename);
+
+  std::cerr << objects << " meshes with " << 2 * grid * grid << " triangles:" << std::endl
+            << "  text:              " << text.size() / 1024 << "KiB, save " << save_text << "ms, load " << load_text
+            << "ms" << std::endl
+            << "  binary:            " << binary.size() / 1024 << "KiB, save " << save_binary << "ms, load "
+            << load_binary << "ms, load memory-mapped " << load_mapped << "ms" << std::endl
+            << "  binary compressed: " << compressed.size() / 1024 << "KiB, save " << save_compressed << "ms, load "
+            << load_compressed << "ms" << std::endl;
+}
+
+TEST(PlanningSceneSnapshotTiming, FewLargeMeshes)
+{
+  benchmarkSceneLoading(5, 300, 5);
+}
+
+TEST(PlanningSceneSnapshotTiming, ManySmallMeshes)
+{
+  benchmarkSceneLoading(500, 10, 5);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
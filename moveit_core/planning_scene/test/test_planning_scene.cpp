@@ -35,12 +35,19 @@
 /* Author: Ioan Sucan */
 
 #include <gtest/gtest.h>
+#include <thread>
 #include <moveit/planning_scene/planning_scene.h>
 #include <urdf_parser/urdf_parser.h>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <boost/filesystem/path.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <moveit/robot_state/attached_body.h>
+#include <geometric_shapes/shapes.h>
+#include <octomap/octomap.h>
+#include <algorithm>
 #include <moveit_resources/config.h>
 
 // This function needs to return void so the gtest FAIL() macro inside
@@ -168,6 +175,374 @@ TEST(PlanningScene, isStateValid)
   }
 }
 
+TEST(PlanningScene, checkCollisionBatch)
+{
+  srdf::ModelSharedPtr srdf_model(new srdf::Model());
+  urdf::ModelInterfaceSharedPtr urdf_model;
+  loadRobotModels(urdf_model, srdf_model);
+
+  planning_scene::PlanningScenePtr ps(new planning_scene::PlanningScene(urdf_model, srdf_model));
+  std::vector<robot_state::RobotStatePtr> robot_states;
+  std::vector<const robot_state::RobotState*> states;
+  for (std::size_t i = 0; i < 50; ++i)
+  {
+    robot_states.push_back(std::make_shared<robot_state::RobotState>(ps->getCurrentState()));
+    robot_states.back()->setToRandomPositions();
+    robot_states.back()->update();
+    states.push_back(robot_states.back().get());
+  }
+
+  std::vector<bool> expected;
+  std::size_t first_collision = states.size();
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    collision_detection::CollisionRequest req;
+    collision_detection::CollisionResult res;
+    ps->checkCollision(req, res, *states[i]);
+    expected.push_back(res.collision);
+    if (res.collision && first_collision == states.size())
+      first_collision = i;
+  }
+
+  collision_detection::CollisionBatchRequest req;
+  std::vector<collision_detection::CollisionResult> results;
+  for (unsigned int num_threads : { 1, 4 })
+  {
+    req.num_threads = num_threads;
+    req.stop_at_first_collision = false;
+    ps->checkCollisionBatch(req, states, results);
+    ASSERT_EQ(results.size(), states.size());
+    for (std::size_t i = 0; i < states.size(); ++i)
+      EXPECT_EQ(results[i].collision, expected[i]);
+
+    // all states up to the first colliding one are checked before stopping, and the results end there
+    req.stop_at_first_collision = true;
+    ps->checkCollisionBatch(req, states, results);
+    ASSERT_EQ(results.size(), std::min(first_collision + 1, states.size()));
+    for (std::size_t i = 0; i < results.size(); ++i)
+      EXPECT_EQ(results[i].collision, expected[i]);
+  }
+}
+
+TEST(PlanningScene, isPathValidParallel)
+{
+  srdf::ModelSharedPtr srdf_model(new srdf::Model());
+  urdf::ModelInterfaceSharedPtr urdf_model;
+  loadRobotModels(urdf_model, srdf_model);
+
+  planning_scene::PlanningScenePtr ps(new planning_scene::PlanningScene(urdf_model, srdf_model));
+  robot_trajectory::RobotTrajectory trajectory(ps->getRobotModel(), "right_arm");
+  robot_state::RobotState state(ps->getCurrentState());
+  for (std::size_t i = 0; i < 50; ++i)
+  {
+    state.setToRandomPositions();
+    state.update();
+    trajectory.addSuffixWayPoint(state, 0.1);
+  }
+
+  std::vector<std::size_t> expected;
+  bool expected_valid = ps->isPathValid(trajectory, "", false, &expected);
+
+  planning_scene::PathValidityRequest req;
+  std::vector<std::size_t> invalid;
+  for (unsigned int num_threads : { 1, 4 })
+  {
+    req.num_threads = num_threads;
+    req.first_invalid_only = false;
+    EXPECT_EQ(expected_valid, ps->isPathValid(trajectory, moveit_msgs::msg::Constraints(),
+                                              std::vector<moveit_msgs::msg::Constraints>(), req, &invalid));
+    EXPECT_EQ(expected, invalid);
+
+    req.first_invalid_only = true;
+    EXPECT_EQ(expected_valid, ps->isPathValid(trajectory, moveit_msgs::msg::Constraints(),
+                                              std::vector<moveit_msgs::msg::Constraints>(), req, &invalid));
+    if (expected_valid)
+      EXPECT_TRUE(invalid.empty());
+    else
+      EXPECT_EQ(std::vector<std::size_t>(1, expected.front()), invalid);
+  }
+}
+
+TEST(PlanningScene, isPathValidInterpolated)
+{
+  srdf::ModelSharedPtr srdf_model(new srdf::Model());
+  urdf::ModelInterfaceSharedPtr urdf_model;
+  loadRobotModels(urdf_model, srdf_model);
+
+  planning_scene::PlanningScenePtr ps(new planning_scene::PlanningScene(urdf_model, srdf_model));
+  // only states in between the waypoints are infeasible
+  ps->setStateFeasibilityPredicate([](const robot_state::RobotState& state, bool) {
+    return std::fabs(state.getVariablePosition("r_shoulder_pan_joint") + 0.2) > 0.05;
+  });
+
+  robot_trajectory::RobotTrajectory trajectory(ps->getRobotModel(), "right_arm");
+  robot_state::RobotState state(ps->getCurrentState());
+  for (double position : { -0.5, 0.1, 0.3 })
+  {
+    state.setVariablePosition("r_shoulder_pan_joint", position);
+    state.update();
+    trajectory.addSuffixWayPoint(state, 0.1);
+  }
+  ASSERT_TRUE(ps->isPathValid(trajectory, "right_arm"));
+
+  planning_scene::PathValidityRequest req;
+  req.group = "right_arm";
+  req.resolution = 0.02;
+  req.num_threads = 4;
+  std::vector<std::size_t> invalid;
+  planning_scene::PathValidityResult result;
+  EXPECT_FALSE(ps->isPathValid(trajectory, moveit_msgs::msg::Constraints(),
+                               std::vector<moveit_msgs::msg::Constraints>(), req, &invalid, &result));
+  EXPECT_EQ(std::vector<std::size_t>(1, 0), invalid);
+
+  // the states are rejected for being infeasible, not for being in collision
+  EXPECT_EQ(std::vector<std::size_t>(1, 0), result.infeasible_index);
+  EXPECT_TRUE(result.colliding_index.empty());
+  EXPECT_TRUE(result.path_constraints_violated_index.empty());
+  EXPECT_FALSE(result.goal_violated);
+}
+
+TEST(PlanningScene, isPathValidFeasibilityInCallingThread)
+{
+  srdf::ModelSharedPtr srdf_model(new srdf::Model());
+  urdf::ModelInterfaceSharedPtr urdf_model;
+  loadRobotModels(urdf_model, srdf_model);
+
+  planning_scene::PlanningScenePtr ps(new planning_scene::PlanningScene(urdf_model, srdf_model));
+  const std::thread::id caller = std::this_thread::get_id();
+  std::size_t other_thread_calls = 0;
+  ps->setStateFeasibilityPredicate([&](const robot_state::RobotState& state, bool) {
+    if (std::this_thread::get_id() != caller)
+      ++other_thread_calls;
+    return state.getVariablePosition("r_shoulder_pan_joint") < 0.25;
+  });
+
+  robot_trajectory::RobotTrajectory trajectory(ps->getRobotModel(), "right_arm");
+  robot_state::RobotState state(ps->getCurrentState());
+  for (double position : { -0.5, 0.0, 0.3, 0.4 })
+  {
+    state.setVariablePosition("r_shoulder_pan_joint", position);
+    state.update();
+    trajectory.addSuffixWayPoint(state, 0.1);
+  }
+
+  // the feasibility predicate is not required to be thread-safe
+  planning_scene::PathValidityRequest req;
+  req.group = "right_arm";
+  req.resolution = 0.01;
+  req.num_threads = 4;
+  std::vector<std::size_t> invalid;
+  planning_scene::PathValidityResult result;
+  EXPECT_FALSE(ps->isPathValid(trajectory, moveit_msgs::msg::Constraints(),
+                               std::vector<moveit_msgs::msg::Constraints>(), req, &invalid, &result));
+  EXPECT_EQ(other_thread_calls, 0u);
+  EXPECT_EQ(std::vector<std::size_t>({ 1, 2, 3 }), invalid);
+  EXPECT_EQ(std::vector<std::size_t>({ 1, 2, 3 }), result.infeasible_index);
+  EXPECT_TRUE(result.colliding_index.empty());
+
+  // an invalid last waypoint violating the goal is reported twice, like before
+  moveit_msgs::msg::Constraints goal;
+  goal.joint_constraints.resize(1);
+  goal.joint_constraints[0].joint_name = "r_shoulder_pan_joint";
+  goal.joint_constraints[0].position = -0.5;
+  goal.joint_constraints[0].tolerance_above = 0.01;
+  goal.joint_constraints[0].tolerance_below = 0.01;
+  goal.joint_constraints[0].weight = 1.0;
+  EXPECT_FALSE(ps->isPathValid(trajectory, moveit_msgs::msg::Constraints(), goal, "right_arm", false, &invalid));
+  EXPECT_EQ(std::vector<std::size_t>({ 2, 3, 3 }), invalid);
+  req.resolution = 0.0;
+  req.num_threads = 1;
+  EXPECT_FALSE(ps->isPathValid(trajectory, moveit_msgs::msg::Constraints(),
+                               std::vector<moveit_msgs::msg::Constraints>(1, goal), req, &invalid, &result));
+  EXPECT_EQ(std::vector<std::size_t>({ 2, 3, 3 }), invalid);
+  EXPECT_TRUE(result.goal_violated);
+}
+
+TEST(PlanningScene, resolveFrame)
+{
+  srdf::ModelSharedPtr srdf_model(new srdf::Model());
+  urdf::ModelInterfaceSharedPtr urdf_model;
+  loadRobotModels(urdf_model, srdf_model);
+
+  planning_scene::PlanningScenePtr ps(new planning_scene::PlanningScene(urdf_model, srdf_model));
+  Eigen::Isometry3d object_pose(Eigen::Translation3d(1.0, 0.0, 0.5));
+  ps->getWorldNonConst()->addToObject("box", shapes::ShapeConstPtr(new shapes::Box(0.1, 0.1, 0.1)), object_pose);
+  Eigen::Isometry3d fixed_pose(Eigen::Translation3d(0.0, 2.0, 0.0));
+  ps->getTransformsNonConst().setTransform(fixed_pose, "fixed");
+
+  robot_state::RobotState state(ps->getCurrentState());
+  state.setToRandomPositions();
+  state.update();
+
+  EXPECT_EQ(planning_scene::FrameHandle::MODEL_FRAME, ps->resolveFrame(ps->getRobotModel()->getModelFrame()).type);
+  EXPECT_EQ(planning_scene::FrameHandle::LINK, ps->resolveFrame("/r_wrist_roll_link").type);
+  EXPECT_EQ(planning_scene::FrameHandle::WORLD_OBJECT, ps->resolveFrame("box").type);
+  EXPECT_EQ(planning_scene::FrameHandle::FIXED_FRAME, ps->resolveFrame("fixed").type);
+  EXPECT_EQ(planning_scene::FrameHandle::UNKNOWN, ps->resolveFrame("unknown").type);
+
+  for (const std::string& id : { ps->getRobotModel()->getModelFrame(), std::string("r_wrist_roll_link"),
+                                 std::string("box"), std::string("fixed"), std::string("unknown") })
+  {
+    planning_scene::FrameHandle frame = ps->resolveFrame(state, id);
+    EXPECT_EQ(ps->knowsFrameTransform(state, id), ps->knowsFrameTransform(state, frame));
+    EXPECT_TRUE(ps->getFrameTransform(state, id).isApprox(ps->getFrameTransform(state, frame)));
+  }
+
+  // handles of fixed frames are checked against the transforms of the scene they are used with
+  planning_scene::PlanningScenePtr child = ps->diff();
+  child->getTransformsNonConst().setTransform(fixed_pose.inverse(), "other");
+  planning_scene::FrameHandle frame = ps->resolveFrame("fixed");
+  EXPECT_TRUE(child->knowsFrameTransform(state, frame));
+  EXPECT_TRUE(child->getFrameTransform(state, frame).isApprox(fixed_pose));
+}
+
+// Compare the content of two scenes as covered by snapshots
+void expectEqualScenes(const planning_scene::PlanningScene& expected, const planning_scene::PlanningScene& scene)
+{
+  EXPECT_EQ(expected.getName(), scene.getName());
+
+  const robot_state::RobotState& expected_state = expected.getCurrentState();
+  const robot_state::RobotState& state = scene.getCurrentState();
+  for (std::size_t i = 0; i < expected_state.getVariableCount(); ++i)
+    EXPECT_EQ(expected_state.getVariablePosition(i), state.getVariablePosition(i));
+  std::vector<const robot_state::AttachedBody*> expected_bodies, bodies;
+  expected_state.getAttachedBodies(expected_bodies);
+  state.getAttachedBodies(bodies);
+  ASSERT_EQ(expected_bodies.size(), bodies.size());
+  for (const robot_state::AttachedBody* expected_body : expected_bodies)
+  {
+    const robot_state::AttachedBody* body = state.getAttachedBody(expected_body->getName());
+    ASSERT_TRUE(body);
+    EXPECT_EQ(expected_body->getAttachedLinkName(), body->getAttachedLinkName());
+    EXPECT_EQ(expected_body->getTouchLinks(), body->getTouchLinks());
+    ASSERT_EQ(expected_body->getShapes().size(), body->getShapes().size());
+    EXPECT_TRUE(expected_body->getFixedTransforms()[0].isApprox(body->getFixedTransforms()[0]));
+    EXPECT_EQ(expected_body->getDetachPosture(), body->getDetachPosture());
+  }
+
+  EXPECT_EQ(expected.getWorld()->getObjectIds(), scene.getWorld()->getObjectIds());
+  for (const auto& expected_object : *expected.getWorld())
+  {
+    collision_detection::World::ObjectConstPtr object = scene.getWorld()->getObject(expected_object.first);
+    ASSERT_TRUE(object);
+    ASSERT_EQ(expected_object.second->shapes_.size(), object->shapes_.size());
+    for (std::size_t i = 0; i < object->shapes_.size(); ++i)
+    {
+      EXPECT_EQ(expected_object.second->shapes_[i]->type, object->shapes_[i]->type);
+      EXPECT_TRUE(expected_object.second->shape_poses_[i].isApprox(object->shape_poses_[i]));
+    }
+    EXPECT_EQ(expected.hasObjectColor(expected_object.first), scene.hasObjectColor(expected_object.first));
+    ASSERT_EQ(expected.hasObjectType(expected_object.first), scene.hasObjectType(expected_object.first));
+    if (expected.hasObjectType(expected_object.first))
+      EXPECT_EQ(expected.getObjectType(expected_object.first), scene.getObjectType(expected_object.first));
+  }
+
+  EXPECT_EQ(expected.getTransforms().getAllTransforms().size(), scene.getTransforms().getAllTransforms().size());
+  moveit_msgs::msg::AllowedCollisionMatrix expected_acm, acm;
+  expected.getAllowedCollisionMatrix().getMessage(expected_acm);
+  scene.getAllowedCollisionMatrix().getMessage(acm);
+  EXPECT_EQ(expected_acm, acm);
+}
+
+TEST(PlanningScene, SnapshotRoundTrip)
+{
+  srdf::ModelSharedPtr srdf_model(new srdf::Model());
+  urdf::ModelInterfaceSharedPtr urdf_model;
+  loadRobotModels(urdf_model, srdf_model);
+
+  planning_scene::PlanningScene ps(urdf_model, srdf_model);
+  ps.setName("snapshot");
+  ps.getCurrentStateNonConst().setToRandomPositions();
+
+  shapes::Mesh* mesh = new shapes::Mesh(4, 2);
+  double vertices[12] = { 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+  unsigned int triangles[6] = { 0, 1, 2, 0, 1, 3 };
+  std::copy(vertices, vertices + 12, mesh->vertices);
+  std::copy(triangles, triangles + 6, mesh->triangles);
+  mesh->computeTriangleNormals();
+  mesh->computeVertexNormals();
+  Eigen::Isometry3d pose(Eigen::Translation3d(1.0, 0.5, 0.2) * Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitZ()));
+  ps.getWorldNonConst()->addToObject("mesh", shapes::ShapeConstPtr(mesh), pose);
+  ps.getWorldNonConst()->addToObject("primitives", shapes::ShapeConstPtr(new shapes::Box(0.1, 0.2, 0.3)), pose);
+  ps.getWorldNonConst()->addToObject("primitives", shapes::ShapeConstPtr(new shapes::Cylinder(0.1, 0.2)),
+                                     pose.inverse());
+  std_msgs::msg::ColorRGBA color;
+  color.r = 1.0;
+  color.a = 0.5;
+  ps.setObjectColor("mesh", color);
+  object_recognition_msgs::msg::ObjectType type;
+  type.key = "mug";
+  type.db = "objects";
+  ps.setObjectType("primitives", type);
+
+  std::shared_ptr<octomap::OcTree> octree = std::make_shared<octomap::OcTree>(0.05);
+  octree->updateNode(octomap::point3d(1.0, 1.0, 1.0), true);
+  // an occupancy that is not one of the clamping thresholds
+  const octomap::point3d uncertain(0.5, 0.5, 0.5);
+  octree->setNodeValue(uncertain, 0.3f);
+  ps.getWorldNonConst()->addToObject(planning_scene::PlanningScene::OCTOMAP_NS,
+                                     shapes::ShapeConstPtr(new shapes::OcTree(octree)), pose);
+
+  trajectory_msgs::msg::JointTrajectory detach_posture;
+  detach_posture.header.frame_id = "r_wrist_roll_link";
+  detach_posture.joint_names = { "r_gripper_joint" };
+  detach_posture.points.resize(1);
+  detach_posture.points[0].positions = { 0.08 };
+  detach_posture.points[0].effort = { 1.0 };
+  detach_posture.points[0].time_from_start.sec = 1;
+  detach_posture.points[0].time_from_start.nanosec = 500000000;
+  ps.getCurrentStateNonConst().attachBody("attached", { shapes::ShapeConstPtr(new shapes::Sphere(0.05)) },
+                                          EigenSTL::vector_Isometry3d(1, pose), { "r_gripper_palm_link" },
+                                          "r_wrist_roll_link", detach_posture);
+  ps.getAllowedCollisionMatrixNonConst().setEntry("mesh", "r_wrist_roll_link", true);
+  ps.getAllowedCollisionMatrixNonConst().setDefaultEntry("mesh", true);
+  ps.getTransformsNonConst().setTransform(pose, "fixed");
+
+  for (bool compress : { false, true })
+  {
+    std::stringstream stream;
+    ps.saveSnapshotToStream(stream, compress);
+
+    planning_scene::PlanningScene loaded(ps.getRobotModel());
+    loaded.getWorldNonConst()->addToObject("stale", shapes::ShapeConstPtr(new shapes::Sphere(1.0)), pose);
+    ASSERT_TRUE(loaded.loadSnapshotFromStream(stream));
+    expectEqualScenes(ps, loaded);
+
+    collision_detection::World::ObjectConstPtr loaded_mesh = loaded.getWorld()->getObject("mesh");
+    const shapes::Mesh* m = static_cast<const shapes::Mesh*>(loaded_mesh->shapes_[0].get());
+    ASSERT_EQ(4u, m->vertex_count);
+    ASSERT_EQ(2u, m->triangle_count);
+    EXPECT_TRUE(std::equal(vertices, vertices + 12, m->vertices));
+    EXPECT_TRUE(std::equal(triangles, triangles + 6, m->triangles));
+    const shapes::OcTree* loaded_octree = static_cast<const shapes::OcTree*>(
+        loaded.getWorld()->getObject(planning_scene::PlanningScene::OCTOMAP_NS)->shapes_[0].get());
+    EXPECT_EQ(octree->getNumLeafNodes(), loaded_octree->octree->getNumLeafNodes());
+    EXPECT_EQ(octree->getResolution(), loaded_octree->octree->getResolution());
+    const octomap::OcTreeNode* node = loaded_octree->octree->search(uncertain);
+    ASSERT_TRUE(node);
+    EXPECT_FLOAT_EQ(0.3f, node->getLogOdds());
+  }
+
+  // memory-mapped loading from a file
+  std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+  ASSERT_TRUE(ps.saveSnapshotToFile(filename, true));
+  planning_scene::PlanningScene loaded(ps.getRobotModel());
+  EXPECT_TRUE(loaded.loadSnapshotFromFile(filename));
+  expectEqualScenes(ps, loaded);
+  boost::filesystem::remove(filename);
+  EXPECT_FALSE(loaded.loadSnapshotFromFile(filename));
+
+  // truncated or corrupt data does not change the scene
+  std::stringstream stream;
+  ps.saveSnapshotToStream(stream);
+  std::string data = stream.str();
+  planning_scene::PlanningScene empty(ps.getRobotModel());
+  EXPECT_FALSE(empty.loadSnapshotFromBuffer(data.data(), data.size() - 1));
+  data[3] = 'X';
+  EXPECT_FALSE(empty.loadSnapshotFromBuffer(data.data(), data.size()));
+  EXPECT_TRUE(empty.getWorld()->getObjectIds().empty());
+}
+
 TEST(PlanningScene, loadGoodSceneGeometry)
 {
   srdf::ModelSharedPtr srdf_model(new srdf::Model());
@@ -51,6 +51,7 @@
 #include <moveit/robot_model/prismatic_joint_model.h>
 #include <Eigen/Geometry>
 #include <iostream>
+#include <mutex>
 
 /** \brief Main namespace for MoveIt! */
 namespace moveit
@@ -338,6 +339,21 @@ public:
   double distance(const double* state1, const double* state2) const;
   void interpolate(const double* from, const double* to, double t, double* state) const;
 
+  /** \name Memory for robot states
+   *  All RobotState instances of a model need a memory block of the same size. Released blocks are pooled (up to a
+   *  limit) and handed out again, which saves a malloc() / free() pair for every state that is created. These
+   *  functions are thread safe.
+   *  @{
+   */
+
+  /** \brief Get a block of \e bytes of memory, aligned like the result of malloc() */
+  void* allocateStateMemory(std::size_t bytes) const;
+
+  /** \brief Give back a block of \e bytes of memory that was obtained from allocateStateMemory() */
+  void releaseStateMemory(void* block, std::size_t bytes) const;
+
+  /** @} */
+
   /** \name Access to joint groups
    *  @{
    */
@@ -567,6 +583,17 @@ protected:
   /** \brief The array of end-effectors, in alphabetical order */
   std::vector<const JointModelGroup*> end_effectors_;
 
+  // STATE MEMORY
+
+  /** \brief Protects the pool of state memory blocks */
+  mutable std::mutex state_memory_lock_;
+
+  /** \brief The memory blocks released by robot states, for reuse by new states */
+  mutable std::vector<void*> state_memory_blocks_;
+
+  /** \brief The size of the pooled memory blocks (0 as long as no block was released) */
+  mutable std::size_t state_memory_block_size_;
+
   /** \brief Given an URDF model and a SRDF model, build a full kinematic model */
   void buildModel(const urdf::ModelInterface& urdf_model, const srdf::Model& srdf_model);
 
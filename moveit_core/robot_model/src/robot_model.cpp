@@ -40,6 +40,7 @@
 #include <boost/math/constants/constants.hpp>
 #include <moveit/profiler/profiler.h>
 #include <algorithm>
+#include <cstdlib>
 #include <limits>
 #include <queue>
 #include <cmath>
@@ -54,6 +55,7 @@ namespace core
 rclcpp::Logger LOGGER_ROBOT_MODEL = rclcpp::get_logger("robot_model");
 
 RobotModel::RobotModel(const urdf::ModelInterfaceSharedPtr& urdf_model, const srdf::ModelConstSharedPtr& srdf_model)
+  : state_memory_block_size_(0)
 {
   root_joint_ = nullptr;
   urdf_ = urdf_model;
@@ -69,6 +71,8 @@ RobotModel::~RobotModel()
     delete joint_model_vector_[i];
   for (std::size_t i = 0; i < link_model_vector_.size(); ++i)
     delete link_model_vector_[i];
+  for (void* block : state_memory_blocks_)
+    free(block);
 }
 
 const JointModel* RobotModel::getRootJoint() const
@@ -1291,6 +1295,45 @@ void RobotModel::interpolate(const double* from, const double* to, double t, dou
   updateMimicJoints(state);
 }
 
+namespace
+{
+// released state memory blocks are pooled up to this total size (but at least MIN_POOLED_STATE_MEMORY_BLOCKS of them)
+const std::size_t MAX_POOLED_STATE_MEMORY = 16 * 1024 * 1024;
+const std::size_t MIN_POOLED_STATE_MEMORY_BLOCKS = 16;
+}  // namespace
+
+void* RobotModel::allocateStateMemory(std::size_t bytes) const
+{
+  {
+    std::lock_guard<std::mutex> lock(state_memory_lock_);
+    if (bytes == state_memory_block_size_ && !state_memory_blocks_.empty())
+    {
+      void* block = state_memory_blocks_.back();
+      state_memory_blocks_.pop_back();
+      return block;
+    }
+  }
+  return malloc(bytes);
+}
+
+void RobotModel::releaseStateMemory(void* block, std::size_t bytes) const
+{
+  if (!block)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(state_memory_lock_);
+    if (state_memory_block_size_ == 0)
+      state_memory_block_size_ = bytes;
+    if (bytes == state_memory_block_size_ &&
+        state_memory_blocks_.size() < std::max(MIN_POOLED_STATE_MEMORY_BLOCKS, MAX_POOLED_STATE_MEMORY / bytes))
+    {
+      state_memory_blocks_.push_back(block);
+      return;
+    }
+  }
+  free(block);
+}
+
 void RobotModel::setKinematicsAllocators(const std::map<std::string, SolverAllocatorFn>& allocators)
 {
   // we first set all the "simple" allocators -- where a group has one IK solver
@@ -41,6 +41,7 @@
 #include <eigen_stl_containers/eigen_stl_containers.h>
 #include <boost/function.hpp>
 #include <trajectory_msgs/msg/joint_trajectory.hpp>
+#include <memory>
 #include <set>
 
 namespace moveit
@@ -52,7 +53,10 @@ typedef boost::function<void(AttachedBody* body, bool attached)> AttachedBodyCal
 
 /** @brief Object defining bodies that can be attached to robot
  *  links. This is useful when handling objects picked up by
- *  the robot. */
+ *  the robot.
+ *
+ *  Except for the global transforms of its shapes, an attached body never changes once created. These properties are
+ *  shared between copies of a body (and thus between copies of a RobotState), which makes copying cheap. */
 class AttachedBody
 {
 public:
@@ -64,36 +68,39 @@ public:
                const EigenSTL::vector_Isometry3d& attach_trans, const std::set<std::string>& touch_links,
                const trajectory_msgs::msg::JointTrajectory& attach_posture);
 
+  /** \brief Copy constructor. The copy shares all properties but the global transforms with \e other. */
+  AttachedBody(const AttachedBody& other) = default;
+
   ~AttachedBody();
 
   /** \brief Get the name of the attached body */
   const std::string& getName() const
   {
-    return id_;
+    return properties_->id_;
   }
 
   /** \brief Get the name of the link this body is attached to */
   const std::string& getAttachedLinkName() const
   {
-    return parent_link_model_->getName();
+    return properties_->parent_link_model_->getName();
   }
 
   /** \brief Get the model of the link this body is attached to */
   const LinkModel* getAttachedLink() const
   {
-    return parent_link_model_;
+    return properties_->parent_link_model_;
   }
 
   /** \brief Get the shapes that make up this attached body */
   const std::vector<shapes::ShapeConstPtr>& getShapes() const
   {
-    return shapes_;
+    return properties_->shapes_;
   }
 
   /** \brief Get the links that the attached body is allowed to touch */
   const std::set<std::string>& getTouchLinks() const
   {
-    return touch_links_;
+    return properties_->touch_links_;
   }
 
   /** \brief Return the posture that is necessary for the object to be released, (if any). This is useful for example
@@ -101,13 +108,13 @@ public:
       the configuration of a gripper holding an object */
   const trajectory_msgs::msg::JointTrajectory& getDetachPosture() const
   {
-    return detach_posture_;
+    return properties_->detach_posture_;
   }
 
   /** \brief Get the fixed transform (the transforms to the shapes associated with this body) */
   const EigenSTL::vector_Isometry3d& getFixedTransforms() const
   {
-    return attach_trans_;
+    return properties_->attach_trans_;
   }
 
   /** \brief Get the global transforms for the collision bodies */
@@ -116,38 +123,49 @@ public:
     return global_collision_body_transforms_;
   }
 
-  /** \brief Set the padding for the shapes of this attached object */
+  /** \brief Set the padding for the shapes of this attached object. Copies of this body are not affected. */
   void setPadding(double padding);
 
-  /** \brief Set the scale for the shapes of this attached object */
+  /** \brief Set the scale for the shapes of this attached object. Copies of this body are not affected. */
   void setScale(double scale);
 
   /** \brief Recompute global_collision_body_transform given the transform of the parent link*/
   void computeTransform(const Eigen::Isometry3d& parent_link_global_transform)
   {
+    const EigenSTL::vector_Isometry3d& attach_trans = properties_->attach_trans_;
     for (std::size_t i = 0; i < global_collision_body_transforms_.size(); ++i)
-      global_collision_body_transforms_[i] = parent_link_global_transform * attach_trans_[i];
+      global_collision_body_transforms_[i] = parent_link_global_transform * attach_trans[i];
   }
 
 private:
-  /** \brief The link that owns this attached body */
-  const LinkModel* parent_link_model_;
+  /** \brief The properties of an attached body that do not depend on the state of the robot */
+  struct Properties
+  {
+    /** \brief The link that owns this attached body */
+    const LinkModel* parent_link_model_;
 
-  /** \brief string id for reference */
-  std::string id_;
+    /** \brief string id for reference */
+    std::string id_;
 
-  /** \brief The geometries of the attached body */
-  std::vector<shapes::ShapeConstPtr> shapes_;
+    /** \brief The geometries of the attached body */
+    std::vector<shapes::ShapeConstPtr> shapes_;
 
-  /** \brief The constant transforms applied to the link (needs to be specified by user) */
-  EigenSTL::vector_Isometry3d attach_trans_;
+    /** \brief The constant transforms applied to the link (needs to be specified by user) */
+    EigenSTL::vector_Isometry3d attach_trans_;
 
-  /** \brief The set of links this body is allowed to touch */
-  std::set<std::string> touch_links_;
+    /** \brief The set of links this body is allowed to touch */
+    std::set<std::string> touch_links_;
 
-  /** \brief Posture of links for releasing the object (if any). This is useful for example when storing
-      the configuration of a gripper holding an object */
-  trajectory_msgs::msg::JointTrajectory detach_posture_;
+    /** \brief Posture of links for releasing the object (if any). This is useful for example when storing
+        the configuration of a gripper holding an object */
+    trajectory_msgs::msg::JointTrajectory detach_posture_;
+  };
+
+  /** \brief Get the properties for modification, copying them first if they are shared with other bodies */
+  Properties& getMutableProperties();
+
+  /** \brief The properties of this body, shared with its copies */
+  std::shared_ptr<const Properties> properties_;
 
   /** \brief The global transforms for these attached bodies (computed by forward kinematics) */
   EigenSTL::vector_Isometry3d global_collision_body_transforms_;
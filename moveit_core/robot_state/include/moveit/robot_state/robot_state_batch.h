@@ -0,0 +1,184 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#ifndef MOVEIT_CORE_ROBOT_STATE_BATCH_
+#define MOVEIT_CORE_ROBOT_STATE_BATCH_
+
+#include <moveit/robot_state/robot_state.h>
+#include <Eigen/Core>
+
+namespace moveit
+{
+namespace core
+{
+MOVEIT_CLASS_FORWARD(RobotStateBatch)
+
+/** \brief The joint positions and link transforms of many configurations of a robot, e.g. the vertices of a roadmap,
+    IK seeds or the waypoints of a trajectory, stored as structure of arrays.
+
+    The positions of each variable, and each element of each global link transform, are contiguous over all
+    configurations. Forward kinematics is computed one link at a time for all configurations: the constant parts of the
+    transforms of revolute, prismatic and fixed joints are folded together in advance, and the remaining arithmetic
+    runs on blocks of BLOCK_SIZE configurations, which Eigen vectorizes. Only planar and floating joints are computed
+    configuration by configuration. This is considerably faster than updating a RobotState per configuration.
+
+    In contrast to RobotState, there are no velocities, accelerations, attached bodies or partial updates. */
+class RobotStateBatch
+{
+public:
+  /** \brief The number of configurations computed together. Storage is padded to a multiple of it. */
+  static const int BLOCK_SIZE = 8;
+
+  /** \brief Create a batch of \e size configurations of \e robot_model, all at the default positions */
+  RobotStateBatch(const RobotModelConstPtr& robot_model, std::size_t size = 0);
+
+  const RobotModelConstPtr& getRobotModel() const
+  {
+    return robot_model_;
+  }
+
+  /** \brief The number of configurations */
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  /** \brief Change the number of configurations. Configurations that are added are at the default positions. */
+  void resize(std::size_t size);
+
+  /** \brief Get the positions of variable \e variable_index in all configurations (size() contiguous values) for
+      modification. Values of mimic joints are overwritten with the ones computed from the mimicked joint by
+      updateLinkTransforms(). */
+  double* getVariablePositions(std::size_t variable_index)
+  {
+    dirty_ = true;
+    return positions_.col(variable_index).data();
+  }
+
+  /** \brief Get the positions of variable \e variable_index in all configurations (size() contiguous values) */
+  const double* getVariablePositions(std::size_t variable_index) const
+  {
+    return positions_.col(variable_index).data();
+  }
+
+  /** \brief Set the positions of all variables of configuration \e index, ordered as in the robot model */
+  void setPositions(std::size_t index, const double* positions);
+
+  /** \brief Get the positions of all variables of configuration \e index, ordered as in the robot model */
+  void getPositions(std::size_t index, double* positions) const;
+
+  /** \brief Set configuration \e index to the positions of \e state */
+  void setFromState(std::size_t index, const RobotState& state)
+  {
+    setPositions(index, state.getVariablePositions());
+  }
+
+  /** \brief Set the positions of \e state to the ones of configuration \e index */
+  void copyToState(std::size_t index, RobotState& state) const;
+
+  /** \brief Compute the global transforms of all links in all configurations, if any position changed */
+  void updateLinkTransforms();
+
+  /** \brief Check if link transforms need to be updated before they can be read */
+  bool dirty() const
+  {
+    return dirty_;
+  }
+
+  /** \brief Get the global transform of \e link in configuration \e index. Requires up-to-date link transforms. */
+  Eigen::Isometry3d getGlobalLinkTransform(std::size_t index, const LinkModel* link) const;
+
+  /** \brief Get element (\e row, \e col) of the global transform of \e link in all configurations (size() contiguous
+      values). \e row is in [0, 2], \e col is in [0, 3]; column 3 is the translation. Requires up-to-date link
+      transforms. */
+  const double* getGlobalLinkTransformElement(const LinkModel* link, int row, int col) const
+  {
+    return link_transforms_.col(link->getLinkIndex() * ELEMENTS + col * 3 + row).data();
+  }
+
+private:
+  /* The elements of a link transform: the rotation matrix in column-major order, followed by the translation */
+  static const int ELEMENTS = 12;
+
+  /* How the transform of a link is computed from the one of its parent link */
+  struct LinkUpdate
+  {
+    enum Type
+    {
+      FIXED,
+      REVOLUTE,
+      PRISMATIC,
+      GENERIC
+    };
+
+    Type type_;
+    const JointModel* joint_;
+    int link_index_;
+    int parent_link_index_;  // -1 for the root link
+    int variable_index_;
+
+    /* Except for GENERIC joints, the transform relative to the parent link (joint origin times joint transform) is
+       [c_ + cos(q) * a_ + sin(q) * b_ | t_ + q * d_] for joint position q */
+    Eigen::Matrix3d c_, a_, b_;
+    Eigen::Vector3d t_, d_;
+
+    /* The joint origin, for GENERIC joints */
+    Eigen::Isometry3d origin_;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /* Compute the transforms of the link of \e update in all configurations */
+  void updateLink(const LinkUpdate& update);
+
+  /* Set the positions of all mimic joints from the ones of the joints they mimic */
+  void updateMimicJoints();
+
+  RobotModelConstPtr robot_model_;
+  std::size_t size_;
+  bool dirty_;
+
+  std::vector<LinkUpdate, Eigen::aligned_allocator<LinkUpdate>> link_updates_;
+
+  // column per variable
+  Eigen::ArrayXXd positions_;
+  // ELEMENTS columns per link
+  Eigen::ArrayXXd link_transforms_;
+
+  // buffers for the sines and cosines of revolute joint positions
+  Eigen::ArrayXd cos_, sin_;
+};
+}  // namespace core
+}  // namespace moveit
+
+#endif
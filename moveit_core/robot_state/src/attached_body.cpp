@@ -42,13 +42,16 @@ moveit::core::AttachedBody::AttachedBody(const LinkModel* parent_link_model, con
                                          const EigenSTL::vector_Isometry3d& attach_trans,
                                          const std::set<std::string>& touch_links,
                                          const trajectory_msgs::msg::JointTrajectory& detach_posture)
-  : parent_link_model_(parent_link_model)
-  , id_(id)
-  , shapes_(shapes)
-  , attach_trans_(attach_trans)
-  , touch_links_(touch_links)
-  , detach_posture_(detach_posture)
 {
+  std::shared_ptr<Properties> properties = std::make_shared<Properties>();
+  properties->parent_link_model_ = parent_link_model;
+  properties->id_ = id;
+  properties->shapes_ = shapes;
+  properties->attach_trans_ = attach_trans;
+  properties->touch_links_ = touch_links;
+  properties->detach_posture_ = detach_posture;
+  properties_ = properties;
+
   global_collision_body_transforms_.resize(attach_trans.size());
   for (std::size_t i = 0; i < global_collision_body_transforms_.size(); ++i)
     global_collision_body_transforms_[i].setIdentity();
@@ -56,36 +59,48 @@ moveit::core::AttachedBody::AttachedBody(const LinkModel* parent_link_model, con
 
 moveit::core::AttachedBody::~AttachedBody() = default;
 
+moveit::core::AttachedBody::Properties& moveit::core::AttachedBody::getMutableProperties()
+{
+  // properties are always created non-const, so if they are only owned here, we can safely const-cast:
+  if (properties_.unique())
+    return const_cast<Properties&>(*properties_);
+  std::shared_ptr<Properties> copy = std::make_shared<Properties>(*properties_);
+  properties_ = copy;
+  return *copy;
+}
+
 void moveit::core::AttachedBody::setScale(double scale)
 {
-  for (std::size_t i = 0; i < shapes_.size(); ++i)
+  std::vector<shapes::ShapeConstPtr>& shapes = getMutableProperties().shapes_;
+  for (std::size_t i = 0; i < shapes.size(); ++i)
   {
     // if this shape is only owned here (and because this is a non-const function), we can safely const-cast:
-    if (shapes_[i].unique())
-      const_cast<shapes::Shape*>(shapes_[i].get())->scale(scale);
+    if (shapes[i].unique())
+      const_cast<shapes::Shape*>(shapes[i].get())->scale(scale);
     else
     {
       // if the shape is owned elsewhere, we make a copy:
-      shapes::Shape* copy = shapes_[i]->clone();
+      shapes::Shape* copy = shapes[i]->clone();
       copy->scale(scale);
-      shapes_[i].reset(copy);
+      shapes[i].reset(copy);
     }
   }
 }
 
 void moveit::core::AttachedBody::setPadding(double padding)
 {
-  for (std::size_t i = 0; i < shapes_.size(); ++i)
+  std::vector<shapes::ShapeConstPtr>& shapes = getMutableProperties().shapes_;
+  for (std::size_t i = 0; i < shapes.size(); ++i)
   {
     // if this shape is only owned here (and because this is a non-const function), we can safely const-cast:
-    if (shapes_[i].unique())
-      const_cast<shapes::Shape*>(shapes_[i].get())->padd(padding);
+    if (shapes[i].unique())
+      const_cast<shapes::Shape*>(shapes[i].get())->padd(padding);
     else
     {
       // if the shape is owned elsewhere, we make a copy:
-      shapes::Shape* copy = shapes_[i]->clone();
+      shapes::Shape* copy = shapes[i]->clone();
       copy->padd(padding);
-      shapes_[i].reset(copy);
+      shapes[i].reset(copy);
     }
   }
 }
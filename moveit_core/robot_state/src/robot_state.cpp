@@ -59,6 +59,25 @@ rclcpp::Logger LOGGER = rclcpp::get_logger("robot_state");
  * valid paths from paths with large joint space jumps. */
 static const std::size_t MIN_STEPS_FOR_JUMP_THRESH = 10;
 
+/** \brief The number of bytes added to the memory block of a state to align its transforms */
+static const std::size_t EXTRA_ALIGNMENT_BYTES = EIGEN_MAX_ALIGN_BYTES - 1;
+
+/** \brief The number of doubles holding the dirty flags of the joint transforms of a state of \e robot_model */
+static std::size_t getDirtyJointTransformsSize(const RobotModel& robot_model)
+{
+  return 1 + robot_model.getJointModelCount() / (sizeof(double) / sizeof(unsigned char));
+}
+
+/** \brief The size of the memory block of a state of \e robot_model, see RobotState::allocMemory() */
+static std::size_t getStateMemorySize(const RobotModel& robot_model)
+{
+  return sizeof(Eigen::Isometry3d) *
+             (robot_model.getJointModelCount() + robot_model.getLinkModelCount() +
+              robot_model.getLinkGeometryCount()) +
+         sizeof(double) * (robot_model.getVariableCount() * 3 + getDirtyJointTransformsSize(robot_model)) +
+         EXTRA_ALIGNMENT_BYTES;
+}
+
 RobotState::RobotState(const RobotModelConstPtr& robot_model)
   : robot_model_(robot_model)
   , has_velocity_(false)
@@ -82,7 +101,7 @@ RobotState::RobotState(const RobotState& other) : rng_(nullptr)
 RobotState::~RobotState()
 {
   clearAttachedBodies();
-  free(memory_);
+  robot_model_->releaseStateMemory(memory_, getStateMemorySize(*robot_model_));
   if (rng_)
     delete rng_;
 }
@@ -93,26 +112,18 @@ void RobotState::allocMemory()
                     sizeof(Eigen::Isometry3d),
                 "sizeof(Eigen::Isometry3d) should be a multiple of EIGEN_MAX_ALIGN_BYTES");
 
-  constexpr unsigned int extra_alignment_bytes = EIGEN_MAX_ALIGN_BYTES - 1;
-  // memory for the dirty joint transforms
-  const int nr_doubles_for_dirty_joint_transforms =
-      1 + robot_model_->getJointModelCount() / (sizeof(double) / sizeof(unsigned char));
-  const size_t bytes =
-      sizeof(Eigen::Isometry3d) * (robot_model_->getJointModelCount() + robot_model_->getLinkModelCount() +
-                                   robot_model_->getLinkGeometryCount()) +
-      sizeof(double) * (robot_model_->getVariableCount() * 3 + nr_doubles_for_dirty_joint_transforms) +
-      extra_alignment_bytes;
-  memory_ = malloc(bytes);
+  // blocks of released states are reused
+  memory_ = robot_model_->allocateStateMemory(getStateMemorySize(*robot_model_));
 
   // make the memory for transforms align at EIGEN_MAX_ALIGN_BYTES
   // https://eigen.tuxfamily.org/dox/classEigen_1_1aligned__allocator.html
-  variable_joint_transforms_ = reinterpret_cast<Eigen::Isometry3d*>(((uintptr_t)memory_ + extra_alignment_bytes) &
-                                                                    ~(uintptr_t)extra_alignment_bytes);
+  variable_joint_transforms_ = reinterpret_cast<Eigen::Isometry3d*>(((uintptr_t)memory_ + EXTRA_ALIGNMENT_BYTES) &
+                                                                    ~(uintptr_t)EXTRA_ALIGNMENT_BYTES);
   global_link_transforms_ = variable_joint_transforms_ + robot_model_->getJointModelCount();
   global_collision_body_transforms_ = global_link_transforms_ + robot_model_->getLinkModelCount();
   dirty_joint_transforms_ =
       reinterpret_cast<unsigned char*>(global_collision_body_transforms_ + robot_model_->getLinkGeometryCount());
-  position_ = reinterpret_cast<double*>(dirty_joint_transforms_) + nr_doubles_for_dirty_joint_transforms;
+  position_ = reinterpret_cast<double*>(dirty_joint_transforms_) + getDirtyJointTransformsSize(*robot_model_);
   velocity_ = position_ + robot_model_->getVariableCount();
   // acceleration and effort share the memory (not both can be specified)
   effort_ = acceleration_ = velocity_ + robot_model_->getVariableCount();
@@ -172,12 +183,16 @@ void RobotState::copyFrom(const RobotState& other)
     memcpy(variable_joint_transforms_, other.variable_joint_transforms_, bytes);
   }
 
-  // copy attached bodies
+  // copy attached bodies; the copies share all properties but their global transforms with the original ones
   clearAttachedBodies();
   for (std::map<std::string, AttachedBody*>::const_iterator it = other.attached_body_map_.begin();
        it != other.attached_body_map_.end(); ++it)
-    attachBody(it->second->getName(), it->second->getShapes(), it->second->getFixedTransforms(),
-               it->second->getTouchLinks(), it->second->getAttachedLinkName(), it->second->getDetachPosture());
+  {
+    AttachedBody* ab = new AttachedBody(*it->second);
+    attached_body_map_.emplace_hint(attached_body_map_.end(), it->first, ab);
+    if (attached_body_update_callback_)
+      attached_body_update_callback_(ab, true);
+  }
 }
 
 bool RobotState::checkJointTransforms(const JointModel* joint) const
@@ -0,0 +1,297 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#include <moveit/robot_state/robot_state_batch.h>
+#include <algorithm>
+#include <cmath>
+
+namespace moveit
+{
+namespace core
+{
+namespace
+{
+// Read the transform in row \e index of \e columns (the ELEMENTS columns of a link)
+void getTransform(const Eigen::Ref<const Eigen::ArrayXXd>& columns, std::size_t index, Eigen::Isometry3d& transform)
+{
+  for (int col = 0; col < 4; ++col)
+    for (int row = 0; row < 3; ++row)
+      transform.matrix()(row, col) = columns(index, col * 3 + row);
+  transform.matrix().row(3) << 0.0, 0.0, 0.0, 1.0;
+}
+
+// Write \e transform to row \e index of \e columns (the ELEMENTS columns of a link)
+template <typename Columns>
+void setTransform(Columns&& columns, std::size_t index, const Eigen::Isometry3d& transform)
+{
+  for (int col = 0; col < 4; ++col)
+    for (int row = 0; row < 3; ++row)
+      columns(index, col * 3 + row) = transform.matrix()(row, col);
+}
+
+// The configurations are processed in blocks of BLOCK_SIZE, which Eigen vectorizes
+typedef Eigen::Array<double, RobotStateBatch::BLOCK_SIZE, 1> Block;
+typedef Eigen::Map<const Block> ConstBlockMap;
+typedef Eigen::Map<Block> BlockMap;
+
+/* Compute the link transforms result = parent * [m | u] of \e n configurations (a multiple of BLOCK_SIZE), where
+   m = c + cos_q * a + sin_q * b for revolute joints (m = c otherwise) and u = t + q * d for prismatic joints (u = t
+   otherwise). Element e of the transforms of configuration k is at [e * n + k] of \e parent and \e result. Without
+   parent, the parent transforms are the identity. */
+template <bool REVOLUTE, bool PRISMATIC, bool PARENT>
+void computeLinkTransforms(const double* parent, const double* q, const double* cos_q, const double* sin_q,
+                           const Eigen::Matrix3d& c, const Eigen::Matrix3d& a, const Eigen::Matrix3d& b,
+                           const Eigen::Vector3d& t, const Eigen::Vector3d& d, double* result, std::size_t n)
+{
+  Block m[9], u[3];
+  for (std::size_t k = 0; k < n; k += RobotStateBatch::BLOCK_SIZE)
+  {
+    for (int e = 0; e < 9; ++e)
+      if (REVOLUTE)
+        m[e] = c(e) + ConstBlockMap(cos_q + k) * a(e) + ConstBlockMap(sin_q + k) * b(e);
+      else
+        m[e].setConstant(c(e));
+    for (int i = 0; i < 3; ++i)
+      if (PRISMATIC)
+        u[i] = t(i) + ConstBlockMap(q + k) * d(i);
+      else
+        u[i].setConstant(t(i));
+
+    if (!PARENT)
+    {
+      for (int e = 0; e < 9; ++e)
+        BlockMap(result + e * n + k) = m[e];
+      for (int i = 0; i < 3; ++i)
+        BlockMap(result + (9 + i) * n + k) = u[i];
+      continue;
+    }
+
+    // element (row, col) of a rotation is at index col * 3 + row
+    for (int row = 0; row < 3; ++row)
+    {
+      const ConstBlockMap p0(parent + row * n + k);
+      const ConstBlockMap p1(parent + (3 + row) * n + k);
+      const ConstBlockMap p2(parent + (6 + row) * n + k);
+      for (int col = 0; col < 3; ++col)
+        BlockMap(result + (col * 3 + row) * n + k) = p0 * m[col * 3] + p1 * m[col * 3 + 1] + p2 * m[col * 3 + 2];
+      BlockMap(result + (9 + row) * n + k) =
+          p0 * u[0] + p1 * u[1] + p2 * u[2] + ConstBlockMap(parent + (9 + row) * n + k);
+    }
+  }
+}
+
+template <bool REVOLUTE, bool PRISMATIC>
+void computeLinkTransforms(const double* parent, const double* q, const double* cos_q, const double* sin_q,
+                           const Eigen::Matrix3d& c, const Eigen::Matrix3d& a, const Eigen::Matrix3d& b,
+                           const Eigen::Vector3d& t, const Eigen::Vector3d& d, double* result, std::size_t n)
+{
+  if (parent)
+    computeLinkTransforms<REVOLUTE, PRISMATIC, true>(parent, q, cos_q, sin_q, c, a, b, t, d, result, n);
+  else
+    computeLinkTransforms<REVOLUTE, PRISMATIC, false>(parent, q, cos_q, sin_q, c, a, b, t, d, result, n);
+}
+}  // namespace
+
+RobotStateBatch::RobotStateBatch(const RobotModelConstPtr& robot_model, std::size_t size)
+  : robot_model_(robot_model), size_(0), dirty_(true)
+{
+  // links are ordered such that parents come before their children
+  for (const LinkModel* link : robot_model_->getLinkModels())
+  {
+    LinkUpdate update;
+    update.joint_ = link->getParentJointModel();
+    update.link_index_ = link->getLinkIndex();
+    update.parent_link_index_ = link->getParentLinkModel() ? link->getParentLinkModel()->getLinkIndex() : -1;
+    update.variable_index_ = update.joint_->getFirstVariableIndex();
+    update.origin_ = link->getJointOriginTransform();
+
+    // fold the joint origin O into the joint transform
+    const Eigen::Matrix3d& rotation = update.origin_.linear();
+    update.c_ = rotation;
+    update.a_.setZero();
+    update.b_.setZero();
+    update.t_ = update.origin_.translation();
+    update.d_.setZero();
+    switch (update.joint_->getType())
+    {
+      case JointModel::FIXED:
+        update.type_ = LinkUpdate::FIXED;
+        break;
+      case JointModel::REVOLUTE:
+      {
+        // The joint rotation about axis x is cos(q) * I + sin(q) * [x]_cross + (1 - cos(q)) * x * x^T (Rodrigues'
+        // formula), so O * R(q) = O * x * x^T + cos(q) * (O - O * x * x^T) + sin(q) * O * [x]_cross
+        update.type_ = LinkUpdate::REVOLUTE;
+        const Eigen::Vector3d& axis = static_cast<const RevoluteJointModel*>(update.joint_)->getAxis();
+        Eigen::Matrix3d cross;
+        cross << 0.0, -axis.z(), axis.y(), axis.z(), 0.0, -axis.x(), -axis.y(), axis.x(), 0.0;
+        update.c_ = rotation * axis * axis.transpose();
+        update.a_ = rotation - update.c_;
+        update.b_ = rotation * cross;
+        break;
+      }
+      case JointModel::PRISMATIC:
+        // the joint translates along its axis x, so O * T(q) = [O_R | O_t + q * O_R * x]
+        update.type_ = LinkUpdate::PRISMATIC;
+        update.d_ = rotation * static_cast<const PrismaticJointModel*>(update.joint_)->getAxis();
+        break;
+      default:
+        update.type_ = LinkUpdate::GENERIC;
+        break;
+    }
+    link_updates_.push_back(update);
+  }
+  resize(size);
+}
+
+void RobotStateBatch::resize(std::size_t size)
+{
+  // round up to whole blocks; the padding configurations are computed along, but never exposed
+  const std::size_t rows = (size + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+  positions_.conservativeResize(rows, robot_model_->getVariableCount());
+  if (size > size_)
+  {
+    std::vector<double> defaults;
+    robot_model_->getVariableDefaultPositions(defaults);
+    for (std::size_t i = 0; i < defaults.size(); ++i)
+      positions_.col(i).tail(rows - size_).setConstant(defaults[i]);
+  }
+  size_ = size;
+
+  link_transforms_.resize(rows, ELEMENTS * robot_model_->getLinkModelCount());
+  cos_.resize(rows);
+  sin_.resize(rows);
+  dirty_ = true;
+}
+
+void RobotStateBatch::setPositions(std::size_t index, const double* positions)
+{
+  for (Eigen::Index i = 0; i < positions_.cols(); ++i)
+    positions_(index, i) = positions[i];
+  dirty_ = true;
+}
+
+void RobotStateBatch::getPositions(std::size_t index, double* positions) const
+{
+  for (Eigen::Index i = 0; i < positions_.cols(); ++i)
+    positions[i] = positions_(index, i);
+}
+
+void RobotStateBatch::copyToState(std::size_t index, RobotState& state) const
+{
+  std::vector<double> positions(positions_.cols());
+  getPositions(index, positions.data());
+  state.setVariablePositions(positions);
+}
+
+void RobotStateBatch::updateMimicJoints()
+{
+  for (const JointModel* joint : robot_model_->getMimicJointModels())
+    positions_.col(joint->getFirstVariableIndex()) =
+        joint->getMimicFactor() * positions_.col(joint->getMimic()->getFirstVariableIndex()) +
+        joint->getMimicOffset();
+}
+
+void RobotStateBatch::updateLinkTransforms()
+{
+  if (!dirty_)
+    return;
+  updateMimicJoints();
+
+  // links are ordered such that parents are updated before their children
+  for (const LinkUpdate& update : link_updates_)
+    updateLink(update);
+  dirty_ = false;
+}
+
+void RobotStateBatch::updateLink(const LinkUpdate& update)
+{
+  double* result = link_transforms_.col(update.link_index_ * ELEMENTS).data();
+  const double* parent =
+      update.parent_link_index_ >= 0 ? link_transforms_.col(update.parent_link_index_ * ELEMENTS).data() : nullptr;
+  const double* q = update.type_ == LinkUpdate::FIXED ? nullptr : positions_.col(update.variable_index_).data();
+
+  switch (update.type_)
+  {
+    case LinkUpdate::FIXED:
+      computeLinkTransforms<false, false>(parent, q, nullptr, nullptr, update.c_, update.a_, update.b_, update.t_,
+                                          update.d_, result, positions_.rows());
+      break;
+
+    case LinkUpdate::REVOLUTE:
+      // there are no vectorized sin() and cos(), so these are computed upfront
+      for (Eigen::Index i = 0; i < positions_.rows(); ++i)
+      {
+        cos_[i] = std::cos(q[i]);
+        sin_[i] = std::sin(q[i]);
+      }
+      computeLinkTransforms<true, false>(parent, q, cos_.data(), sin_.data(), update.c_, update.a_, update.b_,
+                                         update.t_, update.d_, result, positions_.rows());
+      break;
+
+    case LinkUpdate::PRISMATIC:
+      computeLinkTransforms<false, true>(parent, q, nullptr, nullptr, update.c_, update.a_, update.b_, update.t_,
+                                         update.d_, result, positions_.rows());
+      break;
+
+    case LinkUpdate::GENERIC:
+    {
+      // planar and floating joints are rare (usually only the root joint), so they are computed one by one
+      const std::size_t variable_count = update.joint_->getVariableCount();
+      std::vector<double> values(variable_count);
+      Eigen::Isometry3d parent_transform = Eigen::Isometry3d::Identity();
+      Eigen::Isometry3d joint_transform;
+      for (Eigen::Index i = 0; i < positions_.rows(); ++i)
+      {
+        for (std::size_t j = 0; j < variable_count; ++j)
+          values[j] = positions_(i, update.variable_index_ + j);
+        update.joint_->computeTransform(values.data(), joint_transform);
+        if (parent)
+          getTransform(link_transforms_.middleCols(update.parent_link_index_ * ELEMENTS, ELEMENTS), i,
+                       parent_transform);
+        setTransform(link_transforms_.middleCols(update.link_index_ * ELEMENTS, ELEMENTS), i,
+                     parent_transform * update.origin_ * joint_transform);
+      }
+      break;
+    }
+  }
+}
+
+Eigen::Isometry3d RobotStateBatch::getGlobalLinkTransform(std::size_t index, const LinkModel* link) const
+{
+  Eigen::Isometry3d transform;
+  getTransform(link_transforms_.middleCols(link->getLinkIndex() * ELEMENTS, ELEMENTS), index, transform);
+  return transform;
+}
+}  // namespace core
+}  // namespace moveit
@@ -36,8 +36,10 @@
 #include <moveit_resources/config.h>
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_state/robot_state_batch.h>
 #include <moveit/utils/robot_model_test_utils.h>
 #include <eigen_stl_containers/eigen_stl_containers.h>
+#include <geometric_shapes/shapes.h>
 #include <chrono>
 #include <gtest/gtest.h>
 
@@ -107,6 +109,62 @@ TEST_F(Timing, stateUpdate)
   }
 }
 
+TEST_F(Timing, stateCopy)
+{
+  robot_model::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  ASSERT_TRUE(bool(model));
+  robot_state::RobotState state(model);
+  state.setToDefaultValues();
+  state.update();
+  std::vector<shapes::ShapeConstPtr> shapes(1, shapes::ShapeConstPtr(new shapes::Box(.1, .1, .1)));
+  EigenSTL::vector_Isometry3d poses(1, Eigen::Isometry3d::Identity());
+  state.attachBody("box", shapes, poses, std::vector<std::string>(model->getLinkModelNames()), "r_gripper_palm_link");
+
+  {
+    ScopedTimer t("RobotState construction: ");
+    for (unsigned i = 0; i < 1e5; ++i)
+      robot_state::RobotState copy(model);
+  }
+  {
+    ScopedTimer t("RobotState copies (with attached body): ");
+    for (unsigned i = 0; i < 1e5; ++i)
+      robot_state::RobotState copy(state);
+  }
+}
+
+TEST_F(Timing, batchUpdate)
+{
+  robot_model::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  ASSERT_TRUE(bool(model));
+  const std::size_t size = 1000;
+  std::vector<robot_state::RobotState> states(size, robot_state::RobotState(model));
+  robot_state::RobotStateBatch batch(model, size);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    states[i].setToRandomPositions();
+    batch.setFromState(i, states[i]);
+  }
+
+  double gold_standard = 0;
+  {
+    ScopedTimer t("RobotState updates of 1000 configurations: ", &gold_standard);
+    for (unsigned r = 0; r < 100; ++r)
+      for (robot_state::RobotState& state : states)
+      {
+        state.setVariablePosition(0, state.getVariablePosition(0));  // mark dirty
+        state.update();
+      }
+  }
+  {
+    ScopedTimer t("RobotStateBatch update of 1000 configurations: ", &gold_standard);
+    for (unsigned r = 0; r < 100; ++r)
+    {
+      batch.getVariablePositions(0);  // mark dirty
+      batch.updateLinkTransforms();
+    }
+  }
+}
+
 TEST_F(Timing, multiply)
 {
   size_t runs = 1e7;
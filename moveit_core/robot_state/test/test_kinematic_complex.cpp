@@ -37,6 +37,7 @@
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/robot_state/robot_state.h>
 #include <moveit/robot_state/conversions.h>
+#include <moveit/robot_state/robot_state_batch.h>
 #include <urdf_parser/urdf_parser.h>
 #include <fstream>
 #include <gtest/gtest.h>
@@ -276,6 +277,129 @@ TEST_F(LoadPlanningModelsPr2, FullTest)
   ASSERT_EQ(attached_bodies_2.size(), 0u);
 }
 
+TEST_F(LoadPlanningModelsPr2, CopyAttachedBodies)
+{
+  moveit::core::RobotModelPtr robot_model(new moveit::core::RobotModel(urdf_model_, srdf_model_));
+  moveit::core::RobotState ks(robot_model);
+  ks.setToDefaultValues();
+  ks.update();
+
+  std::vector<shapes::ShapeConstPtr> shapes(1, shapes::ShapeConstPtr(new shapes::Box(.1, .1, .1)));
+  EigenSTL::vector_Isometry3d poses(1, Eigen::Isometry3d(Eigen::Translation3d(0.1, 0, 0)));
+  ks.attachBody("box", shapes, poses, std::set<std::string>{ "r_gripper_palm_link" }, "r_gripper_palm_link");
+
+  // copies share the properties of the attached body, but have their own global transforms
+  moveit::core::RobotState ks2(ks);
+  const moveit::core::AttachedBody* body = ks.getAttachedBody("box");
+  const moveit::core::AttachedBody* body2 = ks2.getAttachedBody("box");
+  ASSERT_TRUE(body && body2);
+  EXPECT_NE(body, body2);
+  EXPECT_EQ(&body->getTouchLinks(), &body2->getTouchLinks());
+  EXPECT_EQ(&body->getShapes(), &body2->getShapes());
+  EXPECT_TRUE(body->getGlobalCollisionBodyTransforms()[0].isApprox(body2->getGlobalCollisionBodyTransforms()[0]));
+
+  const Eigen::Isometry3d pose = body->getGlobalCollisionBodyTransforms()[0];
+  ks2.setVariablePosition("r_wrist_roll_joint", 1.0);
+  ks2.update();
+  EXPECT_TRUE(body->getGlobalCollisionBodyTransforms()[0].isApprox(pose));
+  EXPECT_FALSE(body2->getGlobalCollisionBodyTransforms()[0].isApprox(pose));
+
+  // modifying a copy does not modify the original
+  moveit::core::AttachedBody copy(*body);
+  copy.setPadding(0.1);
+  EXPECT_NE(&copy.getShapes(), &body->getShapes());
+  EXPECT_EQ(copy.getTouchLinks(), body->getTouchLinks());
+  EXPECT_DOUBLE_EQ(static_cast<const shapes::Box*>(body->getShapes()[0].get())->size[0], 0.1);
+  EXPECT_DOUBLE_EQ(static_cast<const shapes::Box*>(copy.getShapes()[0].get())->size[0], 0.3);
+  EXPECT_DOUBLE_EQ(static_cast<const shapes::Box*>(shapes[0].get())->size[0], 0.1);
+
+  ks.clearAttachedBody("box");
+  EXPECT_TRUE(ks2.hasAttachedBody("box"));
+  EXPECT_EQ(ks2.getAttachedBody("box")->getTouchLinks().size(), 1u);
+}
+
+TEST_F(LoadPlanningModelsPr2, StateMemoryPool)
+{
+  moveit::core::RobotModelPtr robot_model(new moveit::core::RobotModel(urdf_model_, srdf_model_));
+
+  // the memory of a destroyed state is reused by the next one
+  const double* positions;
+  {
+    moveit::core::RobotState ks(robot_model);
+    positions = ks.getVariablePositions();
+  }
+  moveit::core::RobotState ks(robot_model);
+  EXPECT_EQ(ks.getVariablePositions(), positions);
+  ks.setToDefaultValues();
+  ks.update();
+
+  moveit::core::RobotState ks2(ks);
+  EXPECT_NE(ks2.getVariablePositions(), positions);
+  for (std::size_t i = 0; i < robot_model->getVariableCount(); ++i)
+    EXPECT_EQ(ks.getVariablePosition(i), ks2.getVariablePosition(i));
+  EXPECT_TRUE(ks.getGlobalLinkTransform("r_gripper_palm_link")
+                  .isApprox(ks2.getGlobalLinkTransform("r_gripper_palm_link")));
+}
+
+TEST_F(LoadPlanningModelsPr2, BatchForwardKinematics)
+{
+  const std::size_t size = 21;
+  moveit::core::RobotStateBatch batch(robot_model_, size);
+  EXPECT_EQ(batch.size(), size);
+
+  std::vector<moveit::core::RobotState> states(size, moveit::core::RobotState(robot_model_));
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    states[i].setToRandomPositions();
+    states[i].update();
+    batch.setFromState(i, states[i]);
+  }
+  EXPECT_TRUE(batch.dirty());
+  batch.updateLinkTransforms();
+  EXPECT_FALSE(batch.dirty());
+
+  // the batch matches the scalar forward kinematics for all links, including the ones behind the planar root joint
+  // and mimic joints
+  for (std::size_t i = 0; i < size; ++i)
+    for (const moveit::core::LinkModel* link : robot_model_->getLinkModels())
+      EXPECT_TRUE(batch.getGlobalLinkTransform(i, link).isApprox(states[i].getGlobalLinkTransform(link), 1e-9))
+          << link->getName() << " in configuration " << i;
+
+  const moveit::core::LinkModel* link = robot_model_->getLinkModel("r_gripper_palm_link");
+  const double* x = batch.getGlobalLinkTransformElement(link, 0, 3);
+  for (std::size_t i = 0; i < size; ++i)
+    EXPECT_NEAR(x[i], states[i].getGlobalLinkTransform(link).translation().x(), 1e-9);
+
+  // modifying the positions of one variable in all configurations
+  const std::size_t index = robot_model_->getVariableIndex("r_shoulder_pan_joint");
+  double* positions = batch.getVariablePositions(index);
+  EXPECT_TRUE(batch.dirty());
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    positions[i] = 0.1 * i - 1.0;
+    states[i].setVariablePosition(index, positions[i]);
+    states[i].update();
+  }
+  batch.updateLinkTransforms();
+  for (std::size_t i = 0; i < size; ++i)
+    EXPECT_TRUE(batch.getGlobalLinkTransform(i, link).isApprox(states[i].getGlobalLinkTransform(link), 1e-9));
+
+  moveit::core::RobotState state(robot_model_);
+  batch.copyToState(3, state);
+  for (std::size_t i = 0; i < robot_model_->getVariableCount(); ++i)
+    EXPECT_EQ(state.getVariablePosition(i), states[3].getVariablePosition(i));
+
+  // added configurations are at the default positions
+  batch.resize(size + 5);
+  moveit::core::RobotState default_state(robot_model_);
+  default_state.setToDefaultValues();
+  batch.copyToState(size + 2, state);
+  for (std::size_t i = 0; i < robot_model_->getVariableCount(); ++i)
+    EXPECT_EQ(state.getVariablePosition(i), default_state.getVariablePosition(i));
+  batch.copyToState(3, state);
+  EXPECT_EQ(state.getVariablePosition(index), states[3].getVariablePosition(index));
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
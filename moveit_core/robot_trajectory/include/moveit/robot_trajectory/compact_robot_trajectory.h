@@ -0,0 +1,256 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#ifndef MOVEIT_ROBOT_TRAJECTORY_COMPACT_ROBOT_TRAJECTORY_
+#define MOVEIT_ROBOT_TRAJECTORY_COMPACT_ROBOT_TRAJECTORY_
+
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <Eigen/Core>
+#include <limits>
+#include <vector>
+
+namespace robot_trajectory
+{
+MOVEIT_CLASS_FORWARD(CompactRobotTrajectory)
+
+/** \brief A sequence of waypoints and the time durations between them, like RobotTrajectory, but stored as structure
+    of arrays.
+
+    The positions, velocities and accelerations of each variable are contiguous over all waypoints, and there is no
+    RobotState (with its cache of transforms) per waypoint. This takes a fraction of the memory of a RobotTrajectory
+    and allows algorithms to run over the values of a variable without chasing pointers. RobotState instances are
+    only materialized when a waypoint is requested as a state: they are copies of a reference state (which provides
+    e.g. attached bodies) with the variables of the waypoint. Efforts are not stored. */
+class CompactRobotTrajectory
+{
+public:
+  CompactRobotTrajectory(const robot_model::RobotModelConstPtr& robot_model, const std::string& group);
+
+  CompactRobotTrajectory(const robot_model::RobotModelConstPtr& robot_model, const robot_model::JointModelGroup* group);
+
+  /** \brief Copy the waypoints and durations of \e trajectory. Its first waypoint becomes the reference state. */
+  explicit CompactRobotTrajectory(const RobotTrajectory& trajectory);
+
+  const robot_model::RobotModelConstPtr& getRobotModel() const
+  {
+    return robot_model_;
+  }
+
+  const robot_model::JointModelGroup* getGroup() const
+  {
+    return group_;
+  }
+
+  const std::string& getGroupName() const;
+
+  void setGroupName(const std::string& group_name);
+
+  /** \brief The state that materialized waypoints are copied from, before the variables of the waypoint are set */
+  const robot_state::RobotState& getReferenceState() const
+  {
+    return *reference_state_;
+  }
+
+  void setReferenceState(const robot_state::RobotState& state);
+
+  std::size_t getWayPointCount() const
+  {
+    return size_;
+  }
+
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  /** \brief Allocate memory for \e capacity waypoints */
+  void reserve(std::size_t capacity);
+
+  bool hasVelocities() const
+  {
+    return has_velocities_;
+  }
+
+  bool hasAccelerations() const
+  {
+    return has_accelerations_;
+  }
+
+  /** \brief Get the positions of variable \e variable at all waypoints (getWayPointCount() contiguous values) */
+  const double* getVariablePositions(std::size_t variable) const
+  {
+    return positions_.col(variable).data();
+  }
+
+  double* getVariablePositions(std::size_t variable)
+  {
+    return positions_.col(variable).data();
+  }
+
+  /** \brief Get the velocities of variable \e variable at all waypoints, or nullptr if there are no velocities */
+  const double* getVariableVelocities(std::size_t variable) const
+  {
+    return has_velocities_ ? velocities_.col(variable).data() : nullptr;
+  }
+
+  /** \brief Get the velocities of variable \e variable at all waypoints for modification. If there are no velocities
+      yet, they are initialized to zero for all waypoints. */
+  double* getVariableVelocities(std::size_t variable);
+
+  /** \brief Get the accelerations of variable \e variable at all waypoints, or nullptr if there are no
+      accelerations */
+  const double* getVariableAccelerations(std::size_t variable) const
+  {
+    return has_accelerations_ ? accelerations_.col(variable).data() : nullptr;
+  }
+
+  /** \brief Get the accelerations of variable \e variable at all waypoints for modification. If there are no
+      accelerations yet, they are initialized to zero for all waypoints. */
+  double* getVariableAccelerations(std::size_t variable);
+
+  double getVariablePosition(std::size_t index, std::size_t variable) const
+  {
+    return positions_(index, variable);
+  }
+
+  /** \brief Get the velocity of \e variable at waypoint \e index, zero if there are no velocities */
+  double getVariableVelocity(std::size_t index, std::size_t variable) const
+  {
+    return has_velocities_ ? velocities_(index, variable) : 0.0;
+  }
+
+  /** \brief Get the acceleration of \e variable at waypoint \e index, zero if there are no accelerations */
+  double getVariableAcceleration(std::size_t index, std::size_t variable) const
+  {
+    return has_accelerations_ ? accelerations_(index, variable) : 0.0;
+  }
+
+  /** \brief Set the variables of \e state to the ones of waypoint \e index and update its transforms. The
+      velocities and accelerations of \e state are only set if the trajectory has them. */
+  void getWayPoint(std::size_t index, robot_state::RobotState& state) const;
+
+  /** \brief Materialize waypoint \e index as a new state, copied from the reference state */
+  robot_state::RobotStatePtr getWayPointPtr(std::size_t index) const;
+
+  const std::vector<double>& getWayPointDurations() const
+  {
+    return duration_from_previous_;
+  }
+
+  double getWayPointDurationFromPrevious(std::size_t index) const
+  {
+    return index < duration_from_previous_.size() ? duration_from_previous_[index] : 0.0;
+  }
+
+  void setWayPointDurationFromPrevious(std::size_t index, double value)
+  {
+    duration_from_previous_[index] = value;
+  }
+
+  /** @brief  Returns the duration after start that a waypoint will be reached.
+   *  @param  The waypoint index.
+   *  @return The duration from start; returns overall duration if index is out of range.
+   */
+  double getWayPointDurationFromStart(std::size_t index) const;
+
+  /** \brief Add a waypoint with the variables of \e state, at \e dt after the previous one */
+  void addSuffixWayPoint(const robot_state::RobotState& state, double dt)
+  {
+    insertWayPoint(size_, state, dt);
+  }
+
+  /** \brief Add a waypoint with the given values of all variables of the robot model, at \e dt after the previous
+      one. \e velocities and \e accelerations may be nullptr; they are taken as zero if the trajectory has them. */
+  void addSuffixWayPoint(const double* positions, const double* velocities, const double* accelerations, double dt)
+  {
+    insertWayPoint(size_, positions, velocities, accelerations, dt);
+  }
+
+  void addPrefixWayPoint(const robot_state::RobotState& state, double dt)
+  {
+    insertWayPoint(0, state, dt);
+  }
+
+  void insertWayPoint(std::size_t index, const robot_state::RobotState& state, double dt);
+
+  void insertWayPoint(std::size_t index, const double* positions, const double* velocities,
+                      const double* accelerations, double dt);
+
+  /** \brief Add waypoints \e start_index to \e end_index (exclusive) of \e source to the end of this trajectory, with
+      \e dt added to the duration of the first one */
+  void append(const CompactRobotTrajectory& source, double dt, std::size_t start_index = 0,
+              std::size_t end_index = std::numeric_limits<std::size_t>::max());
+
+  void swap(CompactRobotTrajectory& other);
+
+  void clear();
+
+  void reverse();
+
+  void unwind();
+  void unwind(const robot_state::RobotState& state);
+
+  /** \brief Replace the waypoints of \e trajectory by materialized waypoints of this trajectory */
+  void getRobotTrajectory(RobotTrajectory& trajectory) const;
+
+  /** \brief Replace the waypoints of this trajectory by the ones of \e trajectory. Its first waypoint becomes the
+      reference state. */
+  void setRobotTrajectory(const RobotTrajectory& trajectory);
+
+  /** \brief Fill \e trajectory directly from the stored values, without materializing waypoints */
+  void getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& trajectory) const;
+
+private:
+  /* Make room for one more waypoint at \e index */
+  void insertRow(std::size_t index);
+
+  /* Unwind continuous joints, starting from \e offsets (per continuous joint) at the first waypoint */
+  void unwindContinuousJoints(const std::vector<double>& offsets);
+
+  robot_model::RobotModelConstPtr robot_model_;
+  const robot_model::JointModelGroup* group_;
+  robot_state::RobotStatePtr reference_state_;
+
+  std::size_t size_;
+  bool has_velocities_;
+  bool has_accelerations_;
+
+  // a column per variable, with a row per waypoint (and spare rows up to the capacity)
+  Eigen::MatrixXd positions_;
+  Eigen::MatrixXd velocities_;
+  Eigen::MatrixXd accelerations_;
+  std::vector<double> duration_from_previous_;
+};
+}  // namespace robot_trajectory
+
+#endif
@@ -139,6 +139,7 @@ public:
     if (duration_from_previous_.size() <= index)
       duration_from_previous_.resize(index + 1, 0.0);
     duration_from_previous_[index] = value;
+    updateDurationsFromStart(index);
   }
 
   bool empty() const
@@ -166,6 +167,7 @@ public:
     state->update();
     waypoints_.push_back(state);
     duration_from_previous_.push_back(dt);
+    updateDurationsFromStart(duration_from_previous_.size() - 1);
   }
 
   void addPrefixWayPoint(const robot_state::RobotState& state, double dt)
@@ -178,6 +180,9 @@ public:
     state->update();
     waypoints_.push_front(state);
     duration_from_previous_.push_front(dt);
+    // all later waypoints moved, so index them again
+    updateDurationsFromStart(0);
+    updateDurationsFromStart(duration_from_previous_.size() - 1);
   }
 
   void insertWayPoint(std::size_t index, const robot_state::RobotState& state, double dt)
@@ -190,6 +195,9 @@ public:
     state->update();
     waypoints_.insert(waypoints_.begin() + index, state);
     duration_from_previous_.insert(duration_from_previous_.begin() + index, dt);
+    // all later waypoints moved, so index them again
+    updateDurationsFromStart(index);
+    updateDurationsFromStart(duration_from_previous_.size() - 1);
   }
 
   /**
@@ -246,7 +254,8 @@ public:
   void unwind();
   void unwind(const robot_state::RobotState& state);
 
-  /** @brief Finds the waypoint indicies before and after a duration from start.
+  /** @brief Finds the waypoint indicies before and after a duration from start. Durations from start are indexed, so
+   *  this takes logarithmic time in the number of waypoints, as long as the durations are not negative.
    *  @param The duration from start.
    *  @param The waypoint index before the supplied duration.
    *  @param The waypoint index after (or equal to) the supplied duration.
@@ -264,10 +273,19 @@ public:
   bool getStateAtDurationFromStart(const double request_duration, robot_state::RobotStatePtr& output_state) const;
 
 private:
+  /* Invalidate the indexed durations from start of waypoint \e index and later ones, after the duration of waypoint
+     \e index changed, and bring the index up to date up to waypoint \e index. Adding or setting durations in order
+     only updates the one of \e index, and the first waypoint added after an out-of-order change indexes the ones in
+     between again. */
+  void updateDurationsFromStart(std::size_t index);
+
   robot_model::RobotModelConstPtr robot_model_;
   const robot_model::JointModelGroup* group_;
   std::deque<robot_state::RobotStatePtr> waypoints_;
   std::deque<double> duration_from_previous_;
+  // duration from start of each waypoint, the first valid_durations_from_start_ of which are up to date
+  std::deque<double> duration_from_start_;
+  std::size_t valid_durations_from_start_ = 0;
   rclcpp::Clock clock_ros_;
 };
 }  // namespace robot_trajectory
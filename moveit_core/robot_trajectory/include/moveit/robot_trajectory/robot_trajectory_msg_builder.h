@@ -0,0 +1,67 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#ifndef MOVEIT_ROBOT_TRAJECTORY_ROBOT_TRAJECTORY_MSG_BUILDER_
+#define MOVEIT_ROBOT_TRAJECTORY_ROBOT_TRAJECTORY_MSG_BUILDER_
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit_msgs/msg/robot_trajectory.hpp>
+#include <vector>
+#include "rclcpp/duration.hpp"
+
+namespace robot_trajectory
+{
+/** \brief Fills a moveit_msgs::msg::RobotTrajectory with the waypoints of a trajectory, given by their variable
+    values. Used by RobotTrajectory and CompactRobotTrajectory, which store their waypoints differently. */
+class RobotTrajectoryMsgBuilder
+{
+public:
+  /** \brief Clear \e trajectory and prepare it for \e waypoint_count waypoints of the active joints of \e group, or of
+      all active joints of \e robot_model if \e group is nullptr. \e trajectory must outlive the builder. */
+  RobotTrajectoryMsgBuilder(const robot_model::RobotModelConstPtr& robot_model,
+                            const robot_model::JointModelGroup* group, std::size_t waypoint_count,
+                            const builtin_interfaces::msg::Time& stamp, moveit_msgs::msg::RobotTrajectory& trajectory);
+
+  /** \brief Set waypoint \e index from the values of all variables of the robot model. \e velocities,
+      \e accelerations and \e effort may be nullptr if they are not known. */
+  void setWayPoint(std::size_t index, const double* positions, const double* velocities, const double* accelerations,
+                   const double* effort, const rclcpp::Duration& time_from_start);
+
+private:
+  moveit_msgs::msg::RobotTrajectory& trajectory_;
+  std::vector<const robot_model::JointModel*> onedof_;
+  std::vector<const robot_model::JointModel*> mdof_;
+};
+}  // namespace robot_trajectory
+
+#endif
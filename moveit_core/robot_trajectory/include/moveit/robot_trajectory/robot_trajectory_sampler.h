@@ -0,0 +1,79 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#ifndef MOVEIT_ROBOT_TRAJECTORY_ROBOT_TRAJECTORY_SAMPLER_
+#define MOVEIT_ROBOT_TRAJECTORY_ROBOT_TRAJECTORY_SAMPLER_
+
+#include <moveit/robot_trajectory/robot_trajectory.h>
+
+namespace robot_trajectory
+{
+/** \brief Samples the states of a RobotTrajectory at increasing durations from start, e.g. at controller rate for
+    monitoring or visualization.
+
+    The sampler remembers the segment of the previous sample, so advancing it takes amortized constant time; going back
+    in time takes logarithmic time. Samples are interpolated like in RobotTrajectory::getStateAtDurationFromStart(),
+    but into a state provided by the caller, without allocating memory. The trajectory must outlive the sampler, and
+    reset() needs to be called after the trajectory is modified. */
+class RobotTrajectorySampler
+{
+public:
+  RobotTrajectorySampler(const RobotTrajectory& trajectory);
+
+  /** \brief Restart at the beginning of the trajectory, e.g. after it was modified */
+  void reset();
+
+  /** \brief Set \e state to the one of the trajectory at \e duration from start. Return false if the trajectory is
+      empty. */
+  bool sample(double duration, robot_state::RobotState& state);
+
+  /** \brief Get the index of the first waypoint that is reached at or after the duration of the last sample, or the
+      number of waypoints if the last sample was after the end */
+  std::size_t getWayPointIndex() const
+  {
+    return index_;
+  }
+
+private:
+  /* Move index_ to the first waypoint reached at or after \e duration */
+  void seek(double duration);
+
+  const RobotTrajectory& trajectory_;
+
+  // the waypoint index of the last sample, and its duration from start
+  std::size_t index_;
+  double index_duration_;
+};
+}  // namespace robot_trajectory
+
+#endif
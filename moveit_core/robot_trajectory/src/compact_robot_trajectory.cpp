@@ -0,0 +1,373 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#include <moveit/robot_trajectory/compact_robot_trajectory.h>
+#include <moveit/robot_trajectory/robot_trajectory_msg_builder.h>
+#include <boost/math/constants/constants.hpp>
+#include <algorithm>
+
+namespace robot_trajectory
+{
+namespace
+{
+// Allocate \e values like \e positions and zero them, if \e present is not set yet
+void initializeValues(Eigen::MatrixXd& values, const Eigen::MatrixXd& positions, bool& present)
+{
+  if (present)
+    return;
+  values.setZero(positions.rows(), positions.cols());
+  present = true;
+}
+}  // namespace
+
+CompactRobotTrajectory::CompactRobotTrajectory(const robot_model::RobotModelConstPtr& robot_model,
+                                               const std::string& group)
+  : CompactRobotTrajectory(robot_model, group.empty() ? nullptr : robot_model->getJointModelGroup(group))
+{
+}
+
+CompactRobotTrajectory::CompactRobotTrajectory(const robot_model::RobotModelConstPtr& robot_model,
+                                               const robot_model::JointModelGroup* group)
+  : robot_model_(robot_model)
+  , group_(group)
+  , reference_state_(new robot_state::RobotState(robot_model))
+  , size_(0)
+  , has_velocities_(false)
+  , has_accelerations_(false)
+  , positions_(0, robot_model->getVariableCount())
+{
+  reference_state_->setToDefaultValues();
+}
+
+CompactRobotTrajectory::CompactRobotTrajectory(const RobotTrajectory& trajectory)
+  : CompactRobotTrajectory(trajectory.getRobotModel(), trajectory.getGroup())
+{
+  setRobotTrajectory(trajectory);
+}
+
+void CompactRobotTrajectory::setGroupName(const std::string& group_name)
+{
+  group_ = robot_model_->getJointModelGroup(group_name);
+}
+
+const std::string& CompactRobotTrajectory::getGroupName() const
+{
+  if (group_)
+    return group_->getName();
+  static const std::string EMPTY;
+  return EMPTY;
+}
+
+void CompactRobotTrajectory::setReferenceState(const robot_state::RobotState& state)
+{
+  reference_state_.reset(new robot_state::RobotState(state));
+}
+
+void CompactRobotTrajectory::reserve(std::size_t capacity)
+{
+  if (capacity <= static_cast<std::size_t>(positions_.rows()))
+    return;
+  positions_.conservativeResize(capacity, Eigen::NoChange);
+  if (has_velocities_)
+    velocities_.conservativeResize(capacity, Eigen::NoChange);
+  if (has_accelerations_)
+    accelerations_.conservativeResize(capacity, Eigen::NoChange);
+}
+
+double* CompactRobotTrajectory::getVariableVelocities(std::size_t variable)
+{
+  initializeValues(velocities_, positions_, has_velocities_);
+  return velocities_.col(variable).data();
+}
+
+double* CompactRobotTrajectory::getVariableAccelerations(std::size_t variable)
+{
+  initializeValues(accelerations_, positions_, has_accelerations_);
+  return accelerations_.col(variable).data();
+}
+
+void CompactRobotTrajectory::getWayPoint(std::size_t index, robot_state::RobotState& state) const
+{
+  const std::size_t variable_count = positions_.cols();
+  for (std::size_t i = 0; i < variable_count; ++i)
+    state.setVariablePosition(i, positions_(index, i));
+  if (has_velocities_)
+    for (std::size_t i = 0; i < variable_count; ++i)
+      state.setVariableVelocity(i, velocities_(index, i));
+  if (has_accelerations_)
+    for (std::size_t i = 0; i < variable_count; ++i)
+      state.setVariableAcceleration(i, accelerations_(index, i));
+  state.update();
+}
+
+robot_state::RobotStatePtr CompactRobotTrajectory::getWayPointPtr(std::size_t index) const
+{
+  robot_state::RobotStatePtr state(new robot_state::RobotState(*reference_state_));
+  getWayPoint(index, *state);
+  return state;
+}
+
+double CompactRobotTrajectory::getWayPointDurationFromStart(std::size_t index) const
+{
+  if (duration_from_previous_.empty())
+    return 0.0;
+  if (index >= duration_from_previous_.size())
+    index = duration_from_previous_.size() - 1;
+
+  double time = 0.0;
+  for (std::size_t i = 0; i <= index; ++i)
+    time += duration_from_previous_[i];
+  return time;
+}
+
+void CompactRobotTrajectory::insertRow(std::size_t index)
+{
+  if (size_ == static_cast<std::size_t>(positions_.rows()))
+    reserve(std::max<std::size_t>(2 * size_, 16));
+
+  if (index < size_)
+  {
+    // shift the values of the following waypoints by one
+    for (Eigen::Index i = 0; i < positions_.cols(); ++i)
+    {
+      std::copy_backward(positions_.col(i).data() + index, positions_.col(i).data() + size_,
+                         positions_.col(i).data() + size_ + 1);
+      if (has_velocities_)
+        std::copy_backward(velocities_.col(i).data() + index, velocities_.col(i).data() + size_,
+                           velocities_.col(i).data() + size_ + 1);
+      if (has_accelerations_)
+        std::copy_backward(accelerations_.col(i).data() + index, accelerations_.col(i).data() + size_,
+                           accelerations_.col(i).data() + size_ + 1);
+    }
+  }
+  ++size_;
+}
+
+void CompactRobotTrajectory::insertWayPoint(std::size_t index, const robot_state::RobotState& state, double dt)
+{
+  insertWayPoint(index, state.getVariablePositions(), state.hasVelocities() ? state.getVariableVelocities() : nullptr,
+                 state.hasAccelerations() ? state.getVariableAccelerations() : nullptr, dt);
+}
+
+void CompactRobotTrajectory::insertWayPoint(std::size_t index, const double* positions, const double* velocities,
+                                            const double* accelerations, double dt)
+{
+  if (velocities)
+    initializeValues(velocities_, positions_, has_velocities_);
+  if (accelerations)
+    initializeValues(accelerations_, positions_, has_accelerations_);
+  insertRow(index);
+
+  for (Eigen::Index i = 0; i < positions_.cols(); ++i)
+  {
+    positions_(index, i) = positions[i];
+    if (has_velocities_)
+      velocities_(index, i) = velocities ? velocities[i] : 0.0;
+    if (has_accelerations_)
+      accelerations_(index, i) = accelerations ? accelerations[i] : 0.0;
+  }
+  duration_from_previous_.insert(duration_from_previous_.begin() + index, dt);
+}
+
+void CompactRobotTrajectory::append(const CompactRobotTrajectory& source, double dt, std::size_t start_index,
+                                    std::size_t end_index)
+{
+  end_index = std::min(end_index, source.size_);
+  if (start_index >= end_index)
+    return;
+  const std::size_t count = end_index - start_index;
+  if (source.has_velocities_)
+    initializeValues(velocities_, positions_, has_velocities_);
+  if (source.has_accelerations_)
+    initializeValues(accelerations_, positions_, has_accelerations_);
+  reserve(size_ + count);
+
+  positions_.middleRows(size_, count) = source.positions_.middleRows(start_index, count);
+  if (source.has_velocities_)
+    velocities_.middleRows(size_, count) = source.velocities_.middleRows(start_index, count);
+  else if (has_velocities_)
+    velocities_.middleRows(size_, count).setZero();
+  if (source.has_accelerations_)
+    accelerations_.middleRows(size_, count) = source.accelerations_.middleRows(start_index, count);
+  else if (has_accelerations_)
+    accelerations_.middleRows(size_, count).setZero();
+  size_ += count;
+
+  std::size_t index = duration_from_previous_.size();
+  duration_from_previous_.insert(duration_from_previous_.end(),
+                                 std::next(source.duration_from_previous_.begin(), start_index),
+                                 std::next(source.duration_from_previous_.begin(), end_index));
+  if (duration_from_previous_.size() > index)
+    duration_from_previous_[index] += dt;
+}
+
+void CompactRobotTrajectory::swap(CompactRobotTrajectory& other)
+{
+  robot_model_.swap(other.robot_model_);
+  std::swap(group_, other.group_);
+  reference_state_.swap(other.reference_state_);
+  std::swap(size_, other.size_);
+  std::swap(has_velocities_, other.has_velocities_);
+  std::swap(has_accelerations_, other.has_accelerations_);
+  positions_.swap(other.positions_);
+  velocities_.swap(other.velocities_);
+  accelerations_.swap(other.accelerations_);
+  duration_from_previous_.swap(other.duration_from_previous_);
+}
+
+void CompactRobotTrajectory::clear()
+{
+  // the memory is kept for reuse
+  size_ = 0;
+  has_velocities_ = false;
+  has_accelerations_ = false;
+  duration_from_previous_.clear();
+}
+
+void CompactRobotTrajectory::reverse()
+{
+  for (Eigen::Index i = 0; i < positions_.cols(); ++i)
+  {
+    std::reverse(positions_.col(i).data(), positions_.col(i).data() + size_);
+    if (has_velocities_)
+      std::reverse(velocities_.col(i).data(), velocities_.col(i).data() + size_);
+    if (has_accelerations_)
+      std::reverse(accelerations_.col(i).data(), accelerations_.col(i).data() + size_);
+  }
+  if (!duration_from_previous_.empty())
+  {
+    duration_from_previous_.push_back(duration_from_previous_.front());
+    std::reverse(duration_from_previous_.begin(), duration_from_previous_.end());
+    duration_from_previous_.pop_back();
+  }
+}
+
+void CompactRobotTrajectory::unwind()
+{
+  const std::vector<const robot_model::JointModel*>& cont_joints =
+      group_ ? group_->getContinuousJointModels() : robot_model_->getContinuousJointModels();
+  unwindContinuousJoints(std::vector<double>(cont_joints.size(), 0.0));
+}
+
+void CompactRobotTrajectory::unwind(const robot_state::RobotState& state)
+{
+  const std::vector<const robot_model::JointModel*>& cont_joints =
+      group_ ? group_->getContinuousJointModels() : robot_model_->getContinuousJointModels();
+  std::vector<double> offsets(cont_joints.size());
+  for (std::size_t i = 0; i < cont_joints.size(); ++i)
+  {
+    double reference_value0 = state.getJointPositions(cont_joints[i])[0];
+    double reference_value = reference_value0;
+    cont_joints[i]->enforcePositionBounds(&reference_value);
+    offsets[i] = reference_value0 - reference_value;
+  }
+  unwindContinuousJoints(offsets);
+}
+
+void CompactRobotTrajectory::unwindContinuousJoints(const std::vector<double>& offsets)
+{
+  if (size_ == 0)
+    return;
+
+  const std::vector<const robot_model::JointModel*>& cont_joints =
+      group_ ? group_->getContinuousJointModels() : robot_model_->getContinuousJointModels();
+  const double pi = boost::math::constants::pi<double>();
+
+  for (std::size_t i = 0; i < cont_joints.size(); ++i)
+  {
+    // unwrap continuous joints
+    double* positions = getVariablePositions(cont_joints[i]->getFirstVariableIndex());
+    double running_offset = offsets[i];
+    double last_value = positions[0];
+    positions[0] += running_offset;
+
+    for (std::size_t j = 1; j < size_; ++j)
+    {
+      double current_value = positions[j];
+      if (last_value > current_value + pi)
+        running_offset += 2.0 * pi;
+      else if (current_value > last_value + pi)
+        running_offset -= 2.0 * pi;
+
+      last_value = current_value;
+      positions[j] = current_value + running_offset;
+    }
+  }
+}
+
+void CompactRobotTrajectory::getRobotTrajectory(RobotTrajectory& trajectory) const
+{
+  trajectory.clear();
+  for (std::size_t i = 0; i < size_; ++i)
+    trajectory.addSuffixWayPoint(getWayPointPtr(i), duration_from_previous_[i]);
+}
+
+void CompactRobotTrajectory::setRobotTrajectory(const RobotTrajectory& trajectory)
+{
+  clear();
+  if (trajectory.empty())
+    return;
+  setReferenceState(trajectory.getFirstWayPoint());
+  reserve(trajectory.getWayPointCount());
+  for (std::size_t i = 0; i < trajectory.getWayPointCount(); ++i)
+    addSuffixWayPoint(trajectory.getWayPoint(i), trajectory.getWayPointDurationFromPrevious(i));
+}
+
+void CompactRobotTrajectory::getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& trajectory) const
+{
+  trajectory = moveit_msgs::msg::RobotTrajectory();
+  if (size_ == 0)
+    return;
+
+  rclcpp::Clock clock;
+  RobotTrajectoryMsgBuilder builder(robot_model_, group_, size_, clock.now(), trajectory);
+
+  // the waypoints are rows of the column-major matrices, so copy them for contiguous access
+  Eigen::VectorXd positions, velocities, accelerations;
+  double total_time = 0.0;
+  for (std::size_t i = 0; i < size_; ++i)
+  {
+    total_time += duration_from_previous_[i];
+    int seconds = static_cast<int>(total_time);
+    rclcpp::Duration dur_total((int32_t)seconds, (int32_t)((total_time - seconds) * 1.0e+9));
+
+    positions = positions_.row(i);
+    if (has_velocities_)
+      velocities = velocities_.row(i);
+    if (has_accelerations_)
+      accelerations = accelerations_.row(i);
+    builder.setWayPoint(i, positions.data(), has_velocities_ ? velocities.data() : nullptr,
+                        has_accelerations_ ? accelerations.data() : nullptr, nullptr, dur_total);
+  }
+}
+}  // namespace robot_trajectory
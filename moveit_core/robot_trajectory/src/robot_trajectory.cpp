@@ -35,9 +35,11 @@
 /* Author: Ioan Sucan, Adam Leeper */
 
 #include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/robot_trajectory/robot_trajectory_msg_builder.h>
 #include <moveit/robot_state/conversions.h>
 #include <tf2_eigen/tf2_eigen.h>
 #include <boost/math/constants/constants.hpp>
+#include <algorithm>
 #include <numeric>
 #include "rclcpp/rclcpp.hpp"
 
@@ -82,6 +84,8 @@ void RobotTrajectory::swap(RobotTrajectory& other)
   std::swap(group_, other.group_);
   waypoints_.swap(other.waypoints_);
   duration_from_previous_.swap(other.duration_from_previous_);
+  duration_from_start_.swap(other.duration_from_start_);
+  std::swap(valid_durations_from_start_, other.valid_durations_from_start_);
 }
 
 void RobotTrajectory::append(const RobotTrajectory& source, double dt, size_t start_index, size_t end_index)
@@ -97,6 +101,8 @@ void RobotTrajectory::append(const RobotTrajectory& source, double dt, size_t st
                                  std::next(source.duration_from_previous_.begin(), end_index));
   if (duration_from_previous_.size() > index)
     duration_from_previous_[index] += dt;
+  for (; index < duration_from_previous_.size(); ++index)
+    updateDurationsFromStart(index);
 }
 
 void RobotTrajectory::reverse()
@@ -108,6 +114,8 @@ void RobotTrajectory::reverse()
     std::reverse(duration_from_previous_.begin(), duration_from_previous_.end());
     duration_from_previous_.pop_back();
   }
+  for (std::size_t index = 0; index < duration_from_previous_.size(); ++index)
+    updateDurationsFromStart(index);
 }
 
 void RobotTrajectory::unwind()
@@ -195,6 +203,18 @@ void RobotTrajectory::clear()
 {
   waypoints_.clear();
   duration_from_previous_.clear();
+  duration_from_start_.clear();
+  valid_durations_from_start_ = 0;
+}
+
+void RobotTrajectory::updateDurationsFromStart(std::size_t index)
+{
+  duration_from_start_.resize(duration_from_previous_.size());
+  valid_durations_from_start_ = std::min(valid_durations_from_start_, index);
+  std::size_t end = std::min(index + 1, duration_from_previous_.size());
+  for (std::size_t i = valid_durations_from_start_; i < end; ++i)
+    duration_from_start_[i] = (i > 0 ? duration_from_start_[i - 1] : 0.0) + duration_from_previous_[i];
+  valid_durations_from_start_ = std::max(valid_durations_from_start_, end);
 }
 
 void RobotTrajectory::getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& trajectory)
@@ -205,126 +225,24 @@ void RobotTrajectory::getRobotTrajectoryMsg(moveit_msgs::msg::RobotTrajectory& t
 
   if (waypoints_.empty())
     return;
-  const std::vector<const robot_model::JointModel*>& jnt =
-      group_ ? group_->getActiveJointModels() : robot_model_->getActiveJointModels();
-
-  std::vector<const robot_model::JointModel*> onedof;
-  std::vector<const robot_model::JointModel*> mdof;
-  trajectory.joint_trajectory.joint_names.clear();
-  trajectory.multi_dof_joint_trajectory.joint_names.clear();
-
-  for (std::size_t i = 0; i < jnt.size(); ++i)
-    if (jnt[i]->getVariableCount() == 1)
-    {
-      trajectory.joint_trajectory.joint_names.push_back(jnt[i]->getName());
-      onedof.push_back(jnt[i]);
-    }
-    else
-    {
-      trajectory.multi_dof_joint_trajectory.joint_names.push_back(jnt[i]->getName());
-      mdof.push_back(jnt[i]);
-    }
-  if (!onedof.empty())
-  {
-    trajectory.joint_trajectory.header.frame_id = robot_model_->getModelFrame();
-    trajectory.joint_trajectory.header.stamp = stamp;
-    trajectory.joint_trajectory.points.resize(waypoints_.size());
-  }
-
-  if (!mdof.empty())
-  {
-    trajectory.multi_dof_joint_trajectory.header.frame_id = robot_model_->getModelFrame();
-    trajectory.multi_dof_joint_trajectory.header.stamp = stamp;
-    trajectory.multi_dof_joint_trajectory.points.resize(waypoints_.size());
-  }
+  RobotTrajectoryMsgBuilder builder(robot_model_, group_, waypoints_.size(), stamp, trajectory);
 
   static const rclcpp::Duration ZERO_DURATION(0.0);
   double total_time = 0.0;
-  rclcpp::Duration dur_total(0, 0);
   for (std::size_t i = 0; i < waypoints_.size(); ++i)
   {
+    const robot_state::RobotState& waypoint = *waypoints_[i];
+    rclcpp::Duration dur_total = ZERO_DURATION;
     if (duration_from_previous_.size() > i)
-      total_time += duration_from_previous_[i];
-    int seconds = static_cast<int>(total_time);
-    dur_total = rclcpp::Duration((int32_t)seconds, (int32_t)((total_time - seconds) * 1.0e+9));
-    if (!onedof.empty())
     {
-      trajectory.joint_trajectory.points[i].positions.resize(onedof.size());
-      trajectory.joint_trajectory.points[i].velocities.reserve(onedof.size());
-
-      for (std::size_t j = 0; j < onedof.size(); ++j)
-      {
-        trajectory.joint_trajectory.points[i].positions[j] =
-            waypoints_[i]->getVariablePosition(onedof[j]->getFirstVariableIndex());
-        // if we have velocities/accelerations/effort, copy those too
-        if (waypoints_[i]->hasVelocities())
-          trajectory.joint_trajectory.points[i].velocities.push_back(
-              waypoints_[i]->getVariableVelocity(onedof[j]->getFirstVariableIndex()));
-        if (waypoints_[i]->hasAccelerations())
-          trajectory.joint_trajectory.points[i].accelerations.push_back(
-              waypoints_[i]->getVariableAcceleration(onedof[j]->getFirstVariableIndex()));
-        if (waypoints_[i]->hasEffort())
-          trajectory.joint_trajectory.points[i].effort.push_back(
-              waypoints_[i]->getVariableEffort(onedof[j]->getFirstVariableIndex()));
-      }
-      // clear velocities if we have an incomplete specification
-      if (trajectory.joint_trajectory.points[i].velocities.size() != onedof.size())
-        trajectory.joint_trajectory.points[i].velocities.clear();
-      // clear accelerations if we have an incomplete specification
-      if (trajectory.joint_trajectory.points[i].accelerations.size() != onedof.size())
-        trajectory.joint_trajectory.points[i].accelerations.clear();
-      // clear effort if we have an incomplete specification
-      if (trajectory.joint_trajectory.points[i].effort.size() != onedof.size())
-        trajectory.joint_trajectory.points[i].effort.clear();
-
-      if (duration_from_previous_.size() > i)
-
-        trajectory.joint_trajectory.points[i].time_from_start = dur_total;
-      else
-        trajectory.joint_trajectory.points[i].time_from_start = ZERO_DURATION;
-    }
-    if (!mdof.empty())
-    {
-      trajectory.multi_dof_joint_trajectory.points[i].transforms.resize(mdof.size());
-      for (std::size_t j = 0; j < mdof.size(); ++j)
-      {
-        geometry_msgs::msg::TransformStamped ts = tf2::eigenToTransform(waypoints_[i]->getJointTransform(mdof[j]));
-        trajectory.multi_dof_joint_trajectory.points[i].transforms[j] = ts.transform;
-        // TODO: currently only checking for planar multi DOF joints / need to add check for floating
-        if (waypoints_[i]->hasVelocities() && (mdof[j]->getType() == robot_model::JointModel::JointType::PLANAR))
-        {
-          const std::vector<std::string> names = mdof[j]->getVariableNames();
-          const double* velocities = waypoints_[i]->getJointVelocities(mdof[j]);
-
-          geometry_msgs::msg::Twist point_velocity;
-
-          for (std::size_t k = 0; k < names.size(); ++k)
-          {
-            if (names[k].find("/x") != std::string::npos)
-            {
-              point_velocity.linear.x = velocities[k];
-            }
-            else if (names[k].find("/y") != std::string::npos)
-            {
-              point_velocity.linear.y = velocities[k];
-            }
-            else if (names[k].find("/z") != std::string::npos)
-            {
-              point_velocity.linear.z = velocities[k];
-            }
-            else if (names[k].find("/theta") != std::string::npos)
-            {
-              point_velocity.angular.z = velocities[k];
-            }
-          }
-          trajectory.multi_dof_joint_trajectory.points[i].velocities.push_back(point_velocity);
-        }
-      }
-      if (duration_from_previous_.size() > i)
-        trajectory.multi_dof_joint_trajectory.points[i].time_from_start = dur_total;
-      else
-        trajectory.multi_dof_joint_trajectory.points[i].time_from_start = ZERO_DURATION;
+      total_time += duration_from_previous_[i];
+      int seconds = static_cast<int>(total_time);
+      dur_total = rclcpp::Duration((int32_t)seconds, (int32_t)((total_time - seconds) * 1.0e+9));
     }
+    builder.setWayPoint(i, waypoint.getVariablePositions(),
+                        waypoint.hasVelocities() ? waypoint.getVariableVelocities() : nullptr,
+                        waypoint.hasAccelerations() ? waypoint.getVariableAccelerations() : nullptr,
+                        waypoint.hasEffort() ? waypoint.getVariableEffort() : nullptr, dur_total);
   }
 }
 
@@ -430,24 +348,35 @@ void RobotTrajectory::findWayPointIndicesForDurationAfterStart(const double& dur
     return;
   }
 
-  // Find indicies
-  std::size_t index = 0, num_points = waypoints_.size();
-  double running_duration = 0.0;
-  for (; index < num_points; ++index)
+  // Find the first waypoint reached at or after duration: by binary search, if its duration from start is indexed,
+  // or by summing up the durations after the indexed ones
+  std::size_t num_points = waypoints_.size();
+  std::size_t indexed = std::min(valid_durations_from_start_, num_points);
+  std::size_t index;
+  if (indexed > 0 && duration_from_start_[indexed - 1] >= duration)
+    index = std::lower_bound(duration_from_start_.begin(), duration_from_start_.begin() + indexed, duration) -
+            duration_from_start_.begin();
+  else
   {
-    running_duration += duration_from_previous_[index];
-    if (running_duration >= duration)
-      break;
+    double running_duration = indexed > 0 ? duration_from_start_[indexed - 1] : 0.0;
+    for (index = indexed; index < num_points; ++index)
+    {
+      running_duration += duration_from_previous_[index];
+      if (running_duration >= duration)
+        break;
+    }
   }
   before = std::max<int>(index - 1, 0);
   after = std::min<int>(index, num_points - 1);
 
   // Compute duration blend
-  double before_time = running_duration - duration_from_previous_[index];
   if (after == before)
     blend = 1.0;
   else
+  {
+    double before_time = getWayPointDurationFromStart(index) - duration_from_previous_[index];
     blend = (duration - before_time) / duration_from_previous_[index];
+  }
 }
 
 double RobotTrajectory::getWayPointDurationFromStart(std::size_t index) const
@@ -456,9 +385,11 @@ double RobotTrajectory::getWayPointDurationFromStart(std::size_t index) const
     return 0.0;
   if (index >= duration_from_previous_.size())
     index = duration_from_previous_.size() - 1;
+  if (index < valid_durations_from_start_)
+    return duration_from_start_[index];
 
-  double time = 0.0;
-  for (std::size_t i = 0; i <= index; ++i)
+  double time = valid_durations_from_start_ > 0 ? duration_from_start_[valid_durations_from_start_ - 1] : 0.0;
+  for (std::size_t i = valid_durations_from_start_; i <= index; ++i)
     time += duration_from_previous_[i];
   return time;
 }
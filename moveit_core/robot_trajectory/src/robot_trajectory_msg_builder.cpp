@@ -0,0 +1,141 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_trajectory/robot_trajectory_msg_builder.h>
+#include <tf2_eigen/tf2_eigen.h>
+
+namespace robot_trajectory
+{
+RobotTrajectoryMsgBuilder::RobotTrajectoryMsgBuilder(const robot_model::RobotModelConstPtr& robot_model,
+                                                     const robot_model::JointModelGroup* group,
+                                                     std::size_t waypoint_count,
+                                                     const builtin_interfaces::msg::Time& stamp,
+                                                     moveit_msgs::msg::RobotTrajectory& trajectory)
+  : trajectory_(trajectory)
+{
+  trajectory_ = moveit_msgs::msg::RobotTrajectory();
+  const std::vector<const robot_model::JointModel*>& jnt =
+      group ? group->getActiveJointModels() : robot_model->getActiveJointModels();
+
+  for (const robot_model::JointModel* joint : jnt)
+    if (joint->getVariableCount() == 1)
+    {
+      trajectory_.joint_trajectory.joint_names.push_back(joint->getName());
+      onedof_.push_back(joint);
+    }
+    else
+    {
+      trajectory_.multi_dof_joint_trajectory.joint_names.push_back(joint->getName());
+      mdof_.push_back(joint);
+    }
+
+  if (!onedof_.empty())
+  {
+    trajectory_.joint_trajectory.header.frame_id = robot_model->getModelFrame();
+    trajectory_.joint_trajectory.header.stamp = stamp;
+    trajectory_.joint_trajectory.points.resize(waypoint_count);
+  }
+
+  if (!mdof_.empty())
+  {
+    trajectory_.multi_dof_joint_trajectory.header.frame_id = robot_model->getModelFrame();
+    trajectory_.multi_dof_joint_trajectory.header.stamp = stamp;
+    trajectory_.multi_dof_joint_trajectory.points.resize(waypoint_count);
+  }
+}
+
+void RobotTrajectoryMsgBuilder::setWayPoint(std::size_t index, const double* positions, const double* velocities,
+                                            const double* accelerations, const double* effort,
+                                            const rclcpp::Duration& time_from_start)
+{
+  if (!onedof_.empty())
+  {
+    trajectory_msgs::msg::JointTrajectoryPoint& point = trajectory_.joint_trajectory.points[index];
+    point.positions.resize(onedof_.size());
+    if (velocities)
+      point.velocities.resize(onedof_.size());
+    if (accelerations)
+      point.accelerations.resize(onedof_.size());
+    if (effort)
+      point.effort.resize(onedof_.size());
+    for (std::size_t j = 0; j < onedof_.size(); ++j)
+    {
+      const int variable = onedof_[j]->getFirstVariableIndex();
+      point.positions[j] = positions[variable];
+      // if we have velocities/accelerations/effort, copy those too
+      if (velocities)
+        point.velocities[j] = velocities[variable];
+      if (accelerations)
+        point.accelerations[j] = accelerations[variable];
+      if (effort)
+        point.effort[j] = effort[variable];
+    }
+    point.time_from_start = time_from_start;
+  }
+
+  if (!mdof_.empty())
+  {
+    trajectory_msgs::msg::MultiDOFJointTrajectoryPoint& point = trajectory_.multi_dof_joint_trajectory.points[index];
+    point.transforms.resize(mdof_.size());
+    Eigen::Isometry3d transform;
+    for (std::size_t j = 0; j < mdof_.size(); ++j)
+    {
+      const int variable = mdof_[j]->getFirstVariableIndex();
+      mdof_[j]->computeTransform(positions + variable, transform);
+      point.transforms[j] = tf2::eigenToTransform(transform).transform;
+
+      // TODO: currently only checking for planar multi DOF joints / need to add check for floating
+      if (velocities && mdof_[j]->getType() == robot_model::JointModel::JointType::PLANAR)
+      {
+        const std::vector<std::string>& names = mdof_[j]->getVariableNames();
+        geometry_msgs::msg::Twist point_velocity;
+        for (std::size_t k = 0; k < names.size(); ++k)
+        {
+          const double velocity = velocities[variable + k];
+          if (names[k].find("/x") != std::string::npos)
+            point_velocity.linear.x = velocity;
+          else if (names[k].find("/y") != std::string::npos)
+            point_velocity.linear.y = velocity;
+          else if (names[k].find("/z") != std::string::npos)
+            point_velocity.linear.z = velocity;
+          else if (names[k].find("/theta") != std::string::npos)
+            point_velocity.angular.z = velocity;
+        }
+        point.velocities.push_back(point_velocity);
+      }
+    }
+    point.time_from_start = time_from_start;
+  }
+}
+}  // namespace robot_trajectory
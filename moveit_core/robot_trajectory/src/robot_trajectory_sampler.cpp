@@ -0,0 +1,96 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#include <moveit/robot_trajectory/robot_trajectory_sampler.h>
+#include <algorithm>
+
+namespace robot_trajectory
+{
+RobotTrajectorySampler::RobotTrajectorySampler(const RobotTrajectory& trajectory) : trajectory_(trajectory)
+{
+  reset();
+}
+
+void RobotTrajectorySampler::reset()
+{
+  index_ = 0;
+  index_duration_ = trajectory_.getWayPointDurationFromPrevious(0);
+}
+
+void RobotTrajectorySampler::seek(double duration)
+{
+  const std::size_t count = trajectory_.getWayPointCount();
+  if (index_ > 0 && trajectory_.getWayPointDurationFromStart(index_ - 1) >= duration)
+  {
+    // going back in time: binary search for the first waypoint at or after duration among the earlier ones
+    std::size_t low = 0, high = index_ - 1;
+    while (low < high)
+    {
+      std::size_t mid = (low + high) / 2;
+      if (trajectory_.getWayPointDurationFromStart(mid) >= duration)
+        high = mid;
+      else
+        low = mid + 1;
+    }
+    index_ = low;
+    index_duration_ = trajectory_.getWayPointDurationFromStart(low);
+    return;
+  }
+
+  while (index_ < count && index_duration_ < duration)
+  {
+    ++index_;
+    if (index_ < count)
+      index_duration_ += trajectory_.getWayPointDurationFromPrevious(index_);
+  }
+}
+
+bool RobotTrajectorySampler::sample(double duration, robot_state::RobotState& state)
+{
+  const std::size_t count = trajectory_.getWayPointCount();
+  if (count == 0)
+    return false;
+
+  seek(duration);
+  const std::size_t before = index_ > 0 ? index_ - 1 : 0;
+  const std::size_t after = std::min(index_, count - 1);
+  double blend = 1.0;
+  if (after != before)
+  {
+    const double segment_duration = trajectory_.getWayPointDurationFromPrevious(index_);
+    blend = (duration - (index_duration_ - segment_duration)) / segment_duration;
+  }
+  trajectory_.getWayPoint(before).interpolate(trajectory_.getWayPoint(after), blend, state);
+  return true;
+}
+}  // namespace robot_trajectory
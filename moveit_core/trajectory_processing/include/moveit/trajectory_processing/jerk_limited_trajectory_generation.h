@@ -0,0 +1,85 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_TRAJECTORY_PROCESSING_JERK_LIMITED_TRAJECTORY_GENERATION_H
+#define MOVEIT_TRAJECTORY_PROCESSING_JERK_LIMITED_TRAJECTORY_GENERATION_H
+
+#include <moveit/robot_trajectory/compact_robot_trajectory.h>
+#include <map>
+#include <string>
+
+namespace trajectory_processing
+{
+/** \brief Time-parameterize a trajectory under per-joint velocity, acceleration and jerk limits.
+
+    The waypoints are connected by a natural cubic spline, so the path has continuous curvature and the joint jerk
+    stays bounded. Along this path, the time-optimal velocity profile under the velocity and acceleration limits is
+    computed on a fine grid. Its time law is then averaged over a moving window as long as the time to ramp up the
+    acceleration, which turns the acceleration steps into S-curves. This adds the ramp time once to the duration of
+    the motion, which is time-optimal for motions that reach the acceleration limits. The limit on the path velocity
+    is lowered beforehand to its minimum over the distance covered by the window, so averaging cannot exceed it. The
+    sampled result is checked against all limits, and slowed down if needed.
+
+    Velocity and acceleration limits are taken from the robot model, jerk limits are set per variable. Like
+    TimeOptimalTrajectoryGeneration, the trajectory starts and ends at rest and is resampled at a fixed rate. The spline
+    passes through all waypoints. Where it deviates more than the path tolerance from the straight lines between them,
+    which happens near sharp corners, waypoints are inserted on these lines until it does not. */
+class JerkLimitedTrajectoryGeneration
+{
+public:
+  /** \brief Variables without a jerk limit get \e default_jerk_ratio times their acceleration limit */
+  JerkLimitedTrajectoryGeneration(const double path_tolerance = 0.1, const double resample_dt = 0.01,
+                                  const double default_jerk_ratio = 10.0);
+  ~JerkLimitedTrajectoryGeneration();
+
+  /** \brief Set the jerk limit of \e variable, which is scaled like the acceleration limit */
+  void setMaxJerk(const std::string& variable, double max_jerk);
+
+  bool computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory, const double max_velocity_scaling_factor = 1.0,
+                         const double max_acceleration_scaling_factor = 1.0) const;
+
+  /** \brief Same as above, but operating directly on the contiguous storage of \e trajectory */
+  bool computeTimeStamps(robot_trajectory::CompactRobotTrajectory& trajectory,
+                         const double max_velocity_scaling_factor = 1.0,
+                         const double max_acceleration_scaling_factor = 1.0) const;
+
+private:
+  const double path_tolerance_;
+  const double resample_dt_;
+  const double default_jerk_ratio_;
+  std::map<std::string, double> max_jerk_;
+};
+}  // namespace trajectory_processing
+
+#endif  // MOVEIT_TRAJECTORY_PROCESSING_JERK_LIMITED_TRAJECTORY_GENERATION_H
@@ -41,7 +41,9 @@
 
 #include <Eigen/Core>
 #include <list>
-#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <memory>
+#include <vector>
+#include <moveit/robot_trajectory/compact_robot_trajectory.h>
 
 namespace trajectory_processing
 {
@@ -58,10 +60,29 @@ public:
   {
     return length_;
   }
-  virtual Eigen::VectorXd getConfig(double s) const = 0;
-  virtual Eigen::VectorXd getTangent(double s) const = 0;
-  virtual Eigen::VectorXd getCurvature(double s) const = 0;
-  virtual std::list<double> getSwitchingPoints() const = 0;
+  Eigen::VectorXd getConfig(double s) const
+  {
+    Eigen::VectorXd config;
+    getConfig(s, config);
+    return config;
+  }
+  Eigen::VectorXd getTangent(double s) const
+  {
+    Eigen::VectorXd tangent;
+    getTangent(s, tangent);
+    return tangent;
+  }
+  Eigen::VectorXd getCurvature(double s) const
+  {
+    Eigen::VectorXd curvature;
+    getCurvature(s, curvature);
+    return curvature;
+  }
+  /** \brief Evaluate the segment into an existing vector, which is only reallocated if its size does not match */
+  virtual void getConfig(double s, Eigen::VectorXd& config) const = 0;
+  virtual void getTangent(double s, Eigen::VectorXd& tangent) const = 0;
+  virtual void getCurvature(double s, Eigen::VectorXd& curvature) const = 0;
+  virtual std::vector<double> getSwitchingPoints() const = 0;
   virtual PathSegment* clone() const = 0;
 
   double position_;
@@ -74,19 +95,26 @@ class Path
 {
 public:
   Path(const std::list<Eigen::VectorXd>& path, double max_deviation = 0.0);
+  /** \brief Construct the path through the waypoints stored in the columns of \e path */
+  Path(const Eigen::MatrixXd& path, double max_deviation = 0.0);
   Path(const Path& path);
   double getLength() const;
   Eigen::VectorXd getConfig(double s) const;
   Eigen::VectorXd getTangent(double s) const;
   Eigen::VectorXd getCurvature(double s) const;
+  void getConfig(double s, Eigen::VectorXd& config) const;
+  void getTangent(double s, Eigen::VectorXd& tangent) const;
+  void getCurvature(double s, Eigen::VectorXd& curvature) const;
   double getNextSwitchingPoint(double s, bool& discontinuity) const;
-  std::list<std::pair<double, bool>> getSwitchingPoints() const;
+  /** \brief The switching points sorted by path position, with a flag marking discontinuities */
+  const std::vector<std::pair<double, bool>>& getSwitchingPoints() const;
 
 private:
-  PathSegment* getPathSegment(double& s) const;
+  void init(const Eigen::MatrixXd& path, double max_deviation);
+  const PathSegment* getPathSegment(double& s) const;
   double length_;
-  std::list<std::pair<double, bool>> switching_points_;
-  std::list<std::unique_ptr<PathSegment>> path_segments_;
+  std::vector<std::pair<double, bool>> switching_points_;
+  std::vector<std::unique_ptr<PathSegment>> path_segments_;
 };
 
 class Trajectory
@@ -114,6 +142,11 @@ public:
   /** @brief Return the acceleration vector for a given point in time */
   Eigen::VectorXd getAcceleration(double time) const;
 
+  /** @brief Compute position, velocity and acceleration for a given point in time at once. The vectors are only
+     reallocated if their size does not match. Sampling at increasing times continues the search for the trajectory
+     segment from the previous sample, so resampling the whole trajectory takes linear time. **/
+  void sample(double time, Eigen::VectorXd& position, Eigen::VectorXd& velocity, Eigen::VectorXd& acceleration) const;
+
 private:
   struct TrajectoryStep
   {
@@ -134,8 +167,8 @@ private:
                                          double& before_acceleration, double& after_acceleration);
   bool getNextVelocitySwitchingPoint(double path_pos, TrajectoryStep& next_switching_point, double& before_acceleration,
                                      double& after_acceleration);
-  bool integrateForward(std::list<TrajectoryStep>& trajectory, double acceleration);
-  void integrateBackward(std::list<TrajectoryStep>& start_trajectory, double path_pos, double path_vel,
+  bool integrateForward(std::vector<TrajectoryStep>& trajectory, double acceleration);
+  void integrateBackward(std::vector<TrajectoryStep>& start_trajectory, double path_pos, double path_vel,
                          double acceleration);
   double getMinMaxPathAcceleration(double path_position, double path_velocity, bool max);
   double getMinMaxPhaseSlope(double path_position, double path_velocity, bool max);
@@ -144,20 +177,26 @@ private:
   double getAccelerationMaxPathVelocityDeriv(double path_pos);
   double getVelocityMaxPathVelocityDeriv(double path_pos);
 
-  std::list<TrajectoryStep>::const_iterator getTrajectorySegment(double time) const;
+  std::size_t getTrajectorySegment(double time) const;
+  const TrajectoryStep& getPathState(double time, double& path_pos, double& path_vel) const;
 
   Path path_;
   Eigen::VectorXd max_velocity_;
   Eigen::VectorXd max_acceleration_;
   unsigned int joint_num_;
   bool valid_;
-  std::list<TrajectoryStep> trajectory_;
-  std::list<TrajectoryStep> end_trajectory_;  // non-empty only if the trajectory generation failed.
+  std::vector<TrajectoryStep> trajectory_;
+  std::vector<TrajectoryStep> end_trajectory_;  // non-empty only if the trajectory generation failed.
+  std::vector<TrajectoryStep> backward_trajectory_;  // reused by integrateBackward(), stored in reverse order
 
   const double time_step_;
 
   mutable double cached_time_;
-  mutable std::list<TrajectoryStep>::const_iterator cached_trajectory_segment_;
+  mutable std::size_t cached_trajectory_segment_;
+
+  // buffers for evaluating the path, reused to avoid allocating vectors for every step
+  mutable Eigen::VectorXd tangent_;
+  mutable Eigen::VectorXd curvature_;
 };
 
 class TimeOptimalTrajectoryGeneration
@@ -169,6 +208,11 @@ public:
   bool computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory, const double max_velocity_scaling_factor = 1.0,
                          const double max_acceleration_scaling_factor = 1.0) const;
 
+  /** \brief Same as above, but operating directly on the contiguous storage of \e trajectory */
+  bool computeTimeStamps(robot_trajectory::CompactRobotTrajectory& trajectory,
+                         const double max_velocity_scaling_factor = 1.0,
+                         const double max_acceleration_scaling_factor = 1.0) const;
+
 private:
   const double path_tolerance_;
   const double resample_dt_;
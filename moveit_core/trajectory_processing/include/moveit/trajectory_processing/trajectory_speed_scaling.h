@@ -0,0 +1,121 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_TRAJECTORY_PROCESSING_TRAJECTORY_SPEED_SCALING_
+#define MOVEIT_TRAJECTORY_PROCESSING_TRAJECTORY_SPEED_SCALING_
+
+#include <moveit/robot_trajectory/compact_robot_trajectory.h>
+#include <vector>
+
+namespace trajectory_processing
+{
+/** \brief Re-time the rest of a time-parameterized trajectory while it is executed, e.g. when the speed override
+    of an operator changes.
+
+    The trajectory is sped up or slowed down by scaling its time: at a speed factor of 0.5, the same path is traversed
+    with half the velocity and a quarter of the acceleration. When the factor changes, it ramps from its current value
+    and rate of change to the new value along a cubic polynomial, so position, velocity and acceleration stay
+    continuous at the point where the new suffix is spliced in. Only durations, velocities and accelerations of the
+    remaining waypoints are recomputed, in time linear in their number, which is cheap enough for every control cycle.
+
+    Speed factors are relative to the timing of the original trajectory, which corresponds to a factor of 1, and can
+    not exceed it, so velocity limits that the original trajectory respects stay respected. During a ramp, the
+    velocity times the rate of change of the factor is added to the acceleration; ramps are lengthened as needed to
+    keep this term within the acceleration limits of the joints. Continuous joints are expected to be unwound, as they
+    are after time parameterization. */
+class TrajectorySpeedScaling
+{
+public:
+  /** \brief Prepare re-timing \e trajectory, which needs to have durations and velocities */
+  TrajectorySpeedScaling(const robot_trajectory::RobotTrajectory& trajectory);
+  TrajectorySpeedScaling(const robot_trajectory::CompactRobotTrajectory& trajectory);
+
+  /** \brief Change the speed factor from execution time \e time on, reaching \e speed_factor after \e ramp_duration.
+
+      \e suffix is set to the re-timed rest of the trajectory, starting with the state at \e time and with durations
+      relative to \e time. \e time is measured from the start of the execution of the original trajectory and must not
+      be earlier than in the previous call. \e speed_factor must be in (0, 1]. The ramp takes at least
+      \e ramp_duration; without acceleration limits, a \e ramp_duration of zero changes the speed factor at once,
+      which makes the velocity jump. Returns false if the arguments are invalid or the trajectory has no velocities. */
+  bool setSpeedFactor(double time, double speed_factor, double ramp_duration,
+                      robot_trajectory::CompactRobotTrajectory& suffix);
+  bool setSpeedFactor(double time, double speed_factor, double ramp_duration,
+                      robot_trajectory::RobotTrajectory& suffix);
+
+  /** \brief Get the speed factor at execution time \e time, which must not be earlier than the last change */
+  double getSpeedFactor(double time) const;
+
+  /** \brief Get the time of the original trajectory that is reached at execution time \e time, which must not be
+      earlier than the last change */
+  double getReferenceTime(double time) const;
+
+  /** \brief Get the execution time at which the end of the trajectory is reached */
+  double getDuration() const;
+
+private:
+  void init();
+
+  /* Evaluate the current ramp at execution time \e time: the reference time, speed factor and its derivative */
+  void evaluate(double time, double& reference_time, double& speed_factor, double& speed_factor_derivative) const;
+
+  /* Find the execution time at which \e reference_time is reached, which is not before \e lower_bound */
+  double getExecutionTime(double reference_time, double lower_bound) const;
+
+  /* Lengthen \e ramp_duration so that the acceleration the new ramp adds to the waypoints from \e reference_time on
+     stays within the acceleration limits */
+  double limitRampDuration(double reference_time, double ramp_duration);
+
+  robot_trajectory::CompactRobotTrajectory reference_;
+  std::vector<double> reference_times_;
+  std::vector<std::size_t> variables_;  // the variables of the group, which are the ones that move
+  std::vector<double> max_accelerations_;  // the acceleration limit of each of variables_, zero if unbounded
+
+  // the current ramp of the speed factor, a cubic polynomial in time from its start
+  double ramp_start_time_;
+  double ramp_start_reference_time_;
+  double ramp_start_factor_;
+  double ramp_start_derivative_;
+  double ramp_end_factor_;
+  double ramp_duration_;
+
+  // buffers for the state at the splice point and the speed factor at each waypoint of the suffix
+  std::vector<double> positions_;
+  std::vector<double> velocities_;
+  std::vector<double> accelerations_;
+  std::vector<double> factors_;
+  std::vector<double> factor_derivatives_;
+};
+}  // namespace trajectory_processing
+
+#endif
@@ -0,0 +1,797 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/trajectory_processing/jerk_limited_trajectory_generation.h>
+#include <Eigen/Core>
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <vector>
+#include "rclcpp/rclcpp.hpp"
+
+namespace trajectory_processing
+{
+rclcpp::Logger LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION =
+    rclcpp::get_logger("moveit").get_child("trajectory_processing.jerk_limited_trajectory_generation");
+
+namespace
+{
+constexpr double EPS = 0.000001;
+
+// maximum distance between the points of the grid the path velocity is computed on
+constexpr double GRID_STEP = 0.001;
+
+// relative violation of the limits accepted in the sampled trajectory
+constexpr double LIMIT_TOLERANCE = 0.0001;
+
+// number of times the segments of the spline are split to bring it within the path tolerance
+constexpr unsigned int MAX_PATH_REFINEMENTS = 10;
+
+// minimum number of points per segment the deviation of the spline is checked at
+constexpr std::size_t MIN_DEVIATION_SAMPLES = 16;
+
+/* Natural cubic spline through the waypoints, parameterized by the distance between them */
+class SplinePath
+{
+public:
+  SplinePath(const Eigen::MatrixXd& points) : points_(points), starts_(points.cols())
+  {
+    const Eigen::Index segment_count = points.cols() - 1;
+    starts_[0] = 0.0;
+    for (Eigen::Index i = 0; i < segment_count; ++i)
+      starts_[i + 1] = starts_[i] + (points.col(i + 1) - points.col(i)).norm();
+
+    // solve the tridiagonal system for the second derivatives at the waypoints, which are zero at both ends
+    curvatures_ = Eigen::MatrixXd::Zero(points.rows(), points.cols());
+    std::vector<double> diagonal(points.cols());
+    Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(points.rows(), points.cols());
+    for (Eigen::Index i = 1; i < segment_count; ++i)
+    {
+      const double h0 = getSegmentLength(i - 1);
+      const double h1 = getSegmentLength(i);
+      diagonal[i] = 2.0 * (h0 + h1);
+      rhs.col(i) = 6.0 * ((points.col(i + 1) - points.col(i)) / h1 - (points.col(i) - points.col(i - 1)) / h0);
+      if (i > 1)
+      {
+        const double factor = h0 / diagonal[i - 1];
+        diagonal[i] -= factor * h0;
+        rhs.col(i) -= factor * rhs.col(i - 1);
+      }
+    }
+    for (Eigen::Index i = segment_count - 1; i > 0; --i)
+    {
+      curvatures_.col(i) = rhs.col(i);
+      if (i + 1 < segment_count)
+        curvatures_.col(i) -= getSegmentLength(i) * curvatures_.col(i + 1);
+      curvatures_.col(i) /= diagonal[i];
+    }
+  }
+
+  Eigen::Index getDimension() const
+  {
+    return points_.rows();
+  }
+
+  const Eigen::MatrixXd& getPoints() const
+  {
+    return points_;
+  }
+
+  double getLength() const
+  {
+    return starts_.back();
+  }
+
+  Eigen::VectorXd getEnd() const
+  {
+    return points_.col(points_.cols() - 1);
+  }
+
+  std::size_t getSegmentCount() const
+  {
+    return starts_.size() - 1;
+  }
+
+  double getSegmentStart(std::size_t segment) const
+  {
+    return starts_[segment];
+  }
+
+  double getSegmentLength(std::size_t segment) const
+  {
+    return starts_[segment + 1] - starts_[segment];
+  }
+
+  /* Index of the segment containing path position s, searching forward from segment */
+  std::size_t findSegment(double s, std::size_t segment) const
+  {
+    if (segment >= getSegmentCount() || starts_[segment] > s)
+      segment = 0;
+    while (segment + 1 < getSegmentCount() && starts_[segment + 1] <= s)
+      ++segment;
+    return segment;
+  }
+
+  /* Position and its first three derivatives with respect to the path position s within segment */
+  void evaluate(std::size_t segment, double s, Eigen::VectorXd& position, Eigen::VectorXd& tangent,
+                Eigen::VectorXd& curvature, Eigen::VectorXd& curvature_derivative) const
+  {
+    const double h = getSegmentLength(segment);
+    const double r = s - starts_[segment];
+    const auto m0 = curvatures_.col(segment);
+    const auto m1 = curvatures_.col(segment + 1);
+    curvature_derivative = (m1 - m0) / h;
+    curvature = m0 + curvature_derivative * r;
+    const Eigen::VectorXd slope = (points_.col(segment + 1) - points_.col(segment)) / h - h * (2.0 * m0 + m1) / 6.0;
+    tangent = slope + (m0 + 0.5 * curvature_derivative * r) * r;
+    position = points_.col(segment) + (slope + (0.5 * m0 + curvature_derivative * r / 6.0) * r) * r;
+  }
+
+  /* Largest distance of the spline within segment from the straight line between its waypoints */
+  double getMaxDeviation(std::size_t segment) const
+  {
+    const Eigen::VectorXd start = points_.col(segment);
+    const Eigen::VectorXd line = points_.col(segment + 1) - start;
+    const std::size_t steps =
+        std::max<std::size_t>(MIN_DEVIATION_SAMPLES, std::ceil(getSegmentLength(segment) / GRID_STEP));
+    Eigen::VectorXd position, tangent, curvature, curvature_derivative;
+    double max_deviation = 0.0;
+    for (std::size_t k = 1; k < steps; ++k)
+    {
+      evaluate(segment, starts_[segment] + getSegmentLength(segment) * k / steps, position, tangent, curvature,
+               curvature_derivative);
+      const double t = std::min(1.0, std::max(0.0, (position - start).dot(line) / line.squaredNorm()));
+      max_deviation = std::max(max_deviation, (position - start - t * line).norm());
+    }
+    return max_deviation;
+  }
+
+private:
+  Eigen::MatrixXd points_;
+  Eigen::MatrixXd curvatures_;
+  std::vector<double> starts_;
+};
+
+/* Insert waypoints halfway along the segments of path that deviate more than tolerance from the straight lines
+   between the waypoints, until none does. Returns false if that takes more than MAX_PATH_REFINEMENTS splits. */
+bool refinePath(double tolerance, SplinePath& path)
+{
+  for (unsigned int refinement = 0; refinement <= MAX_PATH_REFINEMENTS; ++refinement)
+  {
+    std::vector<bool> split(path.getSegmentCount());
+    std::size_t split_count = 0;
+    for (std::size_t i = 0; i < path.getSegmentCount(); ++i)
+    {
+      split[i] = path.getMaxDeviation(i) > tolerance;
+      split_count += split[i];
+    }
+    if (split_count == 0)
+      return true;
+    if (refinement == MAX_PATH_REFINEMENTS)
+      break;
+
+    const Eigen::MatrixXd& points = path.getPoints();
+    Eigen::MatrixXd refined(points.rows(), points.cols() + split_count);
+    Eigen::Index column = 0;
+    for (std::size_t i = 0; i < path.getSegmentCount(); ++i)
+    {
+      refined.col(column++) = points.col(i);
+      if (split[i])
+        refined.col(column++) = 0.5 * (points.col(i) + points.col(i + 1));
+    }
+    refined.col(column) = points.col(points.cols() - 1);
+    path = SplinePath(refined);
+  }
+  return false;
+}
+
+/* Grid along the path with the path derivatives needed for the phase plane integration */
+struct PathGrid
+{
+  PathGrid(const SplinePath& path)
+  {
+    for (std::size_t i = 0; i < path.getSegmentCount(); ++i)
+    {
+      const std::size_t steps = std::max<std::size_t>(1, std::ceil(path.getSegmentLength(i) / GRID_STEP));
+      for (std::size_t k = 0; k < steps; ++k)
+      {
+        positions_.push_back(path.getSegmentStart(i) + path.getSegmentLength(i) * k / steps);
+        segments_.push_back(i);
+      }
+    }
+    positions_.push_back(path.getLength());
+    segments_.push_back(path.getSegmentCount() - 1);
+  }
+
+  std::size_t size() const
+  {
+    return positions_.size();
+  }
+
+  std::vector<double> positions_;
+  std::vector<std::size_t> segments_;
+};
+
+/* The velocity profile of the path, stored as the squared path velocity x = ds/dt^2 at the grid points */
+class PhasePlane
+{
+public:
+  PhasePlane(const SplinePath& path, const PathGrid& grid, const Eigen::VectorXd& max_velocity,
+             const Eigen::VectorXd& max_acceleration, const Eigen::VectorXd& max_jerk)
+    : grid_(grid)
+    , max_acceleration_(max_acceleration)
+    , tangents_(max_velocity.size(), grid.size())
+    , curvatures_(max_velocity.size(), grid.size())
+    , max_path_velocity_(grid.size())
+  {
+    Eigen::VectorXd position, tangent, curvature, curvature_derivative;
+    for (std::size_t k = 0; k < grid.size(); ++k)
+    {
+      path.evaluate(grid.segments_[k], grid.positions_[k], position, tangent, curvature, curvature_derivative);
+      tangents_.col(k) = tangent;
+      curvatures_.col(k) = curvature;
+
+      double x = std::numeric_limits<double>::max();
+      for (Eigen::Index i = 0; i < tangent.size(); ++i)
+      {
+        if (std::abs(tangent[i]) > EPS)
+        {
+          x = std::min(x, std::pow(max_velocity[i] / tangent[i], 2));
+
+          // pairs of joints whose curvature cannot be compensated both by the path acceleration
+          for (Eigen::Index j = i + 1; j < tangent.size(); ++j)
+          {
+            if (std::abs(tangent[j]) <= EPS)
+              continue;
+            const double difference = std::abs(curvature[i] / tangent[i] - curvature[j] / tangent[j]);
+            if (difference > EPS)
+              x = std::min(x, (max_acceleration[i] / std::abs(tangent[i]) +
+                               max_acceleration[j] / std::abs(tangent[j])) / difference);
+          }
+        }
+        else if (std::abs(curvature[i]) > EPS)
+          x = std::min(x, max_acceleration[i] / std::abs(curvature[i]));
+
+        if (std::abs(curvature_derivative[i]) > EPS)
+          x = std::min(x, std::pow(max_jerk[i] / std::abs(curvature_derivative[i]), 2.0 / 3.0));
+      }
+      max_path_velocity_[k] = x;
+    }
+  }
+
+  /* Lower the limit of the path velocity to its minimum within distance of each grid point */
+  void erode(double distance)
+  {
+    const std::vector<double>& s = grid_.positions_;
+    std::vector<double> eroded(s.size());
+    std::deque<std::size_t> window;  // indices of increasing limits
+    std::size_t end = 0;
+    std::size_t begin = 0;
+    for (std::size_t k = 0; k < s.size(); ++k)
+    {
+      for (; end < s.size() && s[end] <= s[k] + distance; ++end)
+      {
+        while (!window.empty() && max_path_velocity_[window.back()] >= max_path_velocity_[end])
+          window.pop_back();
+        window.push_back(end);
+      }
+      for (; s[begin] < s[k] - distance; ++begin)
+        if (window.front() == begin)
+          window.pop_front();
+      eroded[k] = max_path_velocity_[window.front()];
+    }
+    max_path_velocity_.swap(eroded);
+  }
+
+  /* Compute the fastest profile within the velocity limit, starting and ending at rest */
+  bool integrate()
+  {
+    const std::size_t size = grid_.size();
+    x_ = max_path_velocity_;
+    x_.front() = 0.0;
+    x_.back() = 0.0;
+
+    // integrating forward and backward once is exact apart from the discretization of the acceleration bounds
+    for (unsigned int pass = 0; pass < 10; ++pass)
+    {
+      bool changed = false;
+      double min_acceleration, max_acceleration;
+      for (std::size_t k = 0; k + 1 < size; ++k)
+      {
+        getAccelerationBounds(k, min_acceleration, max_acceleration);
+        const double x = x_[k] + 2.0 * (grid_.positions_[k + 1] - grid_.positions_[k]) * max_acceleration;
+        if (x < x_[k + 1] * (1.0 - EPS))
+        {
+          x_[k + 1] = std::max(0.0, x);
+          changed = true;
+        }
+      }
+      for (std::size_t k = size - 1; k > 0; --k)
+      {
+        getAccelerationBounds(k, min_acceleration, max_acceleration);
+        const double x = x_[k] - 2.0 * (grid_.positions_[k] - grid_.positions_[k - 1]) * min_acceleration;
+        if (x < x_[k - 1] * (1.0 - EPS))
+        {
+          x_[k - 1] = std::max(0.0, x);
+          changed = true;
+        }
+      }
+      if (!changed)
+        break;
+    }
+
+    for (std::size_t k = 0; k + 1 < size; ++k)
+      if (x_[k] <= 0.0 && x_[k + 1] <= 0.0)
+        return false;
+    return true;
+  }
+
+  double getMaxPathVelocity() const
+  {
+    return std::sqrt(*std::max_element(x_.begin(), x_.end()));
+  }
+
+  const std::vector<double>& getSquaredPathVelocities() const
+  {
+    return x_;
+  }
+
+private:
+  /* Bounds of the path acceleration at grid point k with the current path velocity */
+  void getAccelerationBounds(std::size_t k, double& min_acceleration, double& max_acceleration) const
+  {
+    min_acceleration = std::numeric_limits<double>::lowest();
+    max_acceleration = std::numeric_limits<double>::max();
+    for (Eigen::Index i = 0; i < tangents_.rows(); ++i)
+    {
+      const double tangent = tangents_(i, k);
+      if (std::abs(tangent) <= EPS)
+        continue;
+      const double offset = -curvatures_(i, k) * x_[k] / tangent;
+      const double range = max_acceleration_[i] / std::abs(tangent);
+      min_acceleration = std::max(min_acceleration, offset - range);
+      max_acceleration = std::min(max_acceleration, offset + range);
+    }
+  }
+
+  const PathGrid& grid_;
+  const Eigen::VectorXd max_acceleration_;
+  Eigen::MatrixXd tangents_;
+  Eigen::MatrixXd curvatures_;
+  std::vector<double> max_path_velocity_;
+  std::vector<double> x_;
+};
+
+/* Path position over time for a velocity profile with constant path acceleration between the grid points,
+   averaged over a moving window of filter_duration */
+class FilteredTimeLaw
+{
+public:
+  FilteredTimeLaw(const PathGrid& grid, const std::vector<double>& x, double filter_duration)
+    : filter_duration_(filter_duration)
+  {
+    const std::size_t size = grid.size();
+    positions_ = grid.positions_;
+    velocities_.resize(size);
+    accelerations_.resize(size, 0.0);
+    times_.resize(size);
+    integrals_.resize(size);
+    for (std::size_t k = 0; k < size; ++k)
+      velocities_[k] = std::sqrt(x[k]);
+    times_[0] = 0.0;
+    integrals_[0] = 0.0;
+    for (std::size_t k = 0; k + 1 < size; ++k)
+    {
+      const double distance = positions_[k + 1] - positions_[k];
+      const double duration = 2.0 * distance / (velocities_[k] + velocities_[k + 1]);
+      accelerations_[k] = (x[k + 1] - x[k]) / (2.0 * distance);
+      times_[k + 1] = times_[k] + duration;
+      integrals_[k + 1] = integrals_[k] + (positions_[k] + (velocities_[k] / 2.0 + accelerations_[k] * duration / 6.0) *
+                                                               duration) * duration;
+    }
+  }
+
+  double getDuration() const
+  {
+    return times_.back() + filter_duration_;
+  }
+
+  /* Filtered path position, velocity and acceleration at time t */
+  void sample(double t, double& position, double& velocity, double& acceleration) const
+  {
+    double position1, velocity1, acceleration1, integral1;
+    double position0, velocity0, acceleration0, integral0;
+    getState(t, position1, velocity1, acceleration1, integral1);
+    getState(t - filter_duration_, position0, velocity0, acceleration0, integral0);
+    position = std::min(positions_.back(), std::max(0.0, (integral1 - integral0) / filter_duration_));
+    velocity = (position1 - position0) / filter_duration_;
+    acceleration = (velocity1 - velocity0) / filter_duration_;
+  }
+
+private:
+  /* Unfiltered state at time t, resting at the ends of the path outside of the profile */
+  void getState(double t, double& position, double& velocity, double& acceleration, double& integral) const
+  {
+    velocity = 0.0;
+    acceleration = 0.0;
+    if (t <= 0.0)
+    {
+      position = 0.0;
+      integral = 0.0;
+    }
+    else if (t >= times_.back())
+    {
+      position = positions_.back();
+      integral = integrals_.back() + position * (t - times_.back());
+    }
+    else
+    {
+      const std::size_t k = std::upper_bound(times_.begin(), times_.end(), t) - times_.begin() - 1;
+      const double r = t - times_[k];
+      position = positions_[k] + (velocities_[k] + accelerations_[k] * r / 2.0) * r;
+      velocity = velocities_[k] + accelerations_[k] * r;
+      acceleration = accelerations_[k];
+      integral = integrals_[k] + (positions_[k] + (velocities_[k] / 2.0 + accelerations_[k] * r / 6.0) * r) * r;
+    }
+  }
+
+  double filter_duration_;
+  std::vector<double> positions_;
+  std::vector<double> velocities_;
+  std::vector<double> accelerations_;
+  std::vector<double> times_;
+  std::vector<double> integrals_;
+};
+
+/* Fastest squared path velocities at the grid points whose average over filter_duration stays within the limits */
+bool computePathVelocities(const SplinePath& path, const PathGrid& grid, const Eigen::VectorXd& max_velocity,
+                           const Eigen::VectorXd& max_acceleration, const Eigen::VectorXd& max_jerk,
+                           double filter_duration, std::vector<double>& x)
+{
+  PhasePlane phase_plane(path, grid, max_velocity, max_acceleration, max_jerk);
+  if (!phase_plane.integrate())
+    return false;
+
+  // the averaged path velocity stays within the limits met over the distance covered by the window
+  phase_plane.erode(filter_duration * phase_plane.getMaxPathVelocity());
+  if (!phase_plane.integrate())
+    return false;
+
+  x = phase_plane.getSquaredPathVelocities();
+  return true;
+}
+
+/* Joint trajectory sampled at fixed time steps, with the filtered time law slowed down by time_scale */
+class SampledTrajectory
+{
+public:
+  void sample(const SplinePath& path, const FilteredTimeLaw& time_law, double time_scale, double resample_dt)
+  {
+    const double duration = time_law.getDuration() * time_scale;
+    const std::size_t sample_count = std::ceil(duration / resample_dt);
+    times_.resize(sample_count + 1);
+    positions_.resize(path.getDimension(), sample_count + 1);
+    velocities_.resize(path.getDimension(), sample_count + 1);
+    accelerations_.resize(path.getDimension(), sample_count + 1);
+
+    Eigen::VectorXd position, tangent, curvature, curvature_derivative;
+    std::size_t segment = 0;
+    double s, ds, dds;
+    for (std::size_t i = 0; i < sample_count; ++i)
+    {
+      times_[i] = i * resample_dt;
+      time_law.sample(times_[i] / time_scale, s, ds, dds);
+      ds /= time_scale;
+      dds /= time_scale * time_scale;
+      segment = path.findSegment(s, segment);
+      path.evaluate(segment, s, position, tangent, curvature, curvature_derivative);
+      positions_.col(i) = position;
+      velocities_.col(i) = tangent * ds;
+      accelerations_.col(i) = tangent * dds + curvature * ds * ds;
+    }
+
+    // always end at rest at the last waypoint
+    times_[sample_count] = duration;
+    positions_.col(sample_count) = path.getEnd();
+    velocities_.col(sample_count).setZero();
+    accelerations_.col(sample_count).setZero();
+  }
+
+  /* Factors by which the samples exceed the limits, taking the jerk from the differences of the accelerations */
+  void getLimitRatios(const Eigen::VectorXd& max_velocity, const Eigen::VectorXd& max_acceleration,
+                      const Eigen::VectorXd& max_jerk, double& velocity, double& acceleration, double& jerk) const
+  {
+    velocity = 0.0;
+    acceleration = 0.0;
+    jerk = 0.0;
+    for (std::size_t i = 0; i < times_.size(); ++i)
+    {
+      velocity = std::max(velocity, velocities_.col(i).cwiseAbs().cwiseQuotient(max_velocity).maxCoeff());
+      acceleration =
+          std::max(acceleration, accelerations_.col(i).cwiseAbs().cwiseQuotient(max_acceleration).maxCoeff());
+      if (i > 0 && times_[i] > times_[i - 1])
+      {
+        const Eigen::VectorXd jerks = (accelerations_.col(i) - accelerations_.col(i - 1)) / (times_[i] - times_[i - 1]);
+        jerk = std::max(jerk, jerks.cwiseAbs().cwiseQuotient(max_jerk).maxCoeff());
+      }
+    }
+  }
+
+  std::vector<double> times_;
+  Eigen::MatrixXd positions_;
+  Eigen::MatrixXd velocities_;
+  Eigen::MatrixXd accelerations_;
+};
+}  // namespace
+
+JerkLimitedTrajectoryGeneration::JerkLimitedTrajectoryGeneration(const double path_tolerance, const double resample_dt,
+                                                                 const double default_jerk_ratio)
+  : path_tolerance_(path_tolerance), resample_dt_(resample_dt), default_jerk_ratio_(default_jerk_ratio)
+{
+}
+
+JerkLimitedTrajectoryGeneration::~JerkLimitedTrajectoryGeneration()
+{
+}
+
+void JerkLimitedTrajectoryGeneration::setMaxJerk(const std::string& variable, double max_jerk)
+{
+  max_jerk_[variable] = max_jerk;
+}
+
+bool JerkLimitedTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotTrajectory& trajectory,
+                                                        const double max_velocity_scaling_factor,
+                                                        const double max_acceleration_scaling_factor) const
+{
+  if (trajectory.empty())
+    return true;
+
+  robot_trajectory::CompactRobotTrajectory compact(trajectory);
+  if (!computeTimeStamps(compact, max_velocity_scaling_factor, max_acceleration_scaling_factor))
+    return false;
+  compact.getRobotTrajectory(trajectory);
+  return true;
+}
+
+bool JerkLimitedTrajectoryGeneration::computeTimeStamps(robot_trajectory::CompactRobotTrajectory& trajectory,
+                                                        const double max_velocity_scaling_factor,
+                                                        const double max_acceleration_scaling_factor) const
+{
+  if (trajectory.empty())
+    return true;
+
+  const robot_model::JointModelGroup* group = trajectory.getGroup();
+  if (!group)
+  {
+    RCLCPP_ERROR(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION,
+                 "It looks like the planner did not set the group the plan was computed for");
+    return false;
+  }
+
+  // Validate scaling
+  double velocity_scaling_factor = 1.0;
+  if (max_velocity_scaling_factor > 0.0 && max_velocity_scaling_factor <= 1.0)
+  {
+    velocity_scaling_factor = max_velocity_scaling_factor;
+  }
+  else if (max_velocity_scaling_factor == 0.0)
+  {
+    RCLCPP_DEBUG(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION,
+                 "A max_velocity_scaling_factor of 0.0 was specified, defaulting to %f instead.",
+                 velocity_scaling_factor);
+  }
+  else
+  {
+    RCLCPP_WARN(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION,
+                "Invalid max_velocity_scaling_factor %f specified, defaulting to %f instead.",
+                max_velocity_scaling_factor, velocity_scaling_factor);
+  }
+
+  double acceleration_scaling_factor = 1.0;
+  if (max_acceleration_scaling_factor > 0.0 && max_acceleration_scaling_factor <= 1.0)
+  {
+    acceleration_scaling_factor = max_acceleration_scaling_factor;
+  }
+  else if (max_acceleration_scaling_factor == 0.0)
+  {
+    RCLCPP_DEBUG(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION,
+                 "A max_acceleration_scaling_factor of 0.0 was specified, defaulting to %f instead.",
+                 acceleration_scaling_factor);
+  }
+  else
+  {
+    RCLCPP_WARN(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION,
+                "Invalid max_acceleration_scaling_factor %f specified, defaulting to %f instead.",
+                max_acceleration_scaling_factor, acceleration_scaling_factor);
+  }
+
+  // The spline is fit to the joint values, so wrapping angles have to be unwound first
+  trajectory.unwind();
+
+  const std::vector<std::string>& vars = group->getVariableNames();
+  const std::vector<int>& idx = group->getVariableIndexList();
+  const robot_model::RobotModel& rmodel = group->getParentModel();
+  const unsigned num_joints = group->getVariableCount();
+  const unsigned num_points = trajectory.getWayPointCount();
+
+  // Get the limits, using the same defaults as TimeOptimalTrajectoryGeneration
+  Eigen::VectorXd max_velocity(num_joints);
+  Eigen::VectorXd max_acceleration(num_joints);
+  Eigen::VectorXd max_jerk(num_joints);
+  for (size_t j = 0; j < num_joints; ++j)
+  {
+    const robot_model::VariableBounds& bounds = rmodel.getVariableBounds(vars[j]);
+
+    max_velocity[j] = 1.0;
+    if (bounds.velocity_bounded_)
+    {
+      max_velocity[j] = std::min(fabs(bounds.max_velocity_), fabs(bounds.min_velocity_)) * velocity_scaling_factor;
+      max_velocity[j] = std::max(0.01, max_velocity[j]);
+    }
+
+    max_acceleration[j] = 1.0;
+    if (bounds.acceleration_bounded_)
+    {
+      max_acceleration[j] =
+          std::min(fabs(bounds.max_acceleration_), fabs(bounds.min_acceleration_)) * acceleration_scaling_factor;
+      max_acceleration[j] = std::max(0.01, max_acceleration[j]);
+    }
+
+    // the robot model has no jerk limits
+    std::map<std::string, double>::const_iterator jerk = max_jerk_.find(vars[j]);
+    if (jerk != max_jerk_.end())
+      max_jerk[j] = std::max(0.01, fabs(jerk->second) * acceleration_scaling_factor);
+    else
+      max_jerk[j] = max_acceleration[j] * default_jerk_ratio_;
+  }
+
+  // Remove repeated points, which would split the spline into segments of zero length
+  Eigen::MatrixXd points(num_joints, num_points);
+  Eigen::Index point_count = 0;
+  for (size_t p = 0; p < num_points; ++p)
+  {
+    bool diverse_point = (p == 0);
+
+    for (size_t j = 0; j < num_joints; j++)
+    {
+      points(j, point_count) = trajectory.getVariablePosition(p, idx[j]);
+      if (p > 0 && std::abs(points(j, point_count) - points(j, point_count - 1)) > 0.001)
+        diverse_point = true;
+    }
+
+    if (diverse_point)
+      ++point_count;
+  }
+  points.conservativeResize(Eigen::NoChange, point_count);
+
+  // The variables outside of the group keep their values at the first waypoint
+  const std::size_t variable_count = rmodel.getVariableCount();
+  std::vector<double> positions(variable_count), velocities(variable_count), accelerations(variable_count);
+  for (std::size_t i = 0; i < variable_count; ++i)
+  {
+    positions[i] = trajectory.getVariablePosition(0, i);
+    velocities[i] = trajectory.getVariableVelocity(0, i);
+    accelerations[i] = trajectory.getVariableAcceleration(0, i);
+  }
+
+  // Return trajectory with only the first waypoint if there are not multiple diverse points
+  if (point_count == 1)
+  {
+    RCLCPP_WARN(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION,
+                "Trajectory is not being parameterized since it only contains a single distinct waypoint.");
+    const bool has_velocities = trajectory.hasVelocities();
+    const bool has_accelerations = trajectory.hasAccelerations();
+    trajectory.clear();
+    trajectory.addSuffixWayPoint(positions.data(), has_velocities ? velocities.data() : nullptr,
+                                 has_accelerations ? accelerations.data() : nullptr, 0.0);
+    return true;
+  }
+
+  // A natural spline can overshoot the straight lines between the waypoints, which are known to be valid
+  SplinePath path(points);
+  if (!refinePath(path_tolerance_, path))
+  {
+    RCLCPP_ERROR(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION,
+                 "Unable to fit a spline within a path tolerance of %f to the trajectory.", path_tolerance_);
+    return false;
+  }
+  const PathGrid grid(path);
+
+  // Averaging over the time it takes to ramp up the acceleration limits the jerk of steps from rest
+  double filter_duration = max_acceleration.cwiseQuotient(max_jerk).maxCoeff();
+  std::vector<double> x;
+  if (!computePathVelocities(path, grid, max_velocity, max_acceleration, max_jerk, filter_duration, x))
+  {
+    RCLCPP_ERROR(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION, "Unable to parameterize trajectory.");
+    return false;
+  }
+  FilteredTimeLaw time_law(grid, x, filter_duration);
+
+  SampledTrajectory samples;
+  double velocity_ratio, acceleration_ratio, jerk_ratio;
+  samples.sample(path, time_law, 1.0, resample_dt_);
+  samples.getLimitRatios(max_velocity, max_acceleration, max_jerk, velocity_ratio, acceleration_ratio, jerk_ratio);
+
+  // Switching between accelerating and braking at full acceleration needs up to twice the ramp time
+  if (jerk_ratio > 1.0 + LIMIT_TOLERANCE)
+  {
+    filter_duration *= std::min(jerk_ratio, 2.0);
+    if (!computePathVelocities(path, grid, max_velocity, max_acceleration, max_jerk, filter_duration, x))
+    {
+      RCLCPP_ERROR(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION, "Unable to parameterize trajectory.");
+      return false;
+    }
+    time_law = FilteredTimeLaw(grid, x, filter_duration);
+    samples.sample(path, time_law, 1.0, resample_dt_);
+    samples.getLimitRatios(max_velocity, max_acceleration, max_jerk, velocity_ratio, acceleration_ratio, jerk_ratio);
+  }
+
+  // Averaging the path acceleration along curved paths can still exceed the limits slightly, so slow down uniformly
+  double time_scale = 1.0;
+  double ratio = std::max({ velocity_ratio, std::sqrt(acceleration_ratio), std::cbrt(jerk_ratio) });
+  for (unsigned int attempt = 0; attempt < 10 && ratio > 1.0 + LIMIT_TOLERANCE; ++attempt)
+  {
+    time_scale *= ratio;
+    samples.sample(path, time_law, time_scale, resample_dt_);
+    samples.getLimitRatios(max_velocity, max_acceleration, max_jerk, velocity_ratio, acceleration_ratio, jerk_ratio);
+    ratio = std::max({ velocity_ratio, std::sqrt(acceleration_ratio), std::cbrt(jerk_ratio) });
+  }
+  if (ratio > 1.0 + LIMIT_TOLERANCE)
+  {
+    RCLCPP_ERROR(LOGGER_JERK_LIMITED_TRAJECTORY_GENERATION, "Unable to parameterize trajectory within the limits.");
+    return false;
+  }
+
+  // Fill in trajectory
+  trajectory.clear();
+  trajectory.reserve(samples.times_.size());
+  double last_t = 0;
+  for (size_t sample = 0; sample < samples.times_.size(); ++sample)
+  {
+    for (size_t j = 0; j < num_joints; ++j)
+    {
+      positions[idx[j]] = samples.positions_(j, sample);
+      velocities[idx[j]] = samples.velocities_(j, sample);
+      accelerations[idx[j]] = samples.accelerations_(j, sample);
+    }
+
+    trajectory.addSuffixWayPoint(positions.data(), velocities.data(), accelerations.data(),
+                                 samples.times_[sample] - last_t);
+    last_t = samples.times_[sample];
+  }
+
+  return true;
+}
+}  // namespace trajectory_processing
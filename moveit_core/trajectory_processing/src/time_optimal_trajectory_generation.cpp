@@ -54,30 +54,34 @@ class LinearPathSegment : public PathSegment
 {
 public:
   LinearPathSegment(const Eigen::VectorXd& start, const Eigen::VectorXd& end)
-    : PathSegment((end - start).norm()), end_(end), start_(start)
+    : PathSegment((end - start).norm()), end_(end), start_(start), tangent_((end_ - start_) / length_)
   {
   }
 
-  Eigen::VectorXd getConfig(double s) const override
+  using PathSegment::getConfig;
+  using PathSegment::getTangent;
+  using PathSegment::getCurvature;
+
+  void getConfig(double s, Eigen::VectorXd& config) const override
   {
     s /= length_;
     s = std::max(0.0, std::min(1.0, s));
-    return (1.0 - s) * start_ + s * end_;
+    config = (1.0 - s) * start_ + s * end_;
   }
 
-  Eigen::VectorXd getTangent(double /* s */) const override
+  void getTangent(double /* s */, Eigen::VectorXd& tangent) const override
   {
-    return (end_ - start_) / length_;
+    tangent = tangent_;
   }
 
-  Eigen::VectorXd getCurvature(double /* s */) const override
+  void getCurvature(double /* s */, Eigen::VectorXd& curvature) const override
   {
-    return Eigen::VectorXd::Zero(start_.size());
+    curvature.setZero(start_.size());
   }
 
-  std::list<double> getSwitchingPoints() const override
+  std::vector<double> getSwitchingPoints() const override
   {
-    return std::list<double>();
+    return std::vector<double>();
   }
 
   LinearPathSegment* clone() const override
@@ -88,6 +92,7 @@ public:
 private:
   Eigen::VectorXd end_;
   Eigen::VectorXd start_;
+  Eigen::VectorXd tangent_;
 };
 
 class CircularPathSegment : public PathSegment
@@ -137,27 +142,31 @@ public:
     y = start_direction;
   }
 
-  Eigen::VectorXd getConfig(double s) const override
+  using PathSegment::getConfig;
+  using PathSegment::getTangent;
+  using PathSegment::getCurvature;
+
+  void getConfig(double s, Eigen::VectorXd& config) const override
   {
     const double angle = s / radius;
-    return center + radius * (x * cos(angle) + y * sin(angle));
+    config = center + radius * (x * cos(angle) + y * sin(angle));
   }
 
-  Eigen::VectorXd getTangent(double s) const override
+  void getTangent(double s, Eigen::VectorXd& tangent) const override
   {
     const double angle = s / radius;
-    return -x * sin(angle) + y * cos(angle);
+    tangent = -x * sin(angle) + y * cos(angle);
   }
 
-  Eigen::VectorXd getCurvature(double s) const override
+  void getCurvature(double s, Eigen::VectorXd& curvature) const override
   {
     const double angle = s / radius;
-    return -1.0 / radius * (x * cos(angle) + y * sin(angle));
+    curvature = -1.0 / radius * (x * cos(angle) + y * sin(angle));
   }
 
-  std::list<double> getSwitchingPoints() const override
+  std::vector<double> getSwitchingPoints() const override
   {
-    std::list<double> switching_points;
+    std::vector<double> switching_points;
     const double dim = x.size();
     for (unsigned int i = 0; i < dim; ++i)
     {
@@ -172,7 +181,7 @@ public:
         switching_points.push_back(switching_point);
       }
     }
-    switching_points.sort();
+    std::sort(switching_points.begin(), switching_points.end());
     return switching_points;
   }
 
@@ -192,20 +201,31 @@ Path::Path(const std::list<Eigen::VectorXd>& path, double max_deviation) : lengt
 {
   if (path.size() < 2)
     return;
-  std::list<Eigen::VectorXd>::const_iterator path_iterator1 = path.begin();
-  std::list<Eigen::VectorXd>::const_iterator path_iterator2 = path_iterator1;
-  ++path_iterator2;
-  std::list<Eigen::VectorXd>::const_iterator path_iterator3;
-  Eigen::VectorXd start_config = *path_iterator1;
-  while (path_iterator2 != path.end())
-  {
-    path_iterator3 = path_iterator2;
-    ++path_iterator3;
-    if (max_deviation > 0.0 && path_iterator3 != path.end())
-    {
-      CircularPathSegment* blend_segment =
-          new CircularPathSegment(0.5 * (*path_iterator1 + *path_iterator2), *path_iterator2,
-                                  0.5 * (*path_iterator2 + *path_iterator3), max_deviation);
+  Eigen::MatrixXd points(path.front().size(), path.size());
+  Eigen::Index i = 0;
+  for (const Eigen::VectorXd& point : path)
+    points.col(i++) = point;
+  init(points, max_deviation);
+}
+
+Path::Path(const Eigen::MatrixXd& path, double max_deviation) : length_(0.0)
+{
+  if (path.cols() < 2)
+    return;
+  init(path, max_deviation);
+}
+
+void Path::init(const Eigen::MatrixXd& path, double max_deviation)
+{
+  const Eigen::Index point_count = path.cols();
+  path_segments_.reserve(max_deviation > 0.0 ? 2 * point_count : point_count);
+  Eigen::VectorXd start_config = path.col(0);
+  for (Eigen::Index i = 1; i < point_count; ++i)
+  {
+    if (max_deviation > 0.0 && i + 1 < point_count)
+    {
+      CircularPathSegment* blend_segment = new CircularPathSegment(
+          0.5 * (path.col(i - 1) + path.col(i)), path.col(i), 0.5 * (path.col(i) + path.col(i + 1)), max_deviation);
       Eigen::VectorXd end_config = blend_segment->getConfig(0.0);
       if ((end_config - start_config).norm() > 0.000001)
       {
@@ -213,30 +233,25 @@ Path::Path(const std::list<Eigen::VectorXd>& path, double max_deviation) : lengt
       }
       path_segments_.emplace_back(blend_segment);
 
-      start_config = blend_segment->getConfig(blend_segment->getLength());
+      blend_segment->getConfig(blend_segment->getLength(), start_config);
     }
     else
     {
-      path_segments_.push_back(std::make_unique<LinearPathSegment>(start_config, *path_iterator2));
-      start_config = *path_iterator2;
+      path_segments_.push_back(std::make_unique<LinearPathSegment>(start_config, path.col(i)));
+      start_config = path.col(i);
     }
-    path_iterator1 = path_iterator2;
-    ++path_iterator2;
   }
 
   // Create list of switching point candidates, calculate total path length and
   // absolute positions of path segments
-  for (std::list<std::unique_ptr<PathSegment>>::iterator segment = path_segments_.begin();
-       segment != path_segments_.end(); ++segment)
+  for (const std::unique_ptr<PathSegment>& segment : path_segments_)
   {
-    (*segment)->position_ = length_;
-    std::list<double> local_switching_points = (*segment)->getSwitchingPoints();
-    for (std::list<double>::const_iterator point = local_switching_points.begin();
-         point != local_switching_points.end(); ++point)
+    segment->position_ = length_;
+    for (double point : segment->getSwitchingPoints())
     {
-      switching_points_.push_back(std::make_pair(length_ + *point, false));
+      switching_points_.push_back(std::make_pair(length_ + point, false));
     }
-    length_ += (*segment)->getLength();
+    length_ += segment->getLength();
     while (!switching_points_.empty() && switching_points_.back().first >= length_)
       switching_points_.pop_back();
     switching_points_.push_back(std::make_pair(length_, true));
@@ -246,10 +261,10 @@ Path::Path(const std::list<Eigen::VectorXd>& path, double max_deviation) : lengt
 
 Path::Path(const Path& path) : length_(path.length_), switching_points_(path.switching_points_)
 {
-  for (std::list<std::unique_ptr<PathSegment>>::const_iterator it = path.path_segments_.begin();
-       it != path.path_segments_.end(); ++it)
+  path_segments_.reserve(path.path_segments_.size());
+  for (const std::unique_ptr<PathSegment>& segment : path.path_segments_)
   {
-    path_segments_.emplace_back((*it)->clone());
+    path_segments_.emplace_back(segment->clone());
   }
 }
 
@@ -258,16 +273,13 @@ double Path::getLength() const
   return length_;
 }
 
-PathSegment* Path::getPathSegment(double& s) const
+const PathSegment* Path::getPathSegment(double& s) const
 {
-  std::list<std::unique_ptr<PathSegment>>::const_iterator it = path_segments_.begin();
-  std::list<std::unique_ptr<PathSegment>>::const_iterator next = it;
-  ++next;
-  while (next != path_segments_.end() && s >= (*next)->position_)
-  {
-    it = next;
-    ++next;
-  }
+  // the last segment starting at or before s, or the first one if s is before the start of the path
+  std::vector<std::unique_ptr<PathSegment>>::const_iterator it = std::upper_bound(
+      path_segments_.begin() + 1, path_segments_.end(), s,
+      [](double position, const std::unique_ptr<PathSegment>& segment) { return position < segment->position_; });
+  --it;
   s -= (*it)->position_;
   return (*it).get();
 }
@@ -290,13 +302,29 @@ Eigen::VectorXd Path::getCurvature(double s) const
   return path_segment->getCurvature(s);
 }
 
+void Path::getConfig(double s, Eigen::VectorXd& config) const
+{
+  const PathSegment* path_segment = getPathSegment(s);
+  path_segment->getConfig(s, config);
+}
+
+void Path::getTangent(double s, Eigen::VectorXd& tangent) const
+{
+  const PathSegment* path_segment = getPathSegment(s);
+  path_segment->getTangent(s, tangent);
+}
+
+void Path::getCurvature(double s, Eigen::VectorXd& curvature) const
+{
+  const PathSegment* path_segment = getPathSegment(s);
+  path_segment->getCurvature(s, curvature);
+}
+
 double Path::getNextSwitchingPoint(double s, bool& discontinuity) const
 {
-  std::list<std::pair<double, bool>>::const_iterator it = switching_points_.begin();
-  while (it != switching_points_.end() && it->first <= s)
-  {
-    ++it;
-  }
+  std::vector<std::pair<double, bool>>::const_iterator it =
+      std::upper_bound(switching_points_.begin(), switching_points_.end(), s,
+                       [](double position, const std::pair<double, bool>& point) { return position < point.first; });
   if (it == switching_points_.end())
   {
     discontinuity = true;
@@ -306,7 +334,7 @@ double Path::getNextSwitchingPoint(double s, bool& discontinuity) const
   return it->first;
 }
 
-std::list<std::pair<double, bool>> Path::getSwitchingPoints() const
+const std::vector<std::pair<double, bool>>& Path::getSwitchingPoints() const
 {
   return switching_points_;
 }
@@ -325,6 +353,7 @@ Trajectory::Trajectory(const Path& path, const Eigen::VectorXd& max_velocity, co
   , valid_(true)
   , time_step_(time_step)
   , cached_time_(std::numeric_limits<double>::max())
+  , cached_trajectory_segment_(0)
 {
   trajectory_.push_back(TrajectoryStep(0.0, 0.0));
   double after_acceleration = getMinMaxPathAcceleration(0.0, 0.0, true);
@@ -348,16 +377,13 @@ Trajectory::Trajectory(const Path& path, const Eigen::VectorXd& max_velocity, co
   if (valid_)
   {
     // Calculate timing
-    std::list<TrajectoryStep>::iterator previous = trajectory_.begin();
-    std::list<TrajectoryStep>::iterator it = previous;
-    it->time_ = 0.0;
-    ++it;
-    while (it != trajectory_.end())
+    trajectory_.front().time_ = 0.0;
+    for (std::size_t i = 1; i < trajectory_.size(); ++i)
     {
-      it->time_ =
-          previous->time_ + (it->path_pos_ - previous->path_pos_) / ((it->path_vel_ + previous->path_vel_) / 2.0);
-      previous = it;
-      ++it;
+      const TrajectoryStep& previous = trajectory_[i - 1];
+      TrajectoryStep& step = trajectory_[i];
+      step.time_ =
+          previous.time_ + (step.path_pos_ - previous.path_pos_) / ((step.path_vel_ + previous.path_vel_) / 2.0);
     }
   }
 }
@@ -515,13 +541,16 @@ bool Trajectory::getNextVelocitySwitchingPoint(double path_pos, TrajectoryStep&
 }
 
 // Returns true if end of path is reached
-bool Trajectory::integrateForward(std::list<TrajectoryStep>& trajectory, double acceleration)
+bool Trajectory::integrateForward(std::vector<TrajectoryStep>& trajectory, double acceleration)
 {
   double path_pos = trajectory.back().path_pos_;
   double path_vel = trajectory.back().path_vel_;
 
-  std::list<std::pair<double, bool>> switching_points = path_.getSwitchingPoints();
-  std::list<std::pair<double, bool>>::iterator next_discontinuity = switching_points.begin();
+  // switching points at or before the start position are skipped anyway
+  const std::vector<std::pair<double, bool>>& switching_points = path_.getSwitchingPoints();
+  std::vector<std::pair<double, bool>>::const_iterator next_discontinuity =
+      std::upper_bound(switching_points.begin(), switching_points.end(), path_pos,
+                       [](double position, const std::pair<double, bool>& point) { return position < point.first; });
 
   while (true)
   {
@@ -603,7 +632,7 @@ bool Trajectory::integrateForward(std::list<TrajectoryStep>& trajectory, double
 
       if (getAccelerationMaxPathVelocity(after) < getVelocityMaxPathVelocity(after))
       {
-        if (after > next_discontinuity->first)
+        if (next_discontinuity != switching_points.end() && after > next_discontinuity->first)
         {
           return false;
         }
@@ -625,32 +654,32 @@ bool Trajectory::integrateForward(std::list<TrajectoryStep>& trajectory, double
   }
 }
 
-void Trajectory::integrateBackward(std::list<TrajectoryStep>& start_trajectory, double path_pos, double path_vel,
+void Trajectory::integrateBackward(std::vector<TrajectoryStep>& start_trajectory, double path_pos, double path_vel,
                                    double acceleration)
 {
-  std::list<TrajectoryStep>::iterator start2 = start_trajectory.end();
-  --start2;
-  std::list<TrajectoryStep>::iterator start1 = start2;
-  --start1;
-  std::list<TrajectoryStep> trajectory;
+  std::size_t start2 = start_trajectory.size() - 1;
+  std::size_t start1 = start2 - 1;
+  // the backward trajectory is built in reverse order, its front is at the back
+  std::vector<TrajectoryStep>& trajectory = backward_trajectory_;
+  trajectory.clear();
   double slope;
-  assert(start1->path_pos_ <= path_pos);
+  assert(start_trajectory[start1].path_pos_ <= path_pos);
 
-  while (start1 != start_trajectory.begin() || path_pos >= 0.0)
+  while (start1 != 0 || path_pos >= 0.0)
   {
-    if (start1->path_pos_ <= path_pos)
+    if (start_trajectory[start1].path_pos_ <= path_pos)
     {
-      trajectory.push_front(TrajectoryStep(path_pos, path_vel));
+      trajectory.push_back(TrajectoryStep(path_pos, path_vel));
       path_vel -= time_step_ * acceleration;
-      path_pos -= time_step_ * 0.5 * (path_vel + trajectory.front().path_vel_);
+      path_pos -= time_step_ * 0.5 * (path_vel + trajectory.back().path_vel_);
       acceleration = getMinMaxPathAcceleration(path_pos, path_vel, false);
-      slope = (trajectory.front().path_vel_ - path_vel) / (trajectory.front().path_pos_ - path_pos);
+      slope = (trajectory.back().path_vel_ - path_vel) / (trajectory.back().path_pos_ - path_pos);
 
       if (path_vel < 0.0)
       {
         valid_ = false;
         RCLCPP_ERROR(LOGGER_TIME_OPTIMAL_TRAJECTORY_GENERATION, "Error while integrating backward: Negative path velocity");
-        end_trajectory_ = trajectory;
+        end_trajectory_.assign(trajectory.rbegin(), trajectory.rend());
         return;
       }
     }
@@ -662,30 +691,33 @@ void Trajectory::integrateBackward(std::list<TrajectoryStep>& start_trajectory,
 
     // Check for intersection between current start trajectory and backward
     // trajectory segments
-    const double start_slope = (start2->path_vel_ - start1->path_vel_) / (start2->path_pos_ - start1->path_pos_);
+    const TrajectoryStep& step1 = start_trajectory[start1];
+    const TrajectoryStep& step2 = start_trajectory[start2];
+    const double start_slope = (step2.path_vel_ - step1.path_vel_) / (step2.path_pos_ - step1.path_pos_);
     const double intersection_path_pos =
-        (start1->path_vel_ - path_vel + slope * path_pos - start_slope * start1->path_pos_) / (slope - start_slope);
-    if (std::max(start1->path_pos_, path_pos) - EPS <= intersection_path_pos &&
-        intersection_path_pos <= EPS + std::min(start2->path_pos_, trajectory.front().path_pos_))
+        (step1.path_vel_ - path_vel + slope * path_pos - start_slope * step1.path_pos_) / (slope - start_slope);
+    if (std::max(step1.path_pos_, path_pos) - EPS <= intersection_path_pos &&
+        intersection_path_pos <= EPS + std::min(step2.path_pos_, trajectory.back().path_pos_))
     {
-      const double intersection_path_vel =
-          start1->path_vel_ + start_slope * (intersection_path_pos - start1->path_pos_);
-      start_trajectory.erase(start2, start_trajectory.end());
+      const double intersection_path_vel = step1.path_vel_ + start_slope * (intersection_path_pos - step1.path_pos_);
+      start_trajectory.erase(start_trajectory.begin() + start2, start_trajectory.end());
       start_trajectory.push_back(TrajectoryStep(intersection_path_pos, intersection_path_vel));
-      start_trajectory.splice(start_trajectory.end(), trajectory);
+      start_trajectory.insert(start_trajectory.end(), trajectory.rbegin(), trajectory.rend());
       return;
     }
   }
 
   valid_ = false;
   RCLCPP_ERROR(LOGGER_TIME_OPTIMAL_TRAJECTORY_GENERATION, "Error while integrating backward: Did not hit start trajectory");
-  end_trajectory_ = trajectory;
+  end_trajectory_.assign(trajectory.rbegin(), trajectory.rend());
 }
 
 double Trajectory::getMinMaxPathAcceleration(double path_pos, double path_vel, bool max)
 {
-  Eigen::VectorXd config_deriv = path_.getTangent(path_pos);
-  Eigen::VectorXd config_deriv2 = path_.getCurvature(path_pos);
+  path_.getTangent(path_pos, tangent_);
+  path_.getCurvature(path_pos, curvature_);
+  const Eigen::VectorXd& config_deriv = tangent_;
+  const Eigen::VectorXd& config_deriv2 = curvature_;
   double factor = max ? 1.0 : -1.0;
   double max_path_acceleration = std::numeric_limits<double>::max();
   for (unsigned int i = 0; i < joint_num_; ++i)
@@ -708,8 +740,10 @@ double Trajectory::getMinMaxPhaseSlope(double path_pos, double path_vel, bool ma
 double Trajectory::getAccelerationMaxPathVelocity(double path_pos) const
 {
   double max_path_velocity = std::numeric_limits<double>::infinity();
-  const Eigen::VectorXd config_deriv = path_.getTangent(path_pos);
-  const Eigen::VectorXd config_deriv2 = path_.getCurvature(path_pos);
+  path_.getTangent(path_pos, tangent_);
+  path_.getCurvature(path_pos, curvature_);
+  const Eigen::VectorXd& config_deriv = tangent_;
+  const Eigen::VectorXd& config_deriv2 = curvature_;
   for (unsigned int i = 0; i < joint_num_; ++i)
   {
     if (config_deriv[i] != 0.0)
@@ -738,7 +772,8 @@ double Trajectory::getAccelerationMaxPathVelocity(double path_pos) const
 
 double Trajectory::getVelocityMaxPathVelocity(double path_pos) const
 {
-  const Eigen::VectorXd tangent = path_.getTangent(path_pos);
+  path_.getTangent(path_pos, tangent_);
+  const Eigen::VectorXd& tangent = tangent_;
   double max_path_velocity = std::numeric_limits<double>::max();
   for (unsigned int i = 0; i < joint_num_; ++i)
   {
@@ -755,9 +790,11 @@ double Trajectory::getAccelerationMaxPathVelocityDeriv(double path_pos)
 
 double Trajectory::getVelocityMaxPathVelocityDeriv(double path_pos)
 {
-  const Eigen::VectorXd tangent = path_.getTangent(path_pos);
+  path_.getTangent(path_pos, tangent_);
+  path_.getCurvature(path_pos, curvature_);
+  const Eigen::VectorXd& tangent = tangent_;
   double max_path_velocity = std::numeric_limits<double>::max();
-  unsigned int active_constraint;
+  unsigned int active_constraint = 0;
   for (unsigned int i = 0; i < joint_num_; ++i)
   {
     const double this_max_path_velocity = max_velocity_[i] / std::abs(tangent[i]);
@@ -767,7 +804,7 @@ double Trajectory::getVelocityMaxPathVelocityDeriv(double path_pos)
       active_constraint = i;
     }
   }
-  return -(max_velocity_[active_constraint] * path_.getCurvature(path_pos)[active_constraint]) /
+  return -(max_velocity_[active_constraint] * curvature_[active_constraint]) /
          (tangent[active_constraint] * std::abs(tangent[active_constraint]));
 }
 
@@ -781,21 +818,23 @@ double Trajectory::getDuration() const
   return trajectory_.back().time_;
 }
 
-std::list<Trajectory::TrajectoryStep>::const_iterator Trajectory::getTrajectorySegment(double time) const
+std::size_t Trajectory::getTrajectorySegment(double time) const
 {
   if (time >= trajectory_.back().time_)
   {
-    std::list<TrajectoryStep>::const_iterator last = trajectory_.end();
-    last--;
-    return last;
+    return trajectory_.size() - 1;
   }
   else
   {
     if (time < cached_time_)
     {
-      cached_trajectory_segment_ = trajectory_.begin();
+      // restart from the first step after time, which is never the very first one
+      cached_trajectory_segment_ =
+          std::upper_bound(trajectory_.begin() + 1, trajectory_.end(), time,
+                           [](double t, const TrajectoryStep& step) { return t < step.time_; }) -
+          trajectory_.begin();
     }
-    while (time >= cached_trajectory_segment_->time_)
+    while (time >= trajectory_[cached_trajectory_segment_].time_)
     {
       ++cached_trajectory_segment_;
     }
@@ -804,60 +843,57 @@ std::list<Trajectory::TrajectoryStep>::const_iterator Trajectory::getTrajectoryS
   }
 }
 
-Eigen::VectorXd Trajectory::getPosition(double time) const
+const Trajectory::TrajectoryStep& Trajectory::getPathState(double time, double& path_pos, double& path_vel) const
 {
-  std::list<TrajectoryStep>::const_iterator it = getTrajectorySegment(time);
-  std::list<TrajectoryStep>::const_iterator previous = it;
-  previous--;
+  const TrajectoryStep& step = trajectory_[getTrajectorySegment(time)];
+  const TrajectoryStep& previous = *(&step - 1);
 
-  double time_step = it->time_ - previous->time_;
+  double time_step = step.time_ - previous.time_;
   const double acceleration =
-      2.0 * (it->path_pos_ - previous->path_pos_ - time_step * previous->path_vel_) / (time_step * time_step);
+      2.0 * (step.path_pos_ - previous.path_pos_ - time_step * previous.path_vel_) / (time_step * time_step);
 
-  time_step = time - previous->time_;
-  const double path_pos =
-      previous->path_pos_ + time_step * previous->path_vel_ + 0.5 * time_step * time_step * acceleration;
+  time_step = time - previous.time_;
+  path_pos = previous.path_pos_ + time_step * previous.path_vel_ + 0.5 * time_step * time_step * acceleration;
+  path_vel = previous.path_vel_ + time_step * acceleration;
+  return previous;
+}
 
+Eigen::VectorXd Trajectory::getPosition(double time) const
+{
+  double path_pos, path_vel;
+  getPathState(time, path_pos, path_vel);
   return path_.getConfig(path_pos);
 }
 
 Eigen::VectorXd Trajectory::getVelocity(double time) const
 {
-  std::list<TrajectoryStep>::const_iterator it = getTrajectorySegment(time);
-  std::list<TrajectoryStep>::const_iterator previous = it;
-  previous--;
-
-  double time_step = it->time_ - previous->time_;
-  const double acceleration =
-      2.0 * (it->path_pos_ - previous->path_pos_ - time_step * previous->path_vel_) / (time_step * time_step);
-
-  time_step = time - previous->time_;
-  const double path_pos =
-      previous->path_pos_ + time_step * previous->path_vel_ + 0.5 * time_step * time_step * acceleration;
-  const double path_vel = previous->path_vel_ + time_step * acceleration;
-
+  double path_pos, path_vel;
+  getPathState(time, path_pos, path_vel);
   return path_.getTangent(path_pos) * path_vel;
 }
 
 Eigen::VectorXd Trajectory::getAcceleration(double time) const
 {
-  std::list<TrajectoryStep>::const_iterator it = getTrajectorySegment(time);
-  std::list<TrajectoryStep>::const_iterator previous = it;
-  previous--;
+  Eigen::VectorXd position, velocity, acceleration;
+  sample(time, position, velocity, acceleration);
+  return acceleration;
+}
 
-  double time_step = it->time_ - previous->time_;
-  const double acceleration =
-      2.0 * (it->path_pos_ - previous->path_pos_ - time_step * previous->path_vel_) / (time_step * time_step);
-
-  time_step = time - previous->time_;
-  const double path_pos =
-      previous->path_pos_ + time_step * previous->path_vel_ + 0.5 * time_step * time_step * acceleration;
-  const double path_vel = previous->path_vel_ + time_step * acceleration;
-  Eigen::VectorXd path_acc =
-      (path_.getTangent(path_pos) * path_vel - path_.getTangent(previous->path_pos_) * previous->path_vel_);
+void Trajectory::sample(double time, Eigen::VectorXd& position, Eigen::VectorXd& velocity,
+                        Eigen::VectorXd& acceleration) const
+{
+  double path_pos, path_vel;
+  const TrajectoryStep& previous = getPathState(time, path_pos, path_vel);
+
+  path_.getConfig(path_pos, position);
+  path_.getTangent(path_pos, velocity);
+  velocity *= path_vel;
+
+  path_.getTangent(previous.path_pos_, acceleration);
+  acceleration = velocity - acceleration * previous.path_vel_;
+  const double time_step = time - previous.time_;
   if (time_step > 0.0)
-    path_acc /= time_step;
-  return path_acc;
+    acceleration /= time_step;
 }
 
 TimeOptimalTrajectoryGeneration::TimeOptimalTrajectoryGeneration(const double path_tolerance, const double resample_dt)
@@ -876,6 +912,20 @@ bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotT
   if (trajectory.empty())
     return true;
 
+  robot_trajectory::CompactRobotTrajectory compact(trajectory);
+  if (!computeTimeStamps(compact, max_velocity_scaling_factor, max_acceleration_scaling_factor))
+    return false;
+  compact.getRobotTrajectory(trajectory);
+  return true;
+}
+
+bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::CompactRobotTrajectory& trajectory,
+                                                        const double max_velocity_scaling_factor,
+                                                        const double max_acceleration_scaling_factor) const
+{
+  if (trajectory.empty())
+    return true;
+
   const robot_model::JointModelGroup* group = trajectory.getGroup();
   if (!group)
   {
@@ -952,31 +1002,43 @@ bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotT
 
   // Have to convert into Eigen data structs and remove repeated points
   //  (https://github.com/tobiaskunz/trajectories/issues/3)
-  std::list<Eigen::VectorXd> points;
+  Eigen::MatrixXd points(num_joints, num_points);
+  Eigen::Index point_count = 0;
   for (size_t p = 0; p < num_points; ++p)
   {
-    robot_state::RobotStatePtr waypoint = trajectory.getWayPointPtr(p);
-    Eigen::VectorXd new_point(num_joints);
     bool diverse_point = (p == 0);
 
     for (size_t j = 0; j < num_joints; j++)
     {
-      new_point[j] = waypoint->getVariablePosition(idx[j]);
-      if (p > 0 && std::abs(new_point[j] - points.back()[j]) > 0.001)
+      points(j, point_count) = trajectory.getVariablePosition(p, idx[j]);
+      if (p > 0 && std::abs(points(j, point_count) - points(j, point_count - 1)) > 0.001)
         diverse_point = true;
     }
 
     if (diverse_point)
-      points.push_back(new_point);
+      ++point_count;
+  }
+  points.conservativeResize(Eigen::NoChange, point_count);
+
+  // The variables outside of the group keep their values at the first waypoint
+  const std::size_t variable_count = rmodel.getVariableCount();
+  std::vector<double> positions(variable_count), velocities(variable_count), accelerations(variable_count);
+  for (std::size_t i = 0; i < variable_count; ++i)
+  {
+    positions[i] = trajectory.getVariablePosition(0, i);
+    velocities[i] = trajectory.getVariableVelocity(0, i);
+    accelerations[i] = trajectory.getVariableAcceleration(0, i);
   }
 
   // Return trajectory with only the first waypoint if there are not multiple diverse points
-  if (points.size() == 1)
+  if (point_count == 1)
   {
     RCLCPP_WARN(LOGGER_TIME_OPTIMAL_TRAJECTORY_GENERATION, "Trajectory is not being parameterized since it only contains a single distinct waypoint.");
-    robot_state::RobotState waypoint = robot_state::RobotState(trajectory.getWayPoint(0));
+    const bool has_velocities = trajectory.hasVelocities();
+    const bool has_accelerations = trajectory.hasAccelerations();
     trajectory.clear();
-    trajectory.addSuffixWayPoint(waypoint, 0.0);
+    trajectory.addSuffixWayPoint(positions.data(), has_velocities ? velocities.data() : nullptr,
+                                 has_accelerations ? accelerations.data() : nullptr, 0.0);
     return true;
   }
 
@@ -991,26 +1053,25 @@ bool TimeOptimalTrajectoryGeneration::computeTimeStamps(robot_trajectory::RobotT
   // Compute sample count
   size_t sample_count = std::ceil(parameterized.getDuration() / resample_dt_);
 
-  // Resample and fill in trajectory
-  robot_state::RobotState waypoint = robot_state::RobotState(trajectory.getWayPoint(0));
+  // Resample and fill in trajectory, sampling times are increasing so each sample continues from the previous one
   trajectory.clear();
+  trajectory.reserve(sample_count + 1);
+  Eigen::VectorXd position(num_joints), velocity(num_joints), acceleration(num_joints);
   double last_t = 0;
   for (size_t sample = 0; sample <= sample_count; ++sample)
   {
     // always sample the end of the trajectory as well
     double t = std::min(parameterized.getDuration(), sample * resample_dt_);
-    Eigen::VectorXd position = parameterized.getPosition(t);
-    Eigen::VectorXd velocity = parameterized.getVelocity(t);
-    Eigen::VectorXd acceleration = parameterized.getAcceleration(t);
+    parameterized.sample(t, position, velocity, acceleration);
 
     for (size_t j = 0; j < num_joints; ++j)
     {
-      waypoint.setVariablePosition(idx[j], position[j]);
-      waypoint.setVariableVelocity(idx[j], velocity[j]);
-      waypoint.setVariableAcceleration(idx[j], acceleration[j]);
+      positions[idx[j]] = position[j];
+      velocities[idx[j]] = velocity[j];
+      accelerations[idx[j]] = acceleration[j];
     }
 
-    trajectory.addSuffixWayPoint(waypoint, t - last_t);
+    trajectory.addSuffixWayPoint(positions.data(), velocities.data(), accelerations.data(), t - last_t);
     last_t = t;
   }
 
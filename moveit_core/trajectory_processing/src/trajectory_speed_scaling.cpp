@@ -0,0 +1,338 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/trajectory_processing/trajectory_speed_scaling.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "rclcpp/rclcpp.hpp"
+
+namespace trajectory_processing
+{
+rclcpp::Logger LOGGER_TRAJECTORY_SPEED_SCALING =
+    rclcpp::get_logger("moveit").get_child("trajectory_processing.trajectory_speed_scaling");
+
+TrajectorySpeedScaling::TrajectorySpeedScaling(const robot_trajectory::RobotTrajectory& trajectory)
+  : reference_(trajectory)
+{
+  init();
+}
+
+TrajectorySpeedScaling::TrajectorySpeedScaling(const robot_trajectory::CompactRobotTrajectory& trajectory)
+  : reference_(trajectory)
+{
+  init();
+}
+
+void TrajectorySpeedScaling::init()
+{
+  reference_times_.resize(reference_.getWayPointCount());
+  double time = 0.0;
+  for (std::size_t i = 0; i < reference_times_.size(); ++i)
+  {
+    time += reference_.getWayPointDurationFromPrevious(i);
+    reference_times_[i] = time;
+  }
+
+  if (reference_.getGroup())
+    variables_.assign(reference_.getGroup()->getVariableIndexList().begin(),
+                      reference_.getGroup()->getVariableIndexList().end());
+  else
+  {
+    variables_.resize(reference_.getRobotModel()->getVariableCount());
+    for (std::size_t i = 0; i < variables_.size(); ++i)
+      variables_[i] = i;
+  }
+
+  const robot_model::RobotModelConstPtr& robot_model = reference_.getRobotModel();
+  max_accelerations_.assign(variables_.size(), 0.0);
+  for (std::size_t i = 0; i < variables_.size(); ++i)
+  {
+    const robot_model::VariableBounds& bounds =
+        robot_model->getVariableBounds(robot_model->getVariableNames()[variables_[i]]);
+    if (bounds.acceleration_bounded_)
+      max_accelerations_[i] = std::min(std::abs(bounds.max_acceleration_), std::abs(bounds.min_acceleration_));
+  }
+
+  // the original timing
+  ramp_start_time_ = 0.0;
+  ramp_start_reference_time_ = 0.0;
+  ramp_start_factor_ = 1.0;
+  ramp_start_derivative_ = 0.0;
+  ramp_end_factor_ = 1.0;
+  ramp_duration_ = 0.0;
+
+  positions_.resize(reference_.getRobotModel()->getVariableCount());
+  velocities_.resize(positions_.size());
+  accelerations_.resize(positions_.size());
+}
+
+void TrajectorySpeedScaling::evaluate(double time, double& reference_time, double& speed_factor,
+                                      double& speed_factor_derivative) const
+{
+  const double s = time - ramp_start_time_;
+  const double delta = ramp_end_factor_ - ramp_start_factor_;
+  if (s < ramp_duration_)
+  {
+    // cubic Hermite polynomial from the start factor and derivative to the end factor with zero derivative
+    const double u = s / ramp_duration_;
+    const double u2 = u * u;
+    const double u3 = u2 * u;
+    const double td = ramp_duration_ * ramp_start_derivative_;
+    speed_factor = ramp_start_factor_ + td * (u3 - 2.0 * u2 + u) + delta * (3.0 * u2 - 2.0 * u3);
+    speed_factor_derivative =
+        ramp_start_derivative_ * (3.0 * u2 - 4.0 * u + 1.0) + delta * (6.0 * u - 6.0 * u2) / ramp_duration_;
+    reference_time = ramp_start_reference_time_ + ramp_start_factor_ * s +
+                     ramp_duration_ * td * (0.25 * u2 * u2 - 2.0 / 3.0 * u3 + 0.5 * u2) +
+                     delta * ramp_duration_ * (u3 - 0.5 * u2 * u2);
+  }
+  else
+  {
+    speed_factor = ramp_end_factor_;
+    speed_factor_derivative = 0.0;
+    reference_time = ramp_start_reference_time_ + ramp_start_factor_ * ramp_duration_ +
+                     ramp_duration_ * ramp_duration_ * ramp_start_derivative_ / 12.0 +
+                     0.5 * delta * ramp_duration_ + ramp_end_factor_ * (s - ramp_duration_);
+  }
+}
+
+double TrajectorySpeedScaling::getExecutionTime(double reference_time, double lower_bound) const
+{
+  double ramp_end_reference_time, factor, derivative;
+  evaluate(ramp_start_time_ + ramp_duration_, ramp_end_reference_time, factor, derivative);
+  if (reference_time >= ramp_end_reference_time)
+    return ramp_start_time_ + ramp_duration_ + (reference_time - ramp_end_reference_time) / ramp_end_factor_;
+
+  // the reference time increases monotonically during the ramp: Newton steps, falling back to bisection
+  double lower = std::max(lower_bound - ramp_start_time_, 0.0);
+  double upper = ramp_duration_;
+  double s = lower;
+  const double tolerance = 4.0 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::abs(reference_time));
+  for (int i = 0; i < 100; ++i)
+  {
+    double current;
+    evaluate(ramp_start_time_ + s, current, factor, derivative);
+    const double error = current - reference_time;
+    if (std::abs(error) <= tolerance)
+      break;
+    if (error > 0.0)
+      upper = s;
+    else
+      lower = s;
+    s -= error / factor;
+    if (!(s > lower && s < upper))
+      s = 0.5 * (lower + upper);
+  }
+  return ramp_start_time_ + s;
+}
+
+double TrajectorySpeedScaling::limitRampDuration(double reference_time, double ramp_duration)
+{
+  // the largest ratio of the velocity of a remaining waypoint to the acceleration limit of its joint
+  std::size_t first =
+      std::upper_bound(reference_times_.begin(), reference_times_.end(), reference_time) - reference_times_.begin();
+  first = first > 0 ? first - 1 : 0;
+  double ratio = 0.0;
+  for (std::size_t i = 0; i < variables_.size(); ++i)
+  {
+    if (!(max_accelerations_[i] > 0.0))
+      continue;
+    const double* velocities = reference_.getVariableVelocities(variables_[i]);
+    for (std::size_t j = first; j < reference_times_.size(); ++j)
+      ratio = std::max(ratio, std::abs(velocities[j]) / max_accelerations_[i]);
+  }
+  if (ratio == 0.0)
+    return ramp_duration;
+
+  // the rate of change of the factor is at most |start derivative| + 1.5 |delta| / ramp_duration; a start derivative
+  // that already uses most of the limit is dropped, which makes the acceleration jump by at most the limit
+  if (std::abs(ramp_start_derivative_) * ratio > 0.5)
+    ramp_start_derivative_ = 0.0;
+  const double delta = std::abs(ramp_end_factor_ - ramp_start_factor_);
+  return std::max(ramp_duration, 1.5 * delta * ratio / (1.0 - std::abs(ramp_start_derivative_) * ratio));
+}
+
+double TrajectorySpeedScaling::getSpeedFactor(double time) const
+{
+  double reference_time, factor, derivative;
+  evaluate(time, reference_time, factor, derivative);
+  return factor;
+}
+
+double TrajectorySpeedScaling::getReferenceTime(double time) const
+{
+  double reference_time, factor, derivative;
+  evaluate(time, reference_time, factor, derivative);
+  return reference_time;
+}
+
+double TrajectorySpeedScaling::getDuration() const
+{
+  if (reference_times_.empty())
+    return 0.0;
+  return getExecutionTime(reference_times_.back(), ramp_start_time_);
+}
+
+bool TrajectorySpeedScaling::setSpeedFactor(double time, double speed_factor, double ramp_duration,
+                                            robot_trajectory::RobotTrajectory& suffix)
+{
+  robot_trajectory::CompactRobotTrajectory compact(reference_.getRobotModel(), reference_.getGroup());
+  compact.setReferenceState(reference_.getReferenceState());
+  if (!setSpeedFactor(time, speed_factor, ramp_duration, compact))
+    return false;
+  compact.getRobotTrajectory(suffix);
+  return true;
+}
+
+bool TrajectorySpeedScaling::setSpeedFactor(double time, double speed_factor, double ramp_duration,
+                                            robot_trajectory::CompactRobotTrajectory& suffix)
+{
+  if (reference_.empty() || !reference_.hasVelocities())
+  {
+    RCLCPP_ERROR(LOGGER_TRAJECTORY_SPEED_SCALING, "Speed scaling requires a trajectory with velocities");
+    return false;
+  }
+  if (!(speed_factor > 0.0 && speed_factor <= 1.0) || !(ramp_duration >= 0.0))
+  {
+    RCLCPP_ERROR(LOGGER_TRAJECTORY_SPEED_SCALING, "Invalid speed factor %f or ramp duration %f", speed_factor,
+                 ramp_duration);
+    return false;
+  }
+  if (!(time >= ramp_start_time_))
+  {
+    RCLCPP_ERROR(LOGGER_TRAJECTORY_SPEED_SCALING, "Cannot change the speed factor at time %f, before the previous "
+                                                  "change at %f",
+                 time, ramp_start_time_);
+    return false;
+  }
+
+  // the new ramp starts from the current state of the speed factor
+  double reference_time, factor, derivative;
+  evaluate(time, reference_time, factor, derivative);
+  ramp_start_time_ = time;
+  ramp_start_reference_time_ = reference_time;
+  ramp_start_factor_ = factor;
+  ramp_start_derivative_ = derivative;
+  ramp_end_factor_ = speed_factor;
+  ramp_duration_ = limitRampDuration(reference_time, ramp_duration);
+
+  // keeping the current rate of change may make the factor overshoot below zero in a short ramp, drop it then
+  if (ramp_duration_ > 0.0 && ramp_start_derivative_ != 0.0)
+  {
+    const double td = ramp_duration_ * ramp_start_derivative_;
+    const double delta = ramp_end_factor_ - ramp_start_factor_;
+    // roots of the derivative of the factor with respect to u = s / ramp_duration
+    const double a = 3.0 * td - 6.0 * delta;
+    const double b = 6.0 * delta - 4.0 * td;
+    const double c = td;
+    double roots[2] = { -1.0, -1.0 };
+    if (std::abs(a) > std::numeric_limits<double>::epsilon())
+    {
+      const double discriminant = b * b - 4.0 * a * c;
+      if (discriminant >= 0.0)
+      {
+        roots[0] = (-b + std::sqrt(discriminant)) / (2.0 * a);
+        roots[1] = (-b - std::sqrt(discriminant)) / (2.0 * a);
+      }
+    }
+    else if (std::abs(b) > std::numeric_limits<double>::epsilon())
+      roots[0] = -c / b;
+    for (double u : roots)
+      if (u > 0.0 && u < 1.0 && getSpeedFactor(ramp_start_time_ + u * ramp_duration_) <= 0.0)
+        ramp_start_derivative_ = 0.0;
+  }
+
+  // the state at the splice point, interpolated between the surrounding waypoints
+  const std::size_t count = reference_times_.size();
+  std::size_t next =
+      std::upper_bound(reference_times_.begin(), reference_times_.end(), reference_time) - reference_times_.begin();
+  const std::size_t before = next > 0 ? next - 1 : 0;
+  const std::size_t after = std::min(next, count - 1);
+  const double alpha = after > before ? (reference_time - reference_times_[before]) /
+                                            (reference_times_[after] - reference_times_[before]) :
+                                        0.0;
+  for (std::size_t i = 0; i < positions_.size(); ++i)
+  {
+    positions_[i] = reference_.getVariablePosition(before, i);
+    velocities_[i] = reference_.getVariableVelocity(before, i);
+    accelerations_[i] = reference_.getVariableAcceleration(before, i);
+  }
+  for (std::size_t i : variables_)
+  {
+    positions_[i] += alpha * (reference_.getVariablePosition(after, i) - positions_[i]);
+    velocities_[i] += alpha * (reference_.getVariableVelocity(after, i) - velocities_[i]);
+    accelerations_[i] += alpha * (reference_.getVariableAcceleration(after, i) - accelerations_[i]);
+    accelerations_[i] = accelerations_[i] * factor * factor + velocities_[i] * derivative;
+    velocities_[i] *= factor;
+  }
+  // a waypoint that is reached up to rounding would follow the splice point after a vanishing duration
+  while (next < count && reference_times_[next] - reference_time < 1e-9)
+    ++next;
+
+  if (suffix.getRobotModel() != reference_.getRobotModel() || suffix.getGroup() != reference_.getGroup())
+  {
+    suffix = robot_trajectory::CompactRobotTrajectory(reference_.getRobotModel(), reference_.getGroup());
+    suffix.setReferenceState(reference_.getReferenceState());
+  }
+  suffix.clear();
+  suffix.reserve(count - next + 1);
+  suffix.addSuffixWayPoint(positions_.data(), velocities_.data(), accelerations_.data(), 0.0);
+  suffix.append(reference_, 0.0, next);
+
+  // new durations, and the speed factor at each remaining waypoint
+  factors_.resize(count - next);
+  factor_derivatives_.resize(count - next);
+  double previous = time;
+  for (std::size_t i = 0; i < factors_.size(); ++i)
+  {
+    const double waypoint_time = getExecutionTime(reference_times_[next + i], previous);
+    suffix.setWayPointDurationFromPrevious(i + 1, waypoint_time - previous);
+    evaluate(waypoint_time, reference_time, factors_[i], factor_derivatives_[i]);
+    previous = waypoint_time;
+  }
+
+  // the path is the same, so the velocity scales with the factor and the acceleration gains the change of the factor
+  for (std::size_t variable : variables_)
+  {
+    double* velocities = suffix.getVariableVelocities(variable) + 1;
+    double* accelerations = suffix.getVariableAccelerations(variable) + 1;
+    for (std::size_t i = 0; i < factors_.size(); ++i)
+    {
+      accelerations[i] = accelerations[i] * factors_[i] * factors_[i] + velocities[i] * factor_derivatives_[i];
+      velocities[i] *= factors_[i];
+    }
+  }
+  return true;
+}
+}  // namespace trajectory_processing
@@ -36,11 +36,16 @@
 
 #include <gtest/gtest.h>
 #include <fstream>
+#include <limits>
 #include <moveit/robot_state/robot_state.h>
 #include <moveit/robot_model/robot_model.h>
 #include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/robot_trajectory/robot_trajectory_sampler.h>
 #include <moveit/trajectory_processing/iterative_spline_parameterization.h>
 #include <moveit/trajectory_processing/iterative_time_parameterization.h>
+#include <moveit/trajectory_processing/jerk_limited_trajectory_generation.h>
+#include <moveit/trajectory_processing/time_optimal_trajectory_generation.h>
+#include <moveit/trajectory_processing/trajectory_speed_scaling.h>
 #include <moveit/utils/robot_model_test_utils.h>
 #include "rclcpp/rclcpp.hpp"
 
@@ -188,6 +193,294 @@ TEST(TestTimeParameterization, TestRepeatedPoint)
   ASSERT_LT(TRAJECTORY.getWayPointDurationFromStart(TRAJECTORY.getWayPointCount() - 1), 0.001);
 }
 
+TEST(TestTimeParameterization, TestTimeOptimalCompact)
+{
+  trajectory_processing::TimeOptimalTrajectoryGeneration time_parameterization;
+  EXPECT_EQ(initStraightTrajectory(TRAJECTORY), 0);
+
+  robot_trajectory::CompactRobotTrajectory compact(TRAJECTORY);
+  ASSERT_EQ(compact.getWayPointCount(), TRAJECTORY.getWayPointCount());
+  const int index = TRAJECTORY.getGroup()->getVariableIndexList()[0];
+  for (std::size_t i = 0; i < compact.getWayPointCount(); ++i)
+    EXPECT_EQ(compact.getVariablePositions(index)[i], TRAJECTORY.getWayPoint(i).getVariablePosition(index));
+
+  // parameterizing the compact trajectory gives the same result as parameterizing the RobotTrajectory
+  EXPECT_TRUE(time_parameterization.computeTimeStamps(compact));
+  EXPECT_TRUE(time_parameterization.computeTimeStamps(TRAJECTORY));
+  ASSERT_EQ(compact.getWayPointCount(), TRAJECTORY.getWayPointCount());
+  ASSERT_TRUE(compact.hasVelocities());
+  for (std::size_t i = 0; i < compact.getWayPointCount(); ++i)
+  {
+    EXPECT_DOUBLE_EQ(compact.getWayPointDurationFromStart(i), TRAJECTORY.getWayPointDurationFromStart(i));
+    EXPECT_DOUBLE_EQ(compact.getVariablePosition(i, index), TRAJECTORY.getWayPoint(i).getVariablePosition(index));
+    EXPECT_DOUBLE_EQ(compact.getVariableVelocity(i, index), TRAJECTORY.getWayPoint(i).getVariableVelocity(index));
+  }
+
+  // materialized waypoints are equal to the ones of the RobotTrajectory
+  robot_trajectory::RobotTrajectory materialized(RMODEL, "right_arm");
+  compact.getRobotTrajectory(materialized);
+  ASSERT_EQ(materialized.getWayPointCount(), TRAJECTORY.getWayPointCount());
+  for (std::size_t i = 0; i < materialized.getWayPointCount(); ++i)
+    for (std::size_t j = 0; j < RMODEL->getVariableCount(); ++j)
+      EXPECT_EQ(materialized.getWayPoint(i).getVariablePosition(j), TRAJECTORY.getWayPoint(i).getVariablePosition(j));
+
+  moveit_msgs::msg::RobotTrajectory msg;
+  compact.getRobotTrajectoryMsg(msg);
+  ASSERT_EQ(msg.joint_trajectory.points.size(), compact.getWayPointCount());
+  EXPECT_EQ(msg.joint_trajectory.points.back().velocities.size(), msg.joint_trajectory.joint_names.size());
+}
+
+TEST(TestTimeParameterization, TestSampler)
+{
+  trajectory_processing::IterativeSplineParameterization time_parameterization(true);
+  EXPECT_EQ(initStraightTrajectory(TRAJECTORY), 0);
+  EXPECT_TRUE(time_parameterization.computeTimeStamps(TRAJECTORY));
+
+  // sampling at increasing durations, and going back, gives the same states as getStateAtDurationFromStart()
+  robot_trajectory::RobotTrajectorySampler sampler(TRAJECTORY);
+  robot_state::RobotState state(RMODEL);
+  robot_state::RobotStatePtr expected(new robot_state::RobotState(RMODEL));
+  const int index = TRAJECTORY.getGroup()->getVariableIndexList()[0];
+  const double duration = TRAJECTORY.getWayPointDurationFromStart(TRAJECTORY.getWayPointCount());
+  for (double t : { -0.1, 0.0, 0.01, 0.5, 0.51, 1.0, duration, duration + 0.1, 0.2, 0.7 })
+  {
+    ASSERT_TRUE(sampler.sample(t, state));
+    ASSERT_TRUE(TRAJECTORY.getStateAtDurationFromStart(t, expected));
+    EXPECT_EQ(state.getVariablePosition(index), expected->getVariablePosition(index)) << t;
+  }
+  EXPECT_LT(sampler.getWayPointIndex(), TRAJECTORY.getWayPointCount());
+}
+
+TEST(TestTimeParameterization, TestDurationsFromStart)
+{
+  robot_trajectory::RobotTrajectory trajectory(RMODEL, "right_arm");
+  moveit::core::RobotState state(RMODEL);
+  state.setToDefaultValues();
+  auto expect_durations = [&trajectory]() {
+    double time = 0.0;
+    for (std::size_t i = 0; i < trajectory.getWayPointCount(); ++i)
+    {
+      time += trajectory.getWayPointDurationFromPrevious(i);
+      EXPECT_DOUBLE_EQ(trajectory.getWayPointDurationFromStart(i), time) << i;
+    }
+  };
+
+  for (int i = 0; i < 4; ++i)
+    trajectory.addSuffixWayPoint(state, 1.0);
+  expect_durations();
+
+  // waypoints added or set out of order shift the durations of all later ones, also once more are appended
+  trajectory.addPrefixWayPoint(state, 0.5);
+  expect_durations();
+  trajectory.addSuffixWayPoint(state, 2.0);
+  expect_durations();
+  EXPECT_DOUBLE_EQ(trajectory.getWayPointDurationFromStart(5), 6.5);
+
+  trajectory.insertWayPoint(2, state, 0.25);
+  trajectory.addSuffixWayPoint(state, 1.0);
+  expect_durations();
+  EXPECT_DOUBLE_EQ(trajectory.getWayPointDurationFromStart(7), 7.75);
+
+  trajectory.setWayPointDurationFromPrevious(3, 3.0);
+  trajectory.setWayPointDurationFromPrevious(1, 0.0);
+  expect_durations();
+  EXPECT_DOUBLE_EQ(trajectory.getWayPointDurationFromStart(7), 8.75);
+
+  // durations between waypoints are found on the right segment: waypoint 4 is reached at 4.75, waypoint 5 at 5.75
+  int before, after;
+  double blend;
+  trajectory.findWayPointIndicesForDurationAfterStart(5.0, before, after, blend);
+  EXPECT_EQ(before, 4);
+  EXPECT_EQ(after, 5);
+  EXPECT_DOUBLE_EQ(blend, 0.25);
+}
+
+TEST(TestTimeParameterization, TestSpeedScaling)
+{
+  trajectory_processing::TimeOptimalTrajectoryGeneration time_parameterization(0.1, 0.01);
+  EXPECT_EQ(initStraightTrajectory(TRAJECTORY), 0);
+  EXPECT_TRUE(time_parameterization.computeTimeStamps(TRAJECTORY));
+  robot_trajectory::CompactRobotTrajectory reference(TRAJECTORY);
+  const std::size_t count = reference.getWayPointCount();
+  const int index = TRAJECTORY.getGroup()->getVariableIndexList()[0];
+  const double duration = reference.getWayPointDurationFromStart(count);
+
+  trajectory_processing::TrajectorySpeedScaling scaling(reference);
+  EXPECT_NEAR(scaling.getDuration(), duration, 1e-9);
+
+  // slow down to half the speed in the middle of the trajectory: the suffix starts at the current position
+  const double time = 0.4 * duration;
+  robot_trajectory::CompactRobotTrajectory suffix(RMODEL, "right_arm");
+  ASSERT_TRUE(scaling.setSpeedFactor(time, 0.5, 0.2, suffix));
+  robot_state::RobotStatePtr expected(new robot_state::RobotState(RMODEL));
+  ASSERT_TRUE(TRAJECTORY.getStateAtDurationFromStart(time, expected));
+  EXPECT_NEAR(suffix.getVariablePosition(0, index), expected->getVariablePosition(index), 1e-9);
+  EXPECT_EQ(suffix.getWayPointDurationFromPrevious(0), 0.0);
+  EXPECT_DOUBLE_EQ(suffix.getVariablePosition(suffix.getWayPointCount() - 1, index),
+                   reference.getVariablePosition(count - 1, index));
+  EXPECT_NEAR(time + suffix.getWayPointDurationFromStart(suffix.getWayPointCount()), scaling.getDuration(), 1e-9);
+  EXPECT_GT(scaling.getDuration(), duration);
+
+  // after the ramp, the velocity is halved and the acceleration quartered
+  for (std::size_t i = 1; i < suffix.getWayPointCount(); ++i)
+  {
+    if (suffix.getWayPointDurationFromStart(i) < 0.2)
+      continue;
+    const std::size_t j = count - suffix.getWayPointCount() + i;
+    EXPECT_NEAR(suffix.getVariableVelocity(i, index), 0.5 * reference.getVariableVelocity(j, index), 1e-12);
+    EXPECT_NEAR(suffix.getVariableAcceleration(i, index), 0.25 * reference.getVariableAcceleration(j, index), 1e-12);
+  }
+
+  // changing the factor again during the ramp continues from a waypoint of the previous suffix
+  const std::size_t k = 3;
+  robot_trajectory::CompactRobotTrajectory next_suffix(RMODEL, "right_arm");
+  ASSERT_TRUE(scaling.setSpeedFactor(time + suffix.getWayPointDurationFromStart(k), 1.0, 0.2, next_suffix));
+  ASSERT_EQ(next_suffix.getWayPointCount(), suffix.getWayPointCount() - k);
+  EXPECT_NEAR(next_suffix.getVariablePosition(0, index), suffix.getVariablePosition(k, index), 1e-9);
+  EXPECT_NEAR(next_suffix.getVariableVelocity(0, index), suffix.getVariableVelocity(k, index), 1e-9);
+  EXPECT_NEAR(next_suffix.getVariableAcceleration(0, index), suffix.getVariableAcceleration(k, index), 1e-9);
+
+  // the speed factor can only change forward in time, and needs to be positive and at most the original speed
+  EXPECT_FALSE(scaling.setSpeedFactor(time, 1.0, 0.0, next_suffix));
+  EXPECT_FALSE(scaling.setSpeedFactor(duration, 0.0, 0.0, next_suffix));
+  EXPECT_FALSE(scaling.setSpeedFactor(duration, 1.5, 0.0, next_suffix));
+}
+
+TEST(TestTimeParameterization, TestJerkLimited)
+{
+  const int index = TRAJECTORY.getGroup()->getVariableIndexList()[0];
+  const std::string& name = RMODEL->getVariableNames()[index];
+  trajectory_processing::JerkLimitedTrajectoryGeneration time_parameterization(0.1, 0.01);
+  time_parameterization.setMaxJerk(name, 10.0);
+  trajectory_processing::TimeOptimalTrajectoryGeneration time_optimal(0.1, 0.01);
+
+  EXPECT_EQ(initStraightTrajectory(TRAJECTORY), 0);
+  EXPECT_TRUE(time_optimal.computeTimeStamps(TRAJECTORY, 0.25));
+  const double time_optimal_duration = TRAJECTORY.getWayPointDurationFromStart(TRAJECTORY.getWayPointCount() - 1);
+  EXPECT_EQ(initStraightTrajectory(TRAJECTORY), 0);
+  EXPECT_TRUE(time_parameterization.computeTimeStamps(TRAJECTORY, 0.25));
+  const std::size_t count = TRAJECTORY.getWayPointCount();
+  const double duration = TRAJECTORY.getWayPointDurationFromStart(count - 1);
+
+  // the limits are derived like in the time parameterization
+  const robot_model::VariableBounds& bounds = RMODEL->getVariableBounds(name);
+  const double max_velocity =
+      bounds.velocity_bounded_ ?
+          std::max(0.01, 0.25 * std::min(fabs(bounds.max_velocity_), fabs(bounds.min_velocity_))) :
+          1.0;
+  const double max_acceleration =
+      bounds.acceleration_bounded_ ?
+          std::max(0.01, std::min(fabs(bounds.max_acceleration_), fabs(bounds.min_acceleration_))) :
+          1.0;
+  const double max_jerk = 10.0;
+
+  // the trajectory moves between the first and last waypoint, starting and ending at rest
+  EXPECT_EQ(TRAJECTORY.getWayPoint(0).getVariablePosition(index), 0.0);
+  EXPECT_DOUBLE_EQ(TRAJECTORY.getWayPoint(count - 1).getVariablePosition(index), 2.0);
+  EXPECT_NEAR(TRAJECTORY.getWayPoint(0).getVariableVelocity(index), 0.0, 1e-9);
+  EXPECT_NEAR(TRAJECTORY.getWayPoint(0).getVariableAcceleration(index), 0.0, 1e-9);
+  EXPECT_NEAR(TRAJECTORY.getWayPoint(count - 1).getVariableVelocity(index), 0.0, 1e-9);
+  EXPECT_NEAR(TRAJECTORY.getWayPoint(count - 1).getVariableAcceleration(index), 0.0, 1e-9);
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const robot_state::RobotState& point = TRAJECTORY.getWayPoint(i);
+    EXPECT_LE(std::abs(point.getVariableVelocity(index)), max_velocity * 1.001);
+    EXPECT_LE(std::abs(point.getVariableAcceleration(index)), max_acceleration * 1.001);
+    if (i == 0)
+      continue;
+    const double jerk = (point.getVariableAcceleration(index) -
+                         TRAJECTORY.getWayPoint(i - 1).getVariableAcceleration(index)) /
+                        TRAJECTORY.getWayPointDurationFromPrevious(i);
+    EXPECT_LE(std::abs(jerk), max_jerk * 1.001);
+  }
+
+  // reaching the velocity limit on a straight line only adds the time to ramp up the acceleration
+  EXPECT_NEAR(duration, time_optimal_duration + max_acceleration / max_jerk, 0.02);
+}
+
+TEST(TestTimeParameterization, TestJerkLimitedCurved)
+{
+  const double path_tolerance = 0.02;
+  const double default_jerk_ratio = 10.0;
+  trajectory_processing::JerkLimitedTrajectoryGeneration time_parameterization(path_tolerance, 0.01,
+                                                                               default_jerk_ratio);
+  const robot_model::JointModelGroup* group = TRAJECTORY.getGroup();
+  const std::vector<int>& idx = group->getVariableIndexList();
+  const std::size_t num_joints = idx.size();
+
+  // waypoints with sharp corners, moving all joints of the group
+  std::vector<Eigen::VectorXd> waypoints;
+  for (int i = 0; i < 8; ++i)
+  {
+    Eigen::VectorXd waypoint(num_joints);
+    for (std::size_t j = 0; j < num_joints; ++j)
+      waypoint[j] = -0.3 + 0.2 * std::sin(0.8 * i * (j + 1) + j);
+    waypoints.push_back(waypoint);
+  }
+  moveit::core::RobotState state(RMODEL);
+  state.setToDefaultValues();
+  TRAJECTORY.clear();
+  for (const Eigen::VectorXd& waypoint : waypoints)
+  {
+    for (std::size_t j = 0; j < num_joints; ++j)
+      state.setVariablePosition(idx[j], waypoint[j]);
+    TRAJECTORY.addSuffixWayPoint(state, 0.0);
+  }
+  ASSERT_TRUE(time_parameterization.computeTimeStamps(TRAJECTORY, 0.5, 0.5));
+  const std::size_t count = TRAJECTORY.getWayPointCount();
+  ASSERT_GT(count, waypoints.size());
+
+  // the limits are derived like in the time parameterization
+  std::vector<double> max_velocity(num_joints), max_acceleration(num_joints);
+  for (std::size_t j = 0; j < num_joints; ++j)
+  {
+    const robot_model::VariableBounds& bounds = RMODEL->getVariableBounds(RMODEL->getVariableNames()[idx[j]]);
+    max_velocity[j] = bounds.velocity_bounded_ ?
+                          std::max(0.01, 0.5 * std::min(fabs(bounds.max_velocity_), fabs(bounds.min_velocity_))) :
+                          1.0;
+    max_acceleration[j] =
+        bounds.acceleration_bounded_ ?
+            std::max(0.01, 0.5 * std::min(fabs(bounds.max_acceleration_), fabs(bounds.min_acceleration_))) :
+            1.0;
+  }
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const robot_state::RobotState& point = TRAJECTORY.getWayPoint(i);
+    Eigen::VectorXd position(num_joints);
+    for (std::size_t j = 0; j < num_joints; ++j)
+    {
+      position[j] = point.getVariablePosition(idx[j]);
+      EXPECT_LE(std::abs(point.getVariableVelocity(idx[j])), max_velocity[j] * 1.001);
+      EXPECT_LE(std::abs(point.getVariableAcceleration(idx[j])), max_acceleration[j] * 1.001);
+      if (i == 0)
+        continue;
+      const double jerk = (point.getVariableAcceleration(idx[j]) -
+                           TRAJECTORY.getWayPoint(i - 1).getVariableAcceleration(idx[j])) /
+                          TRAJECTORY.getWayPointDurationFromPrevious(i);
+      EXPECT_LE(std::abs(jerk), max_acceleration[j] * default_jerk_ratio * 1.001);
+    }
+
+    // the path stays within the tolerance of the straight lines between the waypoints
+    double deviation = std::numeric_limits<double>::infinity();
+    for (std::size_t k = 0; k + 1 < waypoints.size(); ++k)
+    {
+      const Eigen::VectorXd line = waypoints[k + 1] - waypoints[k];
+      const double t = std::min(1.0, std::max(0.0, (position - waypoints[k]).dot(line) / line.squaredNorm()));
+      deviation = std::min(deviation, (position - waypoints[k] - t * line).norm());
+    }
+    EXPECT_LE(deviation, path_tolerance * 1.001);
+  }
+
+  // the trajectory ends at the last waypoint, at rest
+  for (std::size_t j = 0; j < num_joints; ++j)
+  {
+    EXPECT_NEAR(TRAJECTORY.getWayPoint(count - 1).getVariablePosition(idx[j]), waypoints.back()[j], 1e-9);
+    EXPECT_NEAR(TRAJECTORY.getWayPoint(count - 1).getVariableVelocity(idx[j]), 0.0, 1e-9);
+  }
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,168 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/robot_model/robot_model.h>
+#include <moveit/robot_state/robot_state.h>
+#include <moveit/robot_trajectory/compact_robot_trajectory.h>
+#include <moveit/robot_trajectory/robot_trajectory.h>
+#include <moveit/trajectory_processing/time_optimal_trajectory_generation.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <chrono>
+#include <cmath>
+#include <gtest/gtest.h>
+
+using trajectory_processing::Path;
+using trajectory_processing::TimeOptimalTrajectoryGeneration;
+using trajectory_processing::Trajectory;
+
+// Helper class to measure time within a scoped block and output the result
+class ScopedTimer
+{
+  const char* const msg_;
+  double* const gold_standard_;
+  const std::chrono::time_point<std::chrono::steady_clock> start_;
+
+public:
+  // if gold_standard is provided, a relative increase/decrease is shown too
+  ScopedTimer(const char* msg = "", double* gold_standard = nullptr)
+    : msg_(msg), gold_standard_(gold_standard), start_(std::chrono::steady_clock::now())
+  {
+  }
+
+  ~ScopedTimer()
+  {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+    std::cerr << msg_ << elapsed.count() * 1000. << "ms ";
+
+    if (gold_standard_)
+    {
+      if (*gold_standard_ == 0)
+        *gold_standard_ = elapsed.count();
+      std::cerr << 100 * elapsed.count() / *gold_standard_ << "%";
+    }
+    std::cerr << std::endl;
+  }
+};
+
+static const std::size_t WAYPOINT_COUNT = 10000;
+
+// A smooth, but not straight path, with a waypoint every few millimeters
+static Eigen::MatrixXd makeWaypoints(std::size_t dof)
+{
+  Eigen::MatrixXd waypoints(dof, WAYPOINT_COUNT);
+  for (std::size_t i = 0; i < WAYPOINT_COUNT; ++i)
+    for (std::size_t j = 0; j < dof; ++j)
+      waypoints(j, i) = 0.5 * std::sin(0.0005 * i * (j + 1)) + 0.001 * i;
+  return waypoints;
+}
+
+TEST(Timing, pathParameterization)
+{
+  const Eigen::MatrixXd waypoints = makeWaypoints(7);
+  const Eigen::VectorXd max_velocity = Eigen::VectorXd::Constant(7, 1.0);
+  const Eigen::VectorXd max_acceleration = Eigen::VectorXd::Constant(7, 2.0);
+
+  for (double max_deviation : { 0.0, 0.1 })
+  {
+    std::cerr << "10k waypoints, max deviation " << max_deviation << std::endl;
+    std::unique_ptr<Trajectory> trajectory;
+    {
+      ScopedTimer t("Trajectory generation: ");
+      trajectory.reset(new Trajectory(Path(waypoints, max_deviation), max_velocity, max_acceleration));
+    }
+    ASSERT_TRUE(trajectory->isValid());
+
+    const double dt = 0.001;
+    const std::size_t sample_count = std::ceil(trajectory->getDuration() / dt);
+    Eigen::VectorXd position, velocity, acceleration;
+    double gold_standard = 0;
+    {
+      ScopedTimer t("Resampling with getPosition/getVelocity/getAcceleration: ", &gold_standard);
+      for (std::size_t i = 0; i <= sample_count; ++i)
+      {
+        const double time = std::min(trajectory->getDuration(), i * dt);
+        position = trajectory->getPosition(time);
+        velocity = trajectory->getVelocity(time);
+        acceleration = trajectory->getAcceleration(time);
+      }
+    }
+    {
+      ScopedTimer t("Resampling with sample(): ", &gold_standard);
+      for (std::size_t i = 0; i <= sample_count; ++i)
+        trajectory->sample(std::min(trajectory->getDuration(), i * dt), position, velocity, acceleration);
+    }
+    EXPECT_TRUE(position.isApprox(waypoints.col(WAYPOINT_COUNT - 1)));
+  }
+}
+
+TEST(Timing, computeTimeStamps)
+{
+  robot_model::RobotModelPtr model = moveit::core::loadTestingRobotModel("pr2");
+  ASSERT_TRUE(bool(model));
+  const robot_model::JointModelGroup* group = model->getJointModelGroup("right_arm");
+  ASSERT_TRUE(group);
+
+  // stay within the joint limits of the arm
+  const Eigen::MatrixXd waypoints = 0.2 * makeWaypoints(group->getVariableCount());
+  robot_trajectory::RobotTrajectory trajectory(model, group);
+  robot_state::RobotState state(model);
+  state.setToDefaultValues();
+  std::vector<double> positions(group->getVariableCount());
+  for (std::size_t i = 0; i < WAYPOINT_COUNT; ++i)
+  {
+    Eigen::VectorXd::Map(positions.data(), positions.size()) = waypoints.col(i);
+    state.setJointGroupPositions(group, positions);
+    trajectory.addSuffixWayPoint(state, 0.0);
+  }
+  const robot_trajectory::CompactRobotTrajectory compact(trajectory);
+
+  TimeOptimalTrajectoryGeneration totg;
+  double gold_standard = 0;
+  {
+    robot_trajectory::RobotTrajectory copy(trajectory);
+    ScopedTimer t("computeTimeStamps() on a RobotTrajectory with 10k waypoints: ", &gold_standard);
+    EXPECT_TRUE(totg.computeTimeStamps(copy));
+  }
+  {
+    robot_trajectory::CompactRobotTrajectory copy(compact);
+    ScopedTimer t("computeTimeStamps() on a CompactRobotTrajectory with 10k waypoints: ", &gold_standard);
+    EXPECT_TRUE(totg.computeTimeStamps(copy));
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -43,6 +43,8 @@
 #include <boost/noncopyable.hpp>
 #include <moveit/macros/class_forward.h>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace moveit
 {
@@ -56,6 +58,9 @@ typedef std::map<std::string, Eigen::Isometry3d, std::less<std::string>,
                  Eigen::aligned_allocator<std::pair<const std::string, Eigen::Isometry3d> > >
     FixedTransformsMap;
 
+/// @brief Handle of a frame interned by a Transforms object, see Transforms::getFrameId()
+typedef int FrameId;
+
 /** @brief Provides an implementation of a snapshot of a transform tree that can be easily queried for
     transforming different quantities. Transforms are maintained as a list of transforms to a particular frame.
     All stored transforms are considered fixed. */
@@ -195,9 +200,54 @@ public:
    */
   virtual const Eigen::Isometry3d& getTransform(const std::string& from_frame) const;
 
+  /**
+   * \name Looking up transforms by frame handle
+   * Each frame with a transform maintained by this object is interned once. Its handle can be resolved by name
+   * and then used for repeated lookups without searching for the name. A handle remains valid for the lifetime of
+   * this object, also when the transform of its frame changes. Only fixed transforms maintained by this class are
+   * covered, not frames additionally known by derived classes.
+   */
+  /**@{*/
+
+  /**
+   * @brief Get the handle of a frame with a fixed transform
+   * @return The handle of the frame, or -1 if no transform is known for the frame
+   */
+  FrameId getFrameId(const std::string& frame) const;
+
+  /**
+   * @brief Get the name of the frame with handle \e frame_id. The name is empty for invalid handles.
+   */
+  const std::string& getFrameName(FrameId frame_id) const;
+
+  /**
+   * @brief Check whether a transform is known for the frame with handle \e frame_id
+   */
+  bool canTransform(FrameId frame_id) const
+  {
+    return frame_id >= 0 && static_cast<std::size_t>(frame_id) < frame_known_.size() && frame_known_[frame_id];
+  }
+
+  /**
+   * @brief Get transform for the frame with handle \e frame_id (w.r.t target frame)
+   * @return The required transform, or identity if the handle is invalid
+   */
+  const Eigen::Isometry3d& getTransform(FrameId frame_id) const;
+  /**@}*/
+
 protected:
   std::string target_frame_;
   FixedTransformsMap transforms_map_;
+
+private:
+  /** @brief Store the transform of \e frame in the flat storage, interning the frame if necessary */
+  void setFrameTransform(const std::string& frame, const Eigen::Isometry3d& t);
+
+  /* Flat storage of the transforms in transforms_map_, indexed by FrameId */
+  std::unordered_map<std::string, FrameId> frame_ids_;
+  std::vector<std::string> frame_names_;
+  std::vector<Eigen::Isometry3d, Eigen::aligned_allocator<Eigen::Isometry3d> > frame_transforms_;
+  std::vector<unsigned char> frame_known_;
 };
 }
 }
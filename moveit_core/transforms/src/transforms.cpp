@@ -37,6 +37,7 @@
 #include <moveit/transforms/transforms.h>
 #include <tf2_eigen/tf2_eigen.h>
 #include <boost/algorithm/string/trim.hpp>
+#include <algorithm>
 #include "rclcpp/rclcpp.hpp"
 
 namespace moveit
@@ -56,6 +57,7 @@ Transforms::Transforms(const std::string& target_frame) : target_frame_(target_f
   else
   {
     transforms_map_[target_frame_] = Eigen::Isometry3d::Identity();
+    setFrameTransform(target_frame_, Eigen::Isometry3d::Identity());
   }
 }
 
@@ -81,23 +83,24 @@ const FixedTransformsMap& Transforms::getAllTransforms() const
 void Transforms::setAllTransforms(const FixedTransformsMap& transforms)
 {
   transforms_map_ = transforms;
+  // keep the handles of all interned frames, but forget their transforms
+  std::fill(frame_known_.begin(), frame_known_.end(), 0);
+  for (const std::pair<const std::string, Eigen::Isometry3d>& transform : transforms_map_)
+    setFrameTransform(transform.first, transform.second);
 }
 
 bool Transforms::isFixedFrame(const std::string& frame) const
 {
-  if (frame.empty())
-    return false;
-  else
-    return transforms_map_.find(frame) != transforms_map_.end();
+  return canTransform(getFrameId(frame));
 }
 
 const Eigen::Isometry3d& Transforms::getTransform(const std::string& from_frame) const
 {
   if (!from_frame.empty())
   {
-    FixedTransformsMap::const_iterator it = transforms_map_.find(from_frame);
-    if (it != transforms_map_.end())
-      return it->second;
+    FrameId frame_id = getFrameId(from_frame);
+    if (canTransform(frame_id))
+      return frame_transforms_[frame_id];
     // If no transform found in map, return identity
   }
 
@@ -111,10 +114,50 @@ const Eigen::Isometry3d& Transforms::getTransform(const std::string& from_frame)
 
 bool Transforms::canTransform(const std::string& from_frame) const
 {
-  if (from_frame.empty())
-    return false;
+  return canTransform(getFrameId(from_frame));
+}
+
+FrameId Transforms::getFrameId(const std::string& frame) const
+{
+  std::unordered_map<std::string, FrameId>::const_iterator it = frame_ids_.find(frame);
+  return it == frame_ids_.end() || !frame_known_[it->second] ? -1 : it->second;
+}
+
+const std::string& Transforms::getFrameName(FrameId frame_id) const
+{
+  static const std::string EMPTY;
+  if (frame_id < 0 || static_cast<std::size_t>(frame_id) >= frame_names_.size())
+    return EMPTY;
+  return frame_names_[frame_id];
+}
+
+const Eigen::Isometry3d& Transforms::getTransform(FrameId frame_id) const
+{
+  if (canTransform(frame_id))
+    return frame_transforms_[frame_id];
+
+  RCLCPP_ERROR(logger_transforms, "Unable to transform from frame with invalid handle %d to frame '%s'. "
+                                  "Returning identity.",
+               frame_id, target_frame_.c_str());
+  static const Eigen::Isometry3d IDENTITY = Eigen::Isometry3d::Identity();
+  return IDENTITY;
+}
+
+void Transforms::setFrameTransform(const std::string& frame, const Eigen::Isometry3d& t)
+{
+  std::pair<std::unordered_map<std::string, FrameId>::iterator, bool> it =
+      frame_ids_.insert(std::make_pair(frame, static_cast<FrameId>(frame_names_.size())));
+  if (it.second)
+  {
+    frame_names_.push_back(frame);
+    frame_transforms_.push_back(t);
+    frame_known_.push_back(1);
+  }
   else
-    return transforms_map_.find(from_frame) != transforms_map_.end();
+  {
+    frame_transforms_[it.first->second] = t;
+    frame_known_[it.first->second] = 1;
+  }
 }
 
 void Transforms::setTransform(const Eigen::Isometry3d& t, const std::string& from_frame)
@@ -123,7 +166,10 @@ void Transforms::setTransform(const Eigen::Isometry3d& t, const std::string& fro
     RCLCPP_ERROR(logger_transforms, "Cannot record transform with empty name");
   }
   else
+  {
     transforms_map_[from_frame] = t;
+    setFrameTransform(from_frame, t);
+  }
 }
 
 void Transforms::setTransform(const geometry_msgs::msg::TransformStamped& transform)
@@ -61,6 +61,42 @@ TEST(Transforms, Simple)
   EXPECT_TRUE(tf.isFixedFrame("global"));
 }
 
+TEST(Transforms, FrameIds)
+{
+  moveit::core::Transforms tf("global");
+  EXPECT_EQ(tf.getFrameId("global"), tf.getFrameId("global"));
+  EXPECT_TRUE(tf.canTransform(tf.getFrameId("global")));
+  EXPECT_EQ(-1, tf.getFrameId("some_frame"));
+  EXPECT_FALSE(tf.canTransform(tf.getFrameId("some_frame")));
+  EXPECT_FALSE(tf.canTransform(-1));
+  EXPECT_FALSE(tf.canTransform(42));
+
+  Eigen::Isometry3d t1(Eigen::Translation3d(10.0, 1.0, 0.0));
+  tf.setTransform(t1, "some_frame");
+  moveit::core::FrameId id = tf.getFrameId("some_frame");
+  ASSERT_TRUE(tf.canTransform(id));
+  EXPECT_EQ("some_frame", tf.getFrameName(id));
+  EXPECT_TRUE(tf.getTransform(id).isApprox(t1));
+
+  // handles stay valid when the transform changes
+  Eigen::Isometry3d t2(Eigen::Translation3d(0.0, 1.0, -1.0) * Eigen::AngleAxisd(0.5, Eigen::Vector3d::UnitY()));
+  tf.setTransform(t2, "some_frame");
+  EXPECT_EQ(id, tf.getFrameId("some_frame"));
+  EXPECT_TRUE(tf.getTransform(id).isApprox(t2));
+  EXPECT_TRUE(tf.getTransform("some_frame").isApprox(t2));
+
+  // and when all transforms are replaced
+  moveit::core::FixedTransformsMap transforms = tf.getAllTransforms();
+  transforms.erase("some_frame");
+  tf.setAllTransforms(transforms);
+  EXPECT_FALSE(tf.canTransform(id));
+  EXPECT_FALSE(tf.isFixedFrame("some_frame"));
+  transforms["some_frame"] = t1;
+  tf.setAllTransforms(transforms);
+  EXPECT_EQ(id, tf.getFrameId("some_frame"));
+  EXPECT_TRUE(tf.getTransform(id).isApprox(t1));
+}
+
 int main(int argc, char** argv)
 {
   testing::InitGoogleTest(&argc, argv);
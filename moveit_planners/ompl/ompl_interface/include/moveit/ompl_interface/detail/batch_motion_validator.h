@@ -0,0 +1,69 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_OMPL_INTERFACE_DETAIL_BATCH_MOTION_VALIDATOR_
+#define MOVEIT_OMPL_INTERFACE_DETAIL_BATCH_MOTION_VALIDATOR_
+
+#include <ompl/base/MotionValidator.h>
+#include <memory>
+
+namespace ompl_interface
+{
+class StateValidityChecker;
+
+/** @class BatchMotionValidator
+    @brief Checks the states along a motion at the resolution of the state space, like OMPL's DiscreteMotionValidator,
+    but with a single StateValidityChecker::isValid() call that checks the collisions of all of them as one batch */
+class BatchMotionValidator : public ompl::base::MotionValidator
+{
+public:
+  BatchMotionValidator(const ompl::base::SpaceInformationPtr& si,
+                       const std::shared_ptr<const StateValidityChecker>& state_validity_checker,
+                       unsigned int num_threads);
+
+  bool checkMotion(const ompl::base::State* s1, const ompl::base::State* s2) const override;
+  bool checkMotion(const ompl::base::State* s1, const ompl::base::State* s2,
+                   std::pair<ompl::base::State*, double>& last_valid) const override;
+
+private:
+  /* Index of the first invalid state in states, which starts with s1 and ends with s2, or states.size() */
+  std::size_t findFirstInvalid(const ompl::base::State* s1, const ompl::base::State* s2,
+                               std::vector<ompl::base::State*>& states) const;
+
+  std::shared_ptr<const StateValidityChecker> state_validity_checker_;
+  unsigned int num_threads_;
+};
+}
+
+#endif
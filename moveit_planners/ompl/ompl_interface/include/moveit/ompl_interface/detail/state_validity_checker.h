@@ -65,6 +65,13 @@ public:
   bool isValid(const ompl::base::State* state, bool verbose) const;
   bool isValid(const ompl::base::State* state, double& dist, bool verbose) const;
 
+  /** \brief Check a sequence of states, e.g. the states along a motion, stopping at the first invalid one.
+      The collision checks of all states are done in one PlanningScene::checkCollisionBatch() call, which distributes
+      them across \e num_threads threads. If \e first_invalid is given, it is set to the index of the first invalid
+      state, or states.size(). */
+  bool isValid(const std::vector<const ompl::base::State*>& states, unsigned int num_threads,
+               std::size_t* first_invalid = nullptr) const;
+
   virtual double cost(const ompl::base::State* state) const;
   double clearance(const ompl::base::State* state) const override;
 
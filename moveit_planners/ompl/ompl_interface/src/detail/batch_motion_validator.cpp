@@ -0,0 +1,93 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/ompl_interface/detail/batch_motion_validator.h>
+#include <moveit/ompl_interface/detail/state_validity_checker.h>
+#include <ompl/base/SpaceInformation.h>
+
+ompl_interface::BatchMotionValidator::BatchMotionValidator(
+    const ompl::base::SpaceInformationPtr& si,
+    const std::shared_ptr<const StateValidityChecker>& state_validity_checker, unsigned int num_threads)
+  : ompl::base::MotionValidator(si), state_validity_checker_(state_validity_checker), num_threads_(num_threads)
+{
+}
+
+std::size_t ompl_interface::BatchMotionValidator::findFirstInvalid(const ompl::base::State* s1,
+                                                                   const ompl::base::State* s2,
+                                                                   std::vector<ompl::base::State*>& states) const
+{
+  // like DiscreteMotionValidator, the start state is assumed to be valid
+  const unsigned int segment_count = si_->getStateSpace()->validSegmentCount(s1, s2);
+  si_->getMotionStates(s1, s2, states, segment_count - 1, true, true);
+  std::vector<const ompl::base::State*> checked(states.begin() + 1, states.end());
+  std::size_t first_invalid;
+  if (state_validity_checker_->isValid(checked, num_threads_, &first_invalid))
+    return states.size();
+  return first_invalid + 1;
+}
+
+bool ompl_interface::BatchMotionValidator::checkMotion(const ompl::base::State* s1,
+                                                       const ompl::base::State* s2) const
+{
+  std::vector<ompl::base::State*> states;
+  const bool valid = findFirstInvalid(s1, s2, states) == states.size();
+  si_->freeStates(states);
+
+  if (valid)
+    valid_++;
+  else
+    invalid_++;
+  return valid;
+}
+
+bool ompl_interface::BatchMotionValidator::checkMotion(const ompl::base::State* s1, const ompl::base::State* s2,
+                                                       std::pair<ompl::base::State*, double>& last_valid) const
+{
+  std::vector<ompl::base::State*> states;
+  const std::size_t first_invalid = findFirstInvalid(s1, s2, states);
+  const bool valid = first_invalid == states.size();
+  if (!valid)
+  {
+    if (last_valid.first)
+      si_->copyState(last_valid.first, states[first_invalid - 1]);
+    last_valid.second = static_cast<double>(first_invalid - 1) / (states.size() - 1);
+  }
+  si_->freeStates(states);
+
+  if (valid)
+    valid_++;
+  else
+    invalid_++;
+  return valid;
+}
@@ -84,6 +84,77 @@ bool ompl_interface::StateValidityChecker::isValid(const ompl::base::State* stat
                                                       isValidWithoutCache(state, dist, verbose);
 }
 
+bool ompl_interface::StateValidityChecker::isValid(const std::vector<const ompl::base::State*>& states,
+                                                   unsigned int num_threads, std::size_t* first_invalid) const
+{
+  const bool use_cache = planning_context_->useStateValidityCache();
+  const kinematic_constraints::KinematicConstraintSetPtr& kset = planning_context_->getPathConstraints();
+  const robot_state::RobotState* start_state = tss_.getStateStorage();
+
+  std::size_t invalid = states.size();
+  std::vector<robot_state::RobotStatePtr> robot_states;
+  std::vector<const robot_state::RobotState*> batch;
+  std::vector<std::size_t> batch_index;
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    const ompl::base::State* state = states[i];
+    if (use_cache && state->as<ModelBasedStateSpace::StateType>()->isValidityKnown())
+    {
+      if (state->as<ModelBasedStateSpace::StateType>()->isMarkedValid())
+        continue;
+      invalid = i;
+      break;
+    }
+
+    // check bounds, path constraints and feasibility first; these do not need the collision batch
+    bool valid = si_->satisfiesBounds(state);
+    if (!valid && verbose_)
+      RCLCPP_INFO(LOGGER_STATE_VALIDITY_CHECKER, "State outside bounds");
+    if (valid)
+    {
+      robot_states.push_back(std::make_shared<robot_state::RobotState>(*start_state));
+      planning_context_->getOMPLStateSpace()->copyToRobotState(*robot_states.back(), state);
+      valid = (!kset || kset->decide(*robot_states.back(), verbose_).satisfied) &&
+              planning_context_->getPlanningScene()->isStateFeasible(*robot_states.back(), verbose_);
+    }
+    if (!valid)
+    {
+      if (use_cache)
+        const_cast<ob::State*>(state)->as<ModelBasedStateSpace::StateType>()->markInvalid();
+      invalid = i;
+      break;
+    }
+    batch.push_back(robot_states.back().get());
+    batch_index.push_back(i);
+  }
+
+  // check collision avoidance for the states before the first otherwise invalid one
+  collision_detection::CollisionBatchRequest req(verbose_ ? collision_request_simple_verbose_ :
+                                                            collision_request_simple_);
+  req.stop_at_first_collision = true;
+  req.num_threads = num_threads;
+  std::vector<collision_detection::CollisionResult> results;
+  planning_context_->getPlanningScene()->checkCollisionBatch(req, batch, results);
+  // the results end with the first colliding state
+  for (std::size_t k = 0; k < results.size(); ++k)
+  {
+    ob::State* state = const_cast<ob::State*>(states[batch_index[k]]);
+    if (results[k].collision)
+    {
+      if (use_cache)
+        state->as<ModelBasedStateSpace::StateType>()->markInvalid();
+      invalid = batch_index[k];
+      break;
+    }
+    if (use_cache)
+      state->as<ModelBasedStateSpace::StateType>()->markValid();
+  }
+
+  if (first_invalid)
+    *first_invalid = invalid;
+  return invalid == states.size();
+}
+
 double ompl_interface::StateValidityChecker::cost(const ompl::base::State* state) const
 {
   double cost = 0.0;
@@ -37,6 +37,7 @@
 #include <boost/algorithm/string/trim.hpp>
 
 #include <moveit/ompl_interface/model_based_planning_context.h>
+#include <moveit/ompl_interface/detail/batch_motion_validator.h>
 #include <moveit/ompl_interface/detail/state_validity_checker.h>
 #include <moveit/ompl_interface/detail/constrained_sampler.h>
 #include <moveit/ompl_interface/detail/constrained_goal_sampler.h>
@@ -276,6 +277,18 @@ void ompl_interface::ModelBasedPlanningContext::useConfig()
     cfg.erase(it);
   }
 
+  // check the states along motions as collision batches, distributed across this number of threads
+  it = cfg.find("motion_validation_threads");
+  if (it != cfg.end())
+  {
+    const int num_threads = static_cast<int>(moveit::core::toDouble(it->second));
+    const ob::SpaceInformationPtr& si = ompl_simple_setup_->getSpaceInformation();
+    si->setMotionValidator(std::make_shared<BatchMotionValidator>(
+        si, std::static_pointer_cast<const StateValidityChecker>(si->getStateValidityChecker()),
+        std::max(num_threads, 1)));
+    cfg.erase(it);
+  }
+
   if (cfg.empty())
     return;
 
@@ -40,6 +40,7 @@
 
 #include <moveit_simple_controller_manager/action_based_controller_handle.h>
 #include <control_msgs/action/follow_joint_trajectory.hpp>
+#include <mutex>
 
 static rclcpp::Logger LOGGER_MOVEIT_SIMPLE_CONTROLLER_MANAGER = rclcpp::get_logger("moveit").get_child("SimpleControllerManager");
 
@@ -54,7 +55,7 @@ class FollowJointTrajectoryControllerHandle
 {
 public:
   FollowJointTrajectoryControllerHandle(const std::string& name, std::shared_ptr<rclcpp::Node>& node)
-    : ActionBasedControllerHandle<control_msgs::action::FollowJointTrajectory>(name, node)
+    : ActionBasedControllerHandle<control_msgs::action::FollowJointTrajectory>(name, node), has_current_goal_(false)
   {
     printf("FollowJointTrajectoryControllerHandle::FollowJointTrajectoryControllerHandle \n");
   }
@@ -79,6 +80,12 @@ protected:
       const std::shared_ptr<const control_msgs::action::FollowJointTrajectory::Feedback> feedback);
 
   control_msgs::action::FollowJointTrajectory::Goal goal_template_;
+
+  /* the goal whose result ends the execution. A goal sent while another one is executed replaces it, and the result
+   * of the replaced goal is ignored. The action client callbacks run in another thread, hence the mutex. */
+  std::mutex current_goal_mutex_;
+  rclcpp_action::GoalUUID current_goal_id_;
+  bool has_current_goal_;
 };
 
 }  // end namespace moveit_simple_controller_manager
@@ -63,6 +63,14 @@ bool FollowJointTrajectoryControllerHandle::sendTrajectory(const moveit_msgs::ms
   bool is_result_ready = false;
   rclcpp_action::ResultCode code_error;
 
+  {
+    // results arriving until the new goal is accepted belong to the goal it replaces
+    std::lock_guard<std::mutex> lock(current_goal_mutex_);
+    has_current_goal_ = false;
+    done_ = false;
+    last_exec_ = moveit_controller_manager::ExecutionStatus::RUNNING;
+  }
+
   using namespace std::placeholders;
 
   auto send_goal_options = rclcpp_action::Client<control_msgs::action::FollowJointTrajectory>::SendGoalOptions();
@@ -81,11 +89,12 @@ bool FollowJointTrajectoryControllerHandle::sendTrajectory(const moveit_msgs::ms
   if(!goal_handle)
   {
     RCLCPP_INFO(node_->get_logger(), "plan: Goal was rejected by server");
+    std::lock_guard<std::mutex> lock(current_goal_mutex_);
+    done_ = true;
+    last_exec_ = moveit_controller_manager::ExecutionStatus::FAILED;
     return false;
   }
 
-  done_ = false;
-  last_exec_ = moveit_controller_manager::ExecutionStatus::RUNNING;
   return true;
 }
 //TODO (anasarrak)
@@ -224,6 +233,13 @@ control_msgs::msg::JointTolerance& FollowJointTrajectoryControllerHandle::getTol
 
 void FollowJointTrajectoryControllerHandle::controllerDoneCallback(const rclcpp_action::ClientGoalHandle<control_msgs::action::FollowJointTrajectory>::WrappedResult& result)
 {
+  std::lock_guard<std::mutex> lock(current_goal_mutex_);
+  if (!has_current_goal_ || result.goal_id != current_goal_id_)
+  {
+    RCLCPP_DEBUG(LOGGER_MOVEIT_SIMPLE_CONTROLLER_MANAGER, "Ignoring the result of a replaced goal of %s", name_.c_str());
+    return;
+  }
+
   // Output custom error message for FollowJointTrajectoryResult if necessary
   if (result.result->error_code == control_msgs::action::FollowJointTrajectory::Result::SUCCESSFUL)
     RCLCPP_INFO(LOGGER_MOVEIT_SIMPLE_CONTROLLER_MANAGER, "Controller %s successfully finished", name_.c_str());
@@ -242,6 +258,10 @@ void FollowJointTrajectoryControllerHandle::controllerActiveCallback(std::shared
     RCLCPP_ERROR(LOGGER_MOVEIT_SIMPLE_CONTROLLER_MANAGER, "Goal was rejected by server");
   } else {
     RCLCPP_INFO(LOGGER_MOVEIT_SIMPLE_CONTROLLER_MANAGER, "Goal accepted by server, waiting for result");
+    // the client asks for the result only after this callback, so the result of this goal cannot arrive earlier
+    std::lock_guard<std::mutex> lock(current_goal_mutex_);
+    current_goal_id_ = goal_handle->get_goal_id();
+    has_current_goal_ = true;
   }
 
   RCLCPP_DEBUG(LOGGER_MOVEIT_SIMPLE_CONTROLLER_MANAGER, "%s started execution", name_.c_str());
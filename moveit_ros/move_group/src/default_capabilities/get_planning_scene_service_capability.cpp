@@ -57,6 +57,8 @@ void move_group::MoveGroupGetPlanningSceneService::getPlanningSceneService(const
     context_->planning_scene_monitor_->updateFrameTransforms();
   planning_scene_monitor::LockedPlanningSceneRO ps(context_->planning_scene_monitor_);
   ps->getPlanningSceneMsg(response->scene, request->components);
+  // tell the requester which of the published scene diffs the response already contains
+  context_->planning_scene_monitor_->publishPlanningSceneStamp(response->scene);
   return;
 }
 
@@ -0,0 +1,85 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_request_adapter/planning_request_adapter.h>
+#include <moveit/trajectory_processing/jerk_limited_trajectory_generation.h>
+#include <class_loader/class_loader.hpp>
+
+namespace default_planner_request_adapters
+{
+using namespace trajectory_processing;
+
+/** @brief This adapter uses the jerk-limited trajectory generation method. The robot model has no jerk limits, so the
+    jerk of each joint is limited to a multiple of its acceleration limit. */
+class AddJerkLimitedParameterization : public planning_request_adapter::PlanningRequestAdapter
+{
+  rclcpp::Logger LOGGER_ADD_JERK_LIMITED_PARAMETERIZATION =
+      rclcpp::get_logger("moveit_planning_request_adapter_plugins").get_child("add_jerk_limited_parameterization");
+
+public:
+  AddJerkLimitedParameterization() : planning_request_adapter::PlanningRequestAdapter()
+  {
+  }
+  void initialize()
+  {
+  }
+  std::string getDescription() const override
+  {
+    return "Add Jerk Limited Parameterization";
+  }
+
+  bool adaptAndPlan(const PlannerFn& planner, const planning_scene::PlanningSceneConstPtr& planning_scene,
+                    const planning_interface::MotionPlanRequest& req, planning_interface::MotionPlanResponse& res,
+                    std::vector<std::size_t>& added_path_index) const override
+  {
+    bool result = planner(planning_scene, req, res);
+    if (result && res.trajectory_)
+    {
+      RCLCPP_DEBUG(LOGGER_ADD_JERK_LIMITED_PARAMETERIZATION, " Running '%s'", getDescription().c_str());
+      JerkLimitedTrajectoryGeneration jltg;
+      if (!jltg.computeTimeStamps(*res.trajectory_, req.max_velocity_scaling_factor,
+                                  req.max_acceleration_scaling_factor))
+      {
+        RCLCPP_WARN(LOGGER_ADD_JERK_LIMITED_PARAMETERIZATION, " Time parametrization for the solution path failed.");
+      }
+    }
+
+    return result;
+  }
+};
+
+}  // namespace default_planner_request_adapters
+
+CLASS_LOADER_REGISTER_CLASS(default_planner_request_adapters::AddJerkLimitedParameterization,
+                            planning_request_adapter::PlanningRequestAdapter);
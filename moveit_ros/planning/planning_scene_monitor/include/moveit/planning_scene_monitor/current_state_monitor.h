@@ -39,8 +39,10 @@
 
 #include <tf2_ros/buffer.h>
 #include <moveit/robot_state/robot_state.h>
+#include <moveit/planning_scene_monitor/joint_state_history.h>
 #include <sensor_msgs/msg/joint_state.hpp>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <boost/thread/condition_variable.hpp>
 #include <boost/signals2.hpp>
@@ -136,6 +138,24 @@ public:
    *  @return Returns a pair of the current state and its time stamp */
   std::pair<robot_state::RobotStatePtr, rclcpp::Time> getCurrentStateAndTime() const;
 
+  /** @brief Set the joint positions of \e upd to the ones of the robot at time \e t, interpolated between the joint
+   *  states received before and after \e t. Other values of \e upd are not modified.
+   *  @return false if \e t is not within the time span of the joint state history (see getJointStateHistory()) */
+  bool setToStateAtTime(robot_state::RobotState& upd, const rclcpp::Time& t) const;
+
+  /** @brief Get the history of the recently received joint states. Each entry holds the complete state of the robot
+   *  after a joint state message was applied, stamped with the time of that message. Messages stamped before the
+   *  newest entry are not recorded. The history can be queried concurrently to incoming updates without locking. */
+  JointStateHistoryConstPtr getJointStateHistory() const
+  {
+    return std::atomic_load(&joint_state_history_);
+  }
+
+  /** @brief Set the number of joint states kept in the history (default: 1000, i.e. one second at 1 kHz).
+   *  This discards the current history and cannot be done while the monitor is active. Concurrent lookups continue
+   *  to use the previous history. */
+  void setJointStateHistoryCapacity(std::size_t capacity);
+
   /** @brief Get the current state values as a map from joint names to joint state values
    *  @return Returns the map from joint names to joint state values*/
   std::map<std::string, double> getCurrentStateValues() const;
@@ -192,6 +212,16 @@ public:
   }
 
 private:
+  /* The joint models for the names in a joint state message */
+  struct JointStateLayout
+  {
+    std::vector<std::string> names_;
+    std::vector<const moveit::core::JointModel*> joints_;  // null for names that are not single-DOF joints
+  };
+
+  /* Get the layout for \e names, creating it if it was not seen before */
+  const JointStateLayout& getJointStateLayout(const std::vector<std::string>& names);
+
   void jointStateCallback(const sensor_msgs::msg::JointState::SharedPtr joint_state);
   void tfCallback();
 
@@ -207,6 +237,11 @@ private:
   double error_;
   rclcpp::Time current_state_time_;
 
+  // layouts of the recently received joint state messages, so joint models are not looked up for every message
+  std::vector<JointStateLayout> joint_state_layouts_;
+  /// only accessed with std::atomic_load() and std::atomic_store()
+  JointStateHistoryPtr joint_state_history_;
+
   mutable std::mutex state_update_lock_;
   mutable std::condition_variable state_update_condition_;
   std::vector<JointStateUpdateCallback> update_callbacks_;
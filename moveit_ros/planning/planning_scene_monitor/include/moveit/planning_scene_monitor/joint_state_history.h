@@ -0,0 +1,143 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#ifndef MOVEIT_PLANNING_SCENE_MONITOR_JOINT_STATE_HISTORY_
+#define MOVEIT_PLANNING_SCENE_MONITOR_JOINT_STATE_HISTORY_
+
+#include <moveit/robot_state/robot_state.h>
+#include <rclcpp/time.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace planning_scene_monitor
+{
+MOVEIT_CLASS_FORWARD(JointStateHistory)
+
+/** @class JointStateHistory
+    @brief A fixed-capacity ring buffer of recent joint positions of a robot, each with its time stamp.
+
+    Entries are recorded by a single writer thread with add(), which never allocates memory or blocks. Any number
+    of threads can concurrently look up the positions at an arbitrary time within the recorded span; the result is
+    interpolated between the two entries around that time. Readers do not lock: each entry carries a sequence counter
+    and reads of entries that are overwritten in the meantime are detected and retried. */
+class JointStateHistory
+{
+public:
+  /** @brief Constructor.
+   *  @param robot_model The kinematic model whose variable positions are recorded
+   *  @param capacity The number of entries kept (at least 2). Once full, the oldest entry is overwritten. */
+  JointStateHistory(const robot_model::RobotModelConstPtr& robot_model, std::size_t capacity);
+
+  const robot_model::RobotModelConstPtr& getRobotModel() const
+  {
+    return robot_model_;
+  }
+
+  /** @brief The maximal number of entries that are kept */
+  std::size_t getCapacity() const
+  {
+    return capacity_;
+  }
+
+  /** @brief The number of entries currently available */
+  std::size_t size() const;
+
+  bool empty() const
+  {
+    return size() == 0;
+  }
+
+  /** @brief Record the positions of all variables of the robot model at time \e stamp (in nanoseconds).
+   *  Entries have to be added in chronological order. Only a single thread may call add() and clear().
+   *  @param positions The positions of all variables, ordered as in the robot model
+   *  @return false (and nothing is recorded) if \e stamp is older than the newest entry */
+  bool add(int64_t stamp, const double* positions);
+
+  /** @brief Record the positions of \e state at time \e stamp */
+  bool add(const rclcpp::Time& stamp, const robot_state::RobotState& state)
+  {
+    return add(stamp.nanoseconds(), state.getVariablePositions());
+  }
+
+  /** @brief Remove all entries. Only a single thread may call add() and clear(). */
+  void clear();
+
+  /** @brief Get the stamps of the oldest and newest entries
+   *  @return false if the history is empty */
+  bool getTimeSpan(int64_t& oldest, int64_t& newest) const;
+
+  /** @brief Get the variable positions at time \e stamp (in nanoseconds), interpolated between the entries recorded
+   *  before and after it. Continuous and multi-DOF joints are interpolated as in RobotModel::interpolate().
+   *  @param positions The interpolated positions of all variables, ordered as in the robot model
+   *  @return false if \e stamp is outside of the recorded time span */
+  bool getPositionsAtTime(int64_t stamp, double* positions) const;
+
+  /** @brief Set the variable positions of \e state to the ones at time \e stamp. Other values of \e state are kept.
+   *  @return false (and \e state is not modified) if \e stamp is outside of the recorded time span */
+  bool getStateAtTime(const rclcpp::Time& stamp, robot_state::RobotState& state) const;
+
+private:
+  struct Entry
+  {
+    /* 2 * (index + 1) once the entry with absolute index \e index is completely written,
+       2 * index + 1 while it is being written */
+    std::atomic<uint64_t> sequence_;
+    std::atomic<int64_t> stamp_;
+  };
+
+  /* Read the stamp and, if \e positions is not null, the positions of the entry with absolute index \e index.
+     Returns false if that entry was overwritten (or not written yet). */
+  bool readEntry(uint64_t index, int64_t& stamp, double* positions) const;
+
+  /* The range [first, last) of absolute indices of the currently available entries */
+  void getRange(uint64_t& first, uint64_t& last) const;
+
+  robot_model::RobotModelConstPtr robot_model_;
+  std::size_t variable_count_;
+  std::size_t capacity_;
+
+  std::unique_ptr<Entry[]> entries_;
+  // positions of entry i are stored at [i * variable_count_, (i + 1) * variable_count_)
+  std::unique_ptr<std::atomic<double>[]> positions_;
+
+  // number of entries ever added
+  std::atomic<uint64_t> head_;
+  // absolute index of the first entry after the last clear()
+  std::atomic<uint64_t> first_;
+  // stamp of the newest entry, only accessed by the writer
+  int64_t newest_stamp_;
+};
+}
+
+#endif
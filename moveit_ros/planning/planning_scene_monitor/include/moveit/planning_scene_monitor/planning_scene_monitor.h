@@ -45,10 +45,14 @@
 #include <moveit/robot_model_loader/robot_model_loader.h>
 #include <moveit/occupancy_map_monitor/occupancy_map_monitor.h>
 #include <moveit/planning_scene_monitor/current_state_monitor.h>
+#include <moveit/planning_scene_monitor/scene_sequence.h>
 #include <moveit/collision_plugin_loader/collision_plugin_loader.h>
+#include <moveit_msgs/srv/get_planning_scene.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/recursive_mutex.hpp>
+#include <cstdint>
 #include <memory>
 #include "rcutils/logging_macros.h"
 #include "tf2_ros/transform_listener.h"
@@ -105,6 +109,10 @@ public:
   /// name, so the topic is prefixed by the node name)
   static const std::string MONITORED_PLANNING_SCENE_TOPIC;  // "monitored_planning_scene"
 
+  /// Appended to the name of a planning scene topic to get the name of the topic carrying the sequence stamps of its
+  /// messages
+  static const std::string SEQUENCE_STAMP_TOPIC_SUFFIX;  // "_sequence"
+
   /** @brief Constructor
    *  @param robot_description The name of the ROS parameter that contains the URDF (in string format)
    *  @param tf_buffer A pointer to a tf2_ros::Buffer
@@ -252,7 +260,12 @@ public:
 
   /** \brief Start publishing the maintained planning scene. The first message set out is a complete planning scene.
       Diffs are sent afterwards on updates specified by the \e event bitmask. For UPDATE_SCENE, the full scene is always
-     sent. */
+     sent.
+
+      The sequence stamp of every message is published on the topic with SEQUENCE_STAMP_TOPIC_SUFFIX appended: the id
+      of this publishing session, a sequence number and, for each scene component, the sequence number of the message
+      that last changed it. Monitors use the stamps to detect missed diffs and to request only the components changed
+      by those (see startSceneMonitor()). The messages themselves are not modified. */
   void startPublishingPlanningScene(SceneUpdateType event,
                                     const std::string& planning_scene_topic = MONITORED_PLANNING_SCENE_TOPIC);
 
@@ -320,6 +333,11 @@ public:
 
   /** @brief Start the scene monitor
    *  @param scene_topic The name of the planning scene topic
+   *
+   *  If sequence stamps are published for the received messages (see startPublishingPlanningScene()), diffs that were
+   *  missed are detected and the components they changed are requested asynchronously from the service last passed
+   *  to requestPlanningSceneState(). Diffs already contained in a previous resync are ignored if their stamps arrive
+   *  before them.
    */
   void startSceneMonitor(const std::string& scene_topic = DEFAULT_PLANNING_SCENE_TOPIC);
 
@@ -331,6 +349,12 @@ public:
    */
   bool requestPlanningSceneState(const std::string& service_name = DEFAULT_PLANNING_SCENE_SERVICE);
 
+  /** @brief Publish the sequence stamp of a scene message taken from the monitored scene, e.g. a GetPlanningScene
+   *  response, so that monitors receiving it know which of the published diffs it already contains. The stamp
+   *  carries the sequence number of the last published planning scene message. Does nothing if the scene is not
+   *  published. The scene needs to be locked for reading while the message is created and its stamp is published. */
+  void publishPlanningSceneStamp(const moveit_msgs::msg::PlanningScene& scene) const;
+
   /** @brief Stop the scene monitor*/
   void stopSceneMonitor();
 
@@ -390,11 +414,51 @@ public:
    */
   void unlockSceneWrite();
 
+  /** \brief Start maintaining snapshots of the monitored scene (see getPlanningSceneSnapshot()). The first snapshot
+      is taken before this function returns. */
+  void startSceneSnapshots();
+
+  /** \brief Stop maintaining snapshots of the monitored scene */
+  void stopSceneSnapshots();
+
+  /** \brief Get the latest snapshot of the monitored scene, or nullptr if snapshots were not started.
+
+      A snapshot is an immutable copy of the scene (including the octomap), taken by a background thread after each
+      batch of updates and published atomically. Unlike LockedPlanningSceneRO, getting and using a snapshot does not
+      lock the monitored scene, so planners holding a snapshot for a long time do not delay updates. The snapshot can
+      lag behind the monitored scene by the time it takes to copy it. The octomap is only copied again after the
+      octomap monitor reports a new map. */
+  planning_scene::PlanningSceneConstPtr getPlanningSceneSnapshot() const;
+
   void clearOctomap();
 
+  /** \brief Only exclude world objects whose bounding box intersects \e region (in the planning frame) from the
+      monitored octomap, e.g. the volume observed by the sensors. Objects outside of it cannot occlude sensor data, but
+      the cost of filtering the sensor data grows with the number of excluded shapes. By default, all world objects
+      are excluded. While a region is set, the world maintains a spatial index of its objects. */
+  void setOctomapExclusionRegion(const Eigen::AlignedBox3d& region);
+
+  /** \brief Exclude all world objects from the monitored octomap again */
+  void clearOctomapExclusionRegion();
+
+  /** \brief Get the ids of the world objects excluded from the monitored octomap, in alphabetical order */
+  std::vector<std::string> getWorldObjectsExcludedFromOctree();
+
+  /** \brief Return true if a region was set with setOctomapExclusionRegion() */
+  bool hasOctomapExclusionRegion() const;
+
+  /** \brief Get the region set with setOctomapExclusionRegion(), only meaningful if hasOctomapExclusionRegion() */
+  const Eigen::AlignedBox3d& getOctomapExclusionRegion() const
+  {
+    return octomap_exclusion_region_;
+  }
+
   // Called to update the planning scene with a new message.
   bool newPlanningSceneMessage(const moveit_msgs::msg::PlanningScene& scene);
 
+  // Called with the sequence stamp of a planning scene message, which may arrive before or after the message.
+  void newSceneSequenceStamp(const SceneSequenceStamp& stamp);
+
 protected:
   /** @brief Initialize the planning scene monitor
    *  @param scene The scene instance to fill with data (an instance is allocated if the one passed in is not allocated)
@@ -435,6 +499,10 @@ protected:
 
   void excludeWorldObjectsFromOctree();
   void includeWorldObjectsInOctree();
+  // the world objects selected by the exclusion region; the scene must be locked
+  std::vector<std::string> getWorldObjectIdsToExclude() const;
+  // maintain the spatial index of the worlds of scene_ and parent_scene_, which must be locked for writing
+  void setSpatialIndexEnabled(bool enable);
   void excludeWorldObjectFromOctree(const collision_detection::World::ObjectConstPtr& obj);
   void includeWorldObjectInOctree(const collision_detection::World::ObjectConstPtr& obj);
 
@@ -516,6 +584,9 @@ protected:
   LinkShapeHandles link_shape_handles_;
   AttachedBodyShapeHandles attached_body_shape_handles_;
   CollisionBodyShapeHandles collision_body_shape_handles_;
+  /// if set, world objects outside of this region (in the planning frame) are not excluded from the octomap
+  Eigen::AlignedBox3d octomap_exclusion_region_;
+  bool has_octomap_exclusion_region_;
   mutable boost::recursive_mutex shape_handles_lock_;
 
   /// lock access to update_callbacks_
@@ -529,6 +600,12 @@ private:
   // publish planning scene update diffs (runs in its own thread)
   void scenePublishingThread();
 
+  // take snapshots of the scene after updates (runs in its own thread)
+  void sceneSnapshotThread();
+
+  // copy the monitored scene into an independent scene
+  planning_scene::PlanningScenePtr createSceneSnapshot();
+
   // called by current_state_monitor_ when robot state (as monitored on joint state topic) changes
   void onStateUpdate(const sensor_msgs::msg::JointState::ConstPtr& /*joint_state*/);
 
@@ -538,6 +615,60 @@ private:
   // Callback for a new planning scene msg
   void newPlanningSceneCallback(const moveit_msgs::msg::PlanningScene::SharedPtr scene);
 
+  // Callback for the sequence stamp of a planning scene msg
+  void newSceneSequenceStampCallback(const std_msgs::msg::UInt64MultiArray::SharedPtr stamp_msg);
+
+  // asynchronously request the given PlanningSceneComponents from scene_resync_service_
+  void requestSceneResync(uint32_t components);
+
+  // apply the response to a resync request
+  void sceneResyncCallback(uint32_t components, const moveit_msgs::msg::PlanningScene& scene);
+
+  // sequence stamps of published messages, protected by scene_update_mutex_
+  SceneSequenceStamper scene_sequence_stamper_;
+  rclcpp::Publisher<std_msgs::msg::UInt64MultiArray>::SharedPtr scene_sequence_publisher_;
+
+  // sequence stamps of received messages
+  boost::mutex scene_sequence_mutex_;
+  /// This field is protected by scene_sequence_mutex_
+  SceneSequenceTracker scene_sequence_tracker_;
+  rclcpp::Subscription<std_msgs::msg::UInt64MultiArray>::SharedPtr scene_sequence_subscriber_;
+
+  // resync requests for missed diffs
+  boost::mutex scene_resync_mutex_;
+  std::string scene_resync_service_;
+  rclcpp::Client<moveit_msgs::srv::GetPlanningScene>::SharedPtr scene_resync_client_;
+  /// Components to request once the current request is answered, protected by scene_resync_mutex_
+  uint32_t scene_resync_components_;
+  /// True while a resync request is pending, protected by scene_resync_mutex_
+  bool scene_resync_in_flight_;
+
+  /// The latest snapshot of the scene; only accessed with std::atomic_load() and std::atomic_store()
+  planning_scene::PlanningSceneConstPtr scene_snapshot_;
+
+  // variables for taking scene snapshots
+  std::unique_ptr<boost::thread> scene_snapshot_thread_;
+  boost::mutex scene_snapshot_mutex_;
+  boost::condition_variable scene_snapshot_condition_;
+
+  /// True when the scene was updated after the latest snapshot was taken
+  // This field is protected by scene_snapshot_mutex_
+  bool scene_snapshot_pending_;
+
+  /// True while the snapshot thread should keep running
+  // This field is protected by scene_snapshot_mutex_
+  bool scene_snapshot_running_;
+
+  /// The copy of the monitored octree used by the latest snapshot, only accessed when taking snapshots
+  std::shared_ptr<const octomap::OcTree> scene_snapshot_octree_;
+
+  /// The value of octomap_update_count_ when scene_snapshot_octree_ was copied
+  std::size_t scene_snapshot_octree_update_;
+
+  /// The number of maps received from octomap_monitor_
+  // This field is protected by scene_update_mutex_
+  std::size_t octomap_update_count_;
+
   // Lock for state_update_pending_ and dt_state_update_
   boost::mutex state_pending_mutex_;
 
@@ -0,0 +1,175 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#ifndef MOVEIT_PLANNING_SCENE_MONITOR_SCENE_SEQUENCE_
+#define MOVEIT_PLANNING_SCENE_MONITOR_SCENE_SEQUENCE_
+
+#include <moveit_msgs/msg/planning_scene.hpp>
+#include <std_msgs/msg/u_int64_multi_array.hpp>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace planning_scene_monitor
+{
+/** @brief The sequence stamp of a planning scene message published by a PlanningSceneMonitor.
+
+    Stamps are published on a companion topic next to the scene messages, so the messages themselves are left
+    untouched. A stamp refers to its message by the key computed by computeSceneMsgKey(). */
+struct SceneSequenceStamp
+{
+  /// The number of scene components whose versions are tracked, see SceneSequenceStamp::COMPONENTS
+  static const std::size_t COMPONENT_COUNT = 8;
+
+  /// The tracked scene components, as PlanningSceneComponents bits
+  static const std::array<uint32_t, COMPONENT_COUNT> COMPONENTS;
+
+  /// All PlanningSceneComponents bits in SceneSequenceStamp::COMPONENTS
+  static const uint32_t ALL_COMPONENTS;
+
+  SceneSequenceStamp() : key(0), is_diff(false), session(0), sequence(0)
+  {
+  }
+
+  /// The key of the stamped message
+  uint64_t key;
+
+  /// True for diffs, false for messages holding the complete state of the components they contain
+  bool is_diff;
+
+  /// Identifies the publishing session; sequence numbers restart with every session
+  uint64_t session;
+
+  uint64_t sequence;
+
+  /// For diffs: the sequence number of the last message that changed each of COMPONENTS before this one
+  std::vector<uint64_t> versions;
+};
+
+/** @brief Compute the key of a planning scene message, a hash of its complete content.
+    The key does not depend on the platform, so stamps can be matched with messages received from other hosts. */
+uint64_t computeSceneMsgKey(const moveit_msgs::msg::PlanningScene& scene);
+
+/** @brief Get the PlanningSceneComponents bits of the components a planning scene diff contains changes for */
+uint32_t getSceneDiffComponents(const moveit_msgs::msg::PlanningScene& scene);
+
+/** @brief Convert a stamp to the message published on the companion topic, laid out as
+    [key, is_diff, session, sequence, versions...] */
+void sceneSequenceStampToMsg(const SceneSequenceStamp& stamp, std_msgs::msg::UInt64MultiArray& msg);
+
+/** @brief Convert a message received on the companion topic to a stamp
+    @return false if \e msg is malformed */
+bool sceneSequenceStampFromMsg(const std_msgs::msg::UInt64MultiArray& msg, SceneSequenceStamp& stamp);
+
+/** @class SceneSequenceStamper
+    @brief Creates the sequence stamps of the planning scene messages a monitor publishes. Not thread-safe. */
+class SceneSequenceStamper
+{
+public:
+  SceneSequenceStamper();
+
+  /** @brief Start a new publishing session with a random id; sequence numbers restart */
+  void startSession();
+
+  /** @brief End the current session; no stamps are created until the next one is started */
+  void stopSession();
+
+  bool hasSession() const
+  {
+    return session_ != 0;
+  }
+
+  /** @brief Create the stamp of the next message published, which is \e scene */
+  SceneSequenceStamp stamp(const moveit_msgs::msg::PlanningScene& scene);
+
+  /** @brief Create the stamp of \e scene, which holds the state of the monitored scene after the last published
+      message, e.g. as GetPlanningScene response. This does not advance the sequence. */
+  SceneSequenceStamp stampCurrent(const moveit_msgs::msg::PlanningScene& scene) const;
+
+private:
+  uint64_t session_;
+  uint64_t sequence_;
+  std::array<uint64_t, SceneSequenceStamp::COMPONENT_COUNT> versions_;
+};
+
+/** @class SceneSequenceTracker
+    @brief Matches received planning scene messages with their sequence stamps to detect missed diffs.
+
+    Scene messages and their stamps travel on different topics, so either one can arrive first. Recent unmatched
+    messages and stamps are remembered until the other one arrives. A message that arrives before its stamp is applied
+    right away; one that arrives after its stamp is skipped if it is a diff already contained in a previously received
+    message holding the complete state. Not thread-safe. */
+class SceneSequenceTracker
+{
+public:
+  /** @brief Constructor.
+   *  @param capacity The number of unmatched messages and stamps that are remembered */
+  SceneSequenceTracker(std::size_t capacity = 100);
+
+  /** @brief Process a received planning scene message
+   *  @param key The key of the message, see computeSceneMsgKey()
+   *  @param resync_components Bits of the PlanningSceneComponents that need to be requested because diffs were
+   *  missed are added to this
+   *  @return false if the message is a diff that is already contained in the scene and should be ignored */
+  bool sceneReceived(uint64_t key, uint32_t& resync_components);
+
+  /** @brief Process a received sequence stamp, see sceneReceived() for \e resync_components */
+  void stampReceived(const SceneSequenceStamp& stamp, uint32_t& resync_components);
+
+  /** @brief The session of the newest message matched with its stamp, 0 if there is none */
+  uint64_t getSession() const
+  {
+    return session_;
+  }
+
+  /** @brief The sequence number of the newest message matched with its stamp */
+  uint64_t getSequence() const
+  {
+    return sequence_;
+  }
+
+private:
+  // update the newest sequence with the stamp of a received message; returns false if the message is redundant
+  bool apply(const SceneSequenceStamp& stamp, uint32_t& resync_components);
+
+  std::size_t capacity_;
+  std::deque<SceneSequenceStamp> unmatched_stamps_;
+  std::deque<uint64_t> unmatched_keys_;
+  uint64_t session_;
+  uint64_t sequence_;
+};
+}
+
+#endif
@@ -43,6 +43,14 @@
 
 rclcpp::Logger logger = rclcpp::get_logger("planning_scene_monitor");
 
+namespace
+{
+// one second of joint states at 1 kHz
+const std::size_t DEFAULT_JOINT_STATE_HISTORY_CAPACITY = 1000;
+// the number of distinct joint state message layouts (e.g. from separate arm and gripper drivers) that are cached
+const std::size_t MAX_JOINT_STATE_LAYOUTS = 8;
+}
+
 planning_scene_monitor::CurrentStateMonitor::CurrentStateMonitor(const robot_model::RobotModelConstPtr& robot_model,
                                                                  const std::shared_ptr<tf2_ros::Buffer>& tf_buffer)
   : CurrentStateMonitor(robot_model, tf_buffer, node)
@@ -59,6 +67,7 @@ planning_scene_monitor::CurrentStateMonitor::CurrentStateMonitor(const robot_mod
   , state_monitor_started_(false)
   , copy_dynamics_(true)
   , error_(std::numeric_limits<double>::epsilon())
+  , joint_state_history_(std::make_shared<JointStateHistory>(robot_model, DEFAULT_JOINT_STATE_HISTORY_CAPACITY))
 {
   robot_state_.setToDefaultValues();
 }
@@ -89,6 +98,23 @@ planning_scene_monitor::CurrentStateMonitor::getCurrentStateAndTime() const
   return std::make_pair(robot_state::RobotStatePtr(result), current_state_time_);
 }
 
+bool planning_scene_monitor::CurrentStateMonitor::setToStateAtTime(robot_state::RobotState& upd,
+                                                                   const rclcpp::Time& t) const
+{
+  return std::atomic_load(&joint_state_history_)->getStateAtTime(t, upd);
+}
+
+void planning_scene_monitor::CurrentStateMonitor::setJointStateHistoryCapacity(std::size_t capacity)
+{
+  if (state_monitor_started_)
+  {
+    RCLCPP_ERROR(logger, "Cannot change the joint state history capacity while the state monitor is active");
+    return;
+  }
+  // readers holding the previous history keep it alive until they are done
+  std::atomic_store(&joint_state_history_, std::make_shared<JointStateHistory>(robot_model_, capacity));
+}
+
 std::map<std::string, double> planning_scene_monitor::CurrentStateMonitor::getCurrentStateValues() const
 {
   std::map<std::string, double> m;
@@ -142,6 +168,7 @@ void planning_scene_monitor::CurrentStateMonitor::startStateMonitor(const std::s
   if (!state_monitor_started_ && robot_model_)
   {
     joint_time_.clear();
+    std::atomic_load(&joint_state_history_)->clear();
     if (joint_states_topic.empty()){
       RCLCPP_ERROR(node_->get_logger(), " The joint states topic cannot be an empty string");
     }
@@ -360,6 +387,27 @@ bool planning_scene_monitor::CurrentStateMonitor::waitForCompleteState(const std
   return ok;
 }
 
+const planning_scene_monitor::CurrentStateMonitor::JointStateLayout&
+planning_scene_monitor::CurrentStateMonitor::getJointStateLayout(const std::vector<std::string>& names)
+{
+  for (const JointStateLayout& layout : joint_state_layouts_)
+    if (layout.names_ == names)
+      return layout;
+
+  if (joint_state_layouts_.size() >= MAX_JOINT_STATE_LAYOUTS)
+    joint_state_layouts_.erase(joint_state_layouts_.begin());
+  JointStateLayout layout;
+  layout.names_ = names;
+  layout.joints_.reserve(names.size());
+  for (const std::string& name : names)
+  {
+    const moveit::core::JointModel* jm = robot_model_->getJointModel(name);
+    layout.joints_.push_back(jm && jm->getVariableCount() == 1 ? jm : nullptr);
+  }
+  joint_state_layouts_.push_back(std::move(layout));
+  return joint_state_layouts_.back();
+}
+
 void planning_scene_monitor::CurrentStateMonitor::jointStateCallback(const sensor_msgs::msg::JointState::SharedPtr joint_state)
 {
   if (joint_state->name.size() != joint_state->position.size())
@@ -374,14 +422,15 @@ void planning_scene_monitor::CurrentStateMonitor::jointStateCallback(const senso
     // read the received values, and update their time stamps
     std::size_t n = joint_state->name.size();
     current_state_time_ = joint_state->header.stamp;
+    const JointStateLayout& layout = getJointStateLayout(joint_state->name);
+    bool known = false;
     for (std::size_t i = 0; i < n; ++i)
     {
-      const moveit::core::JointModel* jm = robot_model_->getJointModel(joint_state->name[i]);
+      // ignore unknown joints, fixed joints, multi-dof joints (they should not even be in the message)
+      const moveit::core::JointModel* jm = layout.joints_[i];
       if (!jm)
         continue;
-      // ignore fixed joints, multi-dof joints (they should not even be in the message)
-      if (jm->getVariableCount() != 1)
-        continue;
+      known = true;
 
       joint_time_[jm] = joint_state->header.stamp;
 
@@ -423,6 +472,11 @@ void planning_scene_monitor::CurrentStateMonitor::jointStateCallback(const senso
       }
     }
 
+    // record the state even if no position changed, so lookups in between messages interpolate correctly
+    if (known)
+      std::atomic_load(&joint_state_history_)
+          ->add(current_state_time_.nanoseconds(), robot_state_.getVariablePositions());
+
   // callbacks, if needed
   if (update)
     for (std::size_t i = 0; i < update_callbacks_.size(); ++i)
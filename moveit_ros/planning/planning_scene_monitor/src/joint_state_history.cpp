@@ -0,0 +1,187 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+#include <moveit/planning_scene_monitor/joint_state_history.h>
+#include <algorithm>
+#include <vector>
+
+planning_scene_monitor::JointStateHistory::JointStateHistory(const robot_model::RobotModelConstPtr& robot_model,
+                                                             std::size_t capacity)
+  : robot_model_(robot_model)
+  , variable_count_(robot_model->getVariableCount())
+  , capacity_(std::max<std::size_t>(capacity, 2))
+  , entries_(new Entry[capacity_])
+  , positions_(new std::atomic<double>[capacity_ * variable_count_])
+  , head_(0)
+  , first_(0)
+  , newest_stamp_(0)
+{
+  for (std::size_t i = 0; i < capacity_; ++i)
+  {
+    entries_[i].sequence_.store(0, std::memory_order_relaxed);
+    entries_[i].stamp_.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::size_t planning_scene_monitor::JointStateHistory::size() const
+{
+  uint64_t first, last;
+  getRange(first, last);
+  return last - first;
+}
+
+void planning_scene_monitor::JointStateHistory::getRange(uint64_t& first, uint64_t& last) const
+{
+  last = head_.load(std::memory_order_acquire);
+  first = first_.load(std::memory_order_acquire);
+  if (last > capacity_)
+    first = std::max<uint64_t>(first, last - capacity_);
+  // a clear() between the two loads above
+  first = std::min(first, last);
+}
+
+bool planning_scene_monitor::JointStateHistory::add(int64_t stamp, const double* positions)
+{
+  const uint64_t index = head_.load(std::memory_order_relaxed);
+  if (index != first_.load(std::memory_order_relaxed) && stamp < newest_stamp_)
+    return false;
+
+  // seqlock write: mark the entry as being written before touching its data, and as complete afterwards
+  Entry& entry = entries_[index % capacity_];
+  entry.sequence_.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  entry.stamp_.store(stamp, std::memory_order_relaxed);
+  std::atomic<double>* data = &positions_[(index % capacity_) * variable_count_];
+  for (std::size_t i = 0; i < variable_count_; ++i)
+    data[i].store(positions[i], std::memory_order_relaxed);
+  entry.sequence_.store(2 * index + 2, std::memory_order_release);
+
+  head_.store(index + 1, std::memory_order_release);
+  newest_stamp_ = stamp;
+  return true;
+}
+
+void planning_scene_monitor::JointStateHistory::clear()
+{
+  first_.store(head_.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+bool planning_scene_monitor::JointStateHistory::readEntry(uint64_t index, int64_t& stamp, double* positions) const
+{
+  const Entry& entry = entries_[index % capacity_];
+  const uint64_t sequence = entry.sequence_.load(std::memory_order_acquire);
+  if (sequence != 2 * index + 2)
+    return false;
+  stamp = entry.stamp_.load(std::memory_order_relaxed);
+  if (positions)
+  {
+    const std::atomic<double>* data = &positions_[(index % capacity_) * variable_count_];
+    for (std::size_t i = 0; i < variable_count_; ++i)
+      positions[i] = data[i].load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return entry.sequence_.load(std::memory_order_relaxed) == sequence;
+}
+
+bool planning_scene_monitor::JointStateHistory::getTimeSpan(int64_t& oldest, int64_t& newest) const
+{
+  while (true)
+  {
+    uint64_t first, last;
+    getRange(first, last);
+    if (first == last)
+      return false;
+    if (readEntry(first, oldest, nullptr) && readEntry(last - 1, newest, nullptr))
+      return true;
+  }
+}
+
+bool planning_scene_monitor::JointStateHistory::getPositionsAtTime(int64_t stamp, double* positions) const
+{
+  std::vector<double> from(variable_count_), to(variable_count_);
+
+  // any read of an entry fails only if the writer overwrote it meanwhile, so start over with the current range then
+  while (true)
+  {
+    uint64_t first, last;
+    getRange(first, last);
+    if (first == last)
+      return false;
+
+    int64_t oldest, newest;
+    if (!readEntry(first, oldest, nullptr) || !readEntry(last - 1, newest, nullptr))
+      continue;
+    if (stamp < oldest || stamp > newest)
+      return false;
+
+    // find the newest entry not later than stamp
+    uint64_t lo = first, hi = last - 1;
+    bool valid = true;
+    while (valid && lo < hi)
+    {
+      const uint64_t mid = lo + (hi - lo + 1) / 2;
+      int64_t mid_stamp;
+      if (!readEntry(mid, mid_stamp, nullptr))
+        valid = false;
+      else if (mid_stamp <= stamp)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+    if (!valid)
+      continue;
+
+    int64_t before, after;
+    if (!readEntry(lo, before, from.data()))
+      continue;
+    if (before == stamp || lo + 1 == last)
+    {
+      std::copy(from.begin(), from.end(), positions);
+      return true;
+    }
+    if (!readEntry(lo + 1, after, to.data()))
+      continue;
+    robot_model_->interpolate(from.data(), to.data(), double(stamp - before) / double(after - before), positions);
+    return true;
+  }
+}
+
+bool planning_scene_monitor::JointStateHistory::getStateAtTime(const rclcpp::Time& stamp,
+                                                               robot_state::RobotState& state) const
+{
+  std::vector<double> positions(variable_count_);
+  if (!getPositionsAtTime(stamp.nanoseconds(), positions.data()))
+    return false;
+  state.setVariablePositions(positions);
+  return true;
+}
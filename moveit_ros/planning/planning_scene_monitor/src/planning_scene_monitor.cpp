@@ -48,7 +48,9 @@
 #include <rcutils/logging_macros.h>
 
 #include <boost/algorithm/string/join.hpp>
+#include <limits>
 #include <memory>
+#include <set>
 
 rclcpp::Logger LOGGER_PLANNING_SCENE_MONITOR = rclcpp::get_logger("planning_scene_monitor");
 
@@ -59,6 +61,11 @@ namespace planning_scene_monitor
 
 static const std::string LOGNAME = "planning_scene_monitor";
 
+namespace
+{
+typedef moveit_msgs::msg::PlanningSceneComponents Components;
+}  // namespace
+
 class PlanningSceneMonitor::DynamicReconfigureImpl
 {
 public:
@@ -118,6 +125,7 @@ const std::string PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_WORLD_TOPIC = "pl
 const std::string PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_TOPIC = "planning_scene";
 const std::string PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_SERVICE = "get_planning_scene";
 const std::string PlanningSceneMonitor::MONITORED_PLANNING_SCENE_TOPIC = "monitored_planning_scene";
+const std::string PlanningSceneMonitor::SEQUENCE_STAMP_TOPIC_SUFFIX = "_sequence";
 
 PlanningSceneMonitor::PlanningSceneMonitor(const std::string& robot_description,
                                            std::shared_ptr<rclcpp::Node>& node,
@@ -161,6 +169,7 @@ PlanningSceneMonitor::~PlanningSceneMonitor()
     scene_->setCollisionObjectUpdateCallback(collision_detection::World::ObserverCallbackFn());
     scene_->setAttachedBodyUpdateCallback(robot_state::AttachedBodyCallback());
   }
+  stopSceneSnapshots();
   stopPublishingPlanningScene();
   stopStateMonitor();
   stopWorldGeometryMonitor();
@@ -235,6 +244,14 @@ void PlanningSceneMonitor::initialize(const planning_scene::PlanningScenePtr& sc
 
   publish_planning_scene_frequency_ = 2.0;
   new_scene_update_ = UPDATE_NONE;
+  scene_resync_service_ = DEFAULT_PLANNING_SCENE_SERVICE;
+  scene_resync_components_ = 0;
+  scene_resync_in_flight_ = false;
+  has_octomap_exclusion_region_ = false;
+  scene_snapshot_pending_ = false;
+  scene_snapshot_running_ = false;
+  scene_snapshot_octree_update_ = 0;
+  octomap_update_count_ = 0;
 
   last_update_time_ = last_robot_motion_time_ = clock_.now();
   last_robot_state_update_wall_time_ = std::chrono::system_clock::now();
@@ -325,6 +342,11 @@ void PlanningSceneMonitor::stopPublishingPlanningScene()
     new_scene_update_condition_.notify_all();
     copy->join();
     monitorDiffs(false);
+    {
+      boost::unique_lock<boost::shared_mutex> ulock(scene_update_mutex_);
+      scene_sequence_stamper_.stopSession();
+      scene_sequence_publisher_.reset();
+    }
     planning_scene_publisher_.reset();
     RCLCPP_INFO(node_->get_logger(), "Stopped publishing maintained planning scene.");
   }
@@ -338,6 +360,8 @@ void PlanningSceneMonitor::startPublishingPlanningScene(SceneUpdateType update_t
   {
     planning_scene_publisher_ =
         node_->create_publisher<moveit_msgs::msg::PlanningScene>(planning_scene_topic, rmw_qos_profile_default);
+    scene_sequence_publisher_ = node_->create_publisher<std_msgs::msg::UInt64MultiArray>(
+        planning_scene_topic + SEQUENCE_STAMP_TOPIC_SUFFIX, rmw_qos_profile_default);
     RCLCPP_INFO(node_->get_logger(), "Publishing maintained planning scene on '%s'", planning_scene_topic.c_str());
     monitorDiffs(true);
     publish_planning_scene_.reset(new boost::thread(boost::bind(&PlanningSceneMonitor::scenePublishingThread, this)));
@@ -351,12 +375,20 @@ void PlanningSceneMonitor::scenePublishingThread()
   // publish the full planning scene once
   {
     moveit_msgs::msg::PlanningScene msg;
+    std_msgs::msg::UInt64MultiArray stamp_msg;
     {
+      boost::unique_lock<boost::shared_mutex> ulock(scene_update_mutex_);
+      // start a new publishing session, so that monitors know that sequence numbers restart
+      scene_sequence_stamper_.startSession();
+
       occupancy_map_monitor::OccMapTree::ReadLock lock;
       if (octomap_monitor_)
         lock = octomap_monitor_->getOcTreePtr()->reading();
       scene_->getPlanningSceneMsg(msg);
+      sceneSequenceStampToMsg(scene_sequence_stamper_.stamp(msg), stamp_msg);
     }
+    // monitors remember stamps until the message arrives, so the stamp is published first
+    scene_sequence_publisher_->publish(stamp_msg);
     planning_scene_publisher_->publish(msg);
     RCLCPP_DEBUG(node_->get_logger(), "Published the full planning scene: '%s'", msg.name.c_str());
   }
@@ -364,6 +396,7 @@ void PlanningSceneMonitor::scenePublishingThread()
   do
   {
     moveit_msgs::msg::PlanningScene msg;
+    std_msgs::msg::UInt64MultiArray stamp_msg;
     bool publish_msg = false;
     bool is_full = false;
     rclcpp::Rate rate(publish_planning_scene_frequency_);
@@ -411,6 +444,7 @@ void PlanningSceneMonitor::scenePublishingThread()
           }
           // also publish timestamp of this robot_state
           msg.robot_state.joint_state.header.stamp = last_robot_motion_time_;
+          sceneSequenceStampToMsg(scene_sequence_stamper_.stamp(msg), stamp_msg);
           publish_msg = true;
         }
         new_scene_update_ = UPDATE_NONE;
@@ -419,6 +453,7 @@ void PlanningSceneMonitor::scenePublishingThread()
     if (publish_msg)
     {
       rate.reset();
+      scene_sequence_publisher_->publish(stamp_msg);
       planning_scene_publisher_->publish(msg);
       if (is_full)
         RCLCPP_DEBUG(node_->get_logger(), "Published full planning scene: '%s'", msg.name.c_str());
@@ -427,6 +462,172 @@ void PlanningSceneMonitor::scenePublishingThread()
   } while (publish_planning_scene_);
 }
 
+void PlanningSceneMonitor::publishPlanningSceneStamp(const moveit_msgs::msg::PlanningScene& scene) const
+{
+  if (!scene_sequence_stamper_.hasSession())
+    return;
+  std_msgs::msg::UInt64MultiArray stamp_msg;
+  sceneSequenceStampToMsg(scene_sequence_stamper_.stampCurrent(scene), stamp_msg);
+  scene_sequence_publisher_->publish(stamp_msg);
+}
+
+void PlanningSceneMonitor::requestSceneResync(uint32_t components)
+{
+  boost::mutex::scoped_lock lock(scene_resync_mutex_);
+  scene_resync_components_ |= components;
+  if (scene_resync_in_flight_ || scene_resync_components_ == 0)
+    return;
+
+  if (!scene_resync_client_)
+    scene_resync_client_ = node_->create_client<moveit_msgs::srv::GetPlanningScene>(scene_resync_service_);
+  if (!scene_resync_client_->service_is_ready())
+  {
+    RCLCPP_WARN(node_->get_logger(), "Cannot resync the planning scene: service '%s' is not available",
+                scene_resync_service_.c_str());
+    return;
+  }
+
+  auto request = std::make_shared<moveit_msgs::srv::GetPlanningScene::Request>();
+  request->components.components = scene_resync_components_;
+  scene_resync_components_ = 0;
+  scene_resync_in_flight_ = true;
+  uint32_t requested = request->components.components;
+  scene_resync_client_->async_send_request(
+      request, [this, requested](rclcpp::Client<moveit_msgs::srv::GetPlanningScene>::SharedFuture response) {
+        sceneResyncCallback(requested, response.get()->scene);
+      });
+}
+
+void PlanningSceneMonitor::sceneResyncCallback(uint32_t components, const moveit_msgs::msg::PlanningScene& scene)
+{
+  {
+    // the response contains the diffs published before its stamp
+    boost::mutex::scoped_lock lock(scene_sequence_mutex_);
+    uint32_t resync_components = 0;
+    scene_sequence_tracker_.sceneReceived(computeSceneMsgKey(scene), resync_components);
+  }
+
+  // the response only contains the requested components, so it is applied as a diff
+  moveit_msgs::msg::PlanningScene diff = scene;
+  diff.is_diff = true;
+  bool removed_octomap = false;
+  if (scene_)
+  {
+    boost::unique_lock<boost::shared_mutex> ulock(scene_update_mutex_);
+    // objects missing from the response were removed by the diffs that were missed
+    if (components & Components::WORLD_OBJECT_GEOMETRY)
+    {
+      std::set<std::string> ids;
+      for (const moveit_msgs::msg::CollisionObject& object : scene.world.collision_objects)
+        ids.insert(object.id);
+      for (const std::string& id : scene_->getWorld()->getObjectIds())
+        if (id != planning_scene::PlanningScene::OCTOMAP_NS && ids.find(id) == ids.end())
+        {
+          moveit_msgs::msg::CollisionObject object;
+          object.id = id;
+          object.operation = moveit_msgs::msg::CollisionObject::REMOVE;
+          diff.world.collision_objects.insert(diff.world.collision_objects.begin(), object);
+        }
+    }
+    // diffs cannot remove the octomap, and the removal may be the only change
+    if ((components & Components::OCTOMAP) && scene.world.octomap.octomap.data.empty())
+      removed_octomap = scene_->getWorldNonConst()->removeObject(planning_scene::PlanningScene::OCTOMAP_NS);
+  }
+  newPlanningSceneMessage(diff);
+  if (removed_octomap)
+    triggerSceneUpdateEvent(UPDATE_GEOMETRY);
+
+  bool pending;
+  {
+    boost::mutex::scoped_lock lock(scene_resync_mutex_);
+    scene_resync_in_flight_ = false;
+    pending = scene_resync_components_ != 0;
+  }
+  if (pending)
+    requestSceneResync(0);
+}
+
+void PlanningSceneMonitor::startSceneSnapshots()
+{
+  if (scene_snapshot_thread_ || !scene_)
+    return;
+  std::atomic_store(&scene_snapshot_, planning_scene::PlanningSceneConstPtr(createSceneSnapshot()));
+  scene_snapshot_pending_ = false;
+  scene_snapshot_running_ = true;
+  scene_snapshot_thread_.reset(new boost::thread(boost::bind(&PlanningSceneMonitor::sceneSnapshotThread, this)));
+  RCLCPP_INFO(node_->get_logger(), "Started taking snapshots of the maintained planning scene.");
+}
+
+void PlanningSceneMonitor::stopSceneSnapshots()
+{
+  if (scene_snapshot_thread_)
+  {
+    {
+      boost::mutex::scoped_lock lock(scene_snapshot_mutex_);
+      scene_snapshot_running_ = false;
+    }
+    scene_snapshot_condition_.notify_all();
+    scene_snapshot_thread_->join();
+    scene_snapshot_thread_.reset();
+    std::atomic_store(&scene_snapshot_, planning_scene::PlanningSceneConstPtr());
+    scene_snapshot_octree_.reset();
+    RCLCPP_INFO(node_->get_logger(), "Stopped taking snapshots of the maintained planning scene.");
+  }
+}
+
+planning_scene::PlanningSceneConstPtr PlanningSceneMonitor::getPlanningSceneSnapshot() const
+{
+  return std::atomic_load(&scene_snapshot_);
+}
+
+planning_scene::PlanningScenePtr PlanningSceneMonitor::createSceneSnapshot()
+{
+  planning_scene::PlanningScenePtr snapshot;
+  // other readers can continue while the scene is copied, only writers wait
+  boost::shared_lock<boost::shared_mutex> slock(scene_update_mutex_);
+  snapshot = planning_scene::PlanningScene::clone(scene_);
+
+  // the octomap monitor updates its tree in place, so the snapshot needs a copy of it; the copy is shared with the
+  // previous snapshot until the monitor reports a new map
+  collision_detection::World::ObjectConstPtr map =
+      snapshot->getWorld()->getObject(planning_scene::PlanningScene::OCTOMAP_NS);
+  if (octomap_monitor_ && map && map->shapes_.size() == 1 && map->shapes_[0]->type == shapes::OCTREE)
+  {
+    const shapes::OcTree* o = static_cast<const shapes::OcTree*>(map->shapes_[0].get());
+    if (o->octree == octomap_monitor_->getOcTreePtr())
+    {
+      if (!scene_snapshot_octree_ || scene_snapshot_octree_update_ != octomap_update_count_)
+      {
+        occupancy_map_monitor::OccMapTree::ReadLock map_lock = octomap_monitor_->getOcTreePtr()->reading();
+        scene_snapshot_octree_ = std::make_shared<const octomap::OcTree>(*o->octree);
+        scene_snapshot_octree_update_ = octomap_update_count_;
+      }
+      snapshot->processOctomapPtr(scene_snapshot_octree_, map->shape_poses_[0]);
+    }
+  }
+  return snapshot;
+}
+
+void PlanningSceneMonitor::sceneSnapshotThread()
+{
+  RCLCPP_DEBUG(node_->get_logger(), "Started scene snapshot thread ...");
+  while (true)
+  {
+    {
+      boost::mutex::scoped_lock lock(scene_snapshot_mutex_);
+      while (!scene_snapshot_pending_ && scene_snapshot_running_)
+        scene_snapshot_condition_.wait(lock);
+      if (!scene_snapshot_running_)
+        break;
+      // all updates up to now are included in the next snapshot
+      scene_snapshot_pending_ = false;
+    }
+
+    // readers holding the previous snapshot keep it alive until they release it
+    std::atomic_store(&scene_snapshot_, planning_scene::PlanningSceneConstPtr(createSceneSnapshot()));
+  }
+}
+
 void PlanningSceneMonitor::getMonitoredTopics(std::vector<std::string>& topics) const
 {
   // TODO(anasarrak): Do we need this for ROS2?
@@ -479,10 +680,27 @@ void PlanningSceneMonitor::triggerSceneUpdateEvent(SceneUpdateType update_type)
     update_callbacks_[i](update_type);
   new_scene_update_ = (SceneUpdateType)((int)new_scene_update_ | (int)update_type);
   new_scene_update_condition_.notify_all();
+
+  boost::mutex::scoped_lock snapshot_lock(scene_snapshot_mutex_);
+  if (scene_snapshot_running_)
+  {
+    scene_snapshot_pending_ = true;
+    scene_snapshot_condition_.notify_all();
+  }
 }
 
 bool PlanningSceneMonitor::requestPlanningSceneState(const std::string& service_name)
 {
+  {
+    // missed diffs are requested from the same service
+    boost::mutex::scoped_lock lock(scene_resync_mutex_);
+    if (service_name != scene_resync_service_)
+    {
+      scene_resync_service_ = service_name;
+      scene_resync_client_.reset();
+    }
+  }
+
   // use global namespace for service
   auto client = node_->create_client<moveit_msgs::srv::GetPlanningScene>(service_name);
   auto srv = std::make_shared<moveit_msgs::srv::GetPlanningScene::Request>();
@@ -518,11 +736,39 @@ void PlanningSceneMonitor::newPlanningSceneCallback(const moveit_msgs::msg::Plan
   newPlanningSceneMessage(*scene);
 }
 
+void PlanningSceneMonitor::newSceneSequenceStampCallback(const std_msgs::msg::UInt64MultiArray::SharedPtr stamp_msg)
+{
+  SceneSequenceStamp stamp;
+  if (sceneSequenceStampFromMsg(*stamp_msg, stamp))
+    newSceneSequenceStamp(stamp);
+  else
+    RCLCPP_WARN(node_->get_logger(), "Ignoring malformed planning scene sequence stamp");
+}
+
+void PlanningSceneMonitor::newSceneSequenceStamp(const SceneSequenceStamp& stamp)
+{
+  uint32_t resync_components = 0;
+  {
+    boost::mutex::scoped_lock lock(scene_sequence_mutex_);
+    scene_sequence_tracker_.stampReceived(stamp, resync_components);
+  }
+  if (resync_components)
+  {
+    RCLCPP_WARN(node_->get_logger(), "Missed planning scene diffs before diff %lu, requesting a resync",
+                static_cast<unsigned long>(stamp.sequence));
+    requestSceneResync(resync_components);
+  }
+}
+
 void PlanningSceneMonitor::clearOctomap()
 {
   octomap_monitor_->getOcTreePtr()->lockWrite();
   octomap_monitor_->getOcTreePtr()->clear();
   octomap_monitor_->getOcTreePtr()->unlockWrite();
+
+  // the next snapshot copies the cleared map
+  boost::unique_lock<boost::shared_mutex> ulock(scene_update_mutex_);
+  ++octomap_update_count_;
 }
 
 bool PlanningSceneMonitor::newPlanningSceneMessage(const moveit_msgs::msg::PlanningScene& scene)
@@ -534,11 +780,23 @@ bool PlanningSceneMonitor::newPlanningSceneMessage(const moveit_msgs::msg::Plann
 
   SceneUpdateType upd = UPDATE_SCENE;
   std::string old_scene_name;
+  uint32_t resync_components = 0;
   {
     boost::unique_lock<boost::shared_mutex> ulock(scene_update_mutex_);
     // we don't want the transform cache to update while we are potentially changing attached bodies
     boost::recursive_mutex::scoped_lock prevent_shape_cache_updates(shape_handles_lock_);
 
+    {
+      boost::mutex::scoped_lock lock(scene_sequence_mutex_);
+      if (!scene_sequence_tracker_.sceneReceived(computeSceneMsgKey(scene), resync_components))
+      {
+        RCLCPP_DEBUG(node_->get_logger(), "Ignoring a planning scene diff the scene already contains");
+        return true;
+      }
+    }
+    if (resync_components)
+      RCLCPP_WARN(node_->get_logger(), "Missed planning scene diffs, requesting a resync");
+
     last_update_time_ = clock_.now();
     last_robot_motion_time_ = scene.robot_state.joint_state.header.stamp;
     RCLCPP_DEBUG(node_->get_logger(), "scene update %f robot stamp: %f", fmod(last_update_time_.seconds(), 10.),
@@ -601,6 +859,8 @@ bool PlanningSceneMonitor::newPlanningSceneMessage(const moveit_msgs::msg::Plann
     }
   }
   triggerSceneUpdateEvent(upd);
+  if (resync_components)
+    requestSceneResync(resync_components);
   return result;
 }
 
@@ -648,6 +908,8 @@ void PlanningSceneMonitor::collisionObjectCallback(const moveit_msgs::msg::Colli
   {
     boost::unique_lock<boost::shared_mutex> ulock(scene_update_mutex_);
     last_update_time_ = clock_.now();
+    // replacing an object removes it and adds its shapes one by one: report this as a single change
+    collision_detection::World::Transaction transaction(*scene_->getWorldNonConst());
     scene_->processCollisionObjectMsg(*obj);
   }
   triggerSceneUpdateEvent(UPDATE_GEOMETRY);
@@ -764,9 +1026,62 @@ void PlanningSceneMonitor::excludeWorldObjectsFromOctree()
   boost::recursive_mutex::scoped_lock _(shape_handles_lock_);
 
   includeWorldObjectsInOctree();
-  for (collision_detection::World::const_iterator it = scene_->getWorld()->begin(); it != scene_->getWorld()->end();
-       ++it)
-    excludeWorldObjectFromOctree(it->second);
+  const collision_detection::WorldConstPtr& world = scene_->getWorld();
+  for (const std::string& id : getWorldObjectIdsToExclude())
+    excludeWorldObjectFromOctree(world->getObject(id));
+}
+
+std::vector<std::string> PlanningSceneMonitor::getWorldObjectIdsToExclude() const
+{
+  boost::recursive_mutex::scoped_lock _(shape_handles_lock_);
+  if (!has_octomap_exclusion_region_)
+    return scene_->getWorld()->getObjectIds();
+  return scene_->getWorld()->getObjectsInBox(octomap_exclusion_region_);
+}
+
+std::vector<std::string> PlanningSceneMonitor::getWorldObjectsExcludedFromOctree()
+{
+  if (!scene_)
+    return std::vector<std::string>();
+  boost::shared_lock<boost::shared_mutex> slock(scene_update_mutex_);
+  return getWorldObjectIdsToExclude();
+}
+
+void PlanningSceneMonitor::setSpatialIndexEnabled(bool enable)
+{
+  // diffs of the parent scene inherit its index
+  if (parent_scene_ && parent_scene_->getWorld()->isSpatialIndexEnabled() != enable)
+    parent_scene_->getWorldNonConst()->setSpatialIndexEnabled(enable);
+  if (scene_ && scene_->getWorld()->isSpatialIndexEnabled() != enable)
+    scene_->getWorldNonConst()->setSpatialIndexEnabled(enable);
+}
+
+void PlanningSceneMonitor::setOctomapExclusionRegion(const Eigen::AlignedBox3d& region)
+{
+  boost::unique_lock<boost::shared_mutex> ulock(scene_update_mutex_);
+  boost::recursive_mutex::scoped_lock _(shape_handles_lock_);
+  octomap_exclusion_region_ = region;
+  has_octomap_exclusion_region_ = true;
+  // the index is only maintained while the region queries need it
+  setSpatialIndexEnabled(true);
+  if (octomap_monitor_)
+    excludeWorldObjectsFromOctree();
+}
+
+void PlanningSceneMonitor::clearOctomapExclusionRegion()
+{
+  boost::unique_lock<boost::shared_mutex> ulock(scene_update_mutex_);
+  boost::recursive_mutex::scoped_lock _(shape_handles_lock_);
+  has_octomap_exclusion_region_ = false;
+  setSpatialIndexEnabled(false);
+  if (octomap_monitor_)
+    excludeWorldObjectsFromOctree();
+}
+
+bool PlanningSceneMonitor::hasOctomapExclusionRegion() const
+{
+  boost::recursive_mutex::scoped_lock _(shape_handles_lock_);
+  return has_octomap_exclusion_region_;
 }
 
 void PlanningSceneMonitor::excludeAttachedBodyFromOctree(const robot_state::AttachedBody* attached_body)
@@ -870,15 +1185,19 @@ void PlanningSceneMonitor::currentWorldObjectUpdateCallback(const collision_dete
   if (obj->id_ == planning_scene::PlanningScene::OCTOMAP_NS)
     return;
 
-  if (action & collision_detection::World::CREATE)
-    excludeWorldObjectFromOctree(obj);
-  else if (action & collision_detection::World::DESTROY)
-    includeWorldObjectInOctree(obj);
-  else
+  if (action & collision_detection::World::DESTROY)
   {
-    excludeWorldObjectFromOctree(obj);
     includeWorldObjectInOctree(obj);
+    return;
   }
+
+  // changed objects may have entered or left the exclusion region
+  boost::recursive_mutex::scoped_lock _(shape_handles_lock_);
+  if (!(action & collision_detection::World::CREATE))
+    includeWorldObjectInOctree(obj);
+  if (!has_octomap_exclusion_region_ ||
+      octomap_exclusion_region_.intersects(collision_detection::World::computeObjectAABB(*obj)))
+    excludeWorldObjectFromOctree(obj);
 }
 
 bool PlanningSceneMonitor::waitForCurrentRobotState(const rclcpp::Time& t, double wait_time)
@@ -979,6 +1298,9 @@ void PlanningSceneMonitor::startSceneMonitor(const std::string& scene_topic)
   {
     planning_scene_subscriber_ = node_->create_subscription<moveit_msgs::msg::PlanningScene>(
         scene_topic, std::bind(&PlanningSceneMonitor::newPlanningSceneCallback, this, std::placeholders::_1));
+    scene_sequence_subscriber_ = node_->create_subscription<std_msgs::msg::UInt64MultiArray>(
+        scene_topic + SEQUENCE_STAMP_TOPIC_SUFFIX,
+        std::bind(&PlanningSceneMonitor::newSceneSequenceStampCallback, this, std::placeholders::_1));
     RCLCPP_INFO(node_->get_logger(), "Listening to '%s'", planning_scene_subscriber_->get_topic_name());
   }
 }
@@ -989,6 +1311,7 @@ void PlanningSceneMonitor::stopSceneMonitor()
   {
     RCLCPP_INFO(node_->get_logger(), "Stopping planning scene monitor");
     planning_scene_subscriber_.reset();
+    scene_sequence_subscriber_.reset();
   }
 }
 
@@ -1239,6 +1562,7 @@ void PlanningSceneMonitor::octomapUpdateCallback()
   {
     boost::unique_lock<boost::shared_mutex> ulock(scene_update_mutex_);
     last_update_time_ = clock_.now();
+    ++octomap_update_count_;
     octomap_monitor_->getOcTreePtr()->lockRead();
     try
     {
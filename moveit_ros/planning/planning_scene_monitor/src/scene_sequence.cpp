@@ -0,0 +1,491 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_scene_monitor/scene_sequence.h>
+#include <moveit/planning_scene/planning_scene.h>
+#include <moveit_msgs/msg/planning_scene_components.hpp>
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+namespace planning_scene_monitor
+{
+namespace
+{
+typedef moveit_msgs::msg::PlanningSceneComponents Components;
+
+// FNV-1a over the values of all message fields; unlike std::hash, this is the same on all platforms
+class SceneMsgHasher
+{
+public:
+  SceneMsgHasher() : hash_(14695981039346656037ULL)
+  {
+  }
+
+  uint64_t getHash() const
+  {
+    return hash_;
+  }
+
+  void addByte(uint8_t byte)
+  {
+    hash_ ^= byte;
+    hash_ *= 1099511628211ULL;
+  }
+
+  void addInt(uint64_t value)
+  {
+    for (std::size_t i = 0; i < sizeof(value); ++i)
+      addByte(static_cast<uint8_t>(value >> (8 * i)));
+  }
+
+  void addReal(double value)
+  {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    addInt(bits);
+  }
+
+  void addString(const std::string& value)
+  {
+    addInt(value.size());
+    for (char c : value)
+      addByte(static_cast<uint8_t>(c));
+  }
+
+  template <typename T>
+  void addInts(const T& values)
+  {
+    addInt(values.size());
+    for (const auto& value : values)
+      addInt(static_cast<uint64_t>(value));
+  }
+
+  template <typename T>
+  void addReals(const T& values)
+  {
+    addInt(values.size());
+    for (const auto& value : values)
+      addReal(value);
+  }
+
+  template <typename T>
+  void addStrings(const T& values)
+  {
+    addInt(values.size());
+    for (const std::string& value : values)
+      addString(value);
+  }
+
+  template <typename T>
+  void addEach(const T& msgs)
+  {
+    addInt(msgs.size());
+    for (const auto& msg : msgs)
+      add(msg);
+  }
+
+  void add(const std_msgs::msg::Header& msg)
+  {
+    addInt(msg.stamp.sec);
+    addInt(msg.stamp.nanosec);
+    addString(msg.frame_id);
+  }
+
+  void add(const geometry_msgs::msg::Vector3& msg)
+  {
+    addReal(msg.x);
+    addReal(msg.y);
+    addReal(msg.z);
+  }
+
+  void add(const geometry_msgs::msg::Point& msg)
+  {
+    addReal(msg.x);
+    addReal(msg.y);
+    addReal(msg.z);
+  }
+
+  void add(const geometry_msgs::msg::Quaternion& msg)
+  {
+    addReal(msg.x);
+    addReal(msg.y);
+    addReal(msg.z);
+    addReal(msg.w);
+  }
+
+  void add(const geometry_msgs::msg::Pose& msg)
+  {
+    add(msg.position);
+    add(msg.orientation);
+  }
+
+  void add(const geometry_msgs::msg::Transform& msg)
+  {
+    add(msg.translation);
+    add(msg.rotation);
+  }
+
+  void add(const geometry_msgs::msg::TransformStamped& msg)
+  {
+    add(msg.header);
+    addString(msg.child_frame_id);
+    add(msg.transform);
+  }
+
+  void add(const geometry_msgs::msg::Twist& msg)
+  {
+    add(msg.linear);
+    add(msg.angular);
+  }
+
+  void add(const geometry_msgs::msg::Wrench& msg)
+  {
+    add(msg.force);
+    add(msg.torque);
+  }
+
+  void add(const shape_msgs::msg::SolidPrimitive& msg)
+  {
+    addInt(msg.type);
+    addReals(msg.dimensions);
+  }
+
+  void add(const shape_msgs::msg::MeshTriangle& msg)
+  {
+    addInts(msg.vertex_indices);
+  }
+
+  void add(const shape_msgs::msg::Mesh& msg)
+  {
+    addEach(msg.triangles);
+    addEach(msg.vertices);
+  }
+
+  void add(const shape_msgs::msg::Plane& msg)
+  {
+    addReals(msg.coef);
+  }
+
+  void add(const moveit_msgs::msg::CollisionObject& msg)
+  {
+    add(msg.header);
+    addString(msg.id);
+    addString(msg.type.key);
+    addString(msg.type.db);
+    addEach(msg.primitives);
+    addEach(msg.primitive_poses);
+    addEach(msg.meshes);
+    addEach(msg.mesh_poses);
+    addEach(msg.planes);
+    addEach(msg.plane_poses);
+    addInt(msg.operation);
+  }
+
+  void add(const trajectory_msgs::msg::JointTrajectoryPoint& msg)
+  {
+    addReals(msg.positions);
+    addReals(msg.velocities);
+    addReals(msg.accelerations);
+    addReals(msg.effort);
+    addInt(msg.time_from_start.sec);
+    addInt(msg.time_from_start.nanosec);
+  }
+
+  void add(const moveit_msgs::msg::AttachedCollisionObject& msg)
+  {
+    addString(msg.link_name);
+    add(msg.object);
+    addStrings(msg.touch_links);
+    add(msg.detach_posture.header);
+    addStrings(msg.detach_posture.joint_names);
+    addEach(msg.detach_posture.points);
+    addReal(msg.weight);
+  }
+
+  void add(const moveit_msgs::msg::RobotState& msg)
+  {
+    add(msg.joint_state.header);
+    addStrings(msg.joint_state.name);
+    addReals(msg.joint_state.position);
+    addReals(msg.joint_state.velocity);
+    addReals(msg.joint_state.effort);
+    add(msg.multi_dof_joint_state.header);
+    addStrings(msg.multi_dof_joint_state.joint_names);
+    addEach(msg.multi_dof_joint_state.transforms);
+    addEach(msg.multi_dof_joint_state.twist);
+    addEach(msg.multi_dof_joint_state.wrench);
+    addEach(msg.attached_collision_objects);
+    addInt(msg.is_diff);
+  }
+
+  void add(const moveit_msgs::msg::AllowedCollisionEntry& msg)
+  {
+    addInts(msg.enabled);
+  }
+
+  void add(const moveit_msgs::msg::LinkPadding& msg)
+  {
+    addString(msg.link_name);
+    addReal(msg.padding);
+  }
+
+  void add(const moveit_msgs::msg::LinkScale& msg)
+  {
+    addString(msg.link_name);
+    addReal(msg.scale);
+  }
+
+  void add(const moveit_msgs::msg::ObjectColor& msg)
+  {
+    addString(msg.id);
+    addReal(msg.color.r);
+    addReal(msg.color.g);
+    addReal(msg.color.b);
+    addReal(msg.color.a);
+  }
+
+  void add(const octomap_msgs::msg::OctomapWithPose& msg)
+  {
+    add(msg.header);
+    add(msg.origin);
+    add(msg.octomap.header);
+    addInt(msg.octomap.binary);
+    addString(msg.octomap.id);
+    addReal(msg.octomap.resolution);
+    addInt(msg.octomap.data.size());
+    for (int8_t byte : msg.octomap.data)
+      addByte(static_cast<uint8_t>(byte));
+  }
+
+  void add(const moveit_msgs::msg::PlanningScene& msg)
+  {
+    addString(msg.name);
+    add(msg.robot_state);
+    addString(msg.robot_model_name);
+    addEach(msg.fixed_frame_transforms);
+    addStrings(msg.allowed_collision_matrix.entry_names);
+    addEach(msg.allowed_collision_matrix.entry_values);
+    addStrings(msg.allowed_collision_matrix.default_entry_names);
+    addInts(msg.allowed_collision_matrix.default_entry_values);
+    addEach(msg.link_padding);
+    addEach(msg.link_scale);
+    addEach(msg.object_colors);
+    addEach(msg.world.collision_objects);
+    add(msg.world.octomap);
+    addInt(msg.is_diff);
+  }
+
+private:
+  uint64_t hash_;
+};
+}  // namespace
+
+const std::size_t SceneSequenceStamp::COMPONENT_COUNT;
+
+const std::array<uint32_t, SceneSequenceStamp::COMPONENT_COUNT> SceneSequenceStamp::COMPONENTS = { {
+    Components::SCENE_SETTINGS,
+    Components::ROBOT_STATE | Components::ROBOT_STATE_ATTACHED_OBJECTS,
+    Components::WORLD_OBJECT_NAMES | Components::WORLD_OBJECT_GEOMETRY,
+    Components::OCTOMAP,
+    Components::TRANSFORMS,
+    Components::ALLOWED_COLLISION_MATRIX,
+    Components::LINK_PADDING_AND_SCALING,
+    Components::OBJECT_COLORS,
+} };
+
+const uint32_t SceneSequenceStamp::ALL_COMPONENTS =
+    Components::SCENE_SETTINGS | Components::ROBOT_STATE | Components::ROBOT_STATE_ATTACHED_OBJECTS |
+    Components::WORLD_OBJECT_NAMES | Components::WORLD_OBJECT_GEOMETRY | Components::OCTOMAP | Components::TRANSFORMS |
+    Components::ALLOWED_COLLISION_MATRIX | Components::LINK_PADDING_AND_SCALING | Components::OBJECT_COLORS;
+
+uint64_t computeSceneMsgKey(const moveit_msgs::msg::PlanningScene& scene)
+{
+  SceneMsgHasher hasher;
+  hasher.add(scene);
+  return hasher.getHash();
+}
+
+uint32_t getSceneDiffComponents(const moveit_msgs::msg::PlanningScene& scene)
+{
+  uint32_t components = 0;
+  if (!scene.name.empty())
+    components |= Components::SCENE_SETTINGS;
+  if (!planning_scene::PlanningScene::isEmpty(scene.robot_state))
+    components |= Components::ROBOT_STATE | Components::ROBOT_STATE_ATTACHED_OBJECTS;
+  if (!scene.world.collision_objects.empty())
+    components |= Components::WORLD_OBJECT_NAMES | Components::WORLD_OBJECT_GEOMETRY;
+  if (!scene.world.octomap.octomap.data.empty())
+    components |= Components::OCTOMAP;
+  if (!scene.fixed_frame_transforms.empty())
+    components |= Components::TRANSFORMS;
+  if (!scene.allowed_collision_matrix.entry_names.empty())
+    components |= Components::ALLOWED_COLLISION_MATRIX;
+  if (!scene.link_padding.empty() || !scene.link_scale.empty())
+    components |= Components::LINK_PADDING_AND_SCALING;
+  if (!scene.object_colors.empty())
+    components |= Components::OBJECT_COLORS;
+  return components;
+}
+
+void sceneSequenceStampToMsg(const SceneSequenceStamp& stamp, std_msgs::msg::UInt64MultiArray& msg)
+{
+  msg.data.clear();
+  msg.data.reserve(4 + stamp.versions.size());
+  msg.data.push_back(stamp.key);
+  msg.data.push_back(stamp.is_diff ? 1 : 0);
+  msg.data.push_back(stamp.session);
+  msg.data.push_back(stamp.sequence);
+  msg.data.insert(msg.data.end(), stamp.versions.begin(), stamp.versions.end());
+}
+
+bool sceneSequenceStampFromMsg(const std_msgs::msg::UInt64MultiArray& msg, SceneSequenceStamp& stamp)
+{
+  if (msg.data.size() < 4 || msg.data[1] > 1)
+    return false;
+  stamp.key = msg.data[0];
+  stamp.is_diff = msg.data[1] == 1;
+  stamp.session = msg.data[2];
+  stamp.sequence = msg.data[3];
+  stamp.versions.assign(msg.data.begin() + 4, msg.data.end());
+  return true;
+}
+
+SceneSequenceStamper::SceneSequenceStamper() : session_(0), sequence_(0)
+{
+  versions_.fill(0);
+}
+
+void SceneSequenceStamper::startSession()
+{
+  std::random_device random;
+  do
+    session_ = (static_cast<uint64_t>(random()) << 32) | random();
+  while (session_ == 0);
+  sequence_ = 0;
+  versions_.fill(0);
+}
+
+void SceneSequenceStamper::stopSession()
+{
+  session_ = 0;
+}
+
+SceneSequenceStamp SceneSequenceStamper::stamp(const moveit_msgs::msg::PlanningScene& scene)
+{
+  SceneSequenceStamp stamp;
+  stamp.key = computeSceneMsgKey(scene);
+  stamp.is_diff = scene.is_diff;
+  stamp.session = session_;
+  stamp.sequence = ++sequence_;
+  uint32_t changed = SceneSequenceStamp::ALL_COMPONENTS;
+  if (scene.is_diff)
+  {
+    stamp.versions.assign(versions_.begin(), versions_.end());
+    changed = getSceneDiffComponents(scene);
+  }
+  for (std::size_t i = 0; i < SceneSequenceStamp::COMPONENT_COUNT; ++i)
+    if (changed & SceneSequenceStamp::COMPONENTS[i])
+      versions_[i] = stamp.sequence;
+  return stamp;
+}
+
+SceneSequenceStamp SceneSequenceStamper::stampCurrent(const moveit_msgs::msg::PlanningScene& scene) const
+{
+  SceneSequenceStamp stamp;
+  stamp.key = computeSceneMsgKey(scene);
+  stamp.session = session_;
+  stamp.sequence = sequence_;
+  return stamp;
+}
+
+SceneSequenceTracker::SceneSequenceTracker(std::size_t capacity) : capacity_(capacity), session_(0), sequence_(0)
+{
+}
+
+bool SceneSequenceTracker::sceneReceived(uint64_t key, uint32_t& resync_components)
+{
+  for (std::deque<SceneSequenceStamp>::iterator it = unmatched_stamps_.begin(); it != unmatched_stamps_.end(); ++it)
+    if (it->key == key)
+    {
+      SceneSequenceStamp stamp = *it;
+      unmatched_stamps_.erase(it);
+      return apply(stamp, resync_components);
+    }
+
+  unmatched_keys_.push_back(key);
+  if (unmatched_keys_.size() > capacity_)
+    unmatched_keys_.pop_front();
+  return true;
+}
+
+void SceneSequenceTracker::stampReceived(const SceneSequenceStamp& stamp, uint32_t& resync_components)
+{
+  std::deque<uint64_t>::iterator it = std::find(unmatched_keys_.begin(), unmatched_keys_.end(), stamp.key);
+  if (it != unmatched_keys_.end())
+  {
+    // the message was applied already
+    unmatched_keys_.erase(it);
+    apply(stamp, resync_components);
+    return;
+  }
+
+  unmatched_stamps_.push_back(stamp);
+  if (unmatched_stamps_.size() > capacity_)
+    unmatched_stamps_.pop_front();
+}
+
+bool SceneSequenceTracker::apply(const SceneSequenceStamp& stamp, uint32_t& resync_components)
+{
+  bool same_session = stamp.session == session_;
+  if (stamp.is_diff)
+  {
+    if (same_session && stamp.sequence <= sequence_)
+      return false;
+    // request the components changed by the missed diffs
+    if (!same_session || stamp.versions.size() != SceneSequenceStamp::COMPONENT_COUNT)
+      resync_components |= SceneSequenceStamp::ALL_COMPONENTS;
+    else if (stamp.sequence > sequence_ + 1)
+      for (std::size_t i = 0; i < SceneSequenceStamp::COMPONENT_COUNT; ++i)
+        if (stamp.versions[i] > sequence_)
+          resync_components |= SceneSequenceStamp::COMPONENTS[i];
+  }
+  if (!same_session || stamp.sequence > sequence_)
+  {
+    session_ = stamp.session;
+    sequence_ = stamp.sequence;
+  }
+  return true;
+}
+}
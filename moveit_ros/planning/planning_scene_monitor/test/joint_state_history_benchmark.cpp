@@ -0,0 +1,124 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+/* Benchmark of recording joint states at 1 kHz in a JointStateHistory while other threads look up states in it */
+
+#include <moveit/planning_scene_monitor/joint_state_history.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <gtest/gtest.h>
+
+// one joint state every millisecond
+const int64_t PERIOD = 1000000;
+
+// A chain of \e dofs continuous joints
+robot_model::RobotModelPtr createChainModel(unsigned int dofs)
+{
+  moveit::core::RobotModelBuilder builder("chain", "link0");
+  std::string chain = "link0";
+  for (unsigned int i = 1; i <= dofs; ++i)
+    chain += "->link" + std::to_string(i);
+  builder.addChain(chain, "continuous");
+  return builder.build();
+}
+
+void benchmarkHistory(unsigned int dofs, std::size_t capacity, unsigned int readers, unsigned int messages)
+{
+  robot_model::RobotModelPtr model = createChainModel(dofs);
+  ASSERT_TRUE(bool(model));
+  planning_scene_monitor::JointStateHistory history(model, capacity);
+  std::vector<double> positions(model->getVariableCount());
+
+  std::atomic<bool> done(false);
+  std::atomic<unsigned long> lookups(0), hits(0);
+  std::vector<std::thread> threads;
+  for (unsigned int r = 0; r < readers; ++r)
+    threads.emplace_back([&history, &done, &lookups, &hits, &model, r] {
+      std::mt19937 gen(r);
+      std::vector<double> result(model->getVariableCount());
+      while (!done)
+      {
+        int64_t oldest, newest;
+        if (!history.getTimeSpan(oldest, newest) || oldest == newest)
+          continue;
+        std::uniform_int_distribution<int64_t> dist(oldest, newest);
+        if (history.getPositionsAtTime(dist(gen), result.data()))
+          ++hits;
+        ++lookups;
+      }
+    });
+
+  // the callback is timed back-to-back; the stamps advance as if messages arrived at 1 kHz
+  std::chrono::duration<double> worst(0);
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < messages; ++i)
+  {
+    for (std::size_t j = 0; j < positions.size(); ++j)
+      positions[j] = std::sin(1e-3 * i + j);
+    auto add_start = std::chrono::steady_clock::now();
+    history.add(int64_t(i) * PERIOD, positions.data());
+    worst = std::max<std::chrono::duration<double>>(worst, std::chrono::steady_clock::now() - add_start);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  done = true;
+  for (std::thread& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(history.size(), std::min<std::size_t>(capacity, messages));
+  std::cerr << dofs << " dofs, " << capacity << " entries, " << readers << " readers: add "
+            << 1e9 * elapsed.count() / messages << "ns on average (" << 1e2 * elapsed.count() / messages / 1e-3
+            << "% of a 1 kHz period), worst " << 1e9 * worst.count() << "ns; " << lookups << " lookups (" << hits
+            << " in range) during " << 1e3 * elapsed.count() << "ms" << std::endl;
+}
+
+TEST(JointStateHistoryTiming, Arm)
+{
+  benchmarkHistory(7, 1000, 0, 1000000);
+  benchmarkHistory(7, 1000, 2, 1000000);
+}
+
+TEST(JointStateHistoryTiming, Humanoid)
+{
+  benchmarkHistory(40, 1000, 0, 1000000);
+  benchmarkHistory(40, 1000, 4, 1000000);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,176 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_scene_monitor/joint_state_history.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+
+class JointStateHistoryTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    moveit::core::RobotModelBuilder builder("chain", "link0");
+    builder.addChain("link0->link1->link2", "revolute");
+    robot_model_ = builder.build();
+    ASSERT_TRUE(bool(robot_model_));
+    ASSERT_EQ(robot_model_->getVariableCount(), 2u);
+  }
+
+  // record positions { value, -value } at \e stamp
+  bool add(planning_scene_monitor::JointStateHistory& history, int64_t stamp, double value)
+  {
+    const double positions[] = { value, -value };
+    return history.add(stamp, positions);
+  }
+
+  robot_model::RobotModelPtr robot_model_;
+  double positions_[2];
+};
+
+TEST_F(JointStateHistoryTest, Interpolation)
+{
+  planning_scene_monitor::JointStateHistory history(robot_model_, 10);
+  EXPECT_TRUE(history.empty());
+  EXPECT_FALSE(history.getPositionsAtTime(0, positions_));
+
+  ASSERT_TRUE(add(history, 100, 0.0));
+  ASSERT_TRUE(add(history, 200, 1.0));
+  ASSERT_TRUE(add(history, 400, 0.5));
+  EXPECT_EQ(history.size(), 3u);
+
+  int64_t oldest, newest;
+  ASSERT_TRUE(history.getTimeSpan(oldest, newest));
+  EXPECT_EQ(oldest, 100);
+  EXPECT_EQ(newest, 400);
+
+  ASSERT_TRUE(history.getPositionsAtTime(125, positions_));
+  EXPECT_DOUBLE_EQ(positions_[0], 0.25);
+  EXPECT_DOUBLE_EQ(positions_[1], -0.25);
+  ASSERT_TRUE(history.getPositionsAtTime(300, positions_));
+  EXPECT_DOUBLE_EQ(positions_[0], 0.75);
+  EXPECT_DOUBLE_EQ(positions_[1], -0.75);
+
+  // recorded stamps and the bounds of the span are returned exactly
+  ASSERT_TRUE(history.getPositionsAtTime(200, positions_));
+  EXPECT_EQ(positions_[0], 1.0);
+  ASSERT_TRUE(history.getPositionsAtTime(100, positions_));
+  EXPECT_EQ(positions_[0], 0.0);
+  ASSERT_TRUE(history.getPositionsAtTime(400, positions_));
+  EXPECT_EQ(positions_[0], 0.5);
+
+  EXPECT_FALSE(history.getPositionsAtTime(99, positions_));
+  EXPECT_FALSE(history.getPositionsAtTime(401, positions_));
+
+  // other values of the state are kept
+  robot_state::RobotState state(robot_model_);
+  state.setToDefaultValues();
+  state.setVariableVelocity(0, 3.0);
+  ASSERT_TRUE(history.getStateAtTime(rclcpp::Time(0, 150), state));
+  EXPECT_DOUBLE_EQ(state.getVariablePosition(0), 0.5);
+  EXPECT_DOUBLE_EQ(state.getVariablePosition(1), -0.5);
+  EXPECT_EQ(state.getVariableVelocity(0), 3.0);
+  EXPECT_FALSE(history.getStateAtTime(rclcpp::Time(0, 500), state));
+  EXPECT_DOUBLE_EQ(state.getVariablePosition(0), 0.5);
+}
+
+TEST_F(JointStateHistoryTest, RingWrapAround)
+{
+  planning_scene_monitor::JointStateHistory history(robot_model_, 4);
+  EXPECT_EQ(history.getCapacity(), 4u);
+  for (int i = 0; i < 10; ++i)
+  {
+    ASSERT_TRUE(add(history, i * 10, i));
+    EXPECT_EQ(history.size(), static_cast<std::size_t>(std::min(i + 1, 4)));
+  }
+
+  // only the newest entries are kept
+  int64_t oldest, newest;
+  ASSERT_TRUE(history.getTimeSpan(oldest, newest));
+  EXPECT_EQ(oldest, 60);
+  EXPECT_EQ(newest, 90);
+  EXPECT_FALSE(history.getPositionsAtTime(55, positions_));
+  ASSERT_TRUE(history.getPositionsAtTime(75, positions_));
+  EXPECT_DOUBLE_EQ(positions_[0], 7.5);
+  ASSERT_TRUE(history.getPositionsAtTime(60, positions_));
+  EXPECT_DOUBLE_EQ(positions_[0], 6.0);
+
+  // the minimal capacity is 2
+  EXPECT_EQ(planning_scene_monitor::JointStateHistory(robot_model_, 0).getCapacity(), 2u);
+}
+
+TEST_F(JointStateHistoryTest, RejectsOutOfOrderStamps)
+{
+  planning_scene_monitor::JointStateHistory history(robot_model_, 10);
+  ASSERT_TRUE(add(history, 100, 1.0));
+  EXPECT_FALSE(add(history, 50, 2.0));
+  EXPECT_EQ(history.size(), 1u);
+  ASSERT_TRUE(history.getPositionsAtTime(100, positions_));
+  EXPECT_EQ(positions_[0], 1.0);
+
+  // equal stamps are accepted, the newer entry is found first
+  EXPECT_TRUE(add(history, 100, 3.0));
+  EXPECT_EQ(history.size(), 2u);
+  ASSERT_TRUE(history.getPositionsAtTime(100, positions_));
+  EXPECT_EQ(positions_[0], 3.0);
+}
+
+TEST_F(JointStateHistoryTest, Clear)
+{
+  planning_scene_monitor::JointStateHistory history(robot_model_, 4);
+  for (int i = 0; i < 6; ++i)
+    ASSERT_TRUE(add(history, 100 + i, i));
+  history.clear();
+  EXPECT_TRUE(history.empty());
+  int64_t oldest, newest;
+  EXPECT_FALSE(history.getTimeSpan(oldest, newest));
+  EXPECT_FALSE(history.getPositionsAtTime(105, positions_));
+
+  // after a clear, the history can start over at an earlier time
+  ASSERT_TRUE(add(history, 10, 1.0));
+  ASSERT_TRUE(add(history, 20, 2.0));
+  EXPECT_EQ(history.size(), 2u);
+  ASSERT_TRUE(history.getTimeSpan(oldest, newest));
+  EXPECT_EQ(oldest, 10);
+  EXPECT_EQ(newest, 20);
+  ASSERT_TRUE(history.getPositionsAtTime(15, positions_));
+  EXPECT_DOUBLE_EQ(positions_[0], 1.5);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,245 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_scene_monitor/planning_scene_monitor.h>
+#include <moveit_msgs/msg/planning_scene_components.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+static const std::string URDF = R"(<?xml version="1.0"?>
+<robot name="one_link">
+  <link name="base_link">
+    <collision>
+      <geometry>
+        <box size="0.1 0.1 0.1"/>
+      </geometry>
+    </collision>
+  </link>
+</robot>)";
+
+static const std::string SRDF = R"(<?xml version="1.0"?>
+<robot name="one_link">
+</robot>)";
+
+class PlanningSceneMonitorTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    node_ = std::make_shared<rclcpp::Node>("planning_scene_monitor_test");
+    robot_model_loader::RobotModelLoader::Options opt(URDF, SRDF);
+    opt.load_kinematics_solvers_ = false;
+    psm_ = std::make_shared<planning_scene_monitor::PlanningSceneMonitor>(
+        std::make_shared<robot_model_loader::RobotModelLoader>(node_, opt), node_);
+    ASSERT_TRUE(bool(psm_->getPlanningScene()));
+  }
+
+  void TearDown() override
+  {
+    psm_.reset();
+    node_.reset();
+  }
+
+  std::shared_ptr<rclcpp::Node> node_;
+  planning_scene_monitor::PlanningSceneMonitorPtr psm_;
+};
+
+// A diff adding a box \e id at \e x along the x axis
+static moveit_msgs::msg::PlanningScene makeObjectDiff(const std::string& id, double x = 0.0)
+{
+  moveit_msgs::msg::PlanningScene scene;
+  scene.is_diff = true;
+  scene.robot_state.is_diff = true;
+  moveit_msgs::msg::CollisionObject object;
+  object.header.frame_id = "base_link";
+  object.id = id;
+  object.primitives.resize(1);
+  object.primitives[0].type = shape_msgs::msg::SolidPrimitive::BOX;
+  object.primitives[0].dimensions = { 0.1, 0.1, 0.1 };
+  object.primitive_poses.resize(1);
+  object.primitive_poses[0].position.x = x;
+  object.primitive_poses[0].orientation.w = 1.0;
+  object.operation = moveit_msgs::msg::CollisionObject::ADD;
+  scene.world.collision_objects.push_back(object);
+  return scene;
+}
+
+TEST_F(PlanningSceneMonitorTest, OctomapExclusionRegion)
+{
+  ASSERT_TRUE(psm_->newPlanningSceneMessage(makeObjectDiff("b1", 0.5)));
+  ASSERT_TRUE(psm_->newPlanningSceneMessage(makeObjectDiff("b2", 5.0)));
+  const std::vector<std::string> all = { "b1", "b2" };
+
+  // all world objects are excluded by default, without a spatial index
+  EXPECT_FALSE(psm_->hasOctomapExclusionRegion());
+  EXPECT_FALSE(psm_->getPlanningScene()->getWorld()->isSpatialIndexEnabled());
+  EXPECT_EQ(psm_->getWorldObjectsExcludedFromOctree(), all);
+
+  // a region unbounded along one axis still limits the excluded objects
+  const double inf = std::numeric_limits<double>::infinity();
+  Eigen::AlignedBox3d region(Eigen::Vector3d(-1.0, -1.0, -inf), Eigen::Vector3d(1.0, 1.0, inf));
+  psm_->setOctomapExclusionRegion(region);
+  EXPECT_TRUE(psm_->hasOctomapExclusionRegion());
+  EXPECT_EQ(psm_->getOctomapExclusionRegion().min(), region.min());
+  EXPECT_EQ(psm_->getOctomapExclusionRegion().max(), region.max());
+  EXPECT_TRUE(psm_->getPlanningScene()->getWorld()->isSpatialIndexEnabled());
+  EXPECT_EQ(psm_->getWorldObjectsExcludedFromOctree(), std::vector<std::string>({ "b1" }));
+
+  // objects are excluded while they intersect the region
+  ASSERT_TRUE(psm_->newPlanningSceneMessage(makeObjectDiff("b2", 1.02)));
+  EXPECT_EQ(psm_->getWorldObjectsExcludedFromOctree(), all);
+  ASSERT_TRUE(psm_->newPlanningSceneMessage(makeObjectDiff("b1", -1.2)));
+  EXPECT_EQ(psm_->getWorldObjectsExcludedFromOctree(), std::vector<std::string>({ "b2" }));
+
+  psm_->clearOctomapExclusionRegion();
+  EXPECT_FALSE(psm_->hasOctomapExclusionRegion());
+  EXPECT_FALSE(psm_->getPlanningScene()->getWorld()->isSpatialIndexEnabled());
+  EXPECT_EQ(psm_->getWorldObjectsExcludedFromOctree(), all);
+
+  // even an unbounded region counts as set
+  region = Eigen::AlignedBox3d(Eigen::Vector3d::Constant(-inf), Eigen::Vector3d::Constant(inf));
+  psm_->setOctomapExclusionRegion(region);
+  EXPECT_TRUE(psm_->hasOctomapExclusionRegion());
+  EXPECT_EQ(psm_->getWorldObjectsExcludedFromOctree(), all);
+}
+
+TEST_F(PlanningSceneMonitorTest, ResyncMissedDiffs)
+{
+  // the publishing side: a scene with boxes b2 and b3, after b1 was removed
+  std::shared_ptr<rclcpp::Node> server_node = std::make_shared<rclcpp::Node>("planning_scene_monitor_test_server");
+  planning_scene::PlanningScene published(psm_->getRobotModel());
+  published.setName("published");
+  published.processPlanningSceneWorldMsg(makeObjectDiff("b2").world);
+  published.processPlanningSceneWorldMsg(makeObjectDiff("b3").world);
+  std::atomic<uint32_t> requested_components(0);
+  auto service = server_node->create_service<moveit_msgs::srv::GetPlanningScene>(
+      planning_scene_monitor::PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_SERVICE,
+      [&](const std::shared_ptr<rmw_request_id_t> /*request_header*/,
+          const std::shared_ptr<moveit_msgs::srv::GetPlanningScene::Request> request,
+          const std::shared_ptr<moveit_msgs::srv::GetPlanningScene::Response> response) {
+        requested_components = request->components.components;
+        published.getPlanningSceneMsg(response->scene, request->components);
+      });
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node_);
+  executor.add_node(server_node);
+  std::thread spinner([&executor] { executor.spin(); });
+  auto client = node_->create_client<moveit_msgs::srv::GetPlanningScene>(
+      planning_scene_monitor::PlanningSceneMonitor::DEFAULT_PLANNING_SCENE_SERVICE);
+  ASSERT_TRUE(client->wait_for_service(std::chrono::seconds(5)));
+
+  planning_scene_monitor::SceneSequenceStamper stamper;
+  stamper.startSession();
+  auto deliver = [&](const moveit_msgs::msg::PlanningScene& scene) {
+    psm_->newSceneSequenceStamp(stamper.stamp(scene));
+    psm_->newPlanningSceneMessage(scene);
+  };
+
+  // messages received in order are applied unchanged
+  moveit_msgs::msg::PlanningScene full;
+  planning_scene::PlanningScene(psm_->getRobotModel()).getPlanningSceneMsg(full);
+  full.name = "published";
+  deliver(full);
+  deliver(makeObjectDiff("b1"));
+  EXPECT_EQ(psm_->getPlanningScene()->getName(), "published");
+  EXPECT_TRUE(psm_->getPlanningScene()->getWorld()->hasObject("b1"));
+
+  // only the stamp of the diff adding b2 arrives, the next diff reveals the gap
+  psm_->newSceneSequenceStamp(stamper.stamp(makeObjectDiff("b2")));
+  EXPECT_EQ(requested_components.load(), 0u);
+  deliver(makeObjectDiff("b3"));
+
+  // the world is requested and replaces the one of the monitor
+  bool synced = false;
+  for (int i = 0; i < 100 && !synced; ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    planning_scene_monitor::LockedPlanningSceneRO scene(psm_);
+    synced = scene->getWorld()->hasObject("b2") && !scene->getWorld()->hasObject("b1");
+  }
+  EXPECT_TRUE(synced);
+  EXPECT_EQ(requested_components.load(), moveit_msgs::msg::PlanningSceneComponents::WORLD_OBJECT_NAMES |
+                                      moveit_msgs::msg::PlanningSceneComponents::WORLD_OBJECT_GEOMETRY);
+  EXPECT_TRUE(psm_->getPlanningScene()->getWorld()->hasObject("b3"));
+  EXPECT_EQ(psm_->getPlanningScene()->getName(), "published");
+
+  executor.cancel();
+  spinner.join();
+}
+
+TEST_F(PlanningSceneMonitorTest, SceneSnapshots)
+{
+  // snapshots are only taken once started
+  EXPECT_FALSE(bool(psm_->getPlanningSceneSnapshot()));
+  psm_->startSceneSnapshots();
+  planning_scene::PlanningSceneConstPtr first = psm_->getPlanningSceneSnapshot();
+  ASSERT_TRUE(bool(first));
+  EXPECT_NE(first.get(), psm_->getPlanningScene().get());
+  EXPECT_FALSE(first->getWorld()->hasObject("b1"));
+
+  // a later snapshot contains the diff, the one held before is not changed
+  ASSERT_TRUE(psm_->newPlanningSceneMessage(makeObjectDiff("b1")));
+  planning_scene::PlanningSceneConstPtr second;
+  for (int i = 0; i < 100 && !(second && second->getWorld()->hasObject("b1")); ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    second = psm_->getPlanningSceneSnapshot();
+  }
+  ASSERT_TRUE(bool(second));
+  EXPECT_TRUE(second->getWorld()->hasObject("b1"));
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_FALSE(first->getWorld()->hasObject("b1"));
+
+  // snapshots are independent of the monitored scene
+  ASSERT_TRUE(psm_->newPlanningSceneMessage(makeObjectDiff("b2")));
+  EXPECT_TRUE(psm_->getPlanningScene()->getWorld()->hasObject("b2"));
+  EXPECT_FALSE(second->getWorld()->hasObject("b2"));
+
+  psm_->stopSceneSnapshots();
+  EXPECT_FALSE(bool(psm_->getPlanningSceneSnapshot()));
+  EXPECT_TRUE(second->getWorld()->hasObject("b1"));
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  int result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
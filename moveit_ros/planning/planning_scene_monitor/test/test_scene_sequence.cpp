@@ -0,0 +1,253 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/planning_scene_monitor/scene_sequence.h>
+#include <moveit_msgs/msg/planning_scene_components.hpp>
+#include <gtest/gtest.h>
+
+using namespace planning_scene_monitor;
+typedef moveit_msgs::msg::PlanningSceneComponents Components;
+
+static const uint32_t WORLD_COMPONENTS = Components::WORLD_OBJECT_NAMES | Components::WORLD_OBJECT_GEOMETRY;
+static const uint32_t STATE_COMPONENTS = Components::ROBOT_STATE | Components::ROBOT_STATE_ATTACHED_OBJECTS;
+
+static moveit_msgs::msg::PlanningScene makeFullScene()
+{
+  moveit_msgs::msg::PlanningScene scene;
+  scene.name = "scene";
+  scene.robot_model_name = "robot";
+  return scene;
+}
+
+// A diff adding a box \e id at \e x
+static moveit_msgs::msg::PlanningScene makeObjectDiff(const std::string& id, double x)
+{
+  moveit_msgs::msg::PlanningScene scene;
+  scene.is_diff = true;
+  scene.robot_state.is_diff = true;
+  moveit_msgs::msg::CollisionObject object;
+  object.header.frame_id = "base_link";
+  object.id = id;
+  object.primitives.resize(1);
+  object.primitives[0].type = shape_msgs::msg::SolidPrimitive::BOX;
+  object.primitives[0].dimensions = { 0.1, 0.1, 0.1 };
+  object.primitive_poses.resize(1);
+  object.primitive_poses[0].position.x = x;
+  object.primitive_poses[0].orientation.w = 1.0;
+  object.operation = moveit_msgs::msg::CollisionObject::ADD;
+  scene.world.collision_objects.push_back(object);
+  return scene;
+}
+
+// A diff setting the position of \e joint
+static moveit_msgs::msg::PlanningScene makeStateDiff(const std::string& joint, double position)
+{
+  moveit_msgs::msg::PlanningScene scene;
+  scene.is_diff = true;
+  scene.robot_state.is_diff = true;
+  scene.robot_state.joint_state.name.push_back(joint);
+  scene.robot_state.joint_state.position.push_back(position);
+  return scene;
+}
+
+TEST(SceneSequence, MessageKey)
+{
+  EXPECT_EQ(computeSceneMsgKey(makeObjectDiff("box", 1.0)), computeSceneMsgKey(makeObjectDiff("box", 1.0)));
+  EXPECT_NE(computeSceneMsgKey(makeObjectDiff("box", 1.0)), computeSceneMsgKey(makeObjectDiff("box", 2.0)));
+  EXPECT_NE(computeSceneMsgKey(makeObjectDiff("box", 1.0)), computeSceneMsgKey(makeObjectDiff("cube", 1.0)));
+  EXPECT_NE(computeSceneMsgKey(makeStateDiff("joint", 0.5)), computeSceneMsgKey(makeStateDiff("joint", 0.25)));
+
+  moveit_msgs::msg::PlanningScene renamed = makeFullScene();
+  renamed.name = "other";
+  EXPECT_NE(computeSceneMsgKey(makeFullScene()), computeSceneMsgKey(renamed));
+}
+
+TEST(SceneSequence, StampMsgRoundTrip)
+{
+  SceneSequenceStamper stamper;
+  stamper.startSession();
+  stamper.stamp(makeFullScene());
+  SceneSequenceStamp stamp = stamper.stamp(makeObjectDiff("box", 1.0));
+  ASSERT_EQ(stamp.versions.size(), SceneSequenceStamp::COMPONENT_COUNT);
+
+  std_msgs::msg::UInt64MultiArray msg;
+  sceneSequenceStampToMsg(stamp, msg);
+  SceneSequenceStamp parsed;
+  ASSERT_TRUE(sceneSequenceStampFromMsg(msg, parsed));
+  EXPECT_EQ(parsed.key, stamp.key);
+  EXPECT_TRUE(parsed.is_diff);
+  EXPECT_EQ(parsed.session, stamp.session);
+  EXPECT_EQ(parsed.sequence, 2u);
+  EXPECT_EQ(parsed.versions, stamp.versions);
+
+  msg.data.resize(3);
+  EXPECT_FALSE(sceneSequenceStampFromMsg(msg, parsed));
+}
+
+TEST(SceneSequence, InOrderDelivery)
+{
+  SceneSequenceStamper stamper;
+  stamper.startSession();
+  SceneSequenceTracker tracker;
+  std::vector<moveit_msgs::msg::PlanningScene> scenes = { makeFullScene(), makeObjectDiff("box", 1.0),
+                                                          makeStateDiff("joint", 0.5), makeObjectDiff("box", 2.0) };
+  uint32_t resync = 0;
+  for (std::size_t i = 0; i < scenes.size(); ++i)
+  {
+    SceneSequenceStamp stamp = stamper.stamp(scenes[i]);
+    // stamps are published before their messages, but either can arrive first
+    if (i % 2 == 0)
+    {
+      tracker.stampReceived(stamp, resync);
+      EXPECT_TRUE(tracker.sceneReceived(computeSceneMsgKey(scenes[i]), resync));
+    }
+    else
+    {
+      EXPECT_TRUE(tracker.sceneReceived(computeSceneMsgKey(scenes[i]), resync));
+      tracker.stampReceived(stamp, resync);
+    }
+    EXPECT_EQ(tracker.getSession(), stamp.session);
+    EXPECT_EQ(tracker.getSequence(), i + 1);
+  }
+  EXPECT_EQ(resync, 0u);
+}
+
+TEST(SceneSequence, DroppedDiffTriggersResync)
+{
+  SceneSequenceStamper stamper;
+  stamper.startSession();
+  SceneSequenceTracker tracker;
+  uint32_t resync = 0;
+  auto deliver = [&](const moveit_msgs::msg::PlanningScene& scene) {
+    tracker.stampReceived(stamper.stamp(scene), resync);
+    return tracker.sceneReceived(computeSceneMsgKey(scene), resync);
+  };
+  EXPECT_TRUE(deliver(makeFullScene()));
+  EXPECT_TRUE(deliver(makeObjectDiff("box", 1.0)));
+  EXPECT_EQ(resync, 0u);
+
+  // only the stamp of a diff changing the world arrives
+  tracker.stampReceived(stamper.stamp(makeObjectDiff("box", 2.0)), resync);
+  EXPECT_EQ(resync, 0u);
+
+  // the next diff reveals the gap; only the world needs to be requested, it is the only component that changed
+  EXPECT_TRUE(deliver(makeStateDiff("joint", 0.5)));
+  EXPECT_EQ(resync, WORLD_COMPONENTS);
+  EXPECT_EQ(tracker.getSequence(), 4u);
+
+  // a missed diff changing the state and then the world
+  resync = 0;
+  stamper.stamp(makeStateDiff("joint", 0.25));
+  stamper.stamp(makeObjectDiff("box", 3.0));
+  EXPECT_TRUE(deliver(makeStateDiff("joint", 0.75)));
+  EXPECT_EQ(resync, WORLD_COMPONENTS | STATE_COMPONENTS);
+  EXPECT_EQ(tracker.getSequence(), 7u);
+}
+
+TEST(SceneSequence, DiffContainedInResyncIsIgnored)
+{
+  SceneSequenceStamper stamper;
+  stamper.startSession();
+  SceneSequenceTracker tracker;
+  uint32_t resync = 0;
+  moveit_msgs::msg::PlanningScene full = makeFullScene();
+  tracker.stampReceived(stamper.stamp(full), resync);
+  EXPECT_TRUE(tracker.sceneReceived(computeSceneMsgKey(full), resync));
+
+  // a GetPlanningScene response already contains the next diff
+  moveit_msgs::msg::PlanningScene diff = makeObjectDiff("box", 1.0);
+  SceneSequenceStamp diff_stamp = stamper.stamp(diff);
+  moveit_msgs::msg::PlanningScene response = makeFullScene();
+  response.world = diff.world;
+  tracker.stampReceived(stamper.stampCurrent(response), resync);
+  EXPECT_TRUE(tracker.sceneReceived(computeSceneMsgKey(response), resync));
+  EXPECT_EQ(tracker.getSequence(), 2u);
+
+  tracker.stampReceived(diff_stamp, resync);
+  EXPECT_FALSE(tracker.sceneReceived(computeSceneMsgKey(diff), resync));
+  EXPECT_EQ(resync, 0u);
+}
+
+TEST(SceneSequence, SessionRestart)
+{
+  SceneSequenceStamper stamper;
+  stamper.startSession();
+  SceneSequenceTracker tracker;
+  uint32_t resync = 0;
+  auto deliver = [&](const moveit_msgs::msg::PlanningScene& scene) {
+    tracker.stampReceived(stamper.stamp(scene), resync);
+    return tracker.sceneReceived(computeSceneMsgKey(scene), resync);
+  };
+  deliver(makeFullScene());
+  deliver(makeObjectDiff("box", 1.0));
+  deliver(makeObjectDiff("box", 2.0));
+  uint64_t old_session = tracker.getSession();
+
+  // a restarted publisher starts with the full scene, so nothing was missed although the sequence restarts
+  stamper.startSession();
+  EXPECT_TRUE(deliver(makeFullScene()));
+  EXPECT_NE(tracker.getSession(), old_session);
+  EXPECT_EQ(tracker.getSequence(), 1u);
+  EXPECT_TRUE(deliver(makeObjectDiff("box", 1.0)));
+  EXPECT_EQ(resync, 0u);
+
+  // if the full scene of the new session is missed, the complete scene is requested
+  stamper.startSession();
+  stamper.stamp(makeFullScene());
+  EXPECT_TRUE(deliver(makeStateDiff("joint", 0.5)));
+  EXPECT_EQ(resync, SceneSequenceStamp::ALL_COMPONENTS);
+}
+
+TEST(SceneSequence, UnmatchedCapacity)
+{
+  SceneSequenceStamper stamper;
+  stamper.startSession();
+  SceneSequenceTracker tracker(2);
+  uint32_t resync = 0;
+
+  // the stamp of the first message is forgotten by the time the message arrives
+  moveit_msgs::msg::PlanningScene full = makeFullScene();
+  tracker.stampReceived(stamper.stamp(full), resync);
+  tracker.stampReceived(stamper.stamp(makeObjectDiff("box", 1.0)), resync);
+  tracker.stampReceived(stamper.stamp(makeObjectDiff("box", 2.0)), resync);
+  EXPECT_TRUE(tracker.sceneReceived(computeSceneMsgKey(full), resync));
+  EXPECT_EQ(tracker.getSession(), 0u);
+  EXPECT_EQ(resync, 0u);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
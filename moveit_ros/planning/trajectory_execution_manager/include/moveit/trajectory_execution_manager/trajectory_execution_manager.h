@@ -100,6 +100,10 @@ public:
   /// Get the instance of the controller manager used (this is the plugin instance loaded)
   const moveit_controller_manager::MoveItControllerManagerPtr& getControllerManager() const;
 
+  /// Use \e controller_manager instead of the loaded plugin, e.g. to execute with fake controllers in tests. Any
+  /// running execution is stopped first.
+  void setControllerManager(const moveit_controller_manager::MoveItControllerManagerPtr& controller_manager);
+
   /** \brief Execute a named event (e.g., 'stop') */
   void processEvent(const std::string& event);
 
@@ -214,6 +218,14 @@ public:
   /// pushAndExecute().
   std::pair<int, int> getCurrentExpectedTrajectoryIndex() const;
 
+  /// Replace the rest of the trajectory that is currently executed by execute() with \e trajectory, e.g. a suffix
+  /// re-timed by trajectory_processing::TrajectorySpeedScaling. It is sent to the controllers of the current trajectory
+  /// while they are executing, so they need to accept a new goal that preempts the active one. The header stamp of
+  /// \e trajectory marks the time at which it starts, or it starts right away if the stamp is not in the future. The
+  /// expected duration of the execution is updated for the new trajectory. Returns false if there is no such execution
+  /// or the trajectory cannot be sent, in which case the execution is stopped.
+  bool replaceCurrentTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory);
+
   /// Return the controller status for the last attempted execution
   moveit_controller_manager::ExecutionStatus getLastExecutionStatus() const;
 
@@ -294,6 +306,8 @@ private:
   void executeThread(const ExecutionCompleteCallback& callback, const PathSegmentCompleteCallback& part_callback,
                      bool auto_clear);
   bool executePart(std::size_t part_index);
+  /// Compute the time index and the deadline for executing \e context, starting now
+  void updateExpectedExecution(const TrajectoryExecutionContext& context);
   bool waitForRobotToStop(const TrajectoryExecutionContext& context, double wait_time = 1.0);
   void continuousExecutionThread();
 
@@ -322,16 +336,24 @@ private:
 
   boost::mutex execution_state_mutex_;
   boost::mutex continuous_execution_mutex_;
+  boost::mutex replacement_mutex_;  // serializes replaceCurrentTrajectory()
 
   boost::condition_variable continuous_execution_condition_;
 
   // this condition is used to notify the completion of execution for given trajectories
   boost::condition_variable execution_complete_condition_;
 
+  // this condition is used with time_index_mutex_ to notify the end of sending a replacement trajectory
+  boost::condition_variable replacement_condition_;
+
   moveit_controller_manager::ExecutionStatus last_execution_status_;
   std::vector<moveit_controller_manager::MoveItControllerHandlePtr> active_handles_;
   int current_context_;
   std::vector<rclcpp::Time> time_index_;  // used to find current expected trajectory location
+  rclcpp::Time execution_start_;     // when the execution of the current part was (re-)started
+  rclcpp::Time execution_deadline_;  // when the current part is expected to be done at the latest
+  std::size_t replacement_count_;    // number of trajectories sent by replaceCurrentTrajectory()
+  std::size_t replacements_in_progress_;  // number of replacements that are being sent to the controllers
   mutable boost::mutex time_index_mutex_;
   bool execution_complete_;
 
@@ -118,6 +118,8 @@ void TrajectoryExecutionManager::initialize()
   execution_complete_ = true;
   stop_continuous_execution_ = false;
   current_context_ = -1;
+  replacement_count_ = 0;
+  replacements_in_progress_ = 0;
   last_execution_status_ = moveit_controller_manager::ExecutionStatus::SUCCEEDED;
   run_continuous_execution_thread_ = true;
   execution_duration_monitoring_ = true;
@@ -233,6 +235,14 @@ const moveit_controller_manager::MoveItControllerManagerPtr& TrajectoryExecution
   return controller_manager_;
 }
 
+void TrajectoryExecutionManager::setControllerManager(
+    const moveit_controller_manager::MoveItControllerManagerPtr& controller_manager)
+{
+  stopExecution(false);
+  controller_manager_ = controller_manager;
+  reloadControllerInformation();
+}
+
 void TrajectoryExecutionManager::processEvent(const std::string& event)
 {
   if (event == "stop")
@@ -1401,151 +1411,122 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
       }
     }
 
-    // compute the expected duration of the trajectory and find the part of the trajectory that takes longest to execute
-
-    std_msgs::msg::Header current_time ;
-    current_time.stamp = rclcpp::Clock().now();
-    rclcpp::Duration expected_trajectory_duration(0.0);
-    int longest_part = -1;
-    for (std::size_t i = 0; i < context.trajectory_parts_.size(); ++i)
     {
-      rclcpp::Duration d(0.0);
-      if (!(context.trajectory_parts_[i].joint_trajectory.points.empty() &&
-            context.trajectory_parts_[i].multi_dof_joint_trajectory.points.empty()))
-      {
-        if (rclcpp::Time(context.trajectory_parts_[i].joint_trajectory.header.stamp) > current_time.stamp){
-
-            rclcpp::Duration dur = rclcpp::Duration(context.trajectory_parts_[i].joint_trajectory.header.stamp.sec, context.trajectory_parts_[i].joint_trajectory.header.stamp.nanosec)
-                                 - rclcpp::Duration(current_time.stamp.sec, current_time.stamp.nanosec);
-            d = dur;
-        }
-        if (rclcpp::Time(context.trajectory_parts_[i].multi_dof_joint_trajectory.header.stamp) > current_time.stamp){
-          rclcpp::Duration dur = rclcpp::Duration(context.trajectory_parts_[i].multi_dof_joint_trajectory.header.stamp.sec, context.trajectory_parts_[i].multi_dof_joint_trajectory.header.stamp.nanosec)
-                               - rclcpp::Duration(current_time.stamp.sec, current_time.stamp.nanosec);
-          d = std::max(d, dur);
-        }
-
-        d = d + std::max(context.trajectory_parts_[i].joint_trajectory.points.empty() ?
-                          rclcpp::Duration(0.0) :
-                          rclcpp::Duration(context.trajectory_parts_[i].joint_trajectory.points.back().time_from_start.sec,
-                          context.trajectory_parts_[i].joint_trajectory.points.back().time_from_start.nanosec),
-                      context.trajectory_parts_[i].multi_dof_joint_trajectory.points.empty() ?
-                          rclcpp::Duration(0.0) :
-                          rclcpp::Duration(context.trajectory_parts_[i].multi_dof_joint_trajectory.points.back().time_from_start.sec,
-                          context.trajectory_parts_[i].multi_dof_joint_trajectory.points.back().time_from_start.nanosec));
-
-        if (longest_part < 0 ||
-            std::max(context.trajectory_parts_[i].joint_trajectory.points.size(),
-                     context.trajectory_parts_[i].multi_dof_joint_trajectory.points.size()) >
-                std::max(context.trajectory_parts_[longest_part].joint_trajectory.points.size(),
-                         context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points.size()))
-          longest_part = i;
-      }
-
-      // prefer controller-specific values over global ones if defined
-      // TODO: the controller-specific parameters are static, but override
-      //       the global ones are configurable via dynamic reconfigure
-      std::map<std::string, double>::const_iterator scaling_it =
-          controller_allowed_execution_duration_scaling_.find(context.controllers_[i]);
-      const double current_scaling = scaling_it != controller_allowed_execution_duration_scaling_.end() ?
-                                         scaling_it->second :
-                                         allowed_execution_duration_scaling_;
-
-      std::map<std::string, double>::const_iterator margin_it =
-          controller_allowed_goal_duration_margin_.find(context.controllers_[i]);
-      const double current_margin = margin_it != controller_allowed_goal_duration_margin_.end() ?
-                                        margin_it->second :
-                                        allowed_goal_duration_margin_;
-
-      // expected duration is the duration of the longest part
-      expected_trajectory_duration =
-          std::max(d * current_scaling + rclcpp::Duration(current_margin), expected_trajectory_duration);
+      boost::mutex::scoped_lock slock(time_index_mutex_);
+      updateExpectedExecution(context);
     }
 
-    // construct a map from expected time to state index, for easy access to expected state location
-    if (longest_part >= 0)
+    bool result = true;
+    std::size_t replacement_count;
     {
       boost::mutex::scoped_lock slock(time_index_mutex_);
-
-      if (context.trajectory_parts_[longest_part].joint_trajectory.points.size() >=
-          context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points.size())
-      {
-        rclcpp::Duration d(0.0);
-        if (rclcpp::Time(context.trajectory_parts_[longest_part].joint_trajectory.header.stamp) > current_time.stamp)
-          d = rclcpp::Duration(context.trajectory_parts_[longest_part].joint_trajectory.header.stamp.sec, context.trajectory_parts_[longest_part].joint_trajectory.header.stamp.nanosec)
-                             - rclcpp::Duration(current_time.stamp.sec, current_time.stamp.nanosec);
-
-        for (std::size_t j = 0; j < context.trajectory_parts_[longest_part].joint_trajectory.points.size(); ++j){
-          time_index_.push_back(rclcpp::Time(current_time.stamp.sec,current_time.stamp.nanosec) + d +
-                                context.trajectory_parts_[longest_part].joint_trajectory.points[j].time_from_start);
-          }
-      }
-      else
-      {
-        rclcpp::Duration d(0.0);
-        if (rclcpp::Time(context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.header.stamp) > current_time.stamp)
-          d = rclcpp::Duration(context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.header.stamp.sec, context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.header.stamp.nanosec)
-                           - rclcpp::Duration(current_time.stamp.sec, current_time.stamp.nanosec);
-
-        for (std::size_t j = 0; j < context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points.size();
-             ++j)
-          time_index_.push_back(
-              rclcpp::Time(current_time.stamp.sec,current_time.stamp.nanosec) + d +
-              context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points[j].time_from_start);
-      }
+      replacement_count = replacement_count_;
     }
-
-    bool result = true;
-    for (std::size_t i = 0; i < handles.size(); ++i)
+    bool restart;
+    do
     {
-      if (execution_duration_monitoring_)
+      for (std::size_t i = 0; i < handles.size();)
       {
-        if (!handles[i]->waitForExecution(expected_trajectory_duration)){
-
-          auto time_now = rclcpp::Clock().now();
-
-          rclcpp::Duration elapsed = time_now - current_time.stamp;
-
-          if (!execution_complete_ && (elapsed) > expected_trajectory_duration)
+        // replaceCurrentTrajectory() may send new goals to the handles and extend the deadline while we wait. The wait
+        // may then have ended with a replaced goal, so we wait for all handles again after a replacement. Replacements
+        // that are still being sent are waited for, so they are counted before we look at the count.
+        bool done = false;
+        bool replaced = false;
+        rclcpp::Duration expected_trajectory_duration(0.0);
+        while (!execution_complete_)
+        {
+          rclcpp::Duration remaining(0.0);
           {
-            RCLCPP_ERROR(node_->get_logger(), "Controller is taking too long to execute trajectory (the expected upper "
-                                   "bound for the trajectory execution was %lf seconds). Stopping trajectory.",
-                            expected_trajectory_duration.seconds());
+            boost::mutex::scoped_lock slock(time_index_mutex_);
+            while (replacements_in_progress_ > 0)
+              replacement_condition_.wait(slock);
+            replaced = replacement_count != replacement_count_;
+            replacement_count = replacement_count_;
+            if (done || replaced)
+              break;
+            remaining = execution_deadline_ - rclcpp::Clock().now();
+            expected_trajectory_duration = execution_deadline_ - execution_start_;
+          }
+          if (execution_duration_monitoring_)
+          {
+            if (remaining <= rclcpp::Duration(0.0))
+              break;
+            done = handles[i]->waitForExecution(remaining);
+            if (!done)
             {
-              boost::mutex::scoped_lock slock(execution_state_mutex_);
-              stopExecutionInternal();  // this is really tricky. we can't call stopExecution() here, so we call the
-                                        // internal function only
+              // some handles return before the timeout without being done, e.g. ActionBasedControllerHandle for
+              // timeouts below a second, so do not poll them in a busy loop
+              boost::mutex::scoped_lock slock(time_index_mutex_);
+              replacement_condition_.wait_for(slock, boost::chrono::milliseconds(10));
             }
-            last_execution_status_ = moveit_controller_manager::ExecutionStatus::TIMED_OUT;
-            result = false;
-            break;
           }
+          else
+          {
+            handles[i]->waitForExecution();
+            done = true;
+          }
+        }
+        if (replaced && !execution_complete_)
+        {
+          i = 0;
+          continue;
         }
+
+        if (!done && !execution_complete_)
+        {
+          RCLCPP_ERROR(node_->get_logger(), "Controller is taking too long to execute trajectory (the expected upper "
+                                 "bound for the trajectory execution was %lf seconds). Stopping trajectory.",
+                          expected_trajectory_duration.seconds());
+          {
+            boost::mutex::scoped_lock slock(execution_state_mutex_);
+            stopExecutionInternal();  // this is really tricky. we can't call stopExecution() here, so we call the
+                                      // internal function only
+          }
+          last_execution_status_ = moveit_controller_manager::ExecutionStatus::TIMED_OUT;
+          result = false;
+          break;
+        }
+
+        // if something made the trajectory stop, we stop this thread too
+        if (execution_complete_)
+        {
+          result = false;
+          break;
+        }
+        else if (handles[i]->getLastExecutionStatus() != moveit_controller_manager::ExecutionStatus::SUCCEEDED)
+        {
+          RCLCPP_WARN(node_->get_logger(), "Controller handle %s reports status %s", handles[i]->getName().c_str()
+                                                            , std::to_string(handles[i]->getLastExecutionStatus()).c_str());
+          last_execution_status_ = handles[i]->getLastExecutionStatus();
+          result = false;
+        }
+        ++i;
       }
-      else
-        handles[i]->waitForExecution();
 
-      // if something made the trajectory stop, we stop this thread too
-      if (execution_complete_)
+      // A replacement that started after the last handle was done executes again, so we wait for all handles again.
+      // Replacements that are still being sent are waited for also if the execution ended, so they see that before
+      // another execution can start. Once the handles are cleared below, with the locks held from here on, no further
+      // replacement can start.
       {
-        result = false;
-        break;
+        boost::mutex::scoped_lock slock(time_index_mutex_);
+        while (replacements_in_progress_ > 0)
+          replacement_condition_.wait(slock);
       }
-      else if (handles[i]->getLastExecutionStatus() != moveit_controller_manager::ExecutionStatus::SUCCEEDED)
+      execution_state_mutex_.lock();
+      time_index_mutex_.lock();
+      restart = replacements_in_progress_ > 0 ||
+                (result && !execution_complete_ && replacement_count != replacement_count_);
+      if (restart)
       {
-        RCLCPP_WARN(node_->get_logger(), "Controller handle %s reports status %s", handles[i]->getName().c_str()
-                                                          , std::to_string(handles[i]->getLastExecutionStatus()).c_str());
-        last_execution_status_ = handles[i]->getLastExecutionStatus();
-        result = false;
+        time_index_mutex_.unlock();
+        execution_state_mutex_.unlock();
       }
-    }
+    } while (restart);
 
     // clear the active handles
-    execution_state_mutex_.lock();
     active_handles_.clear();
 
     // clear the time index
-    time_index_mutex_.lock();
     time_index_.clear();
     current_context_ = -1;
     time_index_mutex_.unlock();
@@ -1560,6 +1541,200 @@ bool TrajectoryExecutionManager::executePart(std::size_t part_index)
   }
 }
 
+void TrajectoryExecutionManager::updateExpectedExecution(const TrajectoryExecutionContext& context)
+{
+  // time_index_mutex_ needs to have been locked by the caller
+
+  // compute the expected duration of the trajectory and find the part of the trajectory that takes longest to execute
+  const rclcpp::Time now = rclcpp::Clock().now();
+  std_msgs::msg::Header current_time;
+  current_time.stamp = now;
+  rclcpp::Duration expected_trajectory_duration(0.0);
+  int longest_part = -1;
+  for (std::size_t i = 0; i < context.trajectory_parts_.size(); ++i)
+  {
+    rclcpp::Duration d(0.0);
+    if (!(context.trajectory_parts_[i].joint_trajectory.points.empty() &&
+          context.trajectory_parts_[i].multi_dof_joint_trajectory.points.empty()))
+    {
+      if (rclcpp::Time(context.trajectory_parts_[i].joint_trajectory.header.stamp) > current_time.stamp){
+
+          rclcpp::Duration dur = rclcpp::Duration(context.trajectory_parts_[i].joint_trajectory.header.stamp.sec, context.trajectory_parts_[i].joint_trajectory.header.stamp.nanosec)
+                               - rclcpp::Duration(current_time.stamp.sec, current_time.stamp.nanosec);
+          d = dur;
+      }
+      if (rclcpp::Time(context.trajectory_parts_[i].multi_dof_joint_trajectory.header.stamp) > current_time.stamp){
+        rclcpp::Duration dur = rclcpp::Duration(context.trajectory_parts_[i].multi_dof_joint_trajectory.header.stamp.sec, context.trajectory_parts_[i].multi_dof_joint_trajectory.header.stamp.nanosec)
+                             - rclcpp::Duration(current_time.stamp.sec, current_time.stamp.nanosec);
+        d = std::max(d, dur);
+      }
+
+      d = d + std::max(context.trajectory_parts_[i].joint_trajectory.points.empty() ?
+                        rclcpp::Duration(0.0) :
+                        rclcpp::Duration(context.trajectory_parts_[i].joint_trajectory.points.back().time_from_start.sec,
+                        context.trajectory_parts_[i].joint_trajectory.points.back().time_from_start.nanosec),
+                    context.trajectory_parts_[i].multi_dof_joint_trajectory.points.empty() ?
+                        rclcpp::Duration(0.0) :
+                        rclcpp::Duration(context.trajectory_parts_[i].multi_dof_joint_trajectory.points.back().time_from_start.sec,
+                        context.trajectory_parts_[i].multi_dof_joint_trajectory.points.back().time_from_start.nanosec));
+
+      if (longest_part < 0 ||
+          std::max(context.trajectory_parts_[i].joint_trajectory.points.size(),
+                   context.trajectory_parts_[i].multi_dof_joint_trajectory.points.size()) >
+              std::max(context.trajectory_parts_[longest_part].joint_trajectory.points.size(),
+                       context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points.size()))
+        longest_part = i;
+    }
+
+    // prefer controller-specific values over global ones if defined. The controller-specific values are only read
+    // from the parameters when the controllers are loaded, so they also win over global values set at runtime with
+    // setAllowedExecutionDurationScaling() and setAllowedGoalDurationMargin().
+    std::map<std::string, double>::const_iterator scaling_it =
+        controller_allowed_execution_duration_scaling_.find(context.controllers_[i]);
+    const double current_scaling = scaling_it != controller_allowed_execution_duration_scaling_.end() ?
+                                       scaling_it->second :
+                                       allowed_execution_duration_scaling_;
+
+    std::map<std::string, double>::const_iterator margin_it =
+        controller_allowed_goal_duration_margin_.find(context.controllers_[i]);
+    const double current_margin = margin_it != controller_allowed_goal_duration_margin_.end() ?
+                                      margin_it->second :
+                                      allowed_goal_duration_margin_;
+
+    // expected duration is the duration of the longest part
+    expected_trajectory_duration =
+        std::max(d * current_scaling + rclcpp::Duration(current_margin), expected_trajectory_duration);
+  }
+
+  // construct a map from expected time to state index, for easy access to expected state location
+  time_index_.clear();
+  if (longest_part >= 0)
+  {
+    if (context.trajectory_parts_[longest_part].joint_trajectory.points.size() >=
+        context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points.size())
+    {
+      rclcpp::Duration d(0.0);
+      if (rclcpp::Time(context.trajectory_parts_[longest_part].joint_trajectory.header.stamp) > current_time.stamp)
+        d = rclcpp::Duration(context.trajectory_parts_[longest_part].joint_trajectory.header.stamp.sec, context.trajectory_parts_[longest_part].joint_trajectory.header.stamp.nanosec)
+                           - rclcpp::Duration(current_time.stamp.sec, current_time.stamp.nanosec);
+
+      for (std::size_t j = 0; j < context.trajectory_parts_[longest_part].joint_trajectory.points.size(); ++j){
+        time_index_.push_back(rclcpp::Time(current_time.stamp.sec,current_time.stamp.nanosec) + d +
+                              context.trajectory_parts_[longest_part].joint_trajectory.points[j].time_from_start);
+        }
+    }
+    else
+    {
+      rclcpp::Duration d(0.0);
+      if (rclcpp::Time(context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.header.stamp) > current_time.stamp)
+        d = rclcpp::Duration(context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.header.stamp.sec, context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.header.stamp.nanosec)
+                         - rclcpp::Duration(current_time.stamp.sec, current_time.stamp.nanosec);
+
+      for (std::size_t j = 0; j < context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points.size();
+           ++j)
+        time_index_.push_back(
+            rclcpp::Time(current_time.stamp.sec,current_time.stamp.nanosec) + d +
+            context.trajectory_parts_[longest_part].multi_dof_joint_trajectory.points[j].time_from_start);
+    }
+  }
+
+  execution_start_ = now;
+  execution_deadline_ = now + expected_trajectory_duration;
+}
+
+bool TrajectoryExecutionManager::replaceCurrentTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory)
+{
+  // replacements are sent one after the other, so all controllers end up with the parts of the same one
+  boost::mutex::scoped_lock rlock(replacement_mutex_);
+
+  // the handles are copied, so the parts can be sent without blocking executePart() and stopExecution()
+  int context_index;
+  std::vector<moveit_msgs::msg::RobotTrajectory> parts;
+  std::vector<moveit_controller_manager::MoveItControllerHandlePtr> handles;
+  {
+    boost::mutex::scoped_lock slock(execution_state_mutex_);
+    {
+      // the time index is only set once executePart() is done with sending the trajectory of the current context
+      boost::mutex::scoped_lock tslock(time_index_mutex_);
+      if (execution_complete_ || current_context_ < 0 || time_index_.empty())
+      {
+        RCLCPP_ERROR(node_->get_logger(), "There is no trajectory executed by execute() that could be replaced");
+        return false;
+      }
+    }
+
+    context_index = current_context_;
+    if (!distributeTrajectory(trajectory, trajectories_[context_index]->controllers_, parts))
+    {
+      RCLCPP_ERROR(node_->get_logger(), "Unable to distribute the replacement trajectory to the current controllers");
+      return false;
+    }
+    handles = active_handles_;
+
+    // executePart() waits for the replacement to be counted before it looks at the handles again
+    boost::mutex::scoped_lock tslock(time_index_mutex_);
+    ++replacements_in_progress_;
+  }
+
+  std::size_t failed_part = parts.size();
+  for (std::size_t i = 0; i < parts.size(); ++i)
+  {
+    bool ok = false;
+    try
+    {
+      ok = handles[i]->sendTrajectory(parts[i]);
+    }
+    catch (std::exception& ex)
+    {
+      RCLCPP_ERROR(node_->get_logger(), "Caught %s when sending trajectory to controller", ex.what());
+    }
+    if (!ok)
+    {
+      failed_part = i;
+      break;
+    }
+  }
+
+  boost::mutex::scoped_lock slock(execution_state_mutex_);
+  boost::mutex::scoped_lock tslock(time_index_mutex_);
+  // waiters only see the result of the replacement once the locks are released
+  --replacements_in_progress_;
+  replacement_condition_.notify_all();
+
+  if (execution_complete_ || current_context_ != context_index)
+  {
+    // the execution was stopped while the parts were sent, so stop the controllers again
+    RCLCPP_ERROR(node_->get_logger(), "The execution ended while its trajectory was replaced");
+    for (const moveit_controller_manager::MoveItControllerHandlePtr& handle : handles)
+      try
+      {
+        handle->cancelExecution();
+      }
+      catch (std::exception& ex)
+      {
+        RCLCPP_ERROR(node_->get_logger(), "Caught %s when canceling execution.", ex.what());
+      }
+    return false;
+  }
+
+  if (failed_part < parts.size())
+  {
+    // some controllers may already execute the replacement, so the parts do not fit together anymore
+    RCLCPP_ERROR(node_->get_logger(), "Failed to send replacement trajectory part %zu of %zu to controller %s. "
+                                      "Stopping trajectory.",
+                 failed_part + 1, parts.size(), handles[failed_part]->getName().c_str());
+    stopExecutionInternal();
+    last_execution_status_ = moveit_controller_manager::ExecutionStatus::ABORTED;
+    return false;
+  }
+
+  TrajectoryExecutionContext& context = *trajectories_[context_index];
+  context.trajectory_parts_.swap(parts);
+  updateExpectedExecution(context);
+  ++replacement_count_;
+  return true;
+}
+
 bool TrajectoryExecutionManager::waitForRobotToStop(const TrajectoryExecutionContext& context, double wait_time)
 {
   // skip waiting for convergence?
@@ -0,0 +1,346 @@
+/*********************************************************************
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2026, The MoveIt Contributors
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the names of the authors nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *********************************************************************/
+
+#include <moveit/trajectory_execution_manager/trajectory_execution_manager.h>
+#include <moveit/utils/robot_model_test_utils.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+const std::string CONTROLLER = "arm_controller";
+
+/* A controller handle that executes its goals until finish() is called. Like an action server, it preempts the
+ * executed goal when it receives a new one, which ends the waits for the preempted goal. */
+class FakeControllerHandle : public moveit_controller_manager::MoveItControllerHandle
+{
+public:
+  FakeControllerHandle()
+    : MoveItControllerHandle(CONTROLLER), goal_count_(0), done_(true), blocked_(false), blocked_goal_(false)
+  {
+  }
+
+  bool sendTrajectory(const moveit_msgs::msg::RobotTrajectory& trajectory) override
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    blocked_goal_ = blocked_;
+    condition_.notify_all();
+    condition_.wait(lock, [this] { return !blocked_; });
+    blocked_goal_ = false;
+    trajectories_.push_back(trajectory);
+    ++goal_count_;
+    done_ = false;
+    status_ = moveit_controller_manager::ExecutionStatus::RUNNING;
+    condition_.notify_all();
+    return true;
+  }
+
+  bool cancelExecution() override
+  {
+    finish(moveit_controller_manager::ExecutionStatus::PREEMPTED);
+    return true;
+  }
+
+  bool waitForExecution(const rclcpp::Duration& timeout = rclcpp::Duration(0.0)) override
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::size_t goal = goal_count_;
+    const auto finished = [this, goal] { return done_ || goal_count_ != goal; };
+    if (timeout <= rclcpp::Duration(0.0))
+    {
+      condition_.wait(lock, finished);
+      return true;
+    }
+    return condition_.wait_for(lock, std::chrono::nanoseconds(timeout.nanoseconds()), finished);
+  }
+
+  moveit_controller_manager::ExecutionStatus getLastExecutionStatus() override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return status_;
+  }
+
+  /// End the execution of the current goal with \e status
+  void finish(const moveit_controller_manager::ExecutionStatus& status)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+    status_ = status;
+    condition_.notify_all();
+  }
+
+  /// Make sendTrajectory() block until \e blocked is reset
+  void setBlocked(bool blocked)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocked_ = blocked;
+    condition_.notify_all();
+  }
+
+  /// Wait until sendTrajectory() blocks, at most 5 seconds
+  bool waitForBlockedGoal()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, std::chrono::seconds(5), [this] { return blocked_goal_; });
+  }
+
+  /// Wait until \e count goals were received, at most 5 seconds
+  bool waitForGoals(std::size_t count)
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return condition_.wait_for(lock, std::chrono::seconds(5), [this, count] { return goal_count_ >= count; });
+  }
+
+  std::vector<moveit_msgs::msg::RobotTrajectory> getTrajectories()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return trajectories_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<moveit_msgs::msg::RobotTrajectory> trajectories_;
+  std::size_t goal_count_;
+  bool done_;
+  bool blocked_;
+  bool blocked_goal_;
+  moveit_controller_manager::ExecutionStatus status_;
+};
+
+/* A controller manager with a single active controller for all joints of the robot */
+class FakeControllerManager : public moveit_controller_manager::MoveItControllerManager
+{
+public:
+  FakeControllerManager(const std::vector<std::string>& joints, const std::shared_ptr<FakeControllerHandle>& handle)
+    : joints_(joints), handle_(handle)
+  {
+  }
+
+  void initialize(std::shared_ptr<rclcpp::Node>& /*node*/) override
+  {
+  }
+
+  moveit_controller_manager::MoveItControllerHandlePtr getControllerHandle(const std::string& name) override
+  {
+    return name == CONTROLLER ? handle_ : moveit_controller_manager::MoveItControllerHandlePtr();
+  }
+
+  void getControllersList(std::vector<std::string>& names) override
+  {
+    names.assign(1, CONTROLLER);
+  }
+
+  void getActiveControllers(std::vector<std::string>& names) override
+  {
+    names.assign(1, CONTROLLER);
+  }
+
+  void getControllerJoints(const std::string& name, std::vector<std::string>& joints) override
+  {
+    joints = name == CONTROLLER ? joints_ : std::vector<std::string>();
+  }
+
+  ControllerState getControllerState(const std::string& name) override
+  {
+    ControllerState state;
+    state.active_ = name == CONTROLLER;
+    state.default_ = name == CONTROLLER;
+    return state;
+  }
+
+  bool switchControllers(const std::vector<std::string>& /*activate*/,
+                         const std::vector<std::string>& /*deactivate*/) override
+  {
+    return true;
+  }
+
+private:
+  std::vector<std::string> joints_;
+  std::shared_ptr<FakeControllerHandle> handle_;
+};
+
+// a trajectory of \e joints that moves them from 0 to \e goal within \e duration seconds
+moveit_msgs::msg::RobotTrajectory makeTrajectory(const std::vector<std::string>& joints, double goal, double duration)
+{
+  moveit_msgs::msg::RobotTrajectory trajectory;
+  trajectory.joint_trajectory.joint_names = joints;
+  trajectory.joint_trajectory.points.resize(2);
+  trajectory.joint_trajectory.points[0].positions.assign(joints.size(), 0.0);
+  trajectory.joint_trajectory.points[1].positions.assign(joints.size(), goal);
+  trajectory.joint_trajectory.points[1].time_from_start = rclcpp::Duration(duration);
+  return trajectory;
+}
+}  // namespace
+
+class ReplaceCurrentTrajectoryTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    moveit::core::RobotModelBuilder builder("chain", "link0");
+    builder.addChain("link0->link1->link2", "revolute");
+    robot_model_ = builder.build();
+    ASSERT_TRUE(bool(robot_model_));
+    joints_ = robot_model_->getVariableNames();
+
+    // the manager reads parameters of this node when it is created
+    parameter_node_ = rclcpp::Node::make_shared("dummy_joint_states");
+    executor_.add_node(parameter_node_);
+    spinner_ = std::thread([this] { executor_.spin(); });
+
+    handle_ = std::make_shared<FakeControllerHandle>();
+    node_ = rclcpp::Node::make_shared("test_replace_current_trajectory");
+    tem_.reset(new trajectory_execution_manager::TrajectoryExecutionManager(
+        robot_model_, planning_scene_monitor::CurrentStateMonitorPtr(), false, node_));
+    tem_->setControllerManager(std::make_shared<FakeControllerManager>(joints_, handle_));
+    // there is no current state monitor to validate the trajectories against
+    tem_->setAllowedStartTolerance(0.0);
+  }
+
+  void TearDown() override
+  {
+    tem_.reset();
+    executor_.cancel();
+    if (spinner_.joinable())
+      spinner_.join();
+  }
+
+  // replace the trajectory executed by tem_ once executePart() is done with sending it, at most within 5 seconds
+  bool replace(const moveit_msgs::msg::RobotTrajectory& trajectory)
+  {
+    for (int i = 0; i < 500; ++i)
+    {
+      if (tem_->replaceCurrentTrajectory(trajectory))
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+  robot_model::RobotModelPtr robot_model_;
+  std::vector<std::string> joints_;
+  rclcpp::Node::SharedPtr parameter_node_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  std::thread spinner_;
+  rclcpp::Node::SharedPtr node_;
+  std::shared_ptr<FakeControllerHandle> handle_;
+  std::unique_ptr<trajectory_execution_manager::TrajectoryExecutionManager> tem_;
+};
+
+TEST_F(ReplaceCurrentTrajectoryTest, NothingToReplace)
+{
+  EXPECT_FALSE(tem_->replaceCurrentTrajectory(makeTrajectory(joints_, 1.0, 10.0)));
+  EXPECT_TRUE(handle_->getTrajectories().empty());
+}
+
+TEST_F(ReplaceCurrentTrajectoryTest, SwapMidExecution)
+{
+  std::atomic<bool> complete(false);
+  ASSERT_TRUE(tem_->push(makeTrajectory(joints_, 1.0, 10.0), CONTROLLER));
+  tem_->execute([&complete](const moveit_controller_manager::ExecutionStatus&) { complete = true; });
+  ASSERT_TRUE(handle_->waitForGoals(1));
+
+  // the handle preempts the first goal, which must not end the execution
+  ASSERT_TRUE(replace(makeTrajectory(joints_, 0.5, 20.0)));
+  ASSERT_TRUE(handle_->waitForGoals(2));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(complete);
+
+  handle_->finish(moveit_controller_manager::ExecutionStatus::SUCCEEDED);
+  EXPECT_EQ(tem_->waitForExecution(), moveit_controller_manager::ExecutionStatus::SUCCEEDED);
+
+  const std::vector<moveit_msgs::msg::RobotTrajectory> trajectories = handle_->getTrajectories();
+  ASSERT_EQ(trajectories.size(), 2u);
+  ASSERT_EQ(trajectories[1].joint_trajectory.points.size(), 2u);
+  EXPECT_EQ(trajectories[1].joint_trajectory.points[1].positions, std::vector<double>(joints_.size(), 0.5));
+  EXPECT_EQ(rclcpp::Duration(trajectories[1].joint_trajectory.points[1].time_from_start).seconds(), 20.0);
+}
+
+TEST_F(ReplaceCurrentTrajectoryTest, FailureOfReplacementIsReported)
+{
+  ASSERT_TRUE(tem_->push(makeTrajectory(joints_, 1.0, 10.0), CONTROLLER));
+  tem_->execute();
+  ASSERT_TRUE(handle_->waitForGoals(1));
+  ASSERT_TRUE(replace(makeTrajectory(joints_, 0.5, 20.0)));
+  ASSERT_TRUE(handle_->waitForGoals(2));
+
+  handle_->finish(moveit_controller_manager::ExecutionStatus::ABORTED);
+  EXPECT_EQ(tem_->waitForExecution(), moveit_controller_manager::ExecutionStatus::ABORTED);
+}
+
+TEST_F(ReplaceCurrentTrajectoryTest, StopWhileReplacementIsSent)
+{
+  ASSERT_TRUE(tem_->push(makeTrajectory(joints_, 1.0, 10.0), CONTROLLER));
+  tem_->execute();
+  ASSERT_TRUE(handle_->waitForGoals(1));
+
+  // executePart() is done with sending the trajectory once its time index is set
+  for (int i = 0; i < 500 && tem_->getCurrentExpectedTrajectoryIndex().second < 0; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_GE(tem_->getCurrentExpectedTrajectoryIndex().second, 0);
+
+  handle_->setBlocked(true);
+  std::atomic<bool> replaced(true);
+  std::thread replacer(
+      [this, &replaced] { replaced = tem_->replaceCurrentTrajectory(makeTrajectory(joints_, 0.5, 20.0)); });
+  ASSERT_TRUE(handle_->waitForBlockedGoal());
+
+  // the replacement is sent without holding the execution state, so the execution can be stopped meanwhile
+  std::thread stopper([this] { tem_->stopExecution(); });
+  for (int i = 0; i < 500 && handle_->getLastExecutionStatus() != moveit_controller_manager::ExecutionStatus::PREEMPTED;
+       ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(handle_->getLastExecutionStatus(), moveit_controller_manager::ExecutionStatus::PREEMPTED);
+
+  // the replacement that arrives after the stop is canceled again
+  handle_->setBlocked(false);
+  replacer.join();
+  stopper.join();
+  EXPECT_FALSE(replaced);
+  EXPECT_EQ(handle_->getTrajectories().size(), 2u);
+  EXPECT_EQ(handle_->getLastExecutionStatus(), moveit_controller_manager::ExecutionStatus::PREEMPTED);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  int result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}